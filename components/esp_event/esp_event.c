@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -26,6 +27,10 @@
 #define LOOP_DUMP_FORMAT              "LOOP @%p,%s rx:%" PRIu32 " dr:%" PRIu32 "\n"
 // handler @<address> ev:<base, id> inv:<times invoked> time:<runtime>
 #define HANDLER_DUMP_FORMAT           "  HANDLER @%p ev:%s,%s inv:%" PRIu32 " time:%lld us\n"
+// pool hit:<payloads allocated from the pool> miss:<payloads allocated from the heap>
+#define POOL_DUMP_FORMAT              "  POOL hit:%" PRIu32 " miss:%" PRIu32 "\n"
+// batch <number of batches of 1, 2-3, 4-7, 8-15 and 16 or more events dispatched>
+#define BATCH_DUMP_FORMAT             "  BATCH 1:%" PRIu32 " 2-3:%" PRIu32 " 4-7:%" PRIu32 " 8-15:%" PRIu32 " 16+:%" PRIu32 "\n"
 
 #define PRINT_DUMP_INFO(dst, sz, ...)  do { \
                                             int cb = snprintf(dst, sz, __VA_ARGS__); \
@@ -34,6 +39,9 @@
                                         } while(0);
 #endif
 
+// Number of events copied and queued at once by esp_event_post_batch
+#define POST_BATCH_CHUNK_SIZE         16
+
 /* ------------------------- Static Variables ------------------------------- */
 
 static const char* TAG = "event";
@@ -89,12 +97,16 @@ static int esp_event_dump_prepare(void)
     // Reserve slightly more memory than computed
     int allowance = 3;
     int size = (((loops + allowance) * (sizeof(LOOP_DUMP_FORMAT) + 10 + 20 + 2 * 11)) +
+                ((loops + allowance) * (sizeof(POOL_DUMP_FORMAT) + 2 * 11)) +
+                ((loops + allowance) * (sizeof(BATCH_DUMP_FORMAT) + ESP_EVENT_BATCH_SIZE_BUCKETS * 11)) +
                 ((handlers + allowance) * (sizeof(HANDLER_DUMP_FORMAT) + 10 + 2 * 20 + 11 + 20)));
 
     return size;
 }
 #endif
 
+static esp_err_t loop_run_queue(esp_event_loop_instance_t* loop, QueueHandle_t queue, TickType_t ticks_to_run);
+
 static void esp_event_loop_run_task(void* args)
 {
     esp_err_t err;
@@ -113,6 +125,17 @@ static void esp_event_loop_run_task(void* args)
     vTaskSuspend(NULL);
 }
 
+static void esp_event_loop_worker_task(void* args)
+{
+    esp_event_loop_worker_t* worker = (esp_event_loop_worker_t*) args;
+
+    ESP_LOGD(TAG, "running worker task for loop %p", worker->loop);
+
+    while (1) {
+        loop_run_queue(worker->loop, worker->queue, portMAX_DELAY);
+    }
+}
+
 static void handler_execute(esp_event_loop_instance_t* loop, esp_event_handler_node_t *handler, esp_event_post_instance_t post)
 {
     ESP_LOGD(TAG, "running post %s:%"PRIu32" with handler %p and context %p on loop %p", post.base, post.id, handler->handler_ctx->handler, &handler->handler_ctx, loop);
@@ -141,8 +164,8 @@ static void handler_execute(esp_event_loop_instance_t* loop, esp_event_handler_n
 #ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
     diff = esp_timer_get_time() - start;
 
-    handler->invoked++;
-    handler->time += diff;
+    atomic_fetch_add(&handler->invoked, 1);
+    atomic_fetch_add(&handler->time, diff);
 #endif
 }
 
@@ -382,6 +405,7 @@ static esp_err_t loop_remove_handler(esp_event_remove_handler_context_t* ctx)
         esp_err_t res = loop_node_remove_handler(it, ctx->event_base, ctx->event_id, ctx->handler_ctx, ctx->legacy);
 
         if (res == ESP_OK) {
+            ctx->loop->dispatch_table_valid = false;
             if (SLIST_EMPTY(&(it->base_nodes)) && SLIST_EMPTY(&(it->handlers))) {
                 SLIST_REMOVE(&(ctx->loop->loop_nodes), it, esp_event_loop_node, next);
                 free(it);
@@ -426,17 +450,365 @@ static void loop_node_remove_all_handler(esp_event_loop_node_t* loop_node)
     }
 }
 
-static void inline __attribute__((always_inline)) post_instance_delete(esp_event_post_instance_t* post)
+static inline bool payload_in_pool(esp_event_loop_instance_t* loop, const void* payload)
+{
+    const uint8_t* ptr = (const uint8_t*) payload;
+    return loop->payload_pool != NULL && ptr >= loop->payload_pool &&
+           ptr < loop->payload_pool + loop->payload_pool_size * loop->payload_buffer_size;
+}
+
+static void payload_release(esp_event_loop_instance_t* loop, void* payload)
+{
+    if (payload_in_pool(loop, payload)) {
+        // unused buffers are linked through their first bytes
+        portENTER_CRITICAL(&loop->payload_lock);
+        *(void**) payload = loop->payload_free;
+        loop->payload_free = payload;
+        portEXIT_CRITICAL(&loop->payload_lock);
+    } else {
+        free(payload);
+    }
+}
+
+static void inline __attribute__((always_inline)) post_instance_delete(esp_event_loop_instance_t* loop, esp_event_post_instance_t* post)
 {
 #if CONFIG_ESP_EVENT_POST_FROM_ISR
     if (post->data_allocated)
 #endif
     {
-        free(post->data.ptr);
+        payload_release(loop, post->data.ptr);
     }
     memset(post, 0, sizeof(*post));
 }
 
+static inline uint32_t dispatch_hash(esp_event_base_t base, int32_t id)
+{
+    uint32_t hash = (uint32_t)(uintptr_t) base ^ ((uint32_t) id * 0x9e3779b1);
+    return hash ^ (hash >> 15);
+}
+
+// Returns the slot holding the entry for base and id, or the unused slot where it has to be added
+static esp_event_dispatch_entry_t* dispatch_table_slot(esp_event_dispatch_table_t* table, esp_event_base_t base, int32_t id)
+{
+    uint32_t i = dispatch_hash(base, id) & table->mask;
+    while (table->slots[i].base != NULL && (table->slots[i].base != base || table->slots[i].id != id)) {
+        i = (i + 1) & table->mask;
+    }
+    return &table->slots[i];
+}
+
+static void dispatch_table_add(esp_event_dispatch_table_t* table, esp_event_base_t base, int32_t id)
+{
+    esp_event_dispatch_entry_t* entry = dispatch_table_slot(table, base, id);
+    entry->base = base;
+    entry->id = id;
+}
+
+// Collects the handlers to execute for an event with the given base and id, in the order in which they are found
+// by walking the handler lists (see dispatch_walk). If out is NULL, the handlers are only counted.
+static uint32_t dispatch_collect(esp_event_loop_instance_t* loop, esp_event_base_t base, int32_t id, esp_event_handler_node_t** out)
+{
+    uint32_t count = 0;
+    esp_event_handler_node_t *handler;
+    esp_event_loop_node_t *loop_node;
+    esp_event_base_node_t *base_node;
+    esp_event_id_node_t *id_node;
+
+    SLIST_FOREACH(loop_node, &(loop->loop_nodes), next) {
+        SLIST_FOREACH(handler, &(loop_node->handlers), next) {
+            if (out) {
+                out[count] = handler;
+            }
+            count++;
+        }
+
+        SLIST_FOREACH(base_node, &(loop_node->base_nodes), next) {
+            if (base_node->base == base) {
+                SLIST_FOREACH(handler, &(base_node->handlers), next) {
+                    if (out) {
+                        out[count] = handler;
+                    }
+                    count++;
+                }
+
+                SLIST_FOREACH(id_node, &(base_node->id_nodes), next) {
+                    if (id_node->id == id) {
+                        SLIST_FOREACH(handler, &(id_node->handlers), next) {
+                            if (out) {
+                                out[count] = handler;
+                            }
+                            count++;
+                        }
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    return count;
+}
+
+static void dispatch_table_delete(esp_event_dispatch_table_t* table)
+{
+    free(table->handlers);
+    free(table);
+}
+
+// Detaches the dispatch table from the loop. If workers still dispatch events using the table, the last one
+// of them deletes it.
+static void dispatch_table_free(esp_event_loop_instance_t* loop)
+{
+    esp_event_dispatch_table_t* table = loop->dispatch_table;
+    loop->dispatch_table = NULL;
+    if (table && table->refs == 0) {
+        dispatch_table_delete(table);
+    }
+}
+
+// Builds the dispatch table, with an entry for every base with handlers and for every base and id with
+// id level handlers. An entry holds all handlers to execute for the event, including base and loop level handlers.
+static esp_err_t dispatch_table_build(esp_event_loop_instance_t* loop)
+{
+    esp_event_loop_node_t *loop_node;
+    esp_event_base_node_t *base_node;
+    esp_event_id_node_t *id_node;
+
+    dispatch_table_free(loop);
+
+    uint32_t keys = 0;
+    SLIST_FOREACH(loop_node, &(loop->loop_nodes), next) {
+        SLIST_FOREACH(base_node, &(loop_node->base_nodes), next) {
+            keys++;
+            SLIST_FOREACH(id_node, &(base_node->id_nodes), next) {
+                keys++;
+            }
+        }
+    }
+
+    // keep the load factor at or below 50%
+    uint32_t slot_count = 4;
+    while (slot_count < keys * 2) {
+        slot_count *= 2;
+    }
+
+    esp_event_dispatch_table_t* table = calloc(1, sizeof(*table) + slot_count * sizeof(table->slots[0]));
+    if (table == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    table->mask = slot_count - 1;
+
+    SLIST_FOREACH(loop_node, &(loop->loop_nodes), next) {
+        SLIST_FOREACH(base_node, &(loop_node->base_nodes), next) {
+            dispatch_table_add(table, base_node->base, ESP_EVENT_ANY_ID);
+            SLIST_FOREACH(id_node, &(base_node->id_nodes), next) {
+                dispatch_table_add(table, base_node->base, id_node->id);
+            }
+        }
+    }
+
+    // no base node has a NULL base, so this yields the loop level handlers only
+    uint32_t total = table->any.count = dispatch_collect(loop, NULL, ESP_EVENT_ANY_ID, NULL);
+    for (uint32_t i = 0; i < slot_count; i++) {
+        esp_event_dispatch_entry_t* entry = &table->slots[i];
+        if (entry->base != NULL) {
+            entry->first = total;
+            entry->count = dispatch_collect(loop, entry->base, entry->id, NULL);
+            total += entry->count;
+        }
+    }
+
+    if (total > 0) {
+        table->handlers = calloc(total, sizeof(table->handlers[0]));
+        if (table->handlers == NULL) {
+            free(table);
+            return ESP_ERR_NO_MEM;
+        }
+
+        dispatch_collect(loop, NULL, ESP_EVENT_ANY_ID, table->handlers);
+        for (uint32_t i = 0; i < slot_count; i++) {
+            esp_event_dispatch_entry_t* entry = &table->slots[i];
+            if (entry->base != NULL) {
+                dispatch_collect(loop, entry->base, entry->id, &table->handlers[entry->first]);
+            }
+        }
+    }
+
+    loop->dispatch_table = table;
+    loop->dispatch_table_valid = true;
+
+    return ESP_OK;
+}
+
+// Executes the handlers of an event using the dispatch table
+static bool dispatch_table_run(esp_event_loop_instance_t* loop, esp_event_dispatch_table_t* table, esp_event_post_instance_t post)
+{
+    esp_event_dispatch_entry_t* entry = dispatch_table_slot(table, post.base, post.id);
+
+    if (entry->base == NULL) {
+        // no id level handlers for this event, execute the base and loop level handlers
+        entry = dispatch_table_slot(table, post.base, ESP_EVENT_ANY_ID);
+        if (entry->base == NULL) {
+            entry = &table->any;
+        }
+    }
+
+    bool exec = false;
+
+    // The handlers are not freed while the loop mutex is held by this task or, for loops with several tasks,
+    // while any of them dispatches an event. The table itself is not deleted while it is used for dispatching.
+    for (uint32_t i = 0; i < entry->count; i++) {
+        esp_event_handler_node_t *handler = table->handlers[entry->first + i];
+        if (!handler->unregistered) {
+            handler_execute(loop, handler, post);
+            exec = true;
+        }
+    }
+
+    return exec;
+}
+
+// Executes the handlers of an event by walking the handler lists, used if there is no memory for the dispatch table
+static bool dispatch_walk(esp_event_loop_instance_t* loop, esp_event_post_instance_t post)
+{
+    bool exec = false;
+
+    esp_event_handler_node_t *handler, *temp_handler;
+    esp_event_loop_node_t *loop_node, *temp_node;
+    esp_event_base_node_t *base_node, *temp_base;
+    esp_event_id_node_t *id_node, *temp_id_node;
+
+    SLIST_FOREACH_SAFE(loop_node, &(loop->loop_nodes), next, temp_node) {
+        // Execute loop level handlers
+        SLIST_FOREACH_SAFE(handler, &(loop_node->handlers), next, temp_handler) {
+            if (!handler->unregistered) {
+                handler_execute(loop, handler, post);
+                exec |= true;
+            }
+        }
+
+        SLIST_FOREACH_SAFE(base_node, &(loop_node->base_nodes), next, temp_base) {
+            if (base_node->base == post.base) {
+                // Execute base level handlers
+                SLIST_FOREACH_SAFE(handler, &(base_node->handlers), next, temp_handler) {
+                    if (!handler->unregistered) {
+                        handler_execute(loop, handler, post);
+                        exec |= true;
+                    }
+                }
+
+                SLIST_FOREACH_SAFE(id_node, &(base_node->id_nodes), next, temp_id_node) {
+                    if (id_node->id == post.id) {
+                        // Execute id level handlers
+                        SLIST_FOREACH_SAFE(handler, &(id_node->handlers), next, temp_handler) {
+                            if (!handler->unregistered) {
+                                handler_execute(loop, handler, post);
+                                exec |= true;
+                            }
+                        }
+                        // Skip to next base node
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    return exec;
+}
+
+// Initializes a post for an event, with a copy of the event data on the heap
+static esp_err_t post_instance_create(esp_event_post_instance_t* post, esp_event_base_t event_base, int32_t event_id,
+                                      const void* event_data, size_t event_data_size)
+{
+    memset((void*)post, 0, sizeof(*post));
+
+    if (event_data != NULL && event_data_size != 0) {
+        // Make persistent copy of event data on heap.
+        void* event_data_copy = calloc(1, event_data_size);
+
+        if (event_data_copy == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+
+        memcpy(event_data_copy, event_data, event_data_size);
+        post->data.ptr = event_data_copy;
+#if CONFIG_ESP_EVENT_POST_FROM_ISR
+        post->data_allocated = true;
+        post->data_set = true;
+#endif
+    }
+    post->base = event_base;
+    post->id = event_id;
+
+    return ESP_OK;
+}
+
+// Returns the queue of the loop an event is posted to. Loops with several tasks dispatch all events with the same
+// base and id from the same queue, which keeps them in order.
+static inline QueueHandle_t post_instance_queue(esp_event_loop_instance_t* loop, const esp_event_post_instance_t* post)
+{
+    if (loop->workers == NULL) {
+        return loop->queue;
+    }
+    return loop->workers[dispatch_hash(post->base, post->id) % loop->worker_count].queue;
+}
+
+static bool loop_task_is_current(esp_event_loop_instance_t* loop)
+{
+    TaskHandle_t current = xTaskGetCurrentTaskHandle();
+    for (uint32_t i = 1; i < loop->worker_count; i++) {
+        if (loop->workers[i].task == current) {
+            return true;
+        }
+    }
+    return loop->task == current;
+}
+
+// Sends a post to the queue of the loop. If the post cannot be sent, its data is left to the caller.
+static esp_err_t post_instance_send(esp_event_loop_instance_t* loop, esp_event_post_instance_t* post, TickType_t ticks_to_wait)
+{
+    BaseType_t result = pdFALSE;
+    QueueHandle_t queue = post_instance_queue(loop, post);
+
+    // Find the task that currently executes the loop. It is safe to query loop->task since it is
+    // not mutated since loop creation. ENSURE THIS REMAINS TRUE.
+    if (loop->task == NULL) {
+        // The loop has no dedicated task. Find out what task is currently running it.
+        result = xSemaphoreTakeRecursive(loop->mutex, ticks_to_wait);
+
+        if (result == pdTRUE) {
+            if (loop->running_task != xTaskGetCurrentTaskHandle()) {
+                xSemaphoreGiveRecursive(loop->mutex);
+                result = xQueueSendToBack(queue, post, ticks_to_wait);
+            } else {
+                xSemaphoreGiveRecursive(loop->mutex);
+                result = xQueueSendToBack(queue, post, 0);
+            }
+        }
+    } else {
+        // The loop has dedicated tasks.
+        if (!loop_task_is_current(loop)) {
+            result = xQueueSendToBack(queue, post, ticks_to_wait);
+        } else {
+            result = xQueueSendToBack(queue, post, 0);
+        }
+    }
+
+    if (result != pdTRUE) {
+#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
+        atomic_fetch_add(&loop->events_dropped, 1);
+#endif
+        return ESP_ERR_TIMEOUT;
+    }
+
+#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
+    atomic_fetch_add(&loop->events_received, 1);
+#endif
+
+    return ESP_OK;
+}
+
 static esp_err_t find_and_unregister_handler(esp_event_remove_handler_context_t* ctx)
 {
     esp_event_handler_node_t *handler_to_unregister = NULL;
@@ -519,6 +891,18 @@ static esp_err_t find_and_unregister_handler(esp_event_remove_handler_context_t*
          * remove from the list. return OK but do nothing */
         return ESP_OK;
     }
+
+    /* the tasks of a loop with several tasks execute the handlers without holding
+     * the mutex: while any of them dispatches an event, the removal is queued to
+     * the pending removals, done by the last of them */
+    esp_event_remove_handler_context_t *pending = NULL;
+    if (ctx->loop->dispatching > 0) {
+        pending = calloc(1, sizeof(esp_event_remove_handler_context_t));
+        if (!pending) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
     /* handler found in the lists and not already marked as unregistered. Mark it as unregistered
      * and post an event to remove it from the lists */
     handler_to_unregister->unregistered = true;
@@ -526,12 +910,19 @@ static esp_err_t find_and_unregister_handler(esp_event_remove_handler_context_t*
         /* in case of legacy code, we have to copy the handler_ctx content since it was created in the calling function */
         esp_event_handler_instance_context_t *handler_ctx_copy = calloc(1, sizeof(esp_event_handler_instance_context_t));
         if (!handler_ctx_copy) {
+            free(pending);
             return ESP_ERR_NO_MEM;
         }
         handler_ctx_copy->arg = ctx->handler_ctx->arg;
         handler_ctx_copy->handler = ctx->handler_ctx->handler;
         ctx->handler_ctx = handler_ctx_copy;
     }
+
+    if (pending) {
+        *pending = *ctx;
+        SLIST_INSERT_HEAD(&(ctx->loop->pending_removals), pending, next);
+        return ESP_OK;
+    }
     return esp_event_post_to(ctx->loop, esp_event_handler_cleanup, 0, ctx, sizeof(esp_event_remove_handler_context_t), portMAX_DELAY);
 }
 
@@ -572,8 +963,73 @@ esp_err_t esp_event_loop_create(const esp_event_loop_args_t* event_loop_args, es
 
     SLIST_INIT(&(loop->loop_nodes));
 
-    // Create the loop task if requested
-    if (event_loop_args->task_name != NULL) {
+    if (event_loop_args->payload_pool_size > 0 && event_loop_args->payload_buffer_size > 0) {
+        // round the buffers up to keep each of them aligned like a heap allocation
+        const size_t align = _Alignof(max_align_t);
+        size_t buffer_size = (event_loop_args->payload_buffer_size + align - 1) & ~(align - 1);
+
+        loop->payload_pool = calloc(event_loop_args->payload_pool_size, buffer_size);
+        if (loop->payload_pool == NULL) {
+            ESP_LOGE(TAG, "alloc for event loop payload pool failed");
+            goto on_err;
+        }
+
+        loop->payload_buffer_size = buffer_size;
+        loop->payload_pool_size = event_loop_args->payload_pool_size;
+        portMUX_INITIALIZE(&loop->payload_lock);
+        for (uint32_t i = 0; i < loop->payload_pool_size; i++) {
+            payload_release(loop, loop->payload_pool + i * buffer_size);
+        }
+    }
+
+    SLIST_INIT(&(loop->pending_removals));
+    loop->batch_size = event_loop_args->dispatch_batch_size > 1 ? event_loop_args->dispatch_batch_size : 1;
+
+    if (event_loop_args->task_name != NULL && event_loop_args->task_count > 1) {
+        // each task has its own queue, the first one is the queue of the loop
+        loop->workers = calloc(event_loop_args->task_count, sizeof(*loop->workers));
+        if (loop->workers == NULL) {
+            ESP_LOGE(TAG, "alloc for event loop tasks failed");
+            goto on_err;
+        }
+        loop->worker_count = event_loop_args->task_count;
+
+        for (uint32_t i = 0; i < loop->worker_count; i++) {
+            loop->workers[i].loop = loop;
+            if (i == 0) {
+                loop->workers[i].queue = loop->queue;
+            } else {
+                loop->workers[i].queue = xQueueCreate(event_loop_args->queue_size, sizeof(esp_event_post_instance_t));
+                if (loop->workers[i].queue == NULL) {
+                    ESP_LOGE(TAG, "create event loop queue failed");
+                    goto on_err;
+                }
+            }
+        }
+
+        for (uint32_t i = 0; i < loop->worker_count; i++) {
+            BaseType_t core_id = event_loop_args->task_core_id;
+            if (event_loop_args->task_pin_per_core && core_id != tskNO_AFFINITY) {
+                core_id = (core_id + i) % portNUM_PROCESSORS;
+            }
+
+            BaseType_t task_created = xTaskCreatePinnedToCore(esp_event_loop_worker_task, event_loop_args->task_name,
+                                                              event_loop_args->task_stack_size, (void*) &(loop->workers[i]),
+                                                              event_loop_args->task_priority, &(loop->workers[i].task), core_id);
+
+            if (task_created != pdPASS) {
+                ESP_LOGE(TAG, "create task for loop failed");
+                err = ESP_FAIL;
+                goto on_err;
+            }
+        }
+
+        loop->task = loop->workers[0].task;
+        loop->name = event_loop_args->task_name;
+
+        ESP_LOGD(TAG, "created %"PRIu32" tasks for loop %p", loop->worker_count, loop);
+    } else if (event_loop_args->task_name != NULL) {
+        // Create the loop task if requested
         BaseType_t task_created = xTaskCreatePinnedToCore(esp_event_loop_run_task, event_loop_args->task_name,
                                                           event_loop_args->task_stack_size, (void*) loop,
                                                           event_loop_args->task_priority, &(loop->task), event_loop_args->task_core_id);
@@ -607,6 +1063,18 @@ esp_err_t esp_event_loop_create(const esp_event_loop_args_t* event_loop_args, es
     return ESP_OK;
 
 on_err:
+    if (loop->workers != NULL) {
+        for (uint32_t i = 0; i < loop->worker_count; i++) {
+            if (loop->workers[i].task != NULL) {
+                vTaskDelete(loop->workers[i].task);
+            }
+            if (i > 0 && loop->workers[i].queue != NULL) {
+                vQueueDelete(loop->workers[i].queue);
+            }
+        }
+        free(loop->workers);
+    }
+
     if (loop->queue != NULL) {
         vQueueDelete(loop->queue);
     }
@@ -615,22 +1083,101 @@ on_err:
         vSemaphoreDelete(loop->mutex);
     }
 
+    free(loop->payload_pool);
     free(loop);
 
     return err;
 }
 
-// On event lookup performance: The library implements the event list as a linked list, which results to O(n)
-// lookup time. The test comparing this implementation to the O(lg n) performance of rbtrees
-// (https://github.com/freebsd/freebsd/blob/master/sys/sys/tree.h)
-// indicate that the difference is not that substantial, especially considering the additional
-// pointers per node of rbtrees. Code for the rbtree implementation of the event loop library is archived
-// in feature/esp_event_loop_library_rbtrees if needed.
-esp_err_t esp_event_loop_run(esp_event_loop_handle_t event_loop, TickType_t ticks_to_run)
+static void loop_remove_handler_and_free_ctx(esp_event_remove_handler_context_t* ctx)
 {
-    assert(event_loop);
+    loop_remove_handler(ctx);
 
-    esp_event_loop_instance_t* loop = (esp_event_loop_instance_t*) event_loop;
+    // if the handler unregistration request came from legacy code,
+    // we have to free handler_ctx pointer since it points to memory
+    // allocated by esp_event_handler_unregister_with_internal
+    if (ctx->legacy) {
+        free(ctx->handler_ctx);
+    }
+}
+
+// Dispatches an event on a loop with several tasks, without holding the loop mutex while the handlers are executed.
+// Must be called with the mutex held and a valid dispatch table.
+static bool dispatch_concurrent(esp_event_loop_instance_t* loop, esp_event_post_instance_t post)
+{
+    esp_event_dispatch_table_t* table = loop->dispatch_table;
+    table->refs++;
+    loop->dispatching++;
+    xSemaphoreGiveRecursive(loop->mutex);
+
+    bool exec = dispatch_table_run(loop, table, post);
+
+    xSemaphoreTakeRecursive(loop->mutex, portMAX_DELAY);
+    loop->dispatching--;
+    if (--table->refs == 0 && table != loop->dispatch_table) {
+        dispatch_table_delete(table);
+    }
+
+    // the last worker leaving removes the handlers unregistered in the meantime
+    if (loop->dispatching == 0) {
+        esp_event_remove_handler_context_t* ctx;
+        while ((ctx = SLIST_FIRST(&(loop->pending_removals))) != NULL) {
+            SLIST_REMOVE_HEAD(&(loop->pending_removals), next);
+            loop_remove_handler_and_free_ctx(ctx);
+            free(ctx);
+        }
+    }
+
+    return exec;
+}
+
+// On event lookup performance: The library keeps the registered handlers in linked lists, which results to O(n)
+// lookup time when walking them for every event. Events are therefore dispatched using a hash table mapping event
+// base and id to an array of the handlers to execute, which is rebuilt from the lists when the first event is
+// dispatched after handlers have been registered or unregistered. The lists are only walked directly if there
+// is not enough memory for the table.
+// Dispatches an event and deletes it afterwards. Must be called with the loop mutex held.
+static void loop_dispatch_post(esp_event_loop_instance_t* loop, esp_event_post_instance_t* post)
+{
+    // check if the event retrieve from the queue is the internal event that is
+    // triggered when a handler needs to be removed..
+    if (post->base == esp_event_handler_cleanup) {
+        assert(post->data.ptr != NULL);
+        esp_event_remove_handler_context_t* ctx = (esp_event_remove_handler_context_t*)post->data.ptr;
+        if (loop->dispatching > 0) {
+            // other workers may still execute the handler, keep the removal until they are done
+            SLIST_INSERT_HEAD(&(loop->pending_removals), ctx, next);
+            post->data.ptr = NULL;
+        } else {
+            loop_remove_handler_and_free_ctx(ctx);
+        }
+    }
+
+    loop->running_task = xTaskGetCurrentTaskHandle();
+
+    if (!loop->dispatch_table_valid) {
+        dispatch_table_build(loop);
+    }
+
+    bool exec;
+    if (loop->dispatch_table_valid && loop->workers != NULL) {
+        exec = dispatch_concurrent(loop, *post);
+    } else if (loop->dispatch_table_valid) {
+        exec = dispatch_table_run(loop, loop->dispatch_table, *post);
+    } else {
+        exec = dispatch_walk(loop, *post);
+    }
+
+    if (!exec) {
+        // No handlers were registered, not even loop/base level handlers
+        ESP_LOGD(TAG, "no handlers have been registered for event %s:%"PRIu32" posted to loop %p", post->base, post->id, loop);
+    }
+
+    post_instance_delete(loop, post);
+}
+
+static esp_err_t loop_run_queue(esp_event_loop_instance_t* loop, QueueHandle_t queue, TickType_t ticks_to_run)
+{
     esp_event_post_instance_t post;
     TickType_t marker = xTaskGetTickCount();
     TickType_t end = 0;
@@ -641,100 +1188,61 @@ esp_err_t esp_event_loop_run(esp_event_loop_handle_t event_loop, TickType_t tick
     int64_t remaining_ticks = ticks_to_run;
 #endif
 
-    while (xQueueReceive(loop->queue, &post, remaining_ticks) == pdTRUE) {
+    while (xQueueReceive(queue, &post, remaining_ticks) == pdTRUE) {
         // The event has already been unqueued, so ensure it gets executed.
         xSemaphoreTakeRecursive(loop->mutex, portMAX_DELAY);
 
-        // check if the event retrieve from the queue is the internal event that is
-        // triggered when a handler needs to be removed..
-        if (post.base == esp_event_handler_cleanup) {
-            assert(post.data.ptr != NULL);
-            esp_event_remove_handler_context_t* ctx = (esp_event_remove_handler_context_t*)post.data.ptr;
-            loop_remove_handler(ctx);
-
-            // if the handler unregistration request came from legacy code,
-            // we have to free handler_ctx pointer since it points to memory
-            // allocated by esp_event_handler_unregister_with_internal
-            if (ctx->legacy) {
-                free(ctx->handler_ctx);
-            }
-        }
-
-        loop->running_task = xTaskGetCurrentTaskHandle();
-
-        bool exec = false;
-
-        esp_event_handler_node_t *handler, *temp_handler;
-        esp_event_loop_node_t *loop_node, *temp_node;
-        esp_event_base_node_t *base_node, *temp_base;
-        esp_event_id_node_t *id_node, *temp_id_node;
-
-        SLIST_FOREACH_SAFE(loop_node, &(loop->loop_nodes), next, temp_node) {
-            // Execute loop level handlers
-            SLIST_FOREACH_SAFE(handler, &(loop_node->handlers), next, temp_handler) {
-                if (!handler->unregistered) {
-                    handler_execute(loop, handler, post);
-                    exec |= true;
+        // Dispatch the events queued in the meantime without giving the mutex back, up to the batch size of the loop
+        uint32_t batch_size = 0;
+        bool expired = false;
+        do {
+            loop_dispatch_post(loop, &post);
+            batch_size++;
+
+            if (ticks_to_run != portMAX_DELAY) {
+                end = xTaskGetTickCount();
+                remaining_ticks -= end - marker;
+                // If the ticks to run expired, return to the caller
+                if (remaining_ticks <= 0) {
+                    expired = true;
+                    break;
+                } else {
+                    marker = end;
                 }
             }
+        } while (batch_size < loop->batch_size && xQueueReceive(queue, &post, 0) == pdTRUE);
 
-            SLIST_FOREACH_SAFE(base_node, &(loop_node->base_nodes), next, temp_base) {
-                if (base_node->base == post.base) {
-                    // Execute base level handlers
-                    SLIST_FOREACH_SAFE(handler, &(base_node->handlers), next, temp_handler) {
-                        if (!handler->unregistered) {
-                            handler_execute(loop, handler, post);
-                            exec |= true;
-                        }
-                    }
-
-                    SLIST_FOREACH_SAFE(id_node, &(base_node->id_nodes), next, temp_id_node) {
-                        if (id_node->id == post.id) {
-                            // Execute id level handlers
-                            SLIST_FOREACH_SAFE(handler, &(id_node->handlers), next, temp_handler) {
-                                if (!handler->unregistered) {
-                                    handler_execute(loop, handler, post);
-                                    exec |= true;
-                                }
-                            }
-                            // Skip to next base node
-                            break;
-                        }
-                    }
-                }
-            }
+#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
+        // buckets of the batch size distribution: 1, 2-3, 4-7, 8-15, 16 and more
+        uint32_t bucket = 31 - __builtin_clz(batch_size);
+        if (bucket >= ESP_EVENT_BATCH_SIZE_BUCKETS) {
+            bucket = ESP_EVENT_BATCH_SIZE_BUCKETS - 1;
         }
+        atomic_fetch_add(&loop->batch_sizes[bucket], 1);
+#endif
 
-        esp_event_base_t base = post.base;
-        int32_t id = post.id;
-
-        post_instance_delete(&post);
-
-        if (ticks_to_run != portMAX_DELAY) {
-            end = xTaskGetTickCount();
-            remaining_ticks -= end - marker;
-            // If the ticks to run expired, return to the caller
-            if (remaining_ticks <= 0) {
-                xSemaphoreGiveRecursive(loop->mutex);
-                break;
-            } else {
-                marker = end;
-            }
+        if (expired) {
+            xSemaphoreGiveRecursive(loop->mutex);
+            break;
         }
 
         loop->running_task = NULL;
 
         xSemaphoreGiveRecursive(loop->mutex);
-
-        if (!exec) {
-            // No handlers were registered, not even loop/base level handlers
-            ESP_LOGD(TAG, "no handlers have been registered for event %s:%"PRIu32" posted to loop %p", base, id, event_loop);
-        }
     }
 
     return ESP_OK;
 }
 
+
+esp_err_t esp_event_loop_run(esp_event_loop_handle_t event_loop, TickType_t ticks_to_run)
+{
+    assert(event_loop);
+
+    esp_event_loop_instance_t* loop = (esp_event_loop_instance_t*) event_loop;
+    return loop_run_queue(loop, loop->queue, ticks_to_run);
+}
+
 esp_err_t esp_event_loop_delete(esp_event_loop_handle_t event_loop)
 {
     assert(event_loop);
@@ -745,17 +1253,38 @@ esp_err_t esp_event_loop_delete(esp_event_loop_handle_t event_loop)
 
     xSemaphoreTakeRecursive(loop->mutex, portMAX_DELAY);
 
+    // Let the tasks of a loop with several tasks finish the handlers they execute without holding the mutex.
+    // They do not start dispatching other events while the mutex is held here.
+    while (loop->dispatching > 0) {
+        xSemaphoreGiveRecursive(loop->mutex);
+        vTaskDelay(1);
+        xSemaphoreTakeRecursive(loop->mutex, portMAX_DELAY);
+    }
+
 #ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
     portENTER_CRITICAL(&s_event_loops_spinlock);
     SLIST_REMOVE(&s_event_loops, loop, esp_event_loop_instance, next);
     portEXIT_CRITICAL(&s_event_loops_spinlock);
 #endif
 
-    // Delete the task if it was created
-    if (loop->task != NULL) {
+    // Delete the tasks if they were created
+    if (loop->workers != NULL) {
+        for (uint32_t i = 0; i < loop->worker_count; i++) {
+            vTaskDelete(loop->workers[i].task);
+        }
+    } else if (loop->task != NULL) {
         vTaskDelete(loop->task);
     }
 
+    // Removals deferred by the tasks are covered by removing all handlers below
+    esp_event_remove_handler_context_t *ctx, *temp_ctx;
+    SLIST_FOREACH_SAFE(ctx, &(loop->pending_removals), next, temp_ctx) {
+        if (ctx->legacy) {
+            free(ctx->handler_ctx);
+        }
+        free(ctx);
+    }
+
     // Remove all registered events and handlers in the loop
     esp_event_loop_node_t *it, *temp;
     SLIST_FOREACH_SAFE(it, &(loop->loop_nodes), next, temp) {
@@ -763,15 +1292,24 @@ esp_err_t esp_event_loop_delete(esp_event_loop_handle_t event_loop)
         SLIST_REMOVE(&(loop->loop_nodes), it, esp_event_loop_node, next);
         free(it);
     }
+    dispatch_table_free(loop);
 
     // Drop existing posts on the queue
     esp_event_post_instance_t post;
     while (xQueueReceive(loop->queue, &post, 0) == pdTRUE) {
-        post_instance_delete(&post);
+        post_instance_delete(loop, &post);
+    }
+    for (uint32_t i = 1; i < loop->worker_count; i++) {
+        while (xQueueReceive(loop->workers[i].queue, &post, 0) == pdTRUE) {
+            post_instance_delete(loop, &post);
+        }
+        vQueueDelete(loop->workers[i].queue);
     }
 
     // Cleanup loop
+    free(loop->workers);
     vQueueDelete(loop->queue);
+    free(loop->payload_pool);
     free(loop);
     // Free loop mutex before deleting
     xSemaphoreGiveRecursive(loop_mutex);
@@ -839,6 +1377,7 @@ esp_err_t esp_event_handler_register_with_internal(esp_event_loop_handle_t event
     }
 
 on_err:
+    loop->dispatch_table_valid = false;
     xSemaphoreGiveRecursive(loop->mutex);
     return err;
 }
@@ -878,7 +1417,13 @@ esp_err_t esp_event_handler_unregister_with_internal(esp_event_loop_handle_t eve
      * otherwise it will be removed from the list later */
     esp_err_t res = ESP_FAIL;
     if (xSemaphoreTake(loop->mutex, 0) == pdTRUE) {
-        res = loop_remove_handler(&remove_handler_ctx);
+        if (loop->dispatching > 0) {
+            /* the mutex is free while the tasks of a loop with several tasks execute
+             * the handlers, which must not be freed until they are done */
+            res = find_and_unregister_handler(&remove_handler_ctx);
+        } else {
+            res = loop_remove_handler(&remove_handler_ctx);
+        }
         xSemaphoreGive(loop->mutex);
     } else {
         xSemaphoreTakeRecursive(loop->mutex, portMAX_DELAY);
@@ -921,66 +1466,168 @@ esp_err_t esp_event_post_to(esp_event_loop_handle_t event_loop, esp_event_base_t
     esp_event_loop_instance_t* loop = (esp_event_loop_instance_t*) event_loop;
 
     esp_event_post_instance_t post;
-    memset((void*)(&post), 0, sizeof(post));
+    esp_err_t err = post_instance_create(&post, event_base, event_id, event_data, event_data_size);
+    if (err != ESP_OK) {
+        return err;
+    }
 
-    if (event_data != NULL && event_data_size != 0) {
-        // Make persistent copy of event data on heap.
-        void* event_data_copy = calloc(1, event_data_size);
+    err = post_instance_send(loop, &post, ticks_to_wait);
+    if (err != ESP_OK) {
+        post_instance_delete(loop, &post);
+    }
 
-        if (event_data_copy == NULL) {
-            return ESP_ERR_NO_MEM;
-        }
+    return err;
+}
 
-        memcpy(event_data_copy, event_data, event_data_size);
-        post.data.ptr = event_data_copy;
-#if CONFIG_ESP_EVENT_POST_FROM_ISR
-        post.data_allocated = true;
-        post.data_set = true;
-#endif
+esp_err_t esp_event_post_batch(esp_event_loop_handle_t event_loop, const esp_event_batch_item_t* events,
+                               size_t event_count, TickType_t ticks_to_wait, size_t* events_posted)
+{
+    assert(event_loop);
+
+    if (events_posted != NULL) {
+        *events_posted = 0;
     }
-    post.base = event_base;
-    post.id = event_id;
 
-    BaseType_t result = pdFALSE;
+    if (events == NULL && event_count > 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
 
-    // Find the task that currently executes the loop. It is safe to query loop->task since it is
-    // not mutated since loop creation. ENSURE THIS REMAINS TRUE.
-    if (loop->task == NULL) {
-        // The loop has no dedicated task. Find out what task is currently running it.
-        result = xSemaphoreTakeRecursive(loop->mutex, ticks_to_wait);
+    for (size_t i = 0; i < event_count; i++) {
+        if (events[i].event_base == ESP_EVENT_ANY_BASE || events[i].event_id == ESP_EVENT_ANY_ID) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
 
-        if (result == pdTRUE) {
-            if (loop->running_task != xTaskGetCurrentTaskHandle()) {
-                xSemaphoreGiveRecursive(loop->mutex);
-                result = xQueueSendToBack(loop->queue, &post, ticks_to_wait);
-            } else {
-                xSemaphoreGiveRecursive(loop->mutex);
-                result = xQueueSendToBack(loop->queue, &post, 0);
+    esp_event_loop_instance_t* loop = (esp_event_loop_instance_t*) event_loop;
+    esp_event_post_instance_t posts[POST_BATCH_CHUNK_SIZE];
+    esp_err_t err = ESP_OK;
+    size_t posted = 0;
+
+    while (posted < event_count && err == ESP_OK) {
+        // The data of the events is copied before the events are sent, since memory is not allocated
+        // while the scheduler is suspended
+        size_t chunk = 0;
+        while (chunk < POST_BATCH_CHUNK_SIZE && posted + chunk < event_count) {
+            const esp_event_batch_item_t* event = &events[posted + chunk];
+            err = post_instance_create(&posts[chunk], event->event_base, event->event_id, event->event_data,
+                                       event->event_data_size);
+            if (err != ESP_OK) {
+                break;
             }
+            chunk++;
         }
-    } else {
-        // The loop has a dedicated task.
-        if (loop->task != xTaskGetCurrentTaskHandle()) {
-            result = xQueueSendToBack(loop->queue, &post, ticks_to_wait);
-        } else {
-            result = xQueueSendToBack(loop->queue, &post, 0);
+
+        size_t sent = 0;
+        if (loop->task != NULL) {
+            // Queue the events which fit without waiting while the scheduler is suspended, so that the loop
+            // task is woken up once for all of them instead of once per event
+            vTaskSuspendAll();
+            while (sent < chunk && xQueueSendToBack(post_instance_queue(loop, &posts[sent]), &posts[sent], 0) == pdTRUE) {
+                sent++;
+            }
+            xTaskResumeAll();
+
+#ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
+            atomic_fetch_add(&loop->events_received, sent);
+#endif
+        }
+
+        // the remaining events wait for space in the queue one by one
+        esp_err_t send_err = ESP_OK;
+        while (sent < chunk && send_err == ESP_OK) {
+            send_err = post_instance_send(loop, &posts[sent], ticks_to_wait);
+            if (send_err == ESP_OK) {
+                sent++;
+            }
+        }
+
+        for (size_t i = sent; i < chunk; i++) {
+            post_instance_delete(loop, &posts[i]);
+        }
+
+        posted += sent;
+        if (err == ESP_OK) {
+            err = send_err;
         }
     }
 
-    if (result != pdTRUE) {
-        post_instance_delete(&post);
+    if (events_posted != NULL) {
+        *events_posted = posted;
+    }
+
+    return err;
+}
+
+void* esp_event_payload_alloc(esp_event_loop_handle_t event_loop, size_t size)
+{
+    assert(event_loop);
+
+    if (size == 0) {
+        return NULL;
+    }
+
+    esp_event_loop_instance_t* loop = (esp_event_loop_instance_t*) event_loop;
+    void* payload = NULL;
 
+    if (size <= loop->payload_buffer_size) {
+        portENTER_CRITICAL(&loop->payload_lock);
+        payload = loop->payload_free;
+        if (payload != NULL) {
+            loop->payload_free = *(void**) payload;
+        }
+        portEXIT_CRITICAL(&loop->payload_lock);
+    }
+
+    if (payload != NULL) {
 #ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
-        atomic_fetch_add(&loop->events_dropped, 1);
+        atomic_fetch_add(&loop->payload_pool_hits, 1);
 #endif
-        return ESP_ERR_TIMEOUT;
+        return payload;
     }
 
 #ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
-    atomic_fetch_add(&loop->events_received, 1);
+    if (loop->payload_pool != NULL) {
+        atomic_fetch_add(&loop->payload_pool_misses, 1);
+    }
 #endif
+    return malloc(size);
+}
 
-    return ESP_OK;
+void esp_event_payload_free(esp_event_loop_handle_t event_loop, void* payload)
+{
+    assert(event_loop);
+
+    if (payload != NULL) {
+        payload_release((esp_event_loop_instance_t*) event_loop, payload);
+    }
+}
+
+esp_err_t esp_event_post_zero_copy(esp_event_loop_handle_t event_loop, esp_event_base_t event_base, int32_t event_id,
+                                   void* payload, TickType_t ticks_to_wait)
+{
+    assert(event_loop);
+
+    if (event_base == ESP_EVENT_ANY_BASE || event_id == ESP_EVENT_ANY_ID) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_event_loop_instance_t* loop = (esp_event_loop_instance_t*) event_loop;
+
+    esp_event_post_instance_t post;
+    memset((void*)(&post), 0, sizeof(post));
+
+    if (payload != NULL) {
+        post.data.ptr = payload;
+#if CONFIG_ESP_EVENT_POST_FROM_ISR
+        post.data_allocated = true;
+        post.data_set = true;
+#endif
+    }
+    post.base = event_base;
+    post.id = event_id;
+
+    // on failure, the buffer is left to the caller
+    return post_instance_send(loop, &post, ticks_to_wait);
 }
 
 #if CONFIG_ESP_EVENT_POST_FROM_ISR
@@ -1013,10 +1660,10 @@ esp_err_t esp_event_isr_post_to(esp_event_loop_handle_t event_loop, esp_event_ba
     BaseType_t result = pdFALSE;
 
     // Post the event from an ISR,
-    result = xQueueSendToBackFromISR(loop->queue, &post, task_unblocked);
+    result = xQueueSendToBackFromISR(post_instance_queue(loop, &post), &post, task_unblocked);
 
     if (result != pdTRUE) {
-        post_instance_delete(&post);
+        post_instance_delete(loop, &post);
 
 #ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
         atomic_fetch_add(&loop->events_dropped, 1);
@@ -1062,18 +1709,31 @@ esp_err_t esp_event_dump(FILE* file)
         PRINT_DUMP_INFO(dst, sz, LOOP_DUMP_FORMAT, loop_it, loop_it->task != NULL ? loop_it->name : "none",
                         events_received, events_dropped);
 
+        if (loop_it->payload_pool != NULL) {
+            PRINT_DUMP_INFO(dst, sz, POOL_DUMP_FORMAT, (uint32_t) atomic_load(&loop_it->payload_pool_hits),
+                            (uint32_t) atomic_load(&loop_it->payload_pool_misses));
+        }
+
+        if (loop_it->batch_size > 1) {
+            PRINT_DUMP_INFO(dst, sz, BATCH_DUMP_FORMAT, (uint32_t) atomic_load(&loop_it->batch_sizes[0]),
+                            (uint32_t) atomic_load(&loop_it->batch_sizes[1]), (uint32_t) atomic_load(&loop_it->batch_sizes[2]),
+                            (uint32_t) atomic_load(&loop_it->batch_sizes[3]), (uint32_t) atomic_load(&loop_it->batch_sizes[4]));
+        }
+
         int sz_bak = sz;
 
         SLIST_FOREACH(loop_node_it, &(loop_it->loop_nodes), next) {
             SLIST_FOREACH(handler_it, &(loop_node_it->handlers), next) {
                 PRINT_DUMP_INFO(dst, sz, HANDLER_DUMP_FORMAT, handler_it->handler_ctx->handler, "ESP_EVENT_ANY_BASE",
-                                "ESP_EVENT_ANY_ID", handler_it->invoked, handler_it->time);
+                                "ESP_EVENT_ANY_ID", (uint32_t) atomic_load(&handler_it->invoked),
+                                (long long) atomic_load(&handler_it->time));
             }
 
             SLIST_FOREACH(base_node_it, &(loop_node_it->base_nodes), next) {
                 SLIST_FOREACH(handler_it, &(base_node_it->handlers), next) {
                     PRINT_DUMP_INFO(dst, sz, HANDLER_DUMP_FORMAT, handler_it->handler_ctx->handler, base_node_it->base,
-                                    "ESP_EVENT_ANY_ID", handler_it->invoked, handler_it->time);
+                                    "ESP_EVENT_ANY_ID", (uint32_t) atomic_load(&handler_it->invoked),
+                                (long long) atomic_load(&handler_it->time));
                 }
 
                 SLIST_FOREACH(id_node_it, &(base_node_it->id_nodes), next) {
@@ -1082,7 +1742,8 @@ esp_err_t esp_event_dump(FILE* file)
                         snprintf(id_str_buf, sizeof(id_str_buf), "%" PRIi32, id_node_it->id);
 
                         PRINT_DUMP_INFO(dst, sz, HANDLER_DUMP_FORMAT, handler_it->handler_ctx->handler, base_node_it->base,
-                                        id_str_buf, handler_it->invoked, handler_it->time);
+                                        id_str_buf, (uint32_t) atomic_load(&handler_it->invoked),
+                                (long long) atomic_load(&handler_it->time));
                     }
                 }
             }
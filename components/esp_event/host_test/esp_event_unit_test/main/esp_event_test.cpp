@@ -8,6 +8,9 @@
 */
 
 #include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
 #include "esp_event.h"
 
 #include <catch2/catch_test_macros.hpp>
@@ -40,6 +43,79 @@ static esp_event_loop_args_t test_event_get_default_loop_args(void)
 
 void dummy_handler(void* event_handler_arg, esp_event_base_t event_base, int32_t event_id, void* event_data) { }
 
+void count_handler(void* event_handler_arg, esp_event_base_t event_base, int32_t event_id, void* event_data)
+{
+    (*static_cast<uint32_t*>(event_handler_arg))++;
+}
+
+/**
+ * Replaces the mocked queue by a FIFO so that events can be posted and the loop can be run by the test itself,
+ * without a loop task. The loop mutex is always available.
+ */
+struct StubQueue : public CMockFix {
+    StubQueue()
+    {
+        s_items.clear();
+        xQueueGenericCreate_Stub(create);
+        xQueueGenericSend_Stub(send);
+        xQueueReceive_Stub(receive);
+        vQueueDelete_Ignore();
+        xQueueCreateMutex_IgnoreAndReturn(reinterpret_cast<QueueHandle_t>(0xdeadbeef));
+        xQueueTakeMutexRecursive_IgnoreAndReturn(pdTRUE);
+        xQueueGiveMutexRecursive_IgnoreAndReturn(pdTRUE);
+        xTaskGetTickCount_IgnoreAndReturn(0);
+        xTaskGetCurrentTaskHandle_IgnoreAndReturn(reinterpret_cast<TaskHandle_t>(1));
+    }
+
+    ~StubQueue()
+    {
+        xQueueGenericCreate_Stub(nullptr);
+        xQueueGenericSend_Stub(nullptr);
+        xQueueReceive_Stub(nullptr);
+        vQueueDelete_StopIgnore();
+        xQueueCreateMutex_StopIgnore();
+        xQueueTakeMutexRecursive_StopIgnore();
+        xQueueGiveMutexRecursive_StopIgnore();
+        xTaskGetTickCount_StopIgnore();
+        xTaskGetCurrentTaskHandle_StopIgnore();
+    }
+
+    static QueueHandle_t create(UBaseType_t length, UBaseType_t item_size, uint8_t type, int num_calls)
+    {
+        s_length = length;
+        s_item_size = item_size;
+        return reinterpret_cast<QueueHandle_t>(0xdeadbeef);
+    }
+
+    static BaseType_t send(QueueHandle_t queue, const void* item, TickType_t ticks, BaseType_t position, int num_calls)
+    {
+        if (s_items.size() == s_length * s_item_size) {
+            return pdFALSE;
+        }
+        const uint8_t* bytes = static_cast<const uint8_t*>(item);
+        s_items.insert(s_items.end(), bytes, bytes + s_item_size);
+        return pdTRUE;
+    }
+
+    static BaseType_t receive(QueueHandle_t queue, void* item, TickType_t ticks, int num_calls)
+    {
+        if (s_items.empty()) {
+            return pdFALSE;
+        }
+        memcpy(item, s_items.data(), s_item_size);
+        s_items.erase(s_items.begin(), s_items.begin() + s_item_size);
+        return pdTRUE;
+    }
+
+    static std::vector<uint8_t> s_items;
+    static size_t s_length;
+    static size_t s_item_size;
+};
+
+std::vector<uint8_t> StubQueue::s_items;
+size_t StubQueue::s_length;
+size_t StubQueue::s_item_size;
+
 }
 
 // TODO: IDF-2693, function definition just to satisfy linker, implement esp_common instead
@@ -149,3 +225,47 @@ TEST_CASE("registering with ANY_BASE but specific ID fails")
                                           dummy_handler,
                                           nullptr) == ESP_ERR_INVALID_ARG);
 }
+
+TEST_CASE("benchmark event dispatch with hundreds of registrations", "[benchmark]")
+{
+    const int32_t ID_COUNT = 32;
+    const size_t BASE_COUNT = 16;
+    const size_t EVENT_COUNT = 100000;
+    static const char bases[BASE_COUNT][8] = {};
+
+    for (size_t base_count : {1, 4, 16}) {
+        StubQueue queue;
+        esp_event_loop_handle_t loop = nullptr;
+        esp_event_loop_args_t loop_args = test_event_get_default_loop_args();
+        loop_args.task_name = nullptr;
+        REQUIRE(ESP_OK == esp_event_loop_create(&loop_args, &loop));
+
+        // one handler per base and id, plus a handler for all events of each base
+        uint32_t invoked = 0;
+        for (size_t base = 0; base < base_count; base++) {
+            for (int32_t id = 0; id < ID_COUNT; id++) {
+                REQUIRE(ESP_OK == esp_event_handler_register_with(loop, bases[base], id, count_handler, &invoked));
+            }
+            REQUIRE(ESP_OK == esp_event_handler_instance_register_with(loop, bases[base], ESP_EVENT_ANY_ID,
+                                                                       count_handler, &invoked, nullptr));
+        }
+
+        // the events of the last base registered are found last when walking the handler lists
+        auto start = std::chrono::steady_clock::now();
+        for (size_t posted = 0; posted < EVENT_COUNT; posted += QUEUE_SIZE) {
+            for (uint32_t i = 0; i < QUEUE_SIZE; i++) {
+                REQUIRE(ESP_OK == esp_event_post_to(loop, bases[base_count - 1], (posted + i) % ID_COUNT,
+                                                    nullptr, 0, 0));
+            }
+            REQUIRE(ESP_OK == esp_event_loop_run(loop, 1000));
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+        const size_t posted = (EVENT_COUNT + QUEUE_SIZE - 1) / QUEUE_SIZE * QUEUE_SIZE;
+        CHECK(invoked == posted * 2);
+        printf("Dispatch with %u registrations: %.0f events/s\n",
+               static_cast<unsigned>(base_count * (ID_COUNT + 1)), posted * 1e6 / elapsed.count());
+
+        CHECK(ESP_OK == esp_event_loop_delete(loop));
+    }
+}
@@ -29,8 +29,29 @@ typedef struct {
     uint32_t task_stack_size;                   /**< stack size of the event loop task, ignored if task name is NULL */
     BaseType_t task_core_id;                    /**< core to which the event loop task is pinned to,
                                                         ignored if task name is NULL */
+    uint32_t task_count;                        /**< number of tasks dispatching the events of the loop, 0 is the
+                                                        same as 1; ignored if task name is NULL. Events with the same
+                                                        base and ID are always dispatched in order by the same task,
+                                                        other events may be dispatched concurrently */
+    bool task_pin_per_core;                     /**< if set, the tasks are pinned to the cores in turn, starting with
+                                                        task_core_id; otherwise all tasks are pinned to task_core_id */
+    uint32_t dispatch_batch_size;               /**< maximum number of queued events dispatched while holding the
+                                                        loop mutex once, 0 is the same as 1 */
+    uint32_t payload_pool_size;                 /**< number of buffers in the payload pool of the event loop, used
+                                                        by esp_event_payload_alloc; 0 if the loop has no pool */
+    size_t payload_buffer_size;                 /**< size of each buffer in the payload pool, ignored if
+                                                        payload pool size is 0 */
 } esp_event_loop_args_t;
 
+/// Event posted by esp_event_post_batch
+typedef struct {
+    esp_event_base_t event_base;                /**< the event base that identifies the event */
+    int32_t event_id;                           /**< the event ID that identifies the event */
+    const void *event_data;                     /**< the data, specific to the event occurrence, that gets passed
+                                                        to the handler */
+    size_t event_data_size;                     /**< the size of the event data */
+} esp_event_batch_item_t;
+
 /**
  * @brief Create a new event loop.
  *
@@ -395,6 +416,81 @@ esp_err_t esp_event_post_to(esp_event_loop_handle_t event_loop,
                             size_t event_data_size,
                             TickType_t ticks_to_wait);
 
+/**
+ * @brief Posts several events to the specified event loop.
+ *
+ * The events are posted in the order given, as if esp_event_post_to was called for each of them. For event loops
+ * with a dedicated task, the events which fit into the event queue are queued at once, so that the task dispatches
+ * them together instead of being woken up for every event.
+ *
+ * @param[in] event_loop the event loop to post to, must not be NULL
+ * @param[in] events the events to post
+ * @param[in] event_count number of events
+ * @param[in] ticks_to_wait number of ticks to block on a full event queue, for each event
+ * @param[out] events_posted optional, number of events posted; the events after them are not posted
+ *
+ * @return
+ *  - ESP_OK: Success
+ *  - ESP_ERR_TIMEOUT: Time to wait for event queue to unblock expired
+ *  - ESP_ERR_INVALID_ARG: Invalid combination of event base and event ID, no event has been posted
+ *  - ESP_ERR_NO_MEM: Cannot allocate memory for the event data
+ *  - Others: Fail
+ */
+esp_err_t esp_event_post_batch(esp_event_loop_handle_t event_loop,
+                               const esp_event_batch_item_t *events,
+                               size_t event_count,
+                               TickType_t ticks_to_wait,
+                               size_t *events_posted);
+
+/**
+ * @brief Allocate a buffer for the data of an event posted with esp_event_post_zero_copy.
+ *
+ * The buffer is taken from the payload pool of the event loop if the pool has an unused buffer and the
+ * requested size fits into it. Otherwise, the buffer is allocated from the heap.
+ *
+ * @param[in] event_loop the event loop the event will be posted to, must not be NULL
+ * @param[in] size size of the event data
+ *
+ * @return pointer to the buffer, or NULL if the size is 0 or no memory could be allocated
+ */
+void *esp_event_payload_alloc(esp_event_loop_handle_t event_loop, size_t size);
+
+/**
+ * @brief Release a buffer allocated with esp_event_payload_alloc which has not been posted.
+ *
+ * @param[in] event_loop the event loop the buffer was allocated for, must not be NULL
+ * @param[in] payload the buffer to release, may be NULL
+ */
+void esp_event_payload_free(esp_event_loop_handle_t event_loop, void *payload);
+
+/**
+ * @brief Posts an event to the specified event loop without copying the event data.
+ *
+ * The event data is passed to the handlers in the buffer filled in by the caller. It has to be allocated
+ * with esp_event_payload_alloc for the same event loop. On success, the event loop takes ownership of the buffer
+ * and releases it once all handlers have been executed, so the caller must not access it anymore.
+ *
+ * @param[in] event_loop the event loop to post to, must not be NULL
+ * @param[in] event_base the event base that identifies the event
+ * @param[in] event_id the event ID that identifies the event
+ * @param[in] payload buffer containing the event data, may be NULL for events without data
+ * @param[in] ticks_to_wait number of ticks to block on a full event queue
+ *
+ * @note If the event cannot be posted, the caller keeps the ownership of the buffer and can either post
+ *       it again or release it with esp_event_payload_free.
+ *
+ * @return
+ *  - ESP_OK: Success
+ *  - ESP_ERR_TIMEOUT: Time to wait for event queue to unblock expired
+ *  - ESP_ERR_INVALID_ARG: Invalid combination of event base and event ID
+ *  - Others: Fail
+ */
+esp_err_t esp_event_post_zero_copy(esp_event_loop_handle_t event_loop,
+                                   esp_event_base_t event_base,
+                                   int32_t event_id,
+                                   void *payload,
+                                   TickType_t ticks_to_wait);
+
 #if CONFIG_ESP_EVENT_POST_FROM_ISR
 /**
  * @brief Special variant of esp_event_post for posting events from interrupt handlers.
@@ -462,6 +558,8 @@ esp_err_t esp_event_isr_post_to(esp_event_loop_handle_t event_loop,
  *
  @verbatim
        event loop
+           payload pool
+           batches
            handler
            handler
            ...
@@ -480,6 +578,17 @@ esp_err_t esp_event_isr_post_to(esp_event_loop_handle_t event_loop,
            total_received - number of successfully posted events
            total_dropped - number of events unsuccessfully posted due to queue being full
 
+   payload pool (only for event loops with a payload pool)
+       format: POOL hit:pool_hits miss:pool_misses
+       where:
+           pool_hits - number of buffers allocated by esp_event_payload_alloc from the payload pool
+           pool_misses - number of buffers allocated from the heap as the pool was empty or too small
+
+   batches (only for event loops with a dispatch batch size of more than 1)
+       format: BATCH 1:batches_1 2-3:batches_2_3 4-7:batches_4_7 8-15:batches_8_15 16+:batches_16
+       where:
+           batches_n - number of times the given number of events was dispatched while holding the loop mutex once
+
    handler
        format: address ev:base,id inv:total_invoked run:total_runtime
        where:
@@ -18,6 +18,9 @@ extern "C" {
 
 typedef SLIST_HEAD(base_nodes, base_node) base_nodes_t;
 
+#define ESP_EVENT_BATCH_SIZE_BUCKETS 5                              /**< buckets of the batch size distribution:
+                                                                            1, 2-3, 4-7, 8-15, 16 and more events */
+
 typedef struct esp_event_handler_context {
     esp_event_handler_t handler;                                    /**< event handler function*/
     void* arg;
@@ -27,8 +30,8 @@ typedef struct esp_event_handler_context {
 typedef struct esp_event_handler_node {
     esp_event_handler_instance_context_t* handler_ctx;              /**< event handler context*/
 #ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
-    uint32_t invoked;                                               /**< number of times this handler has been invoked */
-    int64_t time;                                                   /**< total runtime of this handler across all calls */
+    atomic_uint_least32_t invoked;                                  /**< number of times this handler has been invoked */
+    atomic_int_least64_t time;                                      /**< total runtime of this handler across all calls */
 #endif
     SLIST_ENTRY(esp_event_handler_node) next;                   /**< next event handler in the list */
     bool unregistered;
@@ -66,6 +69,34 @@ typedef struct esp_event_loop_node {
 
 typedef SLIST_HEAD(esp_event_loop_nodes, esp_event_loop_node) esp_event_loop_nodes_t;
 
+/// Handlers to be executed for events with a given base and id
+typedef struct esp_event_dispatch_entry {
+    esp_event_base_t base;                                          /**< base of the events, NULL for an unused slot */
+    int32_t id;                                                     /**< id of the events, ESP_EVENT_ANY_ID for the
+                                                                            events of the base without id level handlers */
+    uint32_t first;                                                 /**< index of the first handler in the handler array */
+    uint32_t count;                                                 /**< number of handlers */
+} esp_event_dispatch_entry_t;
+
+/// Hash table mapping posted events to the handlers to be executed, built from the handler lists of a loop
+typedef struct esp_event_dispatch_table {
+    esp_event_handler_node_t** handlers;                            /**< handlers of all entries, in execution order */
+    esp_event_dispatch_entry_t any;                                 /**< handlers for events of bases without handlers */
+    uint32_t refs;                                                  /**< number of events being dispatched using the
+                                                                            table without holding the loop mutex */
+    uint32_t mask;                                                  /**< number of slots minus one, a power of two */
+    esp_event_dispatch_entry_t slots[];                             /**< open addressing hash table of entries */
+} esp_event_dispatch_table_t;
+
+struct esp_event_loop_instance;
+
+/// Task dispatching the events of one of the queues of an event loop with several tasks
+typedef struct esp_event_loop_worker {
+    struct esp_event_loop_instance* loop;                           /**< event loop the task belongs to */
+    QueueHandle_t queue;                                            /**< queue of the events dispatched by the task */
+    TaskHandle_t task;                                              /**< task dispatching the events */
+} esp_event_loop_worker_t;
+
 /// Event loop
 typedef struct esp_event_loop_instance {
     const char* name;                                               /**< name of this event loop */
@@ -76,9 +107,34 @@ typedef struct esp_event_loop_instance {
     SemaphoreHandle_t mutex;                                        /**< mutex for updating the events linked list */
     esp_event_loop_nodes_t loop_nodes;                              /**< set of linked lists containing the
                                                                             registered handlers for the loop */
+    esp_event_dispatch_table_t* dispatch_table;                     /**< lookup table for dispatching events, built
+                                                                            from loop_nodes */
+    bool dispatch_table_valid;                                      /**< false if loop_nodes changed since the
+                                                                            dispatch table was built */
+    esp_event_loop_worker_t* workers;                               /**< tasks of a loop with several tasks, each with
+                                                                            its own queue; NULL for other loops */
+    uint32_t worker_count;                                          /**< number of tasks in workers */
+    uint32_t dispatching;                                           /**< number of events being dispatched by workers
+                                                                            without holding the mutex */
+    uint32_t batch_size;                                            /**< maximum number of events dispatched while
+                                                                            holding the mutex once */
+    SLIST_HEAD(esp_event_remove_handler_contexts,
+               esp_event_remove_handler_context_t) pending_removals; /**< handler removals deferred until no
+                                                                            worker dispatches an event */
+    uint8_t* payload_pool;                                          /**< buffers of the payload pool, NULL if the
+                                                                            loop has no payload pool */
+    void* payload_free;                                             /**< list of unused buffers in the payload pool */
+    size_t payload_buffer_size;                                     /**< size of each buffer in the payload pool */
+    uint32_t payload_pool_size;                                     /**< number of buffers in the payload pool */
+    portMUX_TYPE payload_lock;                                      /**< spinlock for the list of unused buffers */
 #ifdef CONFIG_ESP_EVENT_LOOP_PROFILING
     atomic_uint_least32_t events_received;                          /**< number of events successfully posted to the loop */
     atomic_uint_least32_t events_dropped;                           /**< number of events dropped due to queue being full */
+    atomic_uint_least32_t payload_pool_hits;                        /**< number of payloads allocated from the pool */
+    atomic_uint_least32_t payload_pool_misses;                      /**< number of payloads allocated from the heap
+                                                                            because the pool was empty or too small */
+    atomic_uint_least32_t batch_sizes[ESP_EVENT_BATCH_SIZE_BUCKETS]; /**< number of times events were dispatched
+                                                                            in batches of the bucket's size */
     SLIST_ENTRY(esp_event_loop_instance) next;                      /**< next event loop in the list */
 #endif
 } esp_event_loop_instance_t;
@@ -89,6 +145,7 @@ typedef struct esp_event_remove_handler_context_t {
     int32_t event_id;                                               /**< The event identification value of the handler that has to be removed */
     esp_event_handler_instance_context_t* handler_ctx;              /**< The handler context of the handler that has to be removed */
     bool legacy;                                                    /**< Set to true when the handler unregistration request was made from legacy code */
+    SLIST_ENTRY(esp_event_remove_handler_context_t) next;           /**< Next removal in the list of deferred removals */
 } esp_event_remove_handler_context_t;
 
 typedef union esp_event_post_data {
@@ -8,6 +8,10 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#include <atomic>
+#include <algorithm>
 #include "sdkconfig.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -1532,6 +1536,371 @@ TEST_CASE("event data many bytes are copied on post", "[event][linux]")
     TEST_ASSERT_EQUAL_HEX8_ARRAY(ev_data_expected, saved_ev_data.event_data, EventData::MAX_SIZE);
 }
 
+TEST_CASE("zero-copy event data is passed to handlers in place", "[event][linux]")
+{
+    esp_event_loop_handle_t loop;
+    esp_event_loop_args_t loop_args = test_event_get_default_loop_args();
+    loop_args.task_name = NULL;
+    loop_args.payload_pool_size = 2;
+    loop_args.payload_buffer_size = EventData::MAX_SIZE;
+    TEST_ESP_OK(esp_event_loop_create(&loop_args, &loop));
+
+    EventData saved_ev_data(EventData::MAX_SIZE);
+    TEST_ESP_OK(esp_event_handler_register_with(loop, s_test_base1, TEST_EVENT_BASE1_EV1, save_ev_data, &saved_ev_data));
+
+    uint8_t *payload = (uint8_t*) esp_event_payload_alloc(loop, EventData::MAX_SIZE);
+    TEST_ASSERT_NOT_NULL(payload);
+    for (size_t i = 0; i < EventData::MAX_SIZE; i++) {
+        payload[i] = i + 1;
+    }
+
+    TEST_ESP_OK(esp_event_post_zero_copy(loop, s_test_base1, TEST_EVENT_BASE1_EV1, payload, portMAX_DELAY));
+    TEST_ESP_OK(esp_event_loop_run(loop, ZERO_DELAY));
+
+    uint8_t ev_data_expected[EventData::MAX_SIZE] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+    TEST_ASSERT_EQUAL(payload, saved_ev_data.event_arg);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(ev_data_expected, saved_ev_data.event_data, EventData::MAX_SIZE);
+
+    TEST_ESP_OK(esp_event_loop_delete(loop));
+}
+
+TEST_CASE("zero-copy payloads are returned to the pool after dispatch", "[event][linux]")
+{
+    esp_event_loop_handle_t loop;
+    esp_event_loop_args_t loop_args = test_event_get_default_loop_args();
+    loop_args.task_name = NULL;
+    loop_args.payload_pool_size = 1;
+    loop_args.payload_buffer_size = 8;
+    TEST_ESP_OK(esp_event_loop_create(&loop_args, &loop));
+
+    int count = 0;
+    TEST_ESP_OK(esp_event_handler_register_with(loop, s_test_base1, ESP_EVENT_ANY_ID, test_handler_inc, &count));
+
+    // the second buffer is allocated from the heap as the pool is empty, the third one as it is too large
+    void *pooled = esp_event_payload_alloc(loop, 8);
+    void *heap = esp_event_payload_alloc(loop, 8);
+    void *large = esp_event_payload_alloc(loop, 64);
+    TEST_ASSERT_NOT_NULL(pooled);
+    TEST_ASSERT_NOT_NULL(heap);
+    TEST_ASSERT_NOT_NULL(large);
+    TEST_ASSERT_NULL(esp_event_payload_alloc(loop, 0));
+
+    TEST_ESP_OK(esp_event_post_zero_copy(loop, s_test_base1, TEST_EVENT_BASE1_EV1, pooled, portMAX_DELAY));
+    TEST_ESP_OK(esp_event_post_zero_copy(loop, s_test_base1, TEST_EVENT_BASE1_EV2, heap, portMAX_DELAY));
+    TEST_ESP_OK(esp_event_post_zero_copy(loop, s_test_base1, TEST_EVENT_BASE1_EV1, NULL, portMAX_DELAY));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_event_post_zero_copy(loop, s_test_base1, ESP_EVENT_ANY_ID, large, portMAX_DELAY));
+    esp_event_payload_free(loop, large);
+
+    TEST_ESP_OK(esp_event_loop_run(loop, ZERO_DELAY));
+    TEST_ESP_OK(esp_event_loop_run(loop, ZERO_DELAY));
+    TEST_ESP_OK(esp_event_loop_run(loop, ZERO_DELAY));
+    TEST_ASSERT_EQUAL(3, count);
+
+    void *reused = esp_event_payload_alloc(loop, 4);
+    TEST_ASSERT_EQUAL(pooled, reused);
+    esp_event_payload_free(loop, reused);
+
+    TEST_ESP_OK(esp_event_loop_delete(loop));
+}
+
+struct OrderData {
+    constexpr static int32_t ID_COUNT = 8;
+    int last_seq[ID_COUNT];
+    std::atomic<int> count;
+    std::atomic<bool> in_order;
+    int expected;
+    SemaphoreHandle_t done;
+};
+
+static void test_handler_check_order(void* handler_arg, esp_event_base_t base, int32_t id, void* event_arg)
+{
+    OrderData *data = (OrderData*) handler_arg;
+    int seq = *(int*) event_arg;
+    if (seq != data->last_seq[id] + 1) {
+        data->in_order = false;
+    }
+    data->last_seq[id] = seq;
+    if (++data->count == data->expected) {
+        xSemaphoreGive(data->done);
+    }
+}
+
+TEST_CASE("loop with several tasks dispatches events with the same base and id in order", "[event][linux]")
+{
+    esp_event_loop_handle_t loop;
+    esp_event_loop_args_t loop_args = test_event_get_default_loop_args();
+    loop_args.task_count = 4;
+    loop_args.task_pin_per_core = true;
+    TEST_ESP_OK(esp_event_loop_create(&loop_args, &loop));
+
+    OrderData data;
+    memset(data.last_seq, 0xff, sizeof(data.last_seq));
+    data.count = 0;
+    data.in_order = true;
+    data.expected = 50 * OrderData::ID_COUNT;
+    data.done = xSemaphoreCreateBinary();
+    TEST_ASSERT(data.done);
+
+    TEST_ESP_OK(esp_event_handler_register_with(loop, s_test_base1, ESP_EVENT_ANY_ID, test_handler_check_order, &data));
+
+    for (int seq = 0; seq < 50; seq++) {
+        for (int32_t id = 0; id < OrderData::ID_COUNT; id++) {
+            TEST_ESP_OK(esp_event_post_to(loop, s_test_base1, id, &seq, sizeof(seq), portMAX_DELAY));
+        }
+    }
+
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(data.done, pdMS_TO_TICKS(5000)));
+    TEST_ASSERT_TRUE(data.in_order);
+
+    TEST_ESP_OK(esp_event_loop_delete(loop));
+    vSemaphoreDelete(data.done);
+}
+
+struct UnregisterData {
+    esp_event_loop_handle_t loop;
+    esp_event_handler_instance_t instance;
+    std::atomic<int> count;
+    std::atomic<int> executing;
+    std::atomic<int> max_executing;
+    std::atomic<bool> unregistered;
+    SemaphoreHandle_t started;
+    SemaphoreHandle_t release;
+};
+
+static void test_handler_unregister_self_slow(void* handler_arg, esp_event_base_t base, int32_t id, void* event_arg)
+{
+    UnregisterData *data = (UnregisterData*) handler_arg;
+    data->count++;
+    int executing = ++data->executing;
+    int max_executing = data->max_executing;
+    while (executing > max_executing && !data->max_executing.compare_exchange_weak(max_executing, executing)) {
+    }
+    // let the other tasks of the loop execute the handler in the meantime
+    vTaskDelay(pdMS_TO_TICKS(10));
+    if (!data->unregistered.exchange(true)) {
+        TEST_ESP_OK(esp_event_handler_instance_unregister_with(data->loop, s_test_base1, ESP_EVENT_ANY_ID, data->instance));
+    }
+    data->executing--;
+}
+
+static void test_handler_wait_release(void* handler_arg, esp_event_base_t base, int32_t id, void* event_arg)
+{
+    UnregisterData *data = (UnregisterData*) handler_arg;
+    data->count++;
+    xSemaphoreGive(data->started);
+    xSemaphoreTake(data->release, portMAX_DELAY);
+}
+
+TEST_CASE("loop with several tasks: handler can unregister itself while other tasks execute it", "[event][linux]")
+{
+    esp_event_loop_args_t loop_args = test_event_get_default_loop_args();
+    loop_args.task_count = 4;
+    UnregisterData data;
+    TEST_ESP_OK(esp_event_loop_create(&loop_args, &data.loop));
+    data.count = 0;
+    data.executing = 0;
+    data.max_executing = 0;
+    data.unregistered = false;
+
+    TEST_ESP_OK(esp_event_handler_instance_register_with(data.loop, s_test_base1, ESP_EVENT_ANY_ID,
+                test_handler_unregister_self_slow, &data, &data.instance));
+
+    // events with different ids are spread over the tasks, which execute the handler at the same time
+    for (int32_t id = 0; id < 16; id++) {
+        TEST_ESP_OK(esp_event_post_to(data.loop, s_test_base1, id, NULL, 0, portMAX_DELAY));
+    }
+    vTaskDelay(pdMS_TO_TICKS(100));
+    int count = data.count;
+    TEST_ASSERT_TRUE(data.max_executing >= 2);
+    TEST_ASSERT_TRUE(count <= loop_args.task_count);
+    TEST_ASSERT_EQUAL(0, data.executing);
+
+    for (int32_t id = 0; id < 16; id++) {
+        TEST_ESP_OK(esp_event_post_to(data.loop, s_test_base1, id, NULL, 0, portMAX_DELAY));
+    }
+    vTaskDelay(pdMS_TO_TICKS(50));
+    TEST_ASSERT_EQUAL(count, data.count);
+
+    TEST_ESP_OK(esp_event_loop_delete(data.loop));
+}
+
+TEST_CASE("loop with several tasks: handler can be unregistered from another task while it executes", "[event][linux]")
+{
+    esp_event_loop_args_t loop_args = test_event_get_default_loop_args();
+    loop_args.task_count = 4;
+    UnregisterData data;
+    TEST_ESP_OK(esp_event_loop_create(&loop_args, &data.loop));
+    data.count = 0;
+    data.started = xSemaphoreCreateBinary();
+    data.release = xSemaphoreCreateBinary();
+    TEST_ASSERT(data.started);
+    TEST_ASSERT(data.release);
+
+    TEST_ESP_OK(esp_event_handler_instance_register_with(data.loop, s_test_base1, TEST_EVENT_BASE1_EV1,
+                test_handler_wait_release, &data, &data.instance));
+
+    TEST_ESP_OK(esp_event_post_to(data.loop, s_test_base1, TEST_EVENT_BASE1_EV1, NULL, 0, portMAX_DELAY));
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(data.started, pdMS_TO_TICKS(1000)));
+
+    // the handler is still executing, its removal waits for the task executing it
+    TEST_ESP_OK(esp_event_handler_instance_unregister_with(data.loop, s_test_base1, TEST_EVENT_BASE1_EV1, data.instance));
+    xSemaphoreGive(data.release);
+    vTaskDelay(pdMS_TO_TICKS(50));
+
+    TEST_ESP_OK(esp_event_post_to(data.loop, s_test_base1, TEST_EVENT_BASE1_EV1, NULL, 0, portMAX_DELAY));
+    vTaskDelay(pdMS_TO_TICKS(50));
+    TEST_ASSERT_EQUAL(1, data.count);
+
+    TEST_ESP_OK(esp_event_loop_delete(data.loop));
+    vSemaphoreDelete(data.started);
+    vSemaphoreDelete(data.release);
+}
+
+TEST_CASE("batch of events is posted and dispatched in order", "[event][linux]")
+{
+    esp_event_loop_handle_t loop;
+    esp_event_loop_args_t loop_args = test_event_get_default_loop_args();
+    loop_args.dispatch_batch_size = 8;
+    TEST_ESP_OK(esp_event_loop_create(&loop_args, &loop));
+
+    OrderData data;
+    memset(data.last_seq, 0xff, sizeof(data.last_seq));
+    data.count = 0;
+    data.in_order = true;
+    data.expected = 40;
+    data.done = xSemaphoreCreateBinary();
+    TEST_ASSERT(data.done);
+
+    TEST_ESP_OK(esp_event_handler_register_with(loop, s_test_base1, ESP_EVENT_ANY_ID, test_handler_check_order, &data));
+
+    int seq[40];
+    esp_event_batch_item_t events[40];
+    for (int i = 0; i < 40; i++) {
+        seq[i] = i / 2;
+        events[i].event_base = s_test_base1;
+        events[i].event_id = i % 2;
+        events[i].event_data = &seq[i];
+        events[i].event_data_size = sizeof(seq[i]);
+    }
+
+    size_t posted = 1;
+    events[39].event_id = ESP_EVENT_ANY_ID;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_event_post_batch(loop, events, 40, portMAX_DELAY, &posted));
+    TEST_ASSERT_EQUAL(0, posted);
+    events[39].event_id = 1;
+
+    TEST_ESP_OK(esp_event_post_batch(loop, events, 40, portMAX_DELAY, &posted));
+    TEST_ASSERT_EQUAL(40, posted);
+
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(data.done, pdMS_TO_TICKS(5000)));
+    TEST_ASSERT_TRUE(data.in_order);
+
+    TEST_ESP_OK(esp_event_loop_delete(loop));
+    vSemaphoreDelete(data.done);
+}
+
+TEST_CASE("batch posting stops at full event queue", "[event][linux]")
+{
+    esp_event_loop_handle_t loop;
+    esp_event_loop_args_t loop_args = test_event_get_default_loop_args();
+    loop_args.task_name = NULL;
+    loop_args.queue_size = 4;
+    loop_args.dispatch_batch_size = 4;
+    TEST_ESP_OK(esp_event_loop_create(&loop_args, &loop));
+
+    int count = 0;
+    TEST_ESP_OK(esp_event_handler_register_with(loop, s_test_base1, ESP_EVENT_ANY_ID, test_handler_inc, &count));
+
+    esp_event_batch_item_t events[6];
+    for (int i = 0; i < 6; i++) {
+        events[i] = {s_test_base1, TEST_EVENT_BASE1_EV1, NULL, 0};
+    }
+
+    size_t posted = 0;
+    TEST_ASSERT_EQUAL(ESP_ERR_TIMEOUT, esp_event_post_batch(loop, events, 6, 0, &posted));
+    TEST_ASSERT_EQUAL(4, posted);
+
+    TEST_ESP_OK(esp_event_loop_run(loop, 10));
+    TEST_ASSERT_EQUAL(4, count);
+
+    TEST_ESP_OK(esp_event_loop_delete(loop));
+}
+
+static int64_t test_time_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+struct LatencyData {
+    constexpr static int EVENT_COUNT = 200;
+    int64_t latency[EVENT_COUNT];
+    std::atomic<int> count;
+    SemaphoreHandle_t done;
+};
+
+static void test_handler_slow(void* handler_arg, esp_event_base_t base, int32_t id, void* event_arg)
+{
+    vTaskDelay(pdMS_TO_TICKS(10));
+}
+
+static void test_handler_latency(void* handler_arg, esp_event_base_t base, int32_t id, void* event_arg)
+{
+    LatencyData *data = (LatencyData*) handler_arg;
+    int index = data->count++;
+    data->latency[index] = test_time_us() - *(int64_t*) event_arg;
+    if (index == LatencyData::EVENT_COUNT - 1) {
+        xSemaphoreGive(data->done);
+    }
+}
+
+static void test_run_slow_handler_benchmark(uint32_t task_count)
+{
+    esp_event_loop_handle_t loop;
+    esp_event_loop_args_t loop_args = test_event_get_default_loop_args();
+    loop_args.task_count = task_count;
+    TEST_ESP_OK(esp_event_loop_create(&loop_args, &loop));
+
+    LatencyData *data = new LatencyData;
+    data->count = 0;
+    data->done = xSemaphoreCreateBinary();
+    TEST_ASSERT(data->done);
+
+    TEST_ESP_OK(esp_event_handler_register_with(loop, s_test_base2, TEST_EVENT_BASE2_EV1, test_handler_slow, NULL));
+    TEST_ESP_OK(esp_event_handler_register_with(loop, s_test_base1, ESP_EVENT_ANY_ID, test_handler_latency, data));
+
+    // every 20th event takes a slow handler 10 ms to process
+    int64_t start = test_time_us();
+    for (int i = 0; i < LatencyData::EVENT_COUNT; i++) {
+        if (i % 20 == 0) {
+            TEST_ESP_OK(esp_event_post_to(loop, s_test_base2, TEST_EVENT_BASE2_EV1, NULL, 0, portMAX_DELAY));
+        }
+        int64_t now = test_time_us();
+        TEST_ESP_OK(esp_event_post_to(loop, s_test_base1, i % 16, &now, sizeof(now), portMAX_DELAY));
+    }
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(data->done, pdMS_TO_TICKS(5000)));
+    int64_t elapsed = test_time_us() - start;
+
+    std::sort(data->latency, data->latency + LatencyData::EVENT_COUNT);
+    int64_t p50 = data->latency[LatencyData::EVENT_COUNT / 2];
+    int64_t p99 = data->latency[LatencyData::EVENT_COUNT * 99 / 100];
+    printf("%" PRIu32 " task(s): %lld events/s, handler start latency p50 %lld us, p99 %lld us\n", task_count,
+           (long long)(LatencyData::EVENT_COUNT * 1000000LL / elapsed), (long long) p50, (long long) p99);
+
+    TEST_ESP_OK(esp_event_loop_delete(loop));
+    vSemaphoreDelete(data->done);
+    delete data;
+}
+
+TEST_CASE("loop with several tasks is not blocked by a slow handler", "[event][linux]")
+{
+    // only the events dispatched by the task executing the slow handler have to wait for it, the latencies are
+    // printed for comparison, not checked, as they depend on the load of the machine running the test
+    test_run_slow_handler_benchmark(1);
+    test_run_slow_handler_benchmark(4);
+}
+
 TEST_CASE("default loop: registering fails on uninitialized default loop", "[event][default][linux]")
 {
     esp_event_handler_instance_t instance;
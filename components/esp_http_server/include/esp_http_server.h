@@ -33,7 +33,8 @@ typedef enum {
     HTTP_SERVER_EVENT_START,           /*!< This event occurs when HTTP Server is started */
     HTTP_SERVER_EVENT_ON_CONNECTED,    /*!< Once the HTTP Server has been connected to the client, no data exchange has been performed */
     HTTP_SERVER_EVENT_ON_HEADER,       /*!< Occurs when receiving each header sent from the client */
-    HTTP_SERVER_EVENT_HEADERS_SENT,     /*!< After sending all the headers to the client */
+    HTTP_SERVER_EVENT_HEADERS_SENT,     /*!< After sending all the headers to the client. A content of up to 512 bytes
+                                             is sent along with the headers by httpd_resp_send(), so it has been sent too */
     HTTP_SERVER_EVENT_ON_DATA,         /*!< Occurs when receiving data from the client */
     HTTP_SERVER_EVENT_SENT_DATA,       /*!< Occurs when an ESP HTTP server session is finished */
     HTTP_SERVER_EVENT_DISCONNECTED,    /*!< The connection has been disconnected */
@@ -78,7 +79,8 @@ initializer that should be kept in sync
         .keep_alive_count = 0,                          \
         .open_fn = NULL,                                \
         .close_fn = NULL,                               \
-        .uri_match_fn = NULL                            \
+        .uri_match_fn = NULL,                           \
+        .worker_count = 0                               \
 }
 
 #define ESP_ERR_HTTPD_BASE              (0xb000)                    /*!< Starting number of HTTPD error codes */
@@ -281,11 +283,36 @@ typedef struct httpd_config {
      * Available options are:
      *     1) NULL : Internally do basic matching using `strncmp()`
      *     2) `httpd_uri_match_wildcard()` : URI wildcard matcher
+     *     3) `httpd_uri_match_params()` : URI wildcard matcher with parameter segments
+     *
+     * With these options, the registered URIs are indexed in a tree so that the time
+     * taken to find the handler of a request does not grow with the number of handlers.
      *
      * Users can implement their own matching functions (See description
-     * of the `httpd_uri_match_func_t` function prototype)
+     * of the `httpd_uri_match_func_t` function prototype). These are called
+     * for each registered URI in turn.
      */
     httpd_uri_match_func_t uri_match_fn;
+
+    /**
+     * Number of worker tasks processing the requests.
+     *
+     * With 0, the requests are parsed and handled by the server task, one at a time.
+     *
+     * Otherwise, the server task only waits for connections and data, and queues the
+     * sessions having data to the workers, so that a slow handler does not delay the
+     * requests of the other sessions. The requests of a session are still processed one
+     * at a time and in order. The workers are created with the task_priority, stack_size,
+     * core_id and task_caps of the server task. As they may run concurrently, the handlers
+     * must protect the data they share. See httpd_get_worker_stats().
+     *
+     * The functions queued with httpd_queue_work() are still executed by the server task,
+     * so they are no longer serialized with the processing of the requests, including the
+     * requests of the session they act on. Only the WebSocket frames are kept whole: those
+     * sent with httpd_ws_send_frame_async() or httpd_ws_send_data() to a session do not
+     * interleave with the frames sent by the worker processing it.
+     */
+    uint8_t worker_count;
 } httpd_config_t;
 
 /**
@@ -957,6 +984,33 @@ size_t httpd_req_get_hdr_value_len(httpd_req_t *r, const char *field);
  */
 esp_err_t httpd_req_get_hdr_value_str(httpd_req_t *r, const char *field, char *val, size_t val_size);
 
+/**
+ * @brief   Get a pointer to the value string of a field from the request headers
+ *
+ * Unlike httpd_req_get_hdr_value_str(), the value is not copied: the pointer
+ * returned refers to the null terminated value kept in the request.
+ *
+ * @note
+ *  - This API is supposed to be called only from the context of
+ *    a URI handler where httpd_req_t* request pointer is valid.
+ *  - The value must not be modified, and must not be used after the
+ *    handler returns or once httpd_resp_send() API is called.
+ *  - The headers are indexed while the request is parsed, so the cost of
+ *    a lookup does not depend on the number of headers in the request.
+ *
+ * @param[in]  r        The request being responded to
+ * @param[in]  field    The field to be searched in the header
+ * @param[out] val      Pointer set to the value string if the field is found
+ * @param[out] val_len  Length of the value string (may be NULL)
+ *
+ * @return
+ *  - ESP_OK : Field found in the request header
+ *  - ESP_ERR_NOT_FOUND          : Key not found
+ *  - ESP_ERR_INVALID_ARG        : Null arguments
+ *  - ESP_ERR_HTTPD_INVALID_REQ  : Invalid HTTP request pointer
+ */
+esp_err_t httpd_req_get_hdr_view(httpd_req_t *r, const char *field, const char **val, size_t *val_len);
+
 /**
  * @brief   Get Query string length from the request URL
  *
@@ -1003,6 +1057,34 @@ size_t httpd_req_get_url_query_len(httpd_req_t *r);
  */
 esp_err_t httpd_req_get_url_query_str(httpd_req_t *r, char *buf, size_t buf_len);
 
+/**
+ * @brief   Get the value of a parameter segment of the request URI
+ *
+ * The handler must have been registered with a template such as "/api/{id}",
+ * and the server started with httpd_uri_match_params() as URI matching
+ * function (see httpd_config_t::uri_match_fn).
+ *
+ * @note
+ *  - This API is supposed to be called only from the context of
+ *    a URI handler where httpd_req_t* request pointer is valid.
+ *  - The value is not URL decoded.
+ *  - If actual value size is greater than val_size, then the value is truncated,
+ *    accompanied by truncation error as return value.
+ *
+ * @param[in]  r         The request being responded to
+ * @param[in]  name      Name of the parameter, without the braces
+ * @param[out] val       Pointer to the buffer into which the value will be copied if the parameter is found
+ * @param[in]  val_size  Size of the user buffer "val"
+ *
+ * @return
+ *  - ESP_OK : Parameter is found in the URI and copied to buffer
+ *  - ESP_ERR_NOT_FOUND          : Parameter not found
+ *  - ESP_ERR_INVALID_ARG        : Null arguments
+ *  - ESP_ERR_HTTPD_INVALID_REQ  : Invalid HTTP request pointer
+ *  - ESP_ERR_HTTPD_RESULT_TRUNC : Value string truncated
+ */
+esp_err_t httpd_req_get_uri_param(httpd_req_t *r, const char *name, char *val, size_t val_size);
+
 /**
  * @brief   Helper function to get a URL query tag from a query
  *          string of the type param1=val1&param2=val2
@@ -1070,6 +1152,27 @@ esp_err_t httpd_req_get_cookie_val(httpd_req_t *req, const char *cookie_name, ch
  */
 bool httpd_uri_match_wildcard(const char *uri_template, const char *uri_to_match, size_t match_upto);
 
+/**
+ * @brief Test if a URI matches the given template with parameter segments.
+ *
+ * A "{name}" segment of the template matches one non empty segment of the URI (all the characters
+ * up to the next '/'). The URI handler can get its value with httpd_req_get_uri_param(). The rest
+ * of the template after the last parameter segment is matched like httpd_uri_match_wildcard() does.
+ *
+ * Example:
+ *   - /api/{id} matches /api/42, but not /api/ or /api/42/name
+ *   - /api/{id}/\* (sans the backslash) matches /api/42/ and /api/42/name, but not /api/42
+ *   - /users/{user}/files/{file} matches /users/alice/files/notes.txt
+ *
+ * @param[in] uri_template   URI template (pattern)
+ * @param[in] uri_to_match   URI to be matched
+ * @param[in] match_upto     how many characters of the URI buffer to test
+ *                          (there may be trailing query string etc.)
+ *
+ * @return true if a match was found
+ */
+bool httpd_uri_match_params(const char *uri_template, const char *uri_to_match, size_t match_upto);
+
 /**
  * @brief   API to send a complete HTTP response.
  *
@@ -1095,6 +1198,8 @@ bool httpd_uri_match_wildcard(const char *uri_template, const char *uri_to_match
  *  - Once this API is called, all request headers are purged, so
  *    request headers need be copied into separate buffers if
  *    they are required later.
+ *  - A content of up to 512 bytes is sent along with the headers,
+ *    before HTTP_SERVER_EVENT_HEADERS_SENT is posted.
  *
  * @param[in] r         The request being responded to
  * @param[in] buf       Buffer from where the content is to be fetched
@@ -1627,6 +1732,35 @@ esp_err_t httpd_sess_update_lru_counter(httpd_handle_t handle, int sockfd);
  */
 esp_err_t httpd_get_client_list(httpd_handle_t handle, size_t *fds, int *client_fds);
 
+/**
+ * @brief   Statistics of the worker tasks, see httpd_config_t::worker_count
+ *
+ * The waiting time of a session is counted from the time it is queued by the
+ * server task (when data is received) until a worker starts processing it.
+ */
+typedef struct {
+    uint32_t queued;            /*!< Number of sessions currently waiting for a worker */
+    uint32_t max_queued;        /*!< Largest number of sessions waiting for a worker */
+    uint32_t processed;         /*!< Number of times a worker processed a session */
+    uint64_t total_wait_us;     /*!< Total waiting time of the sessions (in microseconds) */
+    uint32_t max_wait_us;       /*!< Longest waiting time of a session (in microseconds) */
+    uint64_t total_process_us;  /*!< Total processing time of the sessions (in microseconds) */
+    uint32_t max_process_us;    /*!< Longest processing time of a session (in microseconds) */
+} httpd_worker_stats_t;
+
+/**
+ * @brief   Returns the statistics of the worker tasks of a server
+ *
+ * @param[in]  handle   Handle to server returned by httpd_start
+ * @param[out] stats    Statistics of the workers since the server started
+ *
+ * @return
+ *  - ESP_OK                : Statistics returned
+ *  - ESP_ERR_INVALID_ARG   : Null arguments
+ *  - ESP_ERR_INVALID_STATE : The server has no worker tasks
+ */
+esp_err_t httpd_get_worker_stats(httpd_handle_t handle, httpd_worker_stats_t *stats);
+
 /** End of Session
  * @}
  */
@@ -1653,6 +1787,9 @@ typedef void (*httpd_work_fn_t)(void *arg);
  *          and send it to the persistently opened connection. This facility is for use
  *          by such protocols.
  *
+ * @note    If the server has worker tasks (see httpd_config_t::worker_count), the work
+ *          function may be executed while a worker processes a request of the same session.
+ *
  * @param[in] handle    Handle to server returned by httpd_start
  * @param[in] work      Pointer to the function to be executed in the HTTPD's context
  * @param[in] arg       Pointer to the arguments that should be passed to this function
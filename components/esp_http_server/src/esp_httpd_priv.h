@@ -15,8 +15,12 @@
 #include <esp_log.h>
 #include <esp_err.h>
 
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
 #include <esp_http_server.h>
 #include "osal.h"
+#include "poller.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -34,6 +38,9 @@ extern "C" {
  * that is received and parsed in one turn of the parsing process. */
 #define PARSER_BLOCK_SIZE  128
 
+/* Number of hash buckets indexing the headers of a request */
+#define REQ_HDR_BUCKETS    16
+
 /* Formats a log string to prepend context function name */
 #define LOG_FMT(x)      "%s: " x, __func__
 
@@ -69,6 +76,11 @@ struct sock_db {
     char pending_data[PARSER_BLOCK_SIZE];   /*!< Buffer for pending data to be received */
     size_t pending_len;                     /*!< Length of pending data to be received */
     bool for_async_req;                     /*!< If true, the socket will not be LRU purged */
+    bool polled;                            /*!< The descriptor is in the poller of the server */
+    bool listed;                            /*!< The session is in the list of the server (see hd_sd_listed) */
+    struct sock_db *next_listed;            /*!< Next session in the list of the server */
+    bool dispatched;                        /*!< The session is queued to or processed by a worker */
+    bool close_requested;                   /*!< Close the session when the worker is done with it */
 #ifdef CONFIG_HTTPD_WS_SUPPORT
     bool ws_handshake_done;                 /*!< True if it has done WebSocket handshake (if this socket is a valid WS) */
     bool ws_close;                          /*!< Set to true to close the socket later (when WS Close frame received) */
@@ -92,8 +104,18 @@ struct httpd_req_aux {
     size_t          remaining_len;                  /*!< Amount of data remaining to be fetched */
     char           *status;                         /*!< HTTP response's status code */
     char           *content_type;                   /*!< HTTP response's content type */
+    const char     *uri_template;                   /*!< URI template of the handler, if matched by httpd_uri_match_params() */
     bool            first_chunk_sent;               /*!< Used to indicate if first chunk sent */
     unsigned        req_hdrs_count;                 /*!< Count of total headers in request packet */
+    struct req_hdr {
+        uint32_t field;                             /*!< Offset of the field name in scratch */
+        uint32_t field_len;                         /*!< Length of the field name */
+        uint32_t value;                             /*!< Offset of the value (null terminated) in scratch */
+        uint32_t value_len;                         /*!< Length of the value */
+        uint32_t next;                              /*!< Next header of the hash bucket (index + 1), 0 if last */
+    } *req_hdrs;                                    /*!< Headers of the request packet, in order of reception */
+    unsigned        req_hdrs_size;                  /*!< Number of headers allocated in req_hdrs */
+    uint32_t        req_hdr_buckets[REQ_HDR_BUCKETS]; /*!< First header of each hash bucket (index + 1), 0 if none */
     unsigned        resp_hdrs_count;                /*!< Count of additional headers in response packet */
     struct resp_hdr {
         const char *field;
@@ -123,7 +145,16 @@ struct httpd_data {
     struct thread_data hd_td;               /*!< Information for the HTTPD thread */
     struct sock_db *hd_sd;                  /*!< The socket database */
     int hd_sd_active_count;                 /*!< The number of the active sockets */
+    struct sock_db *hd_sd_listed;           /*!< Sessions checked without waiting for their descriptor (pending data, asynchronous request) */
+    poller_t *hd_poller;                    /*!< Descriptors waited for by the server thread */
+    void **hd_poll_ready;                   /*!< Ready descriptors returned by the poller */
+    bool hd_poll_listen;                    /*!< The listening socket is in the poller */
+    struct httpd_workers *hd_workers;       /*!< Worker tasks processing the requests, NULL if none */
     httpd_uri_t **hd_calls;                 /*!< Registered URI handlers */
+    struct httpd_router_node *hd_router;    /*!< Index of the registered URI handlers, NULL if not built */
+    SemaphoreHandle_t hd_uri_lock;          /*!< Protects hd_calls, hd_router, hd_uri_users and hd_uri_retired */
+    unsigned hd_uri_users;                  /*!< Number of requests using the handler they found */
+    struct httpd_uri_entry *hd_uri_retired; /*!< Handlers unregistered while requests use them, freed once unused */
     struct httpd_req hd_req;                /*!< The current HTTPD request */
     struct httpd_req_aux hd_req_aux;        /*!< Additional data about the HTTPD request kept unexposed */
     uint64_t lru_counter;                   /*!< LRU counter */
@@ -203,12 +234,15 @@ esp_err_t httpd_sess_new(struct httpd_data *hd, int newfd);
  *
  * @param[in] hd      Server instance data
  * @param[in] session Session
+ * @param[in] r       Request structure used for the processing
+ * @param[in] ra      Auxiliary data of the request
  *
  * @return
  *  - ESP_OK    : on successfully receiving, parsing and responding to a request
  *  - ESP_FAIL  : in case of failure in any of the stages of processing
  */
-esp_err_t httpd_sess_process(struct httpd_data *hd, struct sock_db *session);
+esp_err_t httpd_sess_process(struct httpd_data *hd, struct sock_db *session,
+                             httpd_req_t *r, struct httpd_req_aux *ra);
 
 /**
  * @brief   Remove client descriptor from the session / socket database
@@ -228,15 +262,26 @@ void httpd_sess_delete(struct httpd_data *hd, struct sock_db *session);
 void httpd_sess_free_ctx(void **ctx, httpd_free_ctx_fn_t free_fn);
 
 /**
- * @brief   Add descriptors present in the socket database to an fdset and
- *          update the value of maxfd which are needed by the select function
- *          for looking through all available sockets for incoming data.
+ * @brief   Updates how the server thread waits for data of a session,
+ *          after the session has been created or has processed a request.
+ *
+ * The descriptor of a session handling an asynchronous request is removed
+ * from the poller until the request is completed, and a session having
+ * pending data is added to the list of sessions processed without waiting.
+ *
+ * @param[in] hd      Server instance data
+ * @param[in] session Session
+ */
+void httpd_sess_watch(struct httpd_data *hd, struct sock_db *session);
+
+/**
+ * @brief   Adds a session to the list of sessions checked by the server
+ *          thread on its next iteration, if not already in the list.
  *
- * @param[in]  hd    Server instance data
- * @param[out] fdset File descriptor set to be updated.
- * @param[out] maxfd Maximum value among all file descriptors.
+ * @param[in] hd      Server instance data
+ * @param[in] session Session
  */
-void httpd_sess_set_descriptors(struct httpd_data *hd, fd_set *fdset, int *maxfd);
+void httpd_sess_list(struct httpd_data *hd, struct sock_db *session);
 
 /**
  * @brief   Checks if session can accept another connection from new client.
@@ -296,6 +341,89 @@ void httpd_sess_close_all(struct httpd_data *hd);
  * @}
  */
 
+/****************** Group : Workers ********************/
+/** @name Workers
+ * Tasks processing the requests when httpd_config_t::worker_count is not 0
+ * @{
+ */
+
+/**
+ * @brief   Creates the worker tasks, if configured
+ *
+ * @param[in] hd  Server instance data
+ *
+ * @return
+ *  - ESP_OK                  : if the workers are started (or none is configured)
+ *  - ESP_ERR_HTTPD_ALLOC_MEM : if out of memory
+ *  - ESP_ERR_HTTPD_TASK      : if a task can not be created
+ */
+esp_err_t httpd_workers_start(struct httpd_data *hd);
+
+/**
+ * @brief   Stops the worker tasks, after they are done with the sessions
+ *          dispatched to them, and frees their resources
+ *
+ * @param[in] hd  Server instance data
+ */
+void httpd_workers_stop(struct httpd_data *hd);
+
+/**
+ * @brief   Queues a session having data to process to the workers
+ *
+ * The session is processed by one worker at a time: it must not be
+ * dispatched again before being returned by httpd_workers_get_done().
+ *
+ * @param[in] hd      Server instance data
+ * @param[in] session Session to process
+ */
+void httpd_workers_dispatch(struct httpd_data *hd, struct sock_db *session);
+
+/**
+ * @brief   Returns a session processed by a worker, called by the server
+ *          thread after being woken up by the worker
+ *
+ * @param[in]  hd   Server instance data
+ * @param[out] ret  Result of httpd_sess_process() for the session
+ *
+ * @return
+ *  - the session
+ *  - NULL if no more session has been processed
+ */
+struct sock_db *httpd_workers_get_done(struct httpd_data *hd, esp_err_t *ret);
+
+/**
+ * @brief   Locks the sending of a WebSocket frame to a session, so that the
+ *          frames sent by other tasks do not interleave with those of the
+ *          worker processing the session. Does nothing without workers.
+ *
+ * @param[in] hd       Server instance data
+ * @param[in] session  Session the frame is sent to
+ */
+void httpd_workers_lock_send(struct httpd_data *hd, struct sock_db *session);
+
+/**
+ * @brief   Unlocks the sending of frames locked by httpd_workers_lock_send()
+ *
+ * @param[in] hd       Server instance data
+ * @param[in] session  Session the frame was sent to
+ */
+void httpd_workers_unlock_send(struct httpd_data *hd, struct sock_db *session);
+
+/**
+ * @brief   Returns the request processed by the calling task
+ *
+ * @param[in] hd  Server instance data
+ *
+ * @return
+ *  - the request of the server thread, or of the calling worker
+ *  - NULL if the calling task is neither of them
+ */
+httpd_req_t *httpd_req_current(struct httpd_data *hd);
+
+/** End of Group : Workers
+ * @}
+ */
+
 /****************** Group : URI Handling ********************/
 /** @name URI Handling
  * Methods for accessing URI handlers
@@ -307,12 +435,13 @@ void httpd_sess_close_all(struct httpd_data *hd);
  *          and invokes the appropriate one if found
  *
  * @param[in] hd  Server instance data for which handler needs to be invoked
+ * @param[in] req The parsed request
  *
  * @return
  *  - ESP_OK    : if handler found and executed successfully
  *  - ESP_FAIL  : otherwise
  */
-esp_err_t httpd_uri(struct httpd_data *hd);
+esp_err_t httpd_uri(struct httpd_data *hd, httpd_req_t *req);
 
 /**
  * @brief   Unregister all URI handlers
@@ -321,6 +450,57 @@ esp_err_t httpd_uri(struct httpd_data *hd);
  */
 void httpd_unregister_all_uri_handlers(struct httpd_data *hd);
 
+/**
+ * @brief   Finds the first "{name}" parameter segment of a URI template
+ *
+ * @param[in]  template  URI template
+ * @param[out] param_len Length of the parameter segment, braces included
+ *
+ * @return
+ *  - Pointer to the opening brace of the parameter segment
+ *  - NULL if there is no parameter segment in the template
+ */
+const char *httpd_uri_find_param(const char *template, size_t *param_len);
+
+/**
+ * @brief   Rebuilds the index of the registered URI handlers
+ *
+ * To be called whenever a URI handler is registered or unregistered.
+ * The index is only built if the URI matching function is the default
+ * one, httpd_uri_match_wildcard() or httpd_uri_match_params(). Otherwise,
+ * or if there is not enough memory, hd_router is left NULL and the
+ * handlers are found by scanning them all. Called with hd_uri_lock held.
+ *
+ * @param[in] hd  Server instance data
+ */
+void httpd_router_rebuild(struct httpd_data *hd);
+
+/**
+ * @brief   Frees the index of the registered URI handlers
+ *
+ * @param[in] hd  Server instance data
+ */
+void httpd_router_free(struct httpd_data *hd);
+
+/**
+ * @brief   Searches the index for the first registered handler matching
+ *          the URI and method, and sets the appropriate error code if the
+ *          URI or method is not found. Called with hd_uri_lock held.
+ *
+ * @param[in]  hd      Server instance data, with hd_router built
+ * @param[in]  uri     URI path to match
+ * @param[in]  uri_len Length of the URI path
+ * @param[in]  method  Method of the request
+ * @param[out] err     HTTPD_404_NOT_FOUND or HTTPD_405_METHOD_NOT_ALLOWED if no
+ *                     handler is found, 0 otherwise (may be NULL)
+ *
+ * @return
+ *  - Matching URI handler
+ *  - NULL if not found
+ */
+httpd_uri_t *httpd_router_find(struct httpd_data *hd, const char *uri, size_t uri_len,
+                               httpd_method_t method, httpd_err_code_t *err);
+
 /**
  * @brief   Validates the request to prevent users from calling APIs, that are to
  *          be called only inside a URI handler, outside the handler context
@@ -361,25 +541,27 @@ bool httpd_validate_req_ptr(httpd_req_t *r);
  * http_recv() after this reads the body of the request.
  *
  * @param[in] hd  Server instance data
+ * @param[in] r   Request structure to fill
+ * @param[in] ra  Auxiliary data of the request to fill
  * @param[in] sd  Pointer to socket which is needed for receiving TCP packets.
  *
  * @return
  *  - ESP_OK    : if request packet is valid
  *  - ESP_FAIL  : otherwise
  */
-esp_err_t httpd_req_new(struct httpd_data *hd, struct sock_db *sd);
+esp_err_t httpd_req_new(struct httpd_data *hd, httpd_req_t *r, struct httpd_req_aux *ra, struct sock_db *sd);
 
 /**
  * @brief   For an HTTP request, resets the resources allocated for it and
  *          purges any data left to be received
  *
- * @param[in] hd  Server instance data
+ * @param[in] r   The request
  *
  * @return
  *  - ESP_OK    : if request packet deleted and resources cleaned.
  *  - ESP_FAIL  : otherwise.
  */
-esp_err_t httpd_req_delete(struct httpd_data *hd);
+esp_err_t httpd_req_delete(httpd_req_t *r);
 
 /**
  * @brief   For handling HTTP errors by invoking registered
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2018-2023 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -20,7 +20,10 @@
 #include "freertos/semphr.h"
 #endif
 
-#if defined(CONFIG_LWIP_MAX_SOCKETS)
+#if POLLER_USE_EPOLL
+/* Sockets of the host, the limit is the one of max_open_sockets */
+#define HTTPD_MAX_SOCKETS (UINT16_MAX + 3)
+#elif defined(CONFIG_LWIP_MAX_SOCKETS)
 #define HTTPD_MAX_SOCKETS CONFIG_LWIP_MAX_SOCKETS
 #else
 /* LwIP component is not included into the build, use a default value */
@@ -31,10 +34,8 @@ static const int DEFAULT_KEEP_ALIVE_IDLE = 5;
 static const int DEFAULT_KEEP_ALIVE_INTERVAL= 5;
 static const int DEFAULT_KEEP_ALIVE_COUNT= 3;
 
-typedef struct {
-    fd_set *fdset;
-    struct httpd_data *hd;
-} process_session_context_t;
+/* Maximum number of ready descriptors handled in one iteration of the server thread */
+#define HTTPD_POLL_MAX_EVENTS 64
 
 static const char *TAG = "httpd";
 
@@ -243,63 +244,114 @@ static void httpd_process_ctrl_msg(struct httpd_data *hd)
 #endif
 }
 
-// Called for each session from httpd_server
-static int httpd_process_session(struct sock_db *session, void *context)
+// Called when the processing of a session is done, by the server thread or a worker
+static void httpd_sess_processed(struct httpd_data *hd, struct sock_db *session, esp_err_t ret)
 {
-    if ((!session) || (!context)) {
-        return 0;
+    if (ret != ESP_OK || session->close_requested) {
+        httpd_sess_delete(hd, session); // Delete session
+        return;
+    }
+    session->lru_counter = ++hd->lru_counter;
+    if (!session->polled && !session->for_async_req) {
+        // the session was dispatched to a worker, wait again for its data
+        if (poller_add(hd->hd_poller, session->fd, session) < 0) {
+            ESP_LOGE(TAG, LOG_FMT("error in adding fd = %d to poller (%d)"), session->fd, errno);
+            httpd_sess_delete(hd, session);
+            return;
+        }
+        session->polled = true;
     }
+    httpd_sess_watch(hd, session);
+}
 
+// Called for each session checked by httpd_server
+static void httpd_process_session(struct httpd_data *hd, struct sock_db *session)
+{
     if (session->fd < 0) {
-        return 1;
+        return;
     }
 
     // session is busy in an async task, do not process here.
     if (session->for_async_req) {
-        return 1;
+        httpd_sess_list(hd, session);
+        return;
     }
 
-    process_session_context_t *ctx = (process_session_context_t *)context;
-    int fd = session->fd;
-
-    if (FD_ISSET(fd, ctx->fdset) || httpd_sess_pending(ctx->hd, session)) {
-        ESP_LOGD(TAG, LOG_FMT("processing socket %d"), fd);
-        if (httpd_sess_process(ctx->hd, session) != ESP_OK) {
-            httpd_sess_delete(ctx->hd, session); // Delete session
+    if (!session->polled) {
+        // the async request is completed, wait again for data of the session
+        if (poller_add(hd->hd_poller, session->fd, session) < 0) {
+            ESP_LOGE(TAG, LOG_FMT("error in adding fd = %d to poller (%d)"), session->fd, errno);
+            httpd_sess_delete(hd, session);
+            return;
+        }
+        session->polled = true;
+        if (!httpd_sess_pending(hd, session)) {
+            return;
         }
     }
-    return 1;
+
+    if (hd->hd_workers) {
+        // the session is not polled while a worker receives its data
+        ESP_LOGD(TAG, LOG_FMT("dispatching socket %d"), session->fd);
+        poller_del(hd->hd_poller, session->fd);
+        session->polled = false;
+        httpd_workers_dispatch(hd, session);
+        return;
+    }
+
+    ESP_LOGD(TAG, LOG_FMT("processing socket %d"), session->fd);
+    httpd_sess_processed(hd, session, httpd_sess_process(hd, session, &hd->hd_req, &hd->hd_req_aux));
 }
 
 /* Manage in-coming connection or data requests */
 static esp_err_t httpd_server(struct httpd_data *hd)
 {
-    fd_set read_set;
-    FD_ZERO(&read_set);
-    if (hd->config.lru_purge_enable || httpd_is_sess_available(hd)) {
-        /* Only listen for new connections if server has capacity to
-         * handle more (or when LRU purge is enabled, in which case
-         * older connections will be closed) */
-        FD_SET(hd->listen_fd, &read_set);
-    }
-    FD_SET(hd->ctrl_fd, &read_set);
-
-    int tmp_max_fd;
-    httpd_sess_set_descriptors(hd, &read_set, &tmp_max_fd);
-    int maxfd = MAX(hd->listen_fd, tmp_max_fd);
-    tmp_max_fd = maxfd;
-    maxfd = MAX(hd->ctrl_fd, tmp_max_fd);
-
-    ESP_LOGD(TAG, LOG_FMT("doing select maxfd+1 = %d"), maxfd + 1);
-    int active_cnt = select(maxfd + 1, &read_set, NULL, NULL, NULL);
+    /* Only listen for new connections if server has capacity to
+     * handle more (or when LRU purge is enabled, in which case
+     * older connections will be closed) */
+    bool listening = hd->config.lru_purge_enable || httpd_is_sess_available(hd);
+    if (listening != hd->hd_poll_listen) {
+        if (listening) {
+            poller_add(hd->hd_poller, hd->listen_fd, &hd->listen_fd);
+        } else {
+            poller_del(hd->hd_poller, hd->listen_fd);
+        }
+        hd->hd_poll_listen = listening;
+    }
+
+    /* Do not wait if some sessions have pending data */
+    int timeout = -1;
+    for (struct sock_db *session = hd->hd_sd_listed; session; session = session->next_listed) {
+        if (!session->for_async_req) {
+            timeout = 0;
+            break;
+        }
+    }
+
+    ESP_LOGD(TAG, LOG_FMT("waiting, timeout = %d"), timeout);
+    int active_cnt = poller_wait(hd->hd_poller, hd->hd_poll_ready, timeout);
     if (active_cnt < 0) {
-        ESP_LOGE(TAG, LOG_FMT("error in select (%d)"), errno);
+        ESP_LOGE(TAG, LOG_FMT("error in poller wait (%d)"), errno);
         httpd_sess_delete_invalid(hd);
         return ESP_OK;
     }
 
+    bool ctrl_ready = false;
+    bool listen_ready = false;
+    for (int i = 0; i < active_cnt; i++) {
+        void *ready = hd->hd_poll_ready[i];
+        if (ready == &hd->ctrl_fd) {
+            ctrl_ready = true;
+        } else if (ready == &hd->listen_fd) {
+            listen_ready = true;
+        } else {
+            /* Sessions are processed after the control message, which may close them */
+            httpd_sess_list(hd, ready);
+        }
+    }
+
     /* Case0: Do we have a control message? */
-    if (FD_ISSET(hd->ctrl_fd, &read_set)) {
+    if (ctrl_ready) {
         ESP_LOGD(TAG, LOG_FMT("processing ctrl message"));
         httpd_process_ctrl_msg(hd);
         if (hd->hd_td.status == THREAD_STOPPING) {
@@ -308,17 +360,31 @@ static esp_err_t httpd_server(struct httpd_data *hd)
         }
     }
 
+    /* Sessions processed by the workers, they wake up the server
+     * thread with a control message */
+    if (hd->hd_workers) {
+        esp_err_t ret;
+        struct sock_db *session;
+        while ((session = httpd_workers_get_done(hd, &ret)) != NULL) {
+            httpd_sess_processed(hd, session, ret);
+        }
+    }
+
     /* Case1: Do we have any activity on the current data
-     * sessions? */
-    process_session_context_t context = {
-        .fdset = &read_set,
-        .hd = hd
-    };
-    httpd_sess_enum(hd, httpd_process_session, &context);
+     * sessions? Only the ready sessions, and the ones with
+     * pending data, are in the list */
+    struct sock_db *session = hd->hd_sd_listed;
+    hd->hd_sd_listed = NULL;
+    while (session) {
+        struct sock_db *next = session->next_listed;
+        session->listed = false;
+        httpd_process_session(hd, session);
+        session = next;
+    }
 
     /* Case2: Do we have any incoming connection requests to
      * process? */
-    if (FD_ISSET(hd->listen_fd, &read_set)) {
+    if (listen_ready) {
         ESP_LOGD(TAG, LOG_FMT("processing listen socket %d"), hd->listen_fd);
         if (httpd_accept_conn(hd, hd->listen_fd) != ESP_OK) {
             ESP_LOGW(TAG, LOG_FMT("error accepting new connection"));
@@ -343,6 +409,7 @@ static void httpd_thread(void *arg)
     }
 
     ESP_LOGD(TAG, LOG_FMT("web server exiting"));
+    httpd_workers_stop(hd);
     close(hd->msg_fd);
     cs_free_ctrl_sock(hd->ctrl_fd);
     httpd_sess_close_all(hd);
@@ -416,6 +483,17 @@ static esp_err_t httpd_server_init(struct httpd_data *hd)
         return ESP_FAIL;
     }
 
+    int max_events = MIN(hd->config.max_open_sockets + 2, HTTPD_POLL_MAX_EVENTS);
+    hd->hd_poll_ready = calloc(max_events, sizeof(void *));
+    hd->hd_poller = poller_create(max_events);
+    if (!hd->hd_poll_ready || !hd->hd_poller || poller_add(hd->hd_poller, ctrl_fd, &hd->ctrl_fd) < 0) {
+        ESP_LOGE(TAG, LOG_FMT("error in creating poller (%d)"), errno);
+        close(fd);
+        close(ctrl_fd);
+        close(msg_fd);
+        return ESP_FAIL;
+    }
+
     hd->listen_fd = fd;
     hd->ctrl_fd = ctrl_fd;
     hd->msg_fd  = msg_fd;
@@ -461,6 +539,16 @@ static struct httpd_data *httpd_create(const httpd_config_t *config)
         free(hd);
         return NULL;
     }
+    hd->hd_uri_lock = xSemaphoreCreateMutex();
+    if (!hd->hd_uri_lock) {
+        ESP_LOGE(TAG, LOG_FMT("Failed to create HTTP URI handlers lock"));
+        free(hd->err_handler_fns);
+        free(ra->resp_hdrs);
+        free(hd->hd_sd);
+        free(hd->hd_calls);
+        free(hd);
+        return NULL;
+    }
     /* Save the configuration for this instance */
     hd->config = *config;
     return hd;
@@ -470,6 +558,8 @@ static void httpd_delete(struct httpd_data *hd)
 {
     struct httpd_req_aux *ra = &hd->hd_req_aux;
     /* Free memory of httpd instance data */
+    poller_free(hd->hd_poller);
+    free(hd->hd_poll_ready);
     free(hd->err_handler_fns);
     free(ra->resp_hdrs);
     free(hd->hd_sd);
@@ -477,6 +567,7 @@ static void httpd_delete(struct httpd_data *hd)
     /* Free registered URI handlers */
     httpd_unregister_all_uri_handlers(hd);
     free(hd->hd_calls);
+    vSemaphoreDelete(hd->hd_uri_lock);
     free(hd);
 }
 
@@ -527,6 +618,11 @@ esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config)
     }
 
     httpd_sess_init(hd);
+    esp_err_t err = httpd_workers_start(hd);
+    if (err != ESP_OK) {
+        httpd_delete(hd);
+        return err;
+    }
     if (httpd_os_thread_create(&hd->hd_td.handle, "httpd",
                                hd->config.stack_size,
                                hd->config.task_priority,
@@ -534,6 +630,7 @@ esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config)
                                hd->config.core_id,
                                hd->config.task_caps) != ESP_OK) {
         /* Failed to launch task */
+        httpd_workers_stop(hd);
         httpd_delete(hd);
         return ESP_ERR_HTTPD_TASK;
     }
@@ -7,6 +7,7 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 #include <sys/param.h>
 #include <esp_log.h>
 #include <esp_err.h>
@@ -192,6 +193,55 @@ static size_t continue_parsing(http_parser *parser, size_t length)
     return length;
 }
 
+/* Hash bucket of a header field name, case insensitive (FNV-1a) */
+static unsigned req_hdr_bucket(const char *field, size_t length)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ (uint8_t)tolower((unsigned char)field[i])) * 16777619u;
+    }
+    return hash % REQ_HDR_BUCKETS;
+}
+
+/* Records the field name of the next header in the header table
+ * of the request. Offsets are kept, as scratch may be reallocated
+ * while the rest of the headers is received */
+static esp_err_t req_hdr_add_field(struct httpd_req_aux *ra, const char *at, size_t length)
+{
+    if (ra->req_hdrs_count == ra->req_hdrs_size) {
+        unsigned size = ra->req_hdrs_size ? 2 * ra->req_hdrs_size : 8;
+        struct req_hdr *hdrs = realloc(ra->req_hdrs, size * sizeof(struct req_hdr));
+        if (hdrs == NULL) {
+            ESP_LOGE(TAG, LOG_FMT("unable to allocate the header table"));
+            return ESP_ERR_NO_MEM;
+        }
+        ra->req_hdrs = hdrs;
+        ra->req_hdrs_size = size;
+    }
+    struct req_hdr *hdr = &ra->req_hdrs[ra->req_hdrs_count];
+    hdr->field = at - ra->scratch;
+    hdr->field_len = length;
+    return ESP_OK;
+}
+
+/* Completes the last header with its value, and indexes it by its field name */
+static void req_hdr_add_value(struct httpd_req_aux *ra, const char *at, size_t length)
+{
+    struct req_hdr *hdr = &ra->req_hdrs[ra->req_hdrs_count];
+    hdr->value = at - ra->scratch;
+    hdr->value_len = length;
+    hdr->next = 0;
+
+    /* Append to the bucket, so that the first of duplicate fields is found */
+    uint32_t *link = &ra->req_hdr_buckets[req_hdr_bucket(ra->scratch + hdr->field, hdr->field_len)];
+    while (*link) {
+        link = &ra->req_hdrs[*link - 1].next;
+    }
+
+    /* Increment header count */
+    *link = ++ra->req_hdrs_count;
+}
+
 /* http_parser callback on header field in HTTP request
  * May be invoked AT LEAST once every header field
  */
@@ -230,15 +280,13 @@ static esp_err_t cb_header_field(http_parser *parser, const char *at, size_t len
          * (key: value) pair with null characters */
         char *term_start = (char *)parser_data->last.at + parser_data->last.length;
         memset(term_start, '\0', at - term_start);
+        req_hdr_add_value(ra, parser_data->last.at, parser_data->last.length);
 
         /* Store current values of the parser callback arguments */
         parser_data->last.at     = at;
         parser_data->last.length = 0;
         parser_data->status      = PARSING_HDR_FIELD;
         ra->scratch_size_limit   = ra->max_req_hdr_len;
-
-        /* Increment header count */
-        ra->req_hdrs_count++;
     } else if (parser_data->status != PARSING_HDR_FIELD) {
         ESP_LOGE(TAG, LOG_FMT("unexpected state transition"));
         parser_data->error = HTTPD_500_INTERNAL_SERVER_ERROR;
@@ -259,9 +307,18 @@ static esp_err_t cb_header_field(http_parser *parser, const char *at, size_t len
 static esp_err_t cb_header_value(http_parser *parser, const char *at, size_t length)
 {
     parser_data_t *parser_data = (parser_data_t *) parser->data;
+    struct httpd_req *r        = parser_data->req;
+    struct httpd_req_aux *ra   = r->aux;
 
     /* Check previous status */
     if (parser_data->status == PARSING_HDR_FIELD) {
+        /* The field name is complete */
+        if (req_hdr_add_field(ra, parser_data->last.at, parser_data->last.length) != ESP_OK) {
+            parser_data->error = HTTPD_500_INTERNAL_SERVER_ERROR;
+            parser_data->status = PARSING_FAILED;
+            return ESP_FAIL;
+        }
+
         /* Store current values of the parser callback arguments */
         parser_data->last.at     = at;
         parser_data->last.length = 0;
@@ -317,6 +374,8 @@ static esp_err_t cb_headers_complete(http_parser *parser)
             return ESP_FAIL;
         }
     } else if (parser_data->status == PARSING_HDR_VALUE) {
+        req_hdr_add_value(ra, parser_data->last.at, parser_data->last.length);
+
         /* Locate end of last header */
         char *at = (char *)parser_data->last.at + parser_data->last.length;
 
@@ -356,9 +415,6 @@ static esp_err_t cb_headers_complete(http_parser *parser)
 
         /* Place the parser ptr right after the end of headers section */
         parser_data->last.at = at;
-
-        /* Increment header count */
-        ra->req_hdrs_count++;
     } else {
         ESP_LOGE(TAG, LOG_FMT("unexpected state transition"));
         parser_data->error = HTTPD_500_INTERNAL_SERVER_ERROR;
@@ -639,9 +695,8 @@ static void parse_init(httpd_req_t *r, http_parser *parser, parser_data_t *data)
 
 /* Function that receives TCP data and runs parser on it
  */
-static esp_err_t httpd_parse_req(struct httpd_data *hd)
+static esp_err_t httpd_parse_req(struct httpd_data *hd, httpd_req_t *r)
 {
-    httpd_req_t *r = &hd->hd_req;
     int blk_len,  offset;
     http_parser   parser = {};
     parser_data_t parser_data = {};
@@ -681,7 +736,7 @@ static esp_err_t httpd_parse_req(struct httpd_data *hd)
     } while (parser_data.status != PARSING_COMPLETE);
 
     ESP_LOGD(TAG, LOG_FMT("parsing complete"));
-    return httpd_uri(hd);
+    return httpd_uri(hd, r);
 }
 
 static void init_req(httpd_req_t *r, httpd_config_t *config)
@@ -703,8 +758,12 @@ static void init_req_aux(struct httpd_req_aux *ra, httpd_config_t *config)
     ra->remaining_len = 0;
     ra->status = 0;
     ra->content_type = 0;
+    ra->uri_template = NULL;
     ra->first_chunk_sent = 0;
     ra->req_hdrs_count = 0;
+    ra->req_hdrs = NULL;
+    ra->req_hdrs_size = 0;
+    memset(ra->req_hdr_buckets, 0, sizeof(ra->req_hdr_buckets));
     ra->resp_hdrs_count = 0;
     ra->scratch = NULL;
     ra->scratch_cur_size = 0;
@@ -745,6 +804,9 @@ static void httpd_req_cleanup(httpd_req_t *r)
     ra->scratch = NULL;
     ra->scratch_size_limit = 0;
     ra->scratch_cur_size = 0;
+    free(ra->req_hdrs);
+    ra->req_hdrs = NULL;
+    ra->req_hdrs_size = 0;
     r->handle = NULL;
     r->aux = NULL;
     r->user_ctx = NULL;
@@ -753,16 +815,14 @@ static void httpd_req_cleanup(httpd_req_t *r)
 /* Function that processes incoming TCP data and
  * updates the http request data httpd_req_t
  */
-esp_err_t httpd_req_new(struct httpd_data *hd, struct sock_db *sd)
+esp_err_t httpd_req_new(struct httpd_data *hd, httpd_req_t *r, struct httpd_req_aux *ra, struct sock_db *sd)
 {
-    httpd_req_t *r = &hd->hd_req;
     init_req(r, &hd->config);
-    init_req_aux(&hd->hd_req_aux, &hd->config);
+    init_req_aux(ra, &hd->config);
     r->handle = hd;
-    r->aux = &hd->hd_req_aux;
+    r->aux = ra;
 
     /* Associate the request to the socket */
-    struct httpd_req_aux *ra = r->aux;
     ra->sd = sd;
 
     /* Set defaults */
@@ -817,7 +877,7 @@ esp_err_t httpd_req_new(struct httpd_data *hd, struct sock_db *sd)
 #endif
 
     /* Parse request */
-    ret = httpd_parse_req(hd);
+    ret = httpd_parse_req(hd, r);
     if (ret != ESP_OK) {
         httpd_req_cleanup(r);
     }
@@ -826,9 +886,8 @@ esp_err_t httpd_req_new(struct httpd_data *hd, struct sock_db *sd)
 
 /* Function that resets the http request data
  */
-esp_err_t httpd_req_delete(struct httpd_data *hd)
+esp_err_t httpd_req_delete(httpd_req_t *r)
 {
-    httpd_req_t *r = &hd->hd_req;
     struct httpd_req_aux *ra = r->aux;
 
     /* Finish off reading any pending/leftover data */
@@ -868,8 +927,8 @@ bool httpd_validate_req_ptr(httpd_req_t *r)
         struct httpd_data *hd = (struct httpd_data *) r->handle;
         if (hd) {
             /* Check if this function is running in the context of
-             * the correct httpd server thread */
-            if (httpd_os_thread_handle() == hd->hd_td.handle) {
+             * the correct httpd server thread (or of one of its workers) */
+            if (httpd_req_current(hd) != NULL) {
                 return true;
             }
         }
@@ -995,6 +1054,27 @@ esp_err_t httpd_req_get_url_query_str(httpd_req_t *r, char *buf, size_t buf_len)
     return ESP_ERR_NOT_FOUND;
 }
 
+/* Find a header of the request in the header table built during parsing */
+static const struct req_hdr *httpd_req_find_hdr(struct httpd_req_aux *ra, const char *field)
+{
+    /* The header count is reset once the response is sent */
+    if (ra->req_hdrs_count == 0) {
+        return NULL;
+    }
+
+    size_t length = strlen(field);
+    uint32_t index = ra->req_hdr_buckets[req_hdr_bucket(field, length)];
+    while (index) {
+        const struct req_hdr *hdr = &ra->req_hdrs[index - 1];
+        if ((hdr->field_len == length) &&
+            (strncasecmp(ra->scratch + hdr->field, field, length) == 0)) {
+            return hdr;
+        }
+        index = hdr->next;
+    }
+    return NULL;
+}
+
 /* Get the length of the value string of a header request field */
 size_t httpd_req_get_hdr_value_len(httpd_req_t *r, const char *field)
 {
@@ -1006,48 +1086,34 @@ size_t httpd_req_get_hdr_value_len(httpd_req_t *r, const char *field)
         return 0;
     }
 
-    struct httpd_req_aux *ra = r->aux;
-    const char   *hdr_ptr = ra->scratch;         /*!< Request headers are kept in scratch buffer */
-    unsigned      count   = ra->req_hdrs_count;  /*!< Count set during parsing  */
-
-    while (count--) {
-        /* Search for the ':' character. Else, it would mean
-         * that the field is invalid
-         */
-        const char *val_ptr = strchr(hdr_ptr, ':');
-        if (!val_ptr) {
-            break;
-        }
+    const struct req_hdr *hdr = httpd_req_find_hdr(r->aux, field);
+    return hdr ? hdr->value_len : 0;
+}
 
-        /* If the field, does not match, continue searching.
-         * Compare lengths first as field from header is not
-         * null terminated (has ':' in the end).
-         */
-        if ((val_ptr - hdr_ptr != strlen(field)) ||
-            (strncasecmp(hdr_ptr, field, strlen(field)))) {
-            if (count) {
-                /* Jump to end of header field-value string */
-                hdr_ptr = 1 + strchr(hdr_ptr, '\0');
-
-                /* Skip all null characters (with which the line
-                 * terminators had been overwritten) */
-                while (*hdr_ptr == '\0') {
-                    hdr_ptr++;
-                }
-            }
-            continue;
-        }
+/* Get a pointer to the value of a field in the request headers */
+esp_err_t httpd_req_get_hdr_view(httpd_req_t *r, const char *field, const char **val, size_t *val_len)
+{
+    if (r == NULL || field == NULL || val == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
 
-        /* Skip ':' */
-        val_ptr++;
+    if (!httpd_valid_req(r)) {
+        return ESP_ERR_HTTPD_INVALID_REQ;
+    }
 
-        /* Skip preceding space */
-        while ((*val_ptr != '\0') && (*val_ptr == ' ')) {
-            val_ptr++;
-        }
-        return strlen(val_ptr);
+    struct httpd_req_aux *ra = r->aux;
+    const struct req_hdr *hdr = httpd_req_find_hdr(ra, field);
+    if (hdr == NULL) {
+        return ESP_ERR_NOT_FOUND;
     }
-    return 0;
+
+    /* Request headers are kept in scratch buffer, with their
+     * terminators overwritten by null characters */
+    *val = ra->scratch + hdr->value;
+    if (val_len) {
+        *val_len = hdr->value_len;
+    }
+    return ESP_OK;
 }
 
 /* Get the value of a field from the request headers */
@@ -1062,59 +1128,19 @@ esp_err_t httpd_req_get_hdr_value_str(httpd_req_t *r, const char *field, char *v
     }
 
     struct httpd_req_aux *ra = r->aux;
-    const char   *hdr_ptr = ra->scratch;         /*!< Request headers are kept in scratch buffer */
-    unsigned     count    = ra->req_hdrs_count;  /*!< Count set during parsing  */
-    const size_t buf_len  = val_size;
-
-    while (count--) {
-        /* Search for the ':' character. Else, it would mean
-         * that the field is invalid
-         */
-        const char *val_ptr = strchr(hdr_ptr, ':');
-        if (!val_ptr) {
-            break;
-        }
-
-        /* If the field, does not match, continue searching.
-         * Compare lengths first as field from header is not
-         * null terminated (has ':' in the end).
-         */
-        if ((val_ptr - hdr_ptr != strlen(field)) ||
-            (strncasecmp(hdr_ptr, field, strlen(field)))) {
-            if (count) {
-                /* Jump to end of header field-value string */
-                hdr_ptr = 1 + strchr(hdr_ptr, '\0');
-
-                /* Skip all null characters (with which the line
-                 * terminators had been overwritten) */
-                while (*hdr_ptr == '\0') {
-                    hdr_ptr++;
-                }
-            }
-            continue;
-        }
-
-        /* Skip ':' */
-        val_ptr++;
-
-        /* Skip preceding space */
-        while ((*val_ptr != '\0') && (*val_ptr == ' ')) {
-            val_ptr++;
-        }
-
-        /* Get the NULL terminated value and copy it to the caller's buffer. */
-        strlcpy(val, val_ptr, buf_len);
+    const struct req_hdr *hdr = httpd_req_find_hdr(ra, field);
+    if (hdr == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
 
-        /* Update value length, including one byte for null */
-        val_size = strlen(val_ptr) + 1;
+    /* Get the NULL terminated value and copy it to the caller's buffer. */
+    strlcpy(val, ra->scratch + hdr->value, val_size);
 
-        /* If buffer length is smaller than needed, return truncation error */
-        if (buf_len < val_size) {
-            return ESP_ERR_HTTPD_RESULT_TRUNC;
-        }
-        return ESP_OK;
+    /* If buffer length is smaller than needed, return truncation error */
+    if (val_size < hdr->value_len + 1) {
+        return ESP_ERR_HTTPD_RESULT_TRUNC;
     }
-    return ESP_ERR_NOT_FOUND;
+    return ESP_OK;
 }
 
 /* Helper function to get a cookie value from a cookie string of the type "cookie1=val1; cookie2=val2" */
@@ -1181,27 +1207,13 @@ esp_err_t static httpd_cookie_key_value(const char *cookie_str, const char *key,
 /* Get the value of a cookie from the request headers */
 esp_err_t httpd_req_get_cookie_val(httpd_req_t *req, const char *cookie_name, char *val, size_t *val_size)
 {
-    esp_err_t ret;
-    size_t hdr_len_cookie = httpd_req_get_hdr_value_len(req, "Cookie");
-    char *cookie_str = NULL;
-
-    if (hdr_len_cookie <= 0) {
-        return ESP_ERR_NOT_FOUND;
-    }
-    cookie_str = malloc(hdr_len_cookie + 1);
-    if (cookie_str == NULL) {
-        ESP_LOGE(TAG, "Failed to allocate memory for cookie string");
-        return ESP_ERR_NO_MEM;
-    }
+    const char *cookie_str;
+    size_t hdr_len_cookie;
 
-    if (httpd_req_get_hdr_value_str(req, "Cookie", cookie_str, hdr_len_cookie + 1) != ESP_OK) {
-        ESP_LOGW(TAG, "Cookie not found in header uri:[%s]", req->uri);
-        free(cookie_str);
+    /* The cookie string is parsed in place, without copy */
+    if (httpd_req_get_hdr_view(req, "Cookie", &cookie_str, &hdr_len_cookie) != ESP_OK ||
+        hdr_len_cookie == 0) {
         return ESP_ERR_NOT_FOUND;
     }
-
-    ret = httpd_cookie_key_value(cookie_str, cookie_name, val, val_size);
-    free(cookie_str);
-    return ret;
-
+    return httpd_cookie_key_value(cookie_str, cookie_name, val, val_size);
 }
@@ -0,0 +1,321 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <esp_log.h>
+#include <esp_err.h>
+
+#include <esp_http_server.h>
+#include "esp_httpd_priv.h"
+
+static const char *TAG = "httpd_router";
+
+/*
+ * Index of the registered URI handlers
+ *
+ * The URI templates are stored in a radix tree: each node is reached from
+ * its parent by matching the characters of its label, or (for the parameter
+ * child) one non empty path segment of the URI. A template ends at the node
+ * reached by its fixed characters and parameter segments, where the trailing
+ * '?' and '*' of httpd_uri_match_wildcard() are kept as flags of the route.
+ *
+ * Looking up a URI walks down the tree along the URI, so the cost depends on
+ * the length of the URI and not on the number of handlers. As more than one
+ * template may match a URI, all the routes met on the way are checked and the
+ * handler registered first wins, like with a linear scan of hd_calls.
+ */
+
+#define ROUTE_ASTERISK  (1 << 0)    /* Any characters may follow */
+#define ROUTE_QUEST     (1 << 1)    /* The optional character may follow */
+
+struct httpd_router_route {
+    int      method;                /* Method of the handler (or HTTP_ANY) */
+    uint16_t index;                 /* Index of the handler in hd_calls */
+    uint8_t  flags;                 /* ROUTE_ASTERISK and ROUTE_QUEST */
+    char     optional;              /* Optional character, for ROUTE_QUEST */
+};
+
+struct httpd_router_node {
+    const char *label;              /* Characters to match from the parent (points into the URI template) */
+    size_t label_len;               /* Length of the label */
+    struct httpd_router_node **children;    /* Children reached by matching their label */
+    size_t children_count;          /* Number of children */
+    struct httpd_router_node *param;        /* Child reached by a parameter segment */
+    struct httpd_router_route *routes;      /* Templates ending at this node */
+    size_t routes_count;            /* Number of routes */
+};
+
+static void router_node_free(struct httpd_router_node *node)
+{
+    if (node == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < node->children_count; i++) {
+        router_node_free(node->children[i]);
+    }
+    router_node_free(node->param);
+    free(node->children);
+    free(node->routes);
+    free(node);
+}
+
+static struct httpd_router_node *router_node_new(const char *label, size_t label_len)
+{
+    struct httpd_router_node *node = calloc(1, sizeof(struct httpd_router_node));
+    if (node) {
+        node->label = label;
+        node->label_len = label_len;
+    }
+    return node;
+}
+
+static bool router_node_add_child(struct httpd_router_node *node, struct httpd_router_node *child)
+{
+    struct httpd_router_node **children = realloc(node->children, (node->children_count + 1) * sizeof(*children));
+    if (children == NULL) {
+        return false;
+    }
+    children[node->children_count++] = child;
+    node->children = children;
+    return true;
+}
+
+static struct httpd_router_node *router_node_find_child(const struct httpd_router_node *node, char first)
+{
+    for (size_t i = 0; i < node->children_count; i++) {
+        if (node->children[i]->label[0] == first) {
+            return node->children[i];
+        }
+    }
+    return NULL;
+}
+
+/* Returns the node reached from node by the characters of str, creating
+ * (and splitting) nodes as needed. NULL if out of memory */
+static struct httpd_router_node *router_insert_chars(struct httpd_router_node *node, const char *str, size_t len)
+{
+    while (len > 0) {
+        struct httpd_router_node *child = router_node_find_child(node, str[0]);
+        if (child == NULL) {
+            child = router_node_new(str, len);
+            if (child == NULL || !router_node_add_child(node, child)) {
+                free(child);
+                return NULL;
+            }
+            return child;
+        }
+
+        size_t common = 1;
+        while (common < len && common < child->label_len && str[common] == child->label[common]) {
+            common++;
+        }
+        if (common < child->label_len) {
+            /* Split the child: the common part of the label goes to a new node */
+            struct httpd_router_node *split = router_node_new(child->label, common);
+            if (split == NULL) {
+                return NULL;
+            }
+            split->children = malloc(sizeof(*split->children));
+            if (split->children == NULL) {
+                free(split);
+                return NULL;
+            }
+            split->children[0] = child;
+            split->children_count = 1;
+            for (size_t i = 0; i < node->children_count; i++) {
+                if (node->children[i] == child) {
+                    node->children[i] = split;
+                }
+            }
+            child->label += common;
+            child->label_len -= common;
+            child = split;
+        }
+        node = child;
+        str += common;
+        len -= common;
+    }
+    return node;
+}
+
+/* Adds the route of the template tail (after the last parameter), which
+ * is matched like httpd_uri_match_wildcard() does if wildcard is true */
+static bool router_insert_tail(struct httpd_router_node *node, const char *tail, bool wildcard,
+                               int method, uint16_t index)
+{
+    struct httpd_router_route route = {
+        .method = method,
+        .index = index,
+    };
+    size_t exact_len = strlen(tail);
+
+    if (wildcard) {
+        const char last = (exact_len > 0) ? tail[exact_len - 1] : 0;
+        const char prevlast = (exact_len > 1) ? tail[exact_len - 2] : 0;
+        const bool asterisk = last == '*' || (prevlast == '*' && last == '?');
+        const bool quest = last == '?' || (prevlast == '?' && last == '*');
+
+        if (exact_len < asterisk + quest * 2) {
+            /* Invalid template, never matches */
+            return true;
+        }
+        exact_len -= asterisk + quest * 2;
+        route.flags = (asterisk ? ROUTE_ASTERISK : 0) | (quest ? ROUTE_QUEST : 0);
+        route.optional = quest ? tail[exact_len] : 0;
+    }
+
+    node = router_insert_chars(node, tail, exact_len);
+    if (node == NULL) {
+        return false;
+    }
+    struct httpd_router_route *routes = realloc(node->routes, (node->routes_count + 1) * sizeof(*routes));
+    if (routes == NULL) {
+        return false;
+    }
+    routes[node->routes_count++] = route;
+    node->routes = routes;
+    return true;
+}
+
+static bool router_insert(struct httpd_router_node *root, const httpd_uri_t *uri_handler,
+                          uint16_t index, httpd_uri_match_func_t match_fn)
+{
+    struct httpd_router_node *node = root;
+    const char *tpl = uri_handler->uri;
+
+    if (match_fn == httpd_uri_match_params) {
+        const char *param;
+        size_t param_len;
+        while ((param = httpd_uri_find_param(tpl, &param_len)) != NULL) {
+            node = router_insert_chars(node, tpl, param - tpl);
+            if (node == NULL) {
+                return false;
+            }
+            if (node->param == NULL) {
+                node->param = router_node_new("", 0);
+                if (node->param == NULL) {
+                    return false;
+                }
+            }
+            node = node->param;
+            tpl = param + param_len;
+        }
+    }
+    return router_insert_tail(node, tpl, match_fn != NULL, uri_handler->method, index);
+}
+
+void httpd_router_free(struct httpd_data *hd)
+{
+    router_node_free(hd->hd_router);
+    hd->hd_router = NULL;
+}
+
+void httpd_router_rebuild(struct httpd_data *hd)
+{
+    httpd_router_free(hd);
+
+    /* Custom matching functions can not be indexed */
+    httpd_uri_match_func_t match_fn = hd->config.uri_match_fn;
+    if (match_fn != NULL && match_fn != httpd_uri_match_wildcard && match_fn != httpd_uri_match_params) {
+        return;
+    }
+
+    struct httpd_router_node *root = router_node_new("", 0);
+    if (root == NULL) {
+        goto err;
+    }
+    for (unsigned i = 0; i < hd->config.max_uri_handlers; i++) {
+        if (!hd->hd_calls[i]) {
+            break;
+        }
+        if (!router_insert(root, hd->hd_calls[i], i, match_fn)) {
+            goto err;
+        }
+    }
+    hd->hd_router = root;
+    return;
+
+err:
+    /* Handlers are still found by scanning them all */
+    ESP_LOGW(TAG, LOG_FMT("not enough memory to index URI handlers"));
+    router_node_free(root);
+}
+
+/* Result of a lookup */
+struct router_match {
+    int method;                     /* Method of the request */
+    unsigned index;                 /* Index of the matching handler found first */
+    bool uri_found;                 /* A template matches, maybe with another method */
+};
+
+static void router_check_routes(const struct httpd_router_node *node, const char *uri, size_t len,
+                                struct router_match *match)
+{
+    for (size_t i = 0; i < node->routes_count; i++) {
+        const struct httpd_router_route *route = &node->routes[i];
+        bool matches = (len == 0) || (route->flags == ROUTE_ASTERISK);
+        if (!matches && (route->flags & ROUTE_QUEST) && uri[0] == route->optional) {
+            matches = (route->flags & ROUTE_ASTERISK) || len == 1;
+        }
+        if (!matches) {
+            continue;
+        }
+        match->uri_found = true;
+        if ((route->method == match->method || route->method == HTTP_ANY) && route->index < match->index) {
+            match->index = route->index;
+        }
+    }
+}
+
+static void router_lookup(const struct httpd_router_node *node, const char *uri, size_t len,
+                          struct router_match *match)
+{
+    while (node) {
+        router_check_routes(node, uri, len, match);
+        if (len == 0) {
+            return;
+        }
+        if (node->param && uri[0] != '/') {
+            size_t value_len = 1;
+            while (value_len < len && uri[value_len] != '/') {
+                value_len++;
+            }
+            router_lookup(node->param, uri + value_len, len - value_len, match);
+        }
+
+        const struct httpd_router_node *child = router_node_find_child(node, uri[0]);
+        if (child == NULL || child->label_len > len || memcmp(child->label, uri, child->label_len) != 0) {
+            return;
+        }
+        uri += child->label_len;
+        len -= child->label_len;
+        node = child;
+    }
+}
+
+httpd_uri_t *httpd_router_find(struct httpd_data *hd, const char *uri, size_t uri_len,
+                               httpd_method_t method, httpd_err_code_t *err)
+{
+    struct router_match match = {
+        .method = method,
+        .index = UINT16_MAX + 1,
+        .uri_found = false,
+    };
+    router_lookup(hd->hd_router, uri, uri_len, &match);
+
+    if (match.index <= UINT16_MAX) {
+        if (err) {
+            *err = 0;
+        }
+        return hd->hd_calls[match.index];
+    }
+    if (err) {
+        *err = match.uri_found ? HTTPD_405_METHOD_NOT_ALLOWED : HTTPD_404_NOT_FOUND;
+    }
+    return NULL;
+}
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2018-2021 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -21,7 +21,6 @@ typedef enum {
     HTTPD_TASK_GET_ACTIVE,      // Get active session (fd!=-1)
     HTTPD_TASK_GET_FREE,        // Get free session slot (fd<0)
     HTTPD_TASK_FIND_FD,         // Find session with specific fd
-    HTTPD_TASK_SET_DESCRIPTOR,  // Set descriptor
     HTTPD_TASK_DELETE_INVALID,  // Delete invalid session
     HTTPD_TASK_FIND_LOWEST_LRU, // Find session with lowest lru
     HTTPD_TASK_CLOSE            // Close session
@@ -30,8 +29,6 @@ typedef enum {
 typedef struct {
     task_t task;
     int fd;
-    fd_set *fdset;
-    int max_fd;
     struct httpd_data *hd;
     uint64_t lru_counter;
     struct sock_db    *session;
@@ -86,18 +83,9 @@ static int enum_function(struct sock_db *session, void *context)
     case HTTPD_TASK_FIND_FD:
         found = (session->fd == ctx->fd);
         break;
-    // Set descriptor
-    case HTTPD_TASK_SET_DESCRIPTOR:
-        if (session->fd != -1 && !session->for_async_req) {
-            FD_SET(session->fd, ctx->fdset);
-            if (session->fd > ctx->max_fd) {
-                ctx->max_fd = session->fd;
-            }
-        }
-        break;
     // Delete invalid session
     case HTTPD_TASK_DELETE_INVALID:
-        if (!fd_is_valid(session->fd)) {
+        if (!session->dispatched && !fd_is_valid(session->fd)) {
             ESP_LOGW(TAG, LOG_FMT("Closing invalid socket %d"), session->fd);
             httpd_sess_delete(ctx->hd, session);
         }
@@ -109,7 +97,7 @@ static int enum_function(struct sock_db *session, void *context)
             return 0;
         }
         // Only close sockets that are not in use
-        if (session->for_async_req == false) {
+        if (session->for_async_req == false && session->dispatched == false) {
             // Check/update lowest lru
             if (session->lru_counter < ctx->lru_counter) {
                 ctx->lru_counter = session->lru_counter;
@@ -145,6 +133,11 @@ static void httpd_sess_close(void *arg)
         return;
     }
     sock_db->lru_socket = false;
+    if (sock_db->dispatched) {
+        // A worker is processing the session, close it when the worker is done
+        sock_db->close_requested = true;
+        return;
+    }
     struct httpd_data *hd = (struct httpd_data *) sock_db->handle;
     httpd_sess_delete(hd, sock_db);
 }
@@ -163,7 +156,7 @@ struct sock_db *httpd_sess_get_free(struct httpd_data *hd)
 
 bool httpd_is_sess_available(struct httpd_data *hd)
 {
-    return httpd_sess_get_free(hd) ? true : false;
+    return hd && (hd->hd_sd_active_count < hd->config.max_open_sockets);
 }
 
 struct sock_db *httpd_sess_get(struct httpd_data *hd, int sockfd)
@@ -174,8 +167,10 @@ struct sock_db *httpd_sess_get(struct httpd_data *hd, int sockfd)
 
     // Check if called inside a request handler, and the session sockfd in use is same as the parameter
     // => Just return the pointer to the sock_db corresponding to the request
-    if ((hd->hd_req_aux.sd) && (hd->hd_req_aux.sd->fd == sockfd)) {
-        return hd->hd_req_aux.sd;
+    httpd_req_t *r = httpd_req_current(hd);
+    struct httpd_req_aux *ra = r ? r->aux : NULL;
+    if ((ra) && (ra->sd) && (ra->sd->fd == sockfd)) {
+        return ra->sd;
     }
 
     enum_context_t context = {
@@ -221,6 +216,14 @@ esp_err_t httpd_sess_new(struct httpd_data *hd, int newfd)
         }
     }
 
+    if (poller_add(hd->hd_poller, session->fd, session) < 0) {
+        ESP_LOGE(TAG, LOG_FMT("error in adding fd = %d to poller (%d)"), newfd, errno);
+        httpd_sess_delete(hd, session);
+        return ESP_FAIL;
+    }
+    session->polled = true;
+    // open_fn may have already received data, e.g. during a TLS handshake
+    httpd_sess_watch(hd, session);
 
     ESP_LOGD(TAG, LOG_FMT("active sockets: %d"), hd->hd_sd_active_count);
     return ESP_OK;
@@ -268,9 +271,9 @@ void *httpd_sess_get_ctx(httpd_handle_t handle, int sockfd)
     // Check if the function has been called from inside a
     // request handler, in which case fetch the context from
     // the httpd_req_t structure
-    struct httpd_data *hd = (struct httpd_data *) handle;
-    if (hd->hd_req_aux.sd == session) {
-        return hd->hd_req.sess_ctx;
+    httpd_req_t *r = httpd_req_current(handle);
+    if (r && r->aux && ((struct httpd_req_aux *)r->aux)->sd == session) {
+        return r->sess_ctx;
     }
     return session->ctx;
 }
@@ -285,17 +288,17 @@ void httpd_sess_set_ctx(httpd_handle_t handle, int sockfd, void *ctx, httpd_free
     // Check if the function has been called from inside a
     // request handler, in which case set the context inside
     // the httpd_req_t structure
-    struct httpd_data *hd = (struct httpd_data *) handle;
-    if (hd->hd_req_aux.sd == session) {
-        if (hd->hd_req.sess_ctx != ctx) {
+    httpd_req_t *r = httpd_req_current(handle);
+    if (r && r->aux && ((struct httpd_req_aux *)r->aux)->sd == session) {
+        if (r->sess_ctx != ctx) {
             // Don't free previous context if it is in sockdb
             // as it will be freed inside httpd_req_cleanup()
-            if (session->ctx != hd->hd_req.sess_ctx) {
-                httpd_sess_free_ctx(&hd->hd_req.sess_ctx, hd->hd_req.free_ctx); // Free previous context
+            if (session->ctx != r->sess_ctx) {
+                httpd_sess_free_ctx(&r->sess_ctx, r->free_ctx); // Free previous context
             }
-            hd->hd_req.sess_ctx = ctx;
+            r->sess_ctx = ctx;
         }
-        hd->hd_req.free_ctx = free_fn;
+        r->free_ctx = free_fn;
         return;
     }
 
@@ -329,16 +332,39 @@ void httpd_sess_set_transport_ctx(httpd_handle_t handle, int sockfd, void *ctx,
     session->free_transport_ctx = free_fn;
 }
 
-void httpd_sess_set_descriptors(struct httpd_data *hd, fd_set *fdset, int *maxfd)
+void httpd_sess_list(struct httpd_data *hd, struct sock_db *session)
 {
-    enum_context_t context = {
-        .task = HTTPD_TASK_SET_DESCRIPTOR,
-        .max_fd = -1,
-        .fdset = fdset
-    };
-    httpd_sess_enum(hd, enum_function, &context);
-    if (maxfd) {
-        *maxfd = context.max_fd;
+    if (session->listed) {
+        return;
+    }
+    session->next_listed = hd->hd_sd_listed;
+    session->listed = true;
+    hd->hd_sd_listed = session;
+}
+
+static void httpd_sess_unlist(struct httpd_data *hd, struct sock_db *session)
+{
+    for (struct sock_db **prev = &hd->hd_sd_listed; *prev; prev = &(*prev)->next_listed) {
+        if (*prev == session) {
+            *prev = session->next_listed;
+            break;
+        }
+    }
+    session->listed = false;
+}
+
+void httpd_sess_watch(struct httpd_data *hd, struct sock_db *session)
+{
+    if (session->for_async_req) {
+        // The request is still being handled (and its data received) by another task,
+        // the server thread resumes polling the session when the request is completed
+        if (session->polled) {
+            poller_del(hd->hd_poller, session->fd);
+            session->polled = false;
+        }
+        httpd_sess_list(hd, session);
+    } else if (httpd_sess_pending(hd, session)) {
+        httpd_sess_list(hd, session);
     }
 }
 
@@ -358,6 +384,13 @@ void httpd_sess_delete(struct httpd_data *hd, struct sock_db *session)
     }
 
     ESP_LOGD(TAG, LOG_FMT("fd = %d"), session->fd);
+    if (session->polled) {
+        poller_del(hd->hd_poller, session->fd);
+        session->polled = false;
+    }
+    if (session->listed) {
+        httpd_sess_unlist(hd, session);
+    }
     if (hd->config.enable_so_linger) {
         struct linger so_linger = {
             .l_onoff = true,
@@ -417,22 +450,22 @@ bool httpd_sess_pending(struct httpd_data *hd, struct sock_db *session)
  * value is returned, everything related to this socket will be
  * cleaned up and the socket will be closed.
  */
-esp_err_t httpd_sess_process(struct httpd_data *hd, struct sock_db *session)
+esp_err_t httpd_sess_process(struct httpd_data *hd, struct sock_db *session,
+                             httpd_req_t *r, struct httpd_req_aux *ra)
 {
     if ((!hd) || (!session)) {
         return ESP_FAIL;
     }
 
     ESP_LOGD(TAG, LOG_FMT("httpd_req_new"));
-    if (httpd_req_new(hd, session) != ESP_OK) {
+    if (httpd_req_new(hd, r, ra, session) != ESP_OK) {
         return ESP_FAIL;
     }
     ESP_LOGD(TAG, LOG_FMT("httpd_req_delete"));
-    if (httpd_req_delete(hd) != ESP_OK) {
+    if (httpd_req_delete(r) != ESP_OK) {
         return ESP_FAIL;
     }
     ESP_LOGD(TAG, LOG_FMT("success"));
-    session->lru_counter = ++hd->lru_counter;
     return ESP_OK;
 }
 
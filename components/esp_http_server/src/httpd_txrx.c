@@ -225,80 +225,147 @@ esp_err_t httpd_resp_set_type(httpd_req_t *r, const char *type)
     return ESP_OK;
 }
 
-esp_err_t httpd_resp_send(httpd_req_t *r, const char *buf, ssize_t buf_len)
+/* Bodies and chunks up to this size are copied after the header section (or
+ * after the chunk size line) so that they are sent along with it, with a single
+ * call to send_fn. Larger ones are sent on their own, without copy. */
+#define HTTPD_RESP_GATHER_MAX_LEN  512
+
+/* Part of a response, sent by httpd_resp_send_gather() */
+struct resp_part {
+    const char *buf;
+    size_t len;
+};
+
+static char *httpd_resp_append(char *dest, const char *src, size_t len)
 {
-    if (r == NULL) {
-        return ESP_ERR_INVALID_ARG;
-    }
-
-    if (!httpd_valid_req(r)) {
-        return ESP_ERR_HTTPD_INVALID_REQ;
-    }
+    memcpy(dest, src, len);
+    return dest + len;
+}
 
+/**
+ * @brief   Sends the header section of the response, if length_hdr is not NULL,
+ *          followed by the given parts
+ *
+ * The status line, the essential headers, the additional headers set with
+ * httpd_resp_set_hdr() and the parts are gathered into one temporary buffer
+ * and sent at once, instead of sending every header field, separator and
+ * value on its own.
+ *
+ * @param[in] r          The request being responded to
+ * @param[in] length_hdr Content-Length or Transfer-Encoding header line (with
+ *                       CR LF), NULL if the header section was already sent
+ * @param[in] parts      Parts to send after the header section
+ * @param[in] count      Number of parts
+ *
+ * @return
+ *  - ESP_OK : on success
+ *  - ESP_ERR_HTTPD_RESP_HDR    : Essential headers are too large for internal buffer
+ *  - ESP_ERR_HTTPD_RESP_SEND   : Error in raw send
+ *  - ESP_ERR_HTTPD_ALLOC_MEM   : Unable to allocate the buffer
+ */
+static esp_err_t httpd_resp_send_gather(httpd_req_t *r, const char *length_hdr,
+                                        const struct resp_part *parts, size_t count)
+{
     struct httpd_req_aux *ra = r->aux;
-    const char *httpd_hdr_str = "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %d\r\n";
+    const char *status_prefix = "HTTP/1.1 ";
+    const char *content_type_prefix = "\r\nContent-Type: ";
     const char *colon_separator = ": ";
     const char *cr_lf_seperator = "\r\n";
 
-    if (buf_len == HTTPD_RESP_USE_STRLEN) {
-        buf_len = strlen(buf);
+    size_t required_size = 0;
+    if (length_hdr) {
+        required_size = strlen(status_prefix) + strlen(ra->status) + strlen(content_type_prefix) +
+                        strlen(ra->content_type) + strlen(cr_lf_seperator) + strlen(length_hdr);
+        /* Size of essential headers is limited by max_req_hdr_len. +1 for the null terminator */
+        if (required_size + 1 > ra->max_req_hdr_len) {
+            return ESP_ERR_HTTPD_RESP_HDR;
+        }
+        for (unsigned i = 0; i < ra->resp_hdrs_count; i++) {
+            required_size += strlen(ra->resp_hdrs[i].field) + strlen(colon_separator) +
+                             strlen(ra->resp_hdrs[i].value) + strlen(cr_lf_seperator);
+        }
+        /* End of header section */
+        required_size += strlen(cr_lf_seperator);
     }
-
-    /* Request headers are no longer available */
-    ra->req_hdrs_count = 0;
-
-    /* Calculate the size of the headers. +1 for the null terminator */
-    size_t required_size = snprintf(NULL, 0, httpd_hdr_str, ra->status, ra->content_type, buf_len) + 1;
-    if (required_size > ra->max_req_hdr_len) {
-        return ESP_ERR_HTTPD_RESP_HDR;
+    for (size_t i = 0; i < count; i++) {
+        required_size += parts[i].len;
     }
-    char *res_buf = malloc(required_size); /* Temporary buffer to store the headers */
+
+    char *res_buf = malloc(required_size); /* Temporary buffer to store the response */
     if (res_buf == NULL) {
         ESP_LOGE(TAG, "Unable to allocate httpd send buffer");
         return ESP_ERR_HTTPD_ALLOC_MEM;
     }
 
-    esp_err_t ret = snprintf(res_buf, required_size, httpd_hdr_str, ra->status, ra->content_type, buf_len);
-    if (ret < 0 || ret >= required_size) {
-        free(res_buf);
-        return ESP_ERR_HTTPD_RESP_HDR;
+    char *p = res_buf;
+    if (length_hdr) {
+        p = httpd_resp_append(p, status_prefix, strlen(status_prefix));
+        p = httpd_resp_append(p, ra->status, strlen(ra->status));
+        p = httpd_resp_append(p, content_type_prefix, strlen(content_type_prefix));
+        p = httpd_resp_append(p, ra->content_type, strlen(ra->content_type));
+        p = httpd_resp_append(p, cr_lf_seperator, strlen(cr_lf_seperator));
+        p = httpd_resp_append(p, length_hdr, strlen(length_hdr));
+        /* Additional headers based on set_header */
+        for (unsigned i = 0; i < ra->resp_hdrs_count; i++) {
+            p = httpd_resp_append(p, ra->resp_hdrs[i].field, strlen(ra->resp_hdrs[i].field));
+            p = httpd_resp_append(p, colon_separator, strlen(colon_separator));
+            p = httpd_resp_append(p, ra->resp_hdrs[i].value, strlen(ra->resp_hdrs[i].value));
+            p = httpd_resp_append(p, cr_lf_seperator, strlen(cr_lf_seperator));
+        }
+        p = httpd_resp_append(p, cr_lf_seperator, strlen(cr_lf_seperator));
     }
-    ESP_LOGD(TAG, "httpd send buffer size = %d", strlen(res_buf));
-    ret = httpd_send_all(r, res_buf, strlen(res_buf));
+    for (size_t i = 0; i < count; i++) {
+        if (parts[i].len) {
+            p = httpd_resp_append(p, parts[i].buf, parts[i].len);
+        }
+    }
+
+    ESP_LOGD(TAG, "httpd send buffer size = %"NEWLIB_NANO_COMPAT_FORMAT, NEWLIB_NANO_COMPAT_CAST(required_size));
+    esp_err_t ret = httpd_send_all(r, res_buf, required_size);
     free(res_buf);
     if (ret != ESP_OK) {
         return ESP_ERR_HTTPD_RESP_SEND;
     }
+    return ESP_OK;
+}
 
-    /* Sending additional headers based on set_header */
-    for (unsigned i = 0; i < ra->resp_hdrs_count; i++) {
-        /* Send header field */
-        if (httpd_send_all(r, ra->resp_hdrs[i].field, strlen(ra->resp_hdrs[i].field)) != ESP_OK) {
-            return ESP_ERR_HTTPD_RESP_SEND;
-        }
-        /* Send ': ' */
-        if (httpd_send_all(r, colon_separator, strlen(colon_separator)) != ESP_OK) {
-            return ESP_ERR_HTTPD_RESP_SEND;
-        }
-        /* Send header value */
-        if (httpd_send_all(r, ra->resp_hdrs[i].value, strlen(ra->resp_hdrs[i].value)) != ESP_OK) {
-            return ESP_ERR_HTTPD_RESP_SEND;
-        }
-        /* Send CR + LF */
-        if (httpd_send_all(r, cr_lf_seperator, strlen(cr_lf_seperator)) != ESP_OK) {
-            return ESP_ERR_HTTPD_RESP_SEND;
-        }
+esp_err_t httpd_resp_send(httpd_req_t *r, const char *buf, ssize_t buf_len)
+{
+    if (r == NULL) {
+        return ESP_ERR_INVALID_ARG;
     }
 
-    /* End header section */
-    if (httpd_send_all(r, cr_lf_seperator, strlen(cr_lf_seperator)) != ESP_OK) {
-        return ESP_ERR_HTTPD_RESP_SEND;
+    if (!httpd_valid_req(r)) {
+        return ESP_ERR_HTTPD_INVALID_REQ;
+    }
+
+    struct httpd_req_aux *ra = r->aux;
+
+    if (buf_len == HTTPD_RESP_USE_STRLEN) {
+        buf_len = strlen(buf);
+    }
+
+    /* Request headers are no longer available */
+    ra->req_hdrs_count = 0;
+
+    char length_hdr[32];
+    snprintf(length_hdr, sizeof(length_hdr), "Content-Length: %d\r\n", buf_len);
+
+    /* A small content is sent along with the headers */
+    struct resp_part content = {
+        .buf = buf,
+        .len = (buf && buf_len) ? buf_len : 0,
+    };
+    bool content_gathered = (content.len <= HTTPD_RESP_GATHER_MAX_LEN);
+    esp_err_t ret = httpd_resp_send_gather(r, length_hdr, &content, content_gathered ? 1 : 0);
+    if (ret != ESP_OK) {
+        return ret;
     }
     esp_http_server_dispatch_event(HTTP_SERVER_EVENT_HEADERS_SENT, &(ra->sd->fd), sizeof(int));
 
     /* Sending content */
-    if (buf && buf_len) {
-        if (httpd_send_all(r, buf, buf_len) != ESP_OK) {
+    if (!content_gathered) {
+        if (httpd_send_all(r, content.buf, content.len) != ESP_OK) {
             return ESP_ERR_HTTPD_RESP_SEND;
         }
     }
@@ -325,80 +392,36 @@ esp_err_t httpd_resp_send_chunk(httpd_req_t *r, const char *buf, ssize_t buf_len
     }
 
     struct httpd_req_aux *ra = r->aux;
-    const char *httpd_chunked_hdr_str = "HTTP/1.1 %s\r\nContent-Type: %s\r\nTransfer-Encoding: chunked\r\n";
-    const char *colon_separator = ": ";
-    const char *cr_lf_seperator = "\r\n";
+    const char *length_hdr = ra->first_chunk_sent ? NULL : "Transfer-Encoding: chunked\r\n";
 
     /* Request headers are no longer available */
     ra->req_hdrs_count = 0;
 
-    if (!ra->first_chunk_sent) {
-        /* Calculate the size of the headers. +1 for the null terminator */
-        size_t required_size = snprintf(NULL, 0, httpd_chunked_hdr_str, ra->status, ra->content_type) + 1;
-        if (required_size > ra->max_req_hdr_len) {
-            return ESP_ERR_HTTPD_RESP_HDR;
-        }
-        char *res_buf = malloc(required_size); /* Temporary buffer to store the headers */
-        if (res_buf == NULL) {
-            ESP_LOGE(TAG, "Unable to allocate httpd send chunk buffer");
-            return ESP_ERR_HTTPD_ALLOC_MEM;
-        }
-        esp_err_t ret = snprintf(res_buf, required_size, httpd_chunked_hdr_str, ra->status, ra->content_type);
-        if (ret < 0 || ret >= required_size) {
-            free(res_buf);
-            return ESP_ERR_HTTPD_RESP_HDR;
-        }
-        ESP_LOGD(TAG, "httpd send chunk buffer size = %d", strlen(res_buf));
-        /* Size of essential headers is limited by scratch buffer size */
-        ret = httpd_send_all(r, res_buf, strlen(res_buf));
-        free(res_buf);
-        if (ret != ESP_OK) {
-            return ESP_ERR_HTTPD_RESP_SEND;
-        }
-
-        /* Sending additional headers based on set_header */
-        for (unsigned i = 0; i < ra->resp_hdrs_count; i++) {
-            /* Send header field */
-            if (httpd_send_all(r, ra->resp_hdrs[i].field, strlen(ra->resp_hdrs[i].field)) != ESP_OK) {
-                return ESP_ERR_HTTPD_RESP_SEND;
-            }
-            /* Send ': ' */
-            if (httpd_send_all(r, colon_separator, strlen(colon_separator)) != ESP_OK) {
-                return ESP_ERR_HTTPD_RESP_SEND;
-            }
-            /* Send header value */
-            if (httpd_send_all(r, ra->resp_hdrs[i].value, strlen(ra->resp_hdrs[i].value)) != ESP_OK) {
-                return ESP_ERR_HTTPD_RESP_SEND;
-            }
-            /* Send CR + LF */
-            if (httpd_send_all(r, cr_lf_seperator, strlen(cr_lf_seperator)) != ESP_OK) {
-                return ESP_ERR_HTTPD_RESP_SEND;
-            }
-        }
-
-        /* End header section */
-        if (httpd_send_all(r, cr_lf_seperator, strlen(cr_lf_seperator)) != ESP_OK) {
-            return ESP_ERR_HTTPD_RESP_SEND;
-        }
-        ra->first_chunk_sent = true;
-    }
-
-    /* Sending chunked content */
+    /* The chunk size line, the chunk data and the end of chunk are sent
+     * at once (along with the headers for the first chunk), unless the
+     * chunk data is too large to be copied */
     char len_str[10];
     snprintf(len_str, sizeof(len_str), "%lx\r\n", (long)buf_len);
-    if (httpd_send_all(r, len_str, strlen(len_str)) != ESP_OK) {
-        return ESP_ERR_HTTPD_RESP_SEND;
+    struct resp_part chunk[] = {
+        { .buf = len_str, .len = strlen(len_str) },
+        { .buf = buf, .len = buf ? buf_len : 0 },
+        { .buf = "\r\n", .len = strlen("\r\n") },
+    };
+    bool chunk_gathered = (chunk[1].len <= HTTPD_RESP_GATHER_MAX_LEN);
+    esp_err_t ret = httpd_resp_send_gather(r, length_hdr, chunk, chunk_gathered ? 3 : 1);
+    if (ret != ESP_OK) {
+        return ret;
     }
+    ra->first_chunk_sent = true;
 
-    if (buf) {
-        if (httpd_send_all(r, buf, (size_t) buf_len) != ESP_OK) {
+    if (!chunk_gathered) {
+        if (httpd_send_all(r, chunk[1].buf, chunk[1].len) != ESP_OK) {
+            return ESP_ERR_HTTPD_RESP_SEND;
+        }
+        /* Indicate end of chunk */
+        if (httpd_send_all(r, chunk[2].buf, chunk[2].len) != ESP_OK) {
             return ESP_ERR_HTTPD_RESP_SEND;
         }
-    }
-
-    /* Indicate end of chunk */
-    if (httpd_send_all(r, "\r\n", strlen("\r\n")) != ESP_OK) {
-        return ESP_ERR_HTTPD_RESP_SEND;
     }
     esp_http_server_event_data evt_data = {
         .fd = ra->sd->fd,
@@ -655,6 +678,25 @@ esp_err_t httpd_req_async_handler_begin(httpd_req_t *r, httpd_req_t **out)
     }
     memcpy(async_aux->resp_hdrs, r_aux->resp_hdrs, hd->config.max_resp_headers * sizeof(struct resp_hdr));
 
+    // Copy the request headers, which are freed with the original request
+    async_aux->scratch = r_aux->scratch ? malloc(r_aux->scratch_cur_size) : NULL;
+    async_aux->req_hdrs = r_aux->req_hdrs ? malloc(r_aux->req_hdrs_size * sizeof(struct req_hdr)) : NULL;
+    if ((r_aux->scratch && async_aux->scratch == NULL) ||
+        (r_aux->req_hdrs && async_aux->req_hdrs == NULL)) {
+        free(async_aux->req_hdrs);
+        free(async_aux->scratch);
+        free(async_aux->resp_hdrs);
+        free(async_aux);
+        free(async);
+        return ESP_ERR_NO_MEM;
+    }
+    if (r_aux->scratch) {
+        memcpy(async_aux->scratch, r_aux->scratch, r_aux->scratch_cur_size);
+    }
+    if (r_aux->req_hdrs) {
+        memcpy(async_aux->req_hdrs, r_aux->req_hdrs, r_aux->req_hdrs_size * sizeof(struct req_hdr));
+    }
+
     // Prevent the main thread from reading the rest of the request after the handler returns.
     r_aux->remaining_len = 0;
 
@@ -666,6 +708,11 @@ esp_err_t httpd_req_async_handler_begin(httpd_req_t *r, httpd_req_t **out)
     return ESP_OK;
 }
 
+static void httpd_async_req_completed(void *arg)
+{
+    // Nothing to do, the sessions of completed requests are checked on each iteration of the server thread
+}
+
 esp_err_t httpd_req_async_handler_complete(httpd_req_t *r)
 {
     if (r == NULL) {
@@ -674,10 +721,13 @@ esp_err_t httpd_req_async_handler_complete(httpd_req_t *r)
 
     struct httpd_req_aux *ra = r->aux;
     ra->sd->for_async_req = false;
+    // Wake up the server thread, to wait again for data of the session
+    httpd_queue_work(r->handle, httpd_async_req_completed, NULL);
     free(ra->scratch);
     ra->scratch = NULL;
     ra->scratch_cur_size = 0;
     ra->scratch_size_limit = 0;
+    free(ra->req_hdrs);
     free(ra->resp_hdrs);
     free(r->aux);
     free(r);
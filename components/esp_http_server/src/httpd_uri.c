@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2018-2021 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -15,6 +15,42 @@
 
 static const char *TAG = "httpd_uri";
 
+/*
+ * Registered URI handlers
+ *
+ * hd_calls and hd_router are accessed under hd_uri_lock, as handlers may be
+ * registered and unregistered by any task while requests are processed (by
+ * the worker tasks). A request keeps using the handler found after releasing
+ * the lock, so handlers unregistered while any request is processed are only
+ * freed once no request is processed anymore.
+ */
+struct httpd_uri_entry {
+    httpd_uri_t uri;                        /* Handler, pointed to by hd_calls */
+    struct httpd_uri_entry *next_retired;   /* Next handler in hd_uri_retired */
+};
+
+static void httpd_uri_entry_free(struct httpd_data *hd, httpd_uri_t *uri)
+{
+    struct httpd_uri_entry *entry = (struct httpd_uri_entry *) uri;
+    if (hd->hd_uri_users > 0) {
+        entry->next_retired = hd->hd_uri_retired;
+        hd->hd_uri_retired = entry;
+        return;
+    }
+    free((char*)uri->uri);
+    free(entry);
+}
+
+static void httpd_uri_free_retired(struct httpd_data *hd)
+{
+    while (hd->hd_uri_retired) {
+        struct httpd_uri_entry *entry = hd->hd_uri_retired;
+        hd->hd_uri_retired = entry->next_retired;
+        free((char*)entry->uri.uri);
+        free(entry);
+    }
+}
+
 static bool httpd_uri_match_simple(const char *uri1, const char *uri2, size_t len2)
 {
     return strlen(uri1) == len2 &&          // First match lengths
@@ -80,6 +116,94 @@ bool httpd_uri_match_wildcard(const char *template, const char *uri, size_t len)
     }
 }
 
+const char *httpd_uri_find_param(const char *template, size_t *param_len)
+{
+    for (const char *start = strchr(template, '{'); start; start = strchr(start + 1, '{')) {
+        const size_t name_len = strcspn(start + 1, "{}/");
+        if (name_len > 0 && start[1 + name_len] == '}') {
+            *param_len = name_len + 2;
+            return start;
+        }
+    }
+    return NULL;
+}
+
+/* Match the parameter segments of the template, then the rest of it
+ * like httpd_uri_match_wildcard(). If name is not NULL, the value of
+ * the parameter segment with this name is set in value and value_len */
+static bool httpd_uri_match_params_get(const char *template, const char *uri, size_t len,
+                                       const char *name, const char **value, size_t *value_len)
+{
+    const char *param;
+    size_t param_len;
+
+    while ((param = httpd_uri_find_param(template, &param_len)) != NULL) {
+        /* Characters before the parameter must match exactly */
+        const size_t literal_len = param - template;
+        if (len < literal_len || memcmp(template, uri, literal_len) != 0) {
+            return false;
+        }
+        uri += literal_len;
+        len -= literal_len;
+
+        /* The parameter spans up to the next '/', and may not be empty */
+        size_t segment_len = 0;
+        while (segment_len < len && uri[segment_len] != '/') {
+            segment_len++;
+        }
+        if (segment_len == 0) {
+            return false;
+        }
+        if (name && strlen(name) == param_len - 2 && strncmp(name, param + 1, param_len - 2) == 0) {
+            *value = uri;
+            *value_len = segment_len;
+        }
+        uri += segment_len;
+        len -= segment_len;
+        template = param + param_len;
+    }
+    return httpd_uri_match_wildcard(template, uri, len);
+}
+
+bool httpd_uri_match_params(const char *template, const char *uri, size_t len)
+{
+    return httpd_uri_match_params_get(template, uri, len, NULL, NULL, NULL);
+}
+
+esp_err_t httpd_req_get_uri_param(httpd_req_t *r, const char *name, char *val, size_t val_size)
+{
+    if (r == NULL || name == NULL || val == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!httpd_valid_req(r)) {
+        return ESP_ERR_HTTPD_INVALID_REQ;
+    }
+
+    struct httpd_req_aux   *ra  = r->aux;
+    struct http_parser_url *res = &ra->url_parse_res;
+
+    /* Parameters are only known if the handler was matched by httpd_uri_match_params() */
+    if (ra->uri_template == NULL || !(res->field_set & (1 << UF_PATH))) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    const char *value = NULL;
+    size_t value_len = 0;
+    if (!httpd_uri_match_params_get(ra->uri_template, r->uri + res->field_data[UF_PATH].off,
+                                    res->field_data[UF_PATH].len, name, &value, &value_len) || value == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    /* Minimum required buffer len for keeping
+     * null terminated value string */
+    strlcpy(val, value, MIN(val_size, value_len + 1));
+    if (val_size < value_len + 1) {
+        return ESP_ERR_HTTPD_RESULT_TRUNC;
+    }
+    return ESP_OK;
+}
+
 /* Find handler with matching URI and method, and set
  * appropriate error code if URI or method not found */
 static httpd_uri_t* httpd_find_uri_handler(struct httpd_data *hd,
@@ -87,6 +211,11 @@ static httpd_uri_t* httpd_find_uri_handler(struct httpd_data *hd,
                                            httpd_method_t method,
                                            httpd_err_code_t *err)
 {
+    /* Use the index of the handlers if it could be built */
+    if (hd->hd_router) {
+        return httpd_router_find(hd, uri, uri_len, method, err);
+    }
+
     if (err) {
         *err = HTTPD_404_NOT_FOUND;
     }
@@ -123,20 +252,14 @@ static httpd_uri_t* httpd_find_uri_handler(struct httpd_data *hd,
     return NULL;
 }
 
-esp_err_t httpd_register_uri_handler(httpd_handle_t handle,
-                                     const httpd_uri_t *uri_handler)
+static esp_err_t httpd_register_uri_handler_locked(struct httpd_data *hd,
+                                                   const httpd_uri_t *uri_handler)
 {
-    if (handle == NULL || uri_handler == NULL) {
-        return ESP_ERR_INVALID_ARG;
-    }
-
-    struct httpd_data *hd = (struct httpd_data *) handle;
-
     /* Make sure another handler with matching URI and method
      * is not already registered. This will also catch cases
      * when a registered URI wildcard pattern already accounts
      * for the new URI being registered */
-    if (httpd_find_uri_handler(handle, uri_handler->uri,
+    if (httpd_find_uri_handler(hd, uri_handler->uri,
                                strlen(uri_handler->uri),
                                uri_handler->method, NULL) != NULL) {
         ESP_LOGW(TAG, LOG_FMT("handler %s with method %d already registered"),
@@ -147,18 +270,20 @@ esp_err_t httpd_register_uri_handler(httpd_handle_t handle,
     for (int i = 0; i < hd->config.max_uri_handlers; i++) {
         if (hd->hd_calls[i] == NULL) {
             ESP_COMPILER_DIAGNOSTIC_PUSH_IGNORE("-Wanalyzer-malloc-leak") // False-positive detection. TODO GCC-366
-            hd->hd_calls[i] = malloc(sizeof(httpd_uri_t));
-            if (hd->hd_calls[i] == NULL) {
+            struct httpd_uri_entry *entry = malloc(sizeof(struct httpd_uri_entry));
+            if (entry == NULL) {
                 /* Failed to allocate memory */
                 return ESP_ERR_HTTPD_ALLOC_MEM;
             }
+            hd->hd_calls[i] = &entry->uri;
             ESP_COMPILER_DIAGNOSTIC_POP("-Wanalyzer-malloc-leak")
 
             /* Copy URI string */
             hd->hd_calls[i]->uri = strdup(uri_handler->uri);
             if (hd->hd_calls[i]->uri == NULL) {
                 /* Failed to allocate memory */
-                free(hd->hd_calls[i]);
+                free(entry);
+                hd->hd_calls[i] = NULL;
                 return ESP_ERR_HTTPD_ALLOC_MEM;
             }
 
@@ -176,6 +301,7 @@ esp_err_t httpd_register_uri_handler(httpd_handle_t handle,
             }
 #endif
             ESP_LOGD(TAG, LOG_FMT("[%d] installed %s"), i, uri_handler->uri);
+            httpd_router_rebuild(hd);
             return ESP_OK;
         }
         ESP_LOGD(TAG, LOG_FMT("[%d] exists %s"), i, hd->hd_calls[i]->uri);
@@ -184,14 +310,23 @@ esp_err_t httpd_register_uri_handler(httpd_handle_t handle,
     return ESP_ERR_HTTPD_HANDLERS_FULL;
 }
 
-esp_err_t httpd_unregister_uri_handler(httpd_handle_t handle,
-                                       const char *uri, httpd_method_t method)
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle,
+                                     const httpd_uri_t *uri_handler)
 {
-    if (handle == NULL || uri == NULL) {
+    if (handle == NULL || uri_handler == NULL) {
         return ESP_ERR_INVALID_ARG;
     }
 
     struct httpd_data *hd = (struct httpd_data *) handle;
+    xSemaphoreTake(hd->hd_uri_lock, portMAX_DELAY);
+    esp_err_t ret = httpd_register_uri_handler_locked(hd, uri_handler);
+    xSemaphoreGive(hd->hd_uri_lock);
+    return ret;
+}
+
+static esp_err_t httpd_unregister_uri_handler_locked(struct httpd_data *hd,
+                                                     const char *uri, httpd_method_t method)
+{
     for (int i = 0; i < hd->config.max_uri_handlers; i++) {
         if (!hd->hd_calls[i]) {
             break;
@@ -200,8 +335,7 @@ esp_err_t httpd_unregister_uri_handler(httpd_handle_t handle,
             (strcmp(hd->hd_calls[i]->uri, uri) == 0)) {  // Then match URI string
             ESP_LOGD(TAG, LOG_FMT("[%d] removing %s"), i, hd->hd_calls[i]->uri);
 
-            free((char*)hd->hd_calls[i]->uri);
-            free(hd->hd_calls[i]);
+            httpd_uri_entry_free(hd, hd->hd_calls[i]);
             hd->hd_calls[i] = NULL;
 
             /* Shift the remaining non null handlers in the array
@@ -214,6 +348,7 @@ esp_err_t httpd_unregister_uri_handler(httpd_handle_t handle,
             }
             /* Nullify the following non null entry */
             hd->hd_calls[i-1] = NULL;
+            httpd_router_rebuild(hd);
             return ESP_OK;
         }
     }
@@ -221,13 +356,22 @@ esp_err_t httpd_unregister_uri_handler(httpd_handle_t handle,
     return ESP_ERR_NOT_FOUND;
 }
 
-esp_err_t httpd_unregister_uri(httpd_handle_t handle, const char *uri)
+esp_err_t httpd_unregister_uri_handler(httpd_handle_t handle,
+                                       const char *uri, httpd_method_t method)
 {
     if (handle == NULL || uri == NULL) {
         return ESP_ERR_INVALID_ARG;
     }
 
     struct httpd_data *hd = (struct httpd_data *) handle;
+    xSemaphoreTake(hd->hd_uri_lock, portMAX_DELAY);
+    esp_err_t ret = httpd_unregister_uri_handler_locked(hd, uri, method);
+    xSemaphoreGive(hd->hd_uri_lock);
+    return ret;
+}
+
+static esp_err_t httpd_unregister_uri_locked(struct httpd_data *hd, const char *uri)
+{
     bool found = false;
 
     int i = 0, j = 0; // For keeping count of removed entries
@@ -238,8 +382,7 @@ esp_err_t httpd_unregister_uri(httpd_handle_t handle, const char *uri)
         if (strcmp(hd->hd_calls[i]->uri, uri) == 0) {   // Match URI strings
             ESP_LOGD(TAG, LOG_FMT("[%d] removing %s"), i, uri);
 
-            free((char*)hd->hd_calls[i]->uri);
-            free(hd->hd_calls[i]);
+            httpd_uri_entry_free(hd, hd->hd_calls[i]);
             hd->hd_calls[i] = NULL;
             found = true;
 
@@ -255,42 +398,47 @@ esp_err_t httpd_unregister_uri(httpd_handle_t handle, const char *uri)
         hd->hd_calls[k] = NULL;
     }
 
-    if (!found) {
+    if (found) {
+        httpd_router_rebuild(hd);
+    } else {
         ESP_LOGW(TAG, LOG_FMT("no handler found for URI %s"), uri);
     }
     return (found ? ESP_OK : ESP_ERR_NOT_FOUND);
 }
 
+esp_err_t httpd_unregister_uri(httpd_handle_t handle, const char *uri)
+{
+    if (handle == NULL || uri == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    struct httpd_data *hd = (struct httpd_data *) handle;
+    xSemaphoreTake(hd->hd_uri_lock, portMAX_DELAY);
+    esp_err_t ret = httpd_unregister_uri_locked(hd, uri);
+    xSemaphoreGive(hd->hd_uri_lock);
+    return ret;
+}
+
+/* Called once the server and worker tasks are stopped */
 void httpd_unregister_all_uri_handlers(struct httpd_data *hd)
 {
+    httpd_router_free(hd);
     for (unsigned i = 0; i < hd->config.max_uri_handlers; i++) {
         if (!hd->hd_calls[i]) {
             break;
         }
         ESP_LOGD(TAG, LOG_FMT("[%d] removing %s"), i, hd->hd_calls[i]->uri);
 
-        free((char*)hd->hd_calls[i]->uri);
-        free(hd->hd_calls[i]);
+        httpd_uri_entry_free(hd, hd->hd_calls[i]);
         hd->hd_calls[i] = NULL;
     }
+    httpd_uri_free_retired(hd);
 }
 
-esp_err_t httpd_uri(struct httpd_data *hd)
+static esp_err_t httpd_uri_invoke(struct httpd_data *hd, httpd_req_t *req,
+                                  httpd_uri_t *uri, httpd_err_code_t err)
 {
-    httpd_uri_t            *uri = NULL;
-    httpd_req_t            *req = &hd->hd_req;
-    struct http_parser_url *res = &hd->hd_req_aux.url_parse_res;
-
-    /* For conveying URI not found/method not allowed */
-    httpd_err_code_t err = 0;
-
-    ESP_LOGD(TAG, LOG_FMT("request for %s with type %d"), req->uri, req->method);
-
-    /* URL parser result contains offset and length of path string */
-    if (res->field_set & (1 << UF_PATH)) {
-        uri = httpd_find_uri_handler(hd, req->uri + res->field_data[UF_PATH].off,
-                                     res->field_data[UF_PATH].len, req->method, &err);
-    }
+    struct httpd_req_aux   *ra  = req->aux;
 
     /* If URI with method not found, respond with error code */
     if (uri == NULL) {
@@ -310,12 +458,15 @@ esp_err_t httpd_uri(struct httpd_data *hd)
     /* Attach user context data (passed during URI registration) into request */
     req->user_ctx = uri->user_ctx;
 
+    /* Keep the template for httpd_req_get_uri_param() */
+    ra->uri_template = (hd->config.uri_match_fn == httpd_uri_match_params) ? uri->uri : NULL;
+
     /* Final step for a WebSocket handshake verification */
 #ifdef CONFIG_HTTPD_WS_SUPPORT
     struct httpd_req_aux   *aux = req->aux;
     if (uri->is_websocket && aux->ws_handshake_detect && uri->method == HTTP_GET) {
         ESP_LOGD(TAG, LOG_FMT("Responding WS handshake to sock %d"), aux->sd->fd);
-        esp_err_t ret = httpd_ws_respond_server_handshake(&hd->hd_req, uri->supported_subprotocol);
+        esp_err_t ret = httpd_ws_respond_server_handshake(req, uri->supported_subprotocol);
         if (ret != ESP_OK) {
             return ret;
         }
@@ -335,3 +486,34 @@ esp_err_t httpd_uri(struct httpd_data *hd)
     }
     return ESP_OK;
 }
+
+esp_err_t httpd_uri(struct httpd_data *hd, httpd_req_t *req)
+{
+    httpd_uri_t            *uri = NULL;
+    struct httpd_req_aux   *ra  = req->aux;
+    struct http_parser_url *res = &ra->url_parse_res;
+
+    /* For conveying URI not found/method not allowed */
+    httpd_err_code_t err = 0;
+
+    ESP_LOGD(TAG, LOG_FMT("request for %s with type %d"), req->uri, req->method);
+
+    xSemaphoreTake(hd->hd_uri_lock, portMAX_DELAY);
+    /* URL parser result contains offset and length of path string */
+    if (res->field_set & (1 << UF_PATH)) {
+        uri = httpd_find_uri_handler(hd, req->uri + res->field_data[UF_PATH].off,
+                                     res->field_data[UF_PATH].len, req->method, &err);
+    }
+    /* The handler found is not freed until the request is done with it */
+    hd->hd_uri_users++;
+    xSemaphoreGive(hd->hd_uri_lock);
+
+    esp_err_t ret = httpd_uri_invoke(hd, req, uri, err);
+
+    xSemaphoreTake(hd->hd_uri_lock, portMAX_DELAY);
+    if (--hd->hd_uri_users == 0) {
+        httpd_uri_free_retired(hd);
+    }
+    xSemaphoreGive(hd->hd_uri_lock);
+    return ret;
+}
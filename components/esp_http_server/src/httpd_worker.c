@@ -0,0 +1,320 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+#include <esp_log.h>
+#include <esp_err.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+
+#include <esp_http_server.h>
+#include "esp_httpd_priv.h"
+
+static const char *TAG = "httpd_worker";
+
+/*
+ * Worker tasks
+ *
+ * The server task queues the sessions having data to the work queue, after
+ * removing their descriptor from the poller: a session is then processed by
+ * one worker at a time, and its requests are processed in order. When done,
+ * the worker queues the session and the result of the processing to the done
+ * queue, and wakes up the server task with a work item (only if the server
+ * task has not been woken up already), which then deletes the session or
+ * waits again for its data.
+ *
+ * Each worker has its own request structure, httpd_req_current() returns the
+ * one of the calling task for the functions called by the request handlers.
+ *
+ * The WebSocket frames may also be sent to a session by the server task (work
+ * functions) or any other task while a worker processes the session, so they
+ * are sent under a lock of the session.
+ */
+
+struct httpd_work_item {
+    struct sock_db *session;    /* Session to process, NULL to stop the worker */
+    int64_t queued_time;        /* Time of queueing to the work queue */
+};
+
+struct httpd_done_item {
+    struct sock_db *session;    /* Session processed */
+    esp_err_t ret;              /* Result of httpd_sess_process() */
+};
+
+struct httpd_worker {
+    struct httpd_data *hd;      /* Server instance data */
+    struct thread_data td;      /* Information for the worker task */
+    struct httpd_req req;       /* Request processed by the worker */
+    struct httpd_req_aux aux;   /* Auxiliary data of the request */
+};
+
+struct httpd_workers {
+    QueueHandle_t work_queue;   /* Sessions to process (struct httpd_work_item) */
+    QueueHandle_t done_queue;   /* Sessions processed (struct httpd_done_item) */
+    SemaphoreHandle_t lock;     /* Protects stats and wake */
+    SemaphoreHandle_t *send_locks;  /* Lock of the frames sent to each session (indexed like hd_sd) */
+    httpd_worker_stats_t stats; /* Statistics of the workers */
+    bool wake;                  /* The server task has been woken up for the done queue */
+    int count;                  /* Number of workers */
+    struct httpd_worker workers[];
+};
+
+/* Work function waking up the server task, which then checks the done queue */
+static void httpd_workers_wake(void *arg)
+{
+}
+
+static void httpd_worker_thread(void *arg)
+{
+    struct httpd_worker *w = (struct httpd_worker *) arg;
+    struct httpd_data *hd = w->hd;
+    struct httpd_workers *ws = hd->hd_workers;
+    w->td.status = THREAD_RUNNING;
+
+    struct httpd_work_item item;
+    while (xQueueReceive(ws->work_queue, &item, portMAX_DELAY) == pdTRUE && item.session) {
+        int64_t start = esp_timer_get_time();
+        xSemaphoreTake(ws->lock, portMAX_DELAY);
+        uint32_t wait = start - item.queued_time;
+        ws->stats.queued--;
+        ws->stats.total_wait_us += wait;
+        ws->stats.max_wait_us = MAX(ws->stats.max_wait_us, wait);
+        xSemaphoreGive(ws->lock);
+
+        ESP_LOGD(TAG, LOG_FMT("processing socket %d"), item.session->fd);
+        struct httpd_done_item done = {
+            .session = item.session,
+            .ret = httpd_sess_process(hd, item.session, &w->req, &w->aux),
+        };
+        uint32_t process = esp_timer_get_time() - start;
+        xQueueSend(ws->done_queue, &done, portMAX_DELAY);
+
+        xSemaphoreTake(ws->lock, portMAX_DELAY);
+        ws->stats.processed++;
+        ws->stats.total_process_us += process;
+        ws->stats.max_process_us = MAX(ws->stats.max_process_us, process);
+        bool wake = !ws->wake;
+        ws->wake = true;
+        xSemaphoreGive(ws->lock);
+        if (wake && httpd_queue_work(hd, httpd_workers_wake, NULL) != ESP_OK) {
+            ESP_LOGE(TAG, LOG_FMT("failed to wake up the server task"));
+            xSemaphoreTake(ws->lock, portMAX_DELAY);
+            ws->wake = false;
+            xSemaphoreGive(ws->lock);
+        }
+    }
+
+    ESP_LOGD(TAG, LOG_FMT("worker exiting"));
+    w->td.status = THREAD_STOPPED;
+    httpd_os_thread_delete();
+}
+
+static void httpd_workers_free(struct httpd_data *hd, struct httpd_workers *ws)
+{
+    for (int i = 0; i < ws->count; i++) {
+        free(ws->workers[i].aux.resp_hdrs);
+    }
+    if (ws->send_locks) {
+        for (int i = 0; i < hd->config.max_open_sockets; i++) {
+            if (ws->send_locks[i]) {
+                vSemaphoreDelete(ws->send_locks[i]);
+            }
+        }
+        free(ws->send_locks);
+    }
+    if (ws->work_queue) {
+        vQueueDelete(ws->work_queue);
+    }
+    if (ws->done_queue) {
+        vQueueDelete(ws->done_queue);
+    }
+    if (ws->lock) {
+        vSemaphoreDelete(ws->lock);
+    }
+    free(ws);
+}
+
+esp_err_t httpd_workers_start(struct httpd_data *hd)
+{
+    int count = hd->config.worker_count;
+    if (count == 0) {
+        return ESP_OK;
+    }
+
+    struct httpd_workers *ws = calloc(1, sizeof(struct httpd_workers) + count * sizeof(struct httpd_worker));
+    if (!ws) {
+        ESP_LOGE(TAG, LOG_FMT("Failed to allocate memory for HTTP workers"));
+        return ESP_ERR_HTTPD_ALLOC_MEM;
+    }
+    /* A session is queued once at a time, plus the stop request of each worker */
+    ws->work_queue = xQueueCreate(hd->config.max_open_sockets + count, sizeof(struct httpd_work_item));
+    ws->done_queue = xQueueCreate(hd->config.max_open_sockets, sizeof(struct httpd_done_item));
+    ws->lock = xSemaphoreCreateMutex();
+    ws->send_locks = calloc(hd->config.max_open_sockets, sizeof(SemaphoreHandle_t));
+    if (!ws->work_queue || !ws->done_queue || !ws->lock || !ws->send_locks) {
+        ESP_LOGE(TAG, LOG_FMT("Failed to create HTTP worker queues"));
+        httpd_workers_free(hd, ws);
+        return ESP_ERR_HTTPD_ALLOC_MEM;
+    }
+    for (int i = 0; i < hd->config.max_open_sockets; i++) {
+        ws->send_locks[i] = xSemaphoreCreateMutex();
+        if (!ws->send_locks[i]) {
+            ESP_LOGE(TAG, LOG_FMT("Failed to create HTTP session locks"));
+            httpd_workers_free(hd, ws);
+            return ESP_ERR_HTTPD_ALLOC_MEM;
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        struct httpd_worker *w = &ws->workers[i];
+        w->aux.resp_hdrs = calloc(hd->config.max_resp_headers, sizeof(struct resp_hdr));
+        if (!w->aux.resp_hdrs) {
+            ESP_LOGE(TAG, LOG_FMT("Failed to allocate memory for HTTP response headers"));
+            httpd_workers_free(hd, ws);
+            return ESP_ERR_HTTPD_ALLOC_MEM;
+        }
+        w->hd = hd;
+        ws->count++;
+    }
+
+    hd->hd_workers = ws;
+    for (int i = 0; i < count; i++) {
+        struct httpd_worker *w = &ws->workers[i];
+        if (httpd_os_thread_create(&w->td.handle, "httpd_worker",
+                                   hd->config.stack_size,
+                                   hd->config.task_priority,
+                                   httpd_worker_thread, w,
+                                   hd->config.core_id,
+                                   hd->config.task_caps) != ESP_OK) {
+            ESP_LOGE(TAG, LOG_FMT("Failed to launch HTTP worker task"));
+            /* Only stop the workers already running */
+            for (int j = i; j < count; j++) {
+                free(ws->workers[j].aux.resp_hdrs);
+            }
+            ws->count = i;
+            httpd_workers_stop(hd);
+            return ESP_ERR_HTTPD_TASK;
+        }
+    }
+    return ESP_OK;
+}
+
+void httpd_workers_stop(struct httpd_data *hd)
+{
+    struct httpd_workers *ws = hd->hd_workers;
+    if (!ws) {
+        return;
+    }
+
+    /* The workers stop after processing the sessions already queued */
+    struct httpd_work_item item = {
+        .session = NULL,
+    };
+    for (int i = 0; i < ws->count; i++) {
+        xQueueSend(ws->work_queue, &item, portMAX_DELAY);
+    }
+    for (int i = 0; i < ws->count; i++) {
+        while (ws->workers[i].td.status != THREAD_STOPPED) {
+            httpd_os_thread_sleep(10);
+        }
+    }
+
+    /* The sessions are then closed by the server task */
+    struct httpd_done_item done;
+    while (xQueueReceive(ws->done_queue, &done, 0) == pdTRUE) {
+        done.session->dispatched = false;
+    }
+    hd->hd_workers = NULL;
+    httpd_workers_free(hd, ws);
+}
+
+void httpd_workers_dispatch(struct httpd_data *hd, struct sock_db *session)
+{
+    struct httpd_workers *ws = hd->hd_workers;
+    struct httpd_work_item item = {
+        .session = session,
+        .queued_time = esp_timer_get_time(),
+    };
+
+    xSemaphoreTake(ws->lock, portMAX_DELAY);
+    ws->stats.queued++;
+    ws->stats.max_queued = MAX(ws->stats.max_queued, ws->stats.queued);
+    xSemaphoreGive(ws->lock);
+
+    session->dispatched = true;
+    /* Does not block: each session is queued once at a time */
+    xQueueSend(ws->work_queue, &item, portMAX_DELAY);
+}
+
+struct sock_db *httpd_workers_get_done(struct httpd_data *hd, esp_err_t *ret)
+{
+    struct httpd_workers *ws = hd->hd_workers;
+    /* Any session queued from now on wakes up the server task again */
+    xSemaphoreTake(ws->lock, portMAX_DELAY);
+    ws->wake = false;
+    xSemaphoreGive(ws->lock);
+
+    struct httpd_done_item done;
+    if (xQueueReceive(ws->done_queue, &done, 0) != pdTRUE) {
+        return NULL;
+    }
+    done.session->dispatched = false;
+    *ret = done.ret;
+    return done.session;
+}
+
+void httpd_workers_lock_send(struct httpd_data *hd, struct sock_db *session)
+{
+    struct httpd_workers *ws = hd->hd_workers;
+    if (ws) {
+        xSemaphoreTake(ws->send_locks[session - hd->hd_sd], portMAX_DELAY);
+    }
+}
+
+void httpd_workers_unlock_send(struct httpd_data *hd, struct sock_db *session)
+{
+    struct httpd_workers *ws = hd->hd_workers;
+    if (ws) {
+        xSemaphoreGive(ws->send_locks[session - hd->hd_sd]);
+    }
+}
+
+httpd_req_t *httpd_req_current(struct httpd_data *hd)
+{
+    othread_t self = httpd_os_thread_handle();
+    if (self == hd->hd_td.handle) {
+        return &hd->hd_req;
+    }
+    struct httpd_workers *ws = hd->hd_workers;
+    if (ws) {
+        for (int i = 0; i < ws->count; i++) {
+            if (self == ws->workers[i].td.handle) {
+                return &ws->workers[i].req;
+            }
+        }
+    }
+    return NULL;
+}
+
+esp_err_t httpd_get_worker_stats(httpd_handle_t handle, httpd_worker_stats_t *stats)
+{
+    struct httpd_data *hd = (struct httpd_data *) handle;
+    if (hd == NULL || stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct httpd_workers *ws = hd->hd_workers;
+    if (ws == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    xSemaphoreTake(ws->lock, portMAX_DELAY);
+    *stats = ws->stats;
+    xSemaphoreGive(ws->lock);
+    return ESP_OK;
+}
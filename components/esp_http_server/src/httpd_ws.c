@@ -415,21 +415,22 @@ esp_err_t httpd_ws_send_frame_async(httpd_handle_t hd, int fd, httpd_ws_frame_t
         return ESP_ERR_INVALID_ARG;
     }
 
-    /* Send off header */
+    /* Frames sent by another task must not interleave with those of a worker */
+    esp_err_t ret = ESP_OK;
+    httpd_workers_lock_send(hd, sess);
+
+    /* Send off header, then payload */
     if (sess->send_fn(hd, fd, (const char *)header_buf, tx_len, 0) < 0) {
         ESP_LOGW(TAG, LOG_FMT("Failed to send WS header"));
-        return ESP_FAIL;
+        ret = ESP_FAIL;
+    } else if (frame->len > 0 && frame->payload != NULL &&
+               sess->send_fn(hd, fd, (const char *)frame->payload, frame->len, 0) < 0) {
+        ESP_LOGW(TAG, LOG_FMT("Failed to send WS payload"));
+        ret = ESP_FAIL;
     }
 
-    /* Send off payload */
-    if(frame->len > 0 && frame->payload != NULL) {
-        if (sess->send_fn(hd, fd, (const char *)frame->payload, frame->len, 0) < 0) {
-            ESP_LOGW(TAG, LOG_FMT("Failed to send WS payload"));
-            return ESP_FAIL;
-        }
-    }
-
-    return ESP_OK;
+    httpd_workers_unlock_send(hd, sess);
+    return ret;
 }
 
 esp_err_t httpd_ws_get_frame_type(httpd_req_t *req)
@@ -0,0 +1,142 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/param.h>
+#include "poller.h"
+
+#if POLLER_USE_EPOLL
+
+#include <sys/epoll.h>
+
+struct poller {
+    int epfd;
+    int max_events;
+    struct epoll_event events[];
+};
+
+poller_t *poller_create(int max_events)
+{
+    poller_t *p = malloc(sizeof(poller_t) + max_events * sizeof(struct epoll_event));
+    if (p == NULL) {
+        return NULL;
+    }
+    p->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (p->epfd < 0) {
+        free(p);
+        return NULL;
+    }
+    p->max_events = max_events;
+    return p;
+}
+
+void poller_free(poller_t *p)
+{
+    if (p) {
+        close(p->epfd);
+        free(p);
+    }
+}
+
+int poller_add(poller_t *p, int fd, void *data)
+{
+    struct epoll_event event = {
+        .events = EPOLLIN,
+        .data.ptr = data,
+    };
+    return epoll_ctl(p->epfd, EPOLL_CTL_ADD, fd, &event);
+}
+
+void poller_del(poller_t *p, int fd)
+{
+    epoll_ctl(p->epfd, EPOLL_CTL_DEL, fd, NULL);
+}
+
+int poller_wait(poller_t *p, void **ready, int timeout_ms)
+{
+    int ret = epoll_wait(p->epfd, p->events, p->max_events, timeout_ms);
+    for (int i = 0; i < ret; i++) {
+        ready[i] = p->events[i].data.ptr;
+    }
+    return ret;
+}
+
+#else   // POLLER_USE_EPOLL
+
+#include <sys/select.h>
+
+struct poller {
+    fd_set fds;                 /* Descriptors of the set */
+    int max_fd;                 /* Largest descriptor of the set, -1 if empty */
+    int max_events;
+    void *data[FD_SETSIZE];     /* User data, by descriptor */
+};
+
+poller_t *poller_create(int max_events)
+{
+    poller_t *p = calloc(1, sizeof(poller_t));
+    if (p == NULL) {
+        return NULL;
+    }
+    FD_ZERO(&p->fds);
+    p->max_fd = -1;
+    p->max_events = max_events;
+    return p;
+}
+
+void poller_free(poller_t *p)
+{
+    free(p);
+}
+
+int poller_add(poller_t *p, int fd, void *data)
+{
+    if (fd < 0 || fd >= FD_SETSIZE) {
+        errno = EBADF;
+        return -1;
+    }
+    FD_SET(fd, &p->fds);
+    p->data[fd] = data;
+    p->max_fd = MAX(p->max_fd, fd);
+    return 0;
+}
+
+void poller_del(poller_t *p, int fd)
+{
+    if (fd < 0 || fd >= FD_SETSIZE) {
+        return;
+    }
+    FD_CLR(fd, &p->fds);
+    p->data[fd] = NULL;
+    while (p->max_fd >= 0 && !FD_ISSET(p->max_fd, &p->fds)) {
+        p->max_fd--;
+    }
+}
+
+int poller_wait(poller_t *p, void **ready, int timeout_ms)
+{
+    fd_set read_set = p->fds;
+    struct timeval tv = {
+        .tv_sec = timeout_ms / 1000,
+        .tv_usec = (timeout_ms % 1000) * 1000,
+    };
+    int active_cnt = select(p->max_fd + 1, &read_set, NULL, NULL, timeout_ms < 0 ? NULL : &tv);
+    if (active_cnt <= 0) {
+        return active_cnt;
+    }
+    int count = 0;
+    for (int fd = 0; fd <= p->max_fd && count < MIN(active_cnt, p->max_events); fd++) {
+        if (FD_ISSET(fd, &read_set)) {
+            ready[count++] = p->data[fd];
+        }
+    }
+    return count;
+}
+
+#endif  // !POLLER_USE_EPOLL
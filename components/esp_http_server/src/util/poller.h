@@ -0,0 +1,95 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * \file poller.h
+ * \brief Set of descriptors waited for readability
+ *
+ * The descriptors are added and removed one by one, and waiting returns
+ * the user data of the ready descriptors only, so that the cost of an
+ * event does not depend on the number of descriptors in the set.
+ *
+ * On Linux (without LwIP) the set is an epoll instance. Elsewhere, it is
+ * an fd_set kept between the calls to select(): with LwIP, poll() is
+ * itself implemented with select().
+ */
+#ifndef _POLLER_H_
+#define _POLLER_H_
+
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if CONFIG_IDF_TARGET_LINUX && !CONFIG_LWIP_ENABLE && defined(__linux__)
+#define POLLER_USE_EPOLL    1
+#else
+#define POLLER_USE_EPOLL    0
+#endif
+
+typedef struct poller poller_t;
+
+/**
+ * @brief Create an empty set of descriptors
+ *
+ * @param[in] max_events the maximum number of ready descriptors
+ *                       returned by one call to poller_wait()
+ *
+ * @return  - the set
+ *          - NULL if out of memory or out of descriptors
+ */
+poller_t *poller_create(int max_events);
+
+/**
+ * @brief Free a set of descriptors
+ *
+ *      The descriptors in the set are not closed.
+ *
+ * @param[in] p the set, may be NULL
+ */
+void poller_free(poller_t *p);
+
+/**
+ * @brief Add a descriptor to the set
+ *
+ * @param[in] p    the set
+ * @param[in] fd   the descriptor, not in the set yet
+ * @param[in] data the user data returned by poller_wait() when fd is readable
+ *
+ * @return  - 0 on success
+ *          - an error code if less than zero
+ */
+int poller_add(poller_t *p, int fd, void *data);
+
+/**
+ * @brief Remove a descriptor from the set
+ *
+ *      This must be done before closing the descriptor.
+ *
+ * @param[in] p  the set
+ * @param[in] fd the descriptor, in the set
+ */
+void poller_del(poller_t *p, int fd);
+
+/**
+ * @brief Wait for descriptors of the set to be readable (or in error)
+ *
+ * @param[in]  p          the set
+ * @param[out] ready      array receiving the user data of the ready descriptors,
+ *                        with room for the max_events given to poller_create()
+ * @param[in]  timeout_ms the time to wait in milliseconds, -1 to wait forever
+ *
+ * @return  - the number of ready descriptors, 0 on timeout
+ *          - an error code if less than zero, errno is set
+ */
+int poller_wait(poller_t *p, void **ready, int timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ! _POLLER_H_ */
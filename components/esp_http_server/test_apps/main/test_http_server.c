@@ -1,16 +1,23 @@
 /*
- * SPDX-FileCopyrightText: 2018-2021 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2018-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <inttypes.h>
 #include <esp_system.h>
 #include <esp_http_server.h>
+#include <esp_timer.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
 
 #include "unity.h"
 #include "test_utils.h"
+#include "esp_httpd_priv.h"
 
 int pre_start_mem, post_stop_mem, post_stop_min_mem;
 bool basic_sanity = true;
@@ -244,6 +251,576 @@ TEST_CASE("Max Allowed Sockets Test", "[HTTP SERVER]")
     TEST_ASSERT(httpd_start(&hd, &config) != ESP_OK);
 }
 
+/********************* Response Send Test *******************/
+
+static int resp_send_count;
+
+static int counting_send(httpd_handle_t hd, int sockfd, const char *buf, size_t buf_len, int flags)
+{
+    resp_send_count++;
+    return send(sockfd, buf, buf_len, flags);
+}
+
+static esp_err_t counting_open(httpd_handle_t hd, int sockfd)
+{
+    return httpd_sess_set_send_override(hd, sockfd, counting_send);
+}
+
+static esp_err_t hello_handler(httpd_req_t *req)
+{
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    httpd_resp_set_hdr(req, "X-Test", "42");
+    return httpd_resp_sendstr(req, "{\"hello\":\"world\"}");
+}
+
+static const char hello_resp[] = "HTTP/1.1 200 OK\r\n"
+                                 "Content-Type: application/json\r\n"
+                                 "Content-Length: 17\r\n"
+                                 "Cache-Control: no-cache\r\n"
+                                 "X-Test: 42\r\n"
+                                 "\r\n"
+                                 "{\"hello\":\"world\"}";
+
+static void hello_response(int fd)
+{
+    char buf[sizeof(hello_resp)];
+    size_t len = 0;
+    while (len < sizeof(hello_resp) - 1) {
+        int ret = recv(fd, buf + len, sizeof(hello_resp) - 1 - len, 0);
+        TEST_ASSERT_GREATER_THAN(0, ret);
+        len += ret;
+    }
+    buf[len] = '\0';
+    TEST_ASSERT_EQUAL_STRING(hello_resp, buf);
+}
+
+static void hello_request(int fd)
+{
+    const char req[] = "GET /hello HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    TEST_ASSERT_EQUAL(sizeof(req) - 1, send(fd, req, sizeof(req) - 1, 0));
+    hello_response(fd);
+}
+
+TEST_CASE("Response Headers Single Send Test", "[HTTP SERVER]")
+{
+    test_case_uses_tcpip();
+
+    httpd_handle_t hd;
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.open_fn = counting_open;
+    TEST_ASSERT(httpd_start(&hd, &config) == ESP_OK);
+    httpd_uri_t hello = {
+        .uri      = "/hello",
+        .method   = HTTP_GET,
+        .handler  = hello_handler,
+        .user_ctx = NULL,
+    };
+    TEST_ASSERT(httpd_register_uri_handler(hd, &hello) == ESP_OK);
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    TEST_ASSERT(fd >= 0);
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(config.server_port),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    TEST_ASSERT_EQUAL(0, connect(fd, (struct sockaddr *)&addr, sizeof(addr)));
+
+    /* The headers and the small body leave in a single send */
+    resp_send_count = 0;
+    hello_request(fd);
+    TEST_ASSERT_EQUAL(1, resp_send_count);
+
+    const int requests = 200;
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < requests; i++) {
+        hello_request(fd);
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+    printf("%d keep-alive requests in %" PRId64 " us: %" PRId64 " requests/s\n", requests, elapsed, requests * 1000000LL / elapsed);
+
+    close(fd);
+    TEST_ASSERT(httpd_stop(hd) == ESP_OK);
+}
+
+/********************* URI Router Test *******************/
+
+/* Receives a response, returns its status code and copies its body into body */
+static int test_http_response(int fd, char *body, size_t body_size)
+{
+    char buf[512];
+
+    /* Read until the end of the body given by Content-Length */
+    int len = 0;
+    char *content = NULL;
+    while (content == NULL || len < content - buf + atoi(strstr(buf, "Content-Length: ") + 16)) {
+        int ret = recv(fd, buf + len, sizeof(buf) - 1 - len, 0);
+        TEST_ASSERT_GREATER_THAN(0, ret);
+        len += ret;
+        buf[len] = '\0';
+        content = strstr(buf, "\r\n\r\n");
+        if (content) {
+            content += 4;
+        }
+    }
+    strlcpy(body, content, body_size);
+    return atoi(buf + strlen("HTTP/1.1 "));
+}
+
+/* Sends a request on a new connection, returns the status code of the
+ * response and copies its body into body */
+static int test_http_request(uint16_t port, const char *method, const char *path, char *body, size_t body_size)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    TEST_ASSERT(fd >= 0);
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    TEST_ASSERT_EQUAL(0, connect(fd, (struct sockaddr *)&addr, sizeof(addr)));
+
+    char buf[512];
+    int len = snprintf(buf, sizeof(buf), "%s %s HTTP/1.1\r\nHost: localhost\r\n\r\n", method, path);
+    TEST_ASSERT_EQUAL(len, send(fd, buf, len, 0));
+
+    int status = test_http_response(fd, body, body_size);
+    close(fd);
+    return status;
+}
+
+static esp_err_t route_handler(httpd_req_t *req)
+{
+    char resp[64];
+    char id[16];
+    char file[16];
+    strlcpy(resp, req->user_ctx, sizeof(resp));
+    if (httpd_req_get_uri_param(req, "id", id, sizeof(id)) == ESP_OK) {
+        strlcat(resp, ":", sizeof(resp));
+        strlcat(resp, id, sizeof(resp));
+    }
+    if (httpd_req_get_uri_param(req, "file", file, sizeof(file)) == ESP_OK) {
+        strlcat(resp, ":", sizeof(resp));
+        strlcat(resp, file, sizeof(resp));
+    }
+    return httpd_resp_sendstr(req, resp);
+}
+
+TEST_CASE("URI Router Tests", "[HTTP SERVER]")
+{
+    test_case_uses_tcpip();
+
+    httpd_handle_t hd;
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.uri_match_fn = httpd_uri_match_params;
+    config.max_uri_handlers = 16;
+    TEST_ASSERT(httpd_start(&hd, &config) == ESP_OK);
+
+    struct {
+        const char *uri;
+        httpd_method_t method;
+        const char *name;
+    } routes[] = {
+        {"/api/status", HTTP_GET, "status"},
+        {"/api/{id}", HTTP_GET, "item"},
+        {"/api/{id}", HTTP_PUT, "update"},
+        {"/api/{id}/files/{file}", HTTP_GET, "file"},
+        {"/static/*", HTTP_GET, "static"},
+    };
+    for (int i = 0; i < sizeof(routes) / sizeof(routes[0]); i++) {
+        httpd_uri_t uri = {
+            .uri      = routes[i].uri,
+            .method   = routes[i].method,
+            .handler  = route_handler,
+            .user_ctx = (void *)routes[i].name,
+        };
+        TEST_ASSERT(httpd_register_uri_handler(hd, &uri) == ESP_OK);
+    }
+    /* Already handled by "/api/{id}" */
+    httpd_uri_t dup = {
+        .uri      = "/api/42",
+        .method   = HTTP_GET,
+        .handler  = route_handler,
+        .user_ctx = NULL,
+    };
+    TEST_ASSERT(httpd_register_uri_handler(hd, &dup) == ESP_ERR_HTTPD_HANDLER_EXISTS);
+
+    struct {
+        const char *method;
+        const char *path;
+        int status;
+        const char *body;
+    } requests[] = {
+        {"GET", "/api/status", 200, "status"},
+        {"GET", "/api/42", 200, "item:42"},
+        {"GET", "/api/42?verbose=1", 200, "item:42"},
+        {"PUT", "/api/42", 200, "update:42"},
+        {"GET", "/api/42/files/notes.txt", 200, "file:42:notes.txt"},
+        {"GET", "/static/js/app.js", 200, "static"},
+        {"GET", "/api/", 404, NULL},
+        {"GET", "/api/42/files/", 404, NULL},
+        {"GET", "/static", 404, NULL},
+        {"DELETE", "/api/42", 405, NULL},
+    };
+    for (int i = 0; i < sizeof(requests) / sizeof(requests[0]); i++) {
+        char body[64];
+        TEST_ASSERT_EQUAL(requests[i].status, test_http_request(config.server_port, requests[i].method, requests[i].path, body, sizeof(body)));
+        if (requests[i].body) {
+            TEST_ASSERT_EQUAL_STRING(requests[i].body, body);
+        }
+    }
+
+    /* The index is rebuilt when handlers are unregistered */
+    TEST_ASSERT(httpd_unregister_uri(hd, "/api/{id}") == ESP_OK);
+    char body[64];
+    TEST_ASSERT_EQUAL(404, test_http_request(config.server_port, "GET", "/api/42", body, sizeof(body)));
+    TEST_ASSERT_EQUAL(200, test_http_request(config.server_port, "GET", "/api/status", body, sizeof(body)));
+
+    TEST_ASSERT(httpd_stop(hd) == ESP_OK);
+}
+
+TEST_CASE("URI Router Latency Test", "[HTTP SERVER]")
+{
+    test_case_uses_tcpip();
+
+    /* The time to find the handler of a request should not depend on the number
+     * of handlers. The lookup is timed alone, a request over a new connection
+     * takes much longer than the lookup itself. */
+    const int handler_counts[] = { 8, 64 };
+    for (int n = 0; n < sizeof(handler_counts) / sizeof(handler_counts[0]); n++) {
+        httpd_handle_t hd;
+        httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+        config.max_uri_handlers = handler_counts[n];
+        TEST_ASSERT(httpd_start(&hd, &config) == ESP_OK);
+
+        char uris[64][24];
+        for (int i = 0; i < handler_counts[n]; i++) {
+            snprintf(uris[i], sizeof(uris[i]), "/api/v1/resource%d", i);
+            httpd_uri_t uri = {
+                .uri      = uris[i],
+                .method   = HTTP_GET,
+                .handler  = route_handler,
+                .user_ctx = "resource",
+            };
+            TEST_ASSERT(httpd_register_uri_handler(hd, &uri) == ESP_OK);
+        }
+
+        struct httpd_data *data = (struct httpd_data *)hd;
+        const char *last = uris[handler_counts[n] - 1];
+        const int lookups = 1000;
+        xSemaphoreTake(data->hd_uri_lock, portMAX_DELAY);
+        TEST_ASSERT_NOT_NULL(data->hd_router);
+        httpd_uri_t *found = NULL;
+        int64_t start = esp_timer_get_time();
+        for (int i = 0; i < lookups; i++) {
+            found = httpd_router_find(data, last, strlen(last), HTTP_GET, NULL);
+        }
+        int64_t elapsed = esp_timer_get_time() - start;
+        xSemaphoreGive(data->hd_uri_lock);
+        TEST_ASSERT_NOT_NULL(found);
+        TEST_ASSERT_EQUAL_STRING(last, found->uri);
+        printf("%d handlers: %" PRId64 " ns per lookup of the last handler\n", handler_counts[n], elapsed * 1000 / lookups);
+
+        TEST_ASSERT(httpd_stop(hd) == ESP_OK);
+    }
+}
+
+/********************* Idle Connections Test *******************/
+
+static int test_connect(uint16_t port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    TEST_ASSERT(fd >= 0);
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    TEST_ASSERT_EQUAL(0, connect(fd, (struct sockaddr *)&addr, sizeof(addr)));
+    return fd;
+}
+
+TEST_CASE("Idle Connections Test", "[HTTP SERVER]")
+{
+    test_case_uses_tcpip();
+
+    httpd_handle_t hd;
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    TEST_ASSERT(httpd_start(&hd, &config) == ESP_OK);
+    httpd_uri_t hello = {
+        .uri      = "/hello",
+        .method   = HTTP_GET,
+        .handler  = hello_handler,
+        .user_ctx = NULL,
+    };
+    TEST_ASSERT(httpd_register_uri_handler(hd, &hello) == ESP_OK);
+
+    /* Keep-alive connections left idle, up to the limit of the server */
+    const int idle_count = config.max_open_sockets - 1;
+    int idle_fds[idle_count];
+    for (int i = 0; i < idle_count; i++) {
+        idle_fds[i] = test_connect(config.server_port);
+        hello_request(idle_fds[i]);
+    }
+
+    /* Requests on the last connection are served while the others are idle */
+    int fd = test_connect(config.server_port);
+    const int requests = 200;
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < requests; i++) {
+        hello_request(fd);
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+    printf("%d idle connections, %d keep-alive requests in %" PRId64 " us: %" PRId64 " requests/s\n",
+           idle_count, requests, elapsed, requests * 1000000LL / elapsed);
+    close(fd);
+
+    /* The idle connections are still open */
+    for (int i = 0; i < idle_count; i++) {
+        hello_request(idle_fds[i]);
+        close(idle_fds[i]);
+    }
+    TEST_ASSERT(httpd_stop(hd) == ESP_OK);
+}
+
+/********************* Worker Pool Test *******************/
+
+#define SLOW_HANDLER_DELAY_MS 500
+
+static esp_err_t slow_handler(httpd_req_t *req)
+{
+    vTaskDelay(pdMS_TO_TICKS(SLOW_HANDLER_DELAY_MS));
+    return httpd_resp_sendstr(req, "slow");
+}
+
+/* Receives responses until the body of the last one is expected */
+static void test_recv_until(int fd, const char *last_body)
+{
+    char buf[512];
+    size_t len = 0;
+    buf[0] = '\0';
+    while (len < strlen(last_body) || strcmp(buf + len - strlen(last_body), last_body) != 0) {
+        int ret = recv(fd, buf + len, sizeof(buf) - 1 - len, 0);
+        TEST_ASSERT_GREATER_THAN(0, ret);
+        len += ret;
+        buf[len] = '\0';
+    }
+}
+
+TEST_CASE("Worker Pool Test", "[HTTP SERVER]")
+{
+    test_case_uses_tcpip();
+
+    httpd_handle_t hd;
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.worker_count = 2;
+    TEST_ASSERT(httpd_start(&hd, &config) == ESP_OK);
+    httpd_uri_t hello = {
+        .uri      = "/hello",
+        .method   = HTTP_GET,
+        .handler  = hello_handler,
+        .user_ctx = NULL,
+    };
+    httpd_uri_t slow = {
+        .uri      = "/slow",
+        .method   = HTTP_GET,
+        .handler  = slow_handler,
+        .user_ctx = NULL,
+    };
+    TEST_ASSERT(httpd_register_uri_handler(hd, &hello) == ESP_OK);
+    TEST_ASSERT(httpd_register_uri_handler(hd, &slow) == ESP_OK);
+
+    /* Pipelined requests of a session are processed in order */
+    const char reqs[] = "GET /slow HTTP/1.1\r\nHost: localhost\r\n\r\n"
+                        "GET /hello HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    int slow_fd = test_connect(config.server_port);
+    TEST_ASSERT_EQUAL(sizeof(reqs) - 1, send(slow_fd, reqs, sizeof(reqs) - 1, 0));
+
+    /* A slow handler does not delay the requests of the other sessions */
+    vTaskDelay(pdMS_TO_TICKS(50));
+    int64_t start = esp_timer_get_time();
+    int fd = test_connect(config.server_port);
+    hello_request(fd);
+    int64_t elapsed = esp_timer_get_time() - start;
+    close(fd);
+    printf("request served in %" PRId64 " us during a slow request\n", elapsed);
+    TEST_ASSERT_LESS_THAN(SLOW_HANDLER_DELAY_MS * 1000 / 2, elapsed);
+
+    test_recv_until(slow_fd, "{\"hello\":\"world\"}");
+    close(slow_fd);
+
+    httpd_worker_stats_t stats;
+    TEST_ASSERT(httpd_get_worker_stats(hd, &stats) == ESP_OK);
+    printf("processed %" PRIu32 ", max queued %" PRIu32 ", max wait %" PRIu32 " us, max processing %" PRIu32 " us\n",
+           stats.processed, stats.max_queued, stats.max_wait_us, stats.max_process_us);
+    TEST_ASSERT_GREATER_OR_EQUAL(3, stats.processed);
+    TEST_ASSERT_GREATER_OR_EQUAL(SLOW_HANDLER_DELAY_MS * 1000, stats.max_process_us);
+    TEST_ASSERT(httpd_stop(hd) == ESP_OK);
+
+    /* No statistics without workers */
+    config.worker_count = 0;
+    TEST_ASSERT(httpd_start(&hd, &config) == ESP_OK);
+    TEST_ASSERT(httpd_get_worker_stats(hd, &stats) == ESP_ERR_INVALID_STATE);
+    TEST_ASSERT(httpd_stop(hd) == ESP_OK);
+}
+
+/********************* Worker Pool URI Registration Test *******************/
+
+static esp_err_t churn_handler(httpd_req_t *req)
+{
+    /* Changes the handlers while the other workers look them up */
+    httpd_uri_t added = {
+        .uri      = "/added",
+        .method   = HTTP_GET,
+        .handler  = hello_handler,
+        .user_ctx = NULL,
+    };
+    httpd_register_uri_handler(req->handle, &added);
+    httpd_unregister_uri(req->handle, added.uri);
+    return hello_handler(req);
+}
+
+TEST_CASE("Worker Pool URI Registration Test", "[HTTP SERVER]")
+{
+    test_case_uses_tcpip();
+
+    httpd_handle_t hd;
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.worker_count = 4;
+    TEST_ASSERT(httpd_start(&hd, &config) == ESP_OK);
+    httpd_uri_t hello = {
+        .uri      = "/hello",
+        .method   = HTTP_GET,
+        .handler  = hello_handler,
+        .user_ctx = NULL,
+    };
+    httpd_uri_t churn = {
+        .uri      = "/churn",
+        .method   = HTTP_GET,
+        .handler  = churn_handler,
+        .user_ctx = NULL,
+    };
+    TEST_ASSERT(httpd_register_uri_handler(hd, &hello) == ESP_OK);
+    TEST_ASSERT(httpd_register_uri_handler(hd, &churn) == ESP_OK);
+
+    /* Pipelined requests on several sessions, processed by the workers in parallel */
+    const char reqs[] = "GET /churn HTTP/1.1\r\nHost: localhost\r\n\r\n"
+                        "GET /hello HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    const int conn_count = 4;
+    const int rounds = 20;
+    int fds[conn_count];
+    for (int i = 0; i < conn_count; i++) {
+        fds[i] = test_connect(config.server_port);
+        for (int j = 0; j < rounds; j++) {
+            TEST_ASSERT_EQUAL(sizeof(reqs) - 1, send(fds[i], reqs, sizeof(reqs) - 1, 0));
+        }
+    }
+
+    /* Meanwhile, handlers are registered and unregistered by this task too */
+    httpd_uri_t other = {
+        .uri      = "/other",
+        .method   = HTTP_GET,
+        .handler  = hello_handler,
+        .user_ctx = NULL,
+    };
+    for (int i = 0; i < 100; i++) {
+        TEST_ASSERT(httpd_register_uri_handler(hd, &other) == ESP_OK);
+        TEST_ASSERT(httpd_unregister_uri_handler(hd, other.uri, other.method) == ESP_OK);
+    }
+
+    for (int i = 0; i < conn_count; i++) {
+        for (int j = 0; j < rounds * 2; j++) {
+            hello_response(fds[i]);
+        }
+        close(fds[i]);
+    }
+    TEST_ASSERT(httpd_stop(hd) == ESP_OK);
+}
+
+/********************* Request Headers Test *******************/
+
+/* Lengths, results and values of the header lookups */
+#define HEADERS_RESP_FMT "%d,%d:%s,%d:%s:%d,%d,%d:%s,%d:%s"
+
+static esp_err_t headers_handler(httpd_req_t *req)
+{
+    char resp[128];
+    char dup[16];
+    char trunc[8];
+    char cookie[8];
+    size_t cookie_len = sizeof(cookie);
+    const char *empty = NULL;
+    size_t empty_len = 1;
+    const char *missing = NULL;
+
+    size_t test_len = httpd_req_get_hdr_value_len(req, "x-test");
+    esp_err_t dup_ret = httpd_req_get_hdr_value_str(req, "X-DUP", dup, sizeof(dup));
+    esp_err_t empty_ret = httpd_req_get_hdr_view(req, "X-Empty", &empty, &empty_len);
+    esp_err_t missing_ret = httpd_req_get_hdr_view(req, "X-Missing", &missing, NULL);
+    esp_err_t trunc_ret = httpd_req_get_hdr_value_str(req, "X-Long", trunc, sizeof(trunc));
+    esp_err_t cookie_ret = httpd_req_get_cookie_val(req, "b", cookie, &cookie_len);
+
+    snprintf(resp, sizeof(resp), HEADERS_RESP_FMT,
+             (int)test_len,
+             dup_ret, dup,
+             empty_ret, empty ? empty : "NULL", (int)empty_len,
+             missing_ret,
+             trunc_ret, trunc,
+             cookie_ret, cookie);
+    return httpd_resp_sendstr(req, resp);
+}
+
+TEST_CASE("Request Headers Test", "[HTTP SERVER]")
+{
+    test_case_uses_tcpip();
+
+    httpd_handle_t hd;
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.max_req_hdr_len = 1024;
+    TEST_ASSERT(httpd_start(&hd, &config) == ESP_OK);
+    httpd_uri_t headers = {
+        .uri      = "/headers",
+        .method   = HTTP_GET,
+        .handler  = headers_handler,
+        .user_ctx = NULL,
+    };
+    TEST_ASSERT(httpd_register_uri_handler(hd, &headers) == ESP_OK);
+
+    /* Enough headers to grow the header table of the request */
+    char req[1024];
+    int len = snprintf(req, sizeof(req), "GET /headers HTTP/1.1\r\nHost: localhost\r\n");
+    for (int i = 0; i < 24; i++) {
+        len += snprintf(req + len, sizeof(req) - len, "X-Pad-%d: %d\r\n", i, i);
+    }
+    len += snprintf(req + len, sizeof(req) - len,
+                    "X-Test: 12345\r\n"
+                    "x-dup: first\r\n"
+                    "X-Dup: second\r\n"
+                    "X-Empty:\r\n"
+                    "X-Long: 0123456789abcdef\r\n"
+                    "Cookie: a=1; b=2\r\n"
+                    "\r\n");
+    TEST_ASSERT(len < sizeof(req));
+
+    int fd = test_connect(config.server_port);
+    TEST_ASSERT_EQUAL(len, send(fd, req, len, 0));
+    char body[128];
+    TEST_ASSERT_EQUAL(200, test_http_response(fd, body, sizeof(body)));
+    close(fd);
+    /* Case insensitive lookups, the first of duplicate fields is returned */
+    char expected[128];
+    snprintf(expected, sizeof(expected), HEADERS_RESP_FMT,
+             5,
+             ESP_OK, "first",
+             ESP_OK, "", 0,
+             ESP_ERR_NOT_FOUND,
+             ESP_ERR_HTTPD_RESULT_TRUNC, "0123456",
+             ESP_OK, "2");
+    TEST_ASSERT_EQUAL_STRING(expected, body);
+    TEST_ASSERT(httpd_stop(hd) == ESP_OK);
+}
+
 void app_main(void)
 {
     unity_run_menu();
@@ -176,7 +176,8 @@ typedef struct httpd_ssl_config httpd_ssl_config_t;
         .keep_alive_count = 0,                    \
         .open_fn = NULL,                          \
         .close_fn = NULL,                         \
-        .uri_match_fn = NULL                      \
+        .uri_match_fn = NULL,                     \
+        .worker_count = 0                         \
     },                                            \
     .servercert = NULL,                           \
     .servercert_len = 0,                          \
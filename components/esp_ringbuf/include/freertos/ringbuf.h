@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2023 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2023-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -44,6 +44,14 @@ typedef enum {
     RINGBUF_TYPE_MAX,
 } RingbufferType_t;
 
+/**
+ * @brief Part of an item sent by xRingbufferSendv()
+ */
+typedef struct {
+    const void *pvData;     /**< Pointer to the data of the part. NULL is allowed if xLen is 0. */
+    size_t xLen;            /**< Size of the data of the part */
+} RingbufferIOVec_t;
+
 /**
  * @brief Struct that is equivalent in size to the ring buffer's data structure
  *
@@ -61,6 +69,7 @@ typedef struct xSTATIC_RINGBUFFER {
     BaseType_t xDummy4;
     StaticList_t xDummy5[2];
     void * pvDummy6;
+    UBaseType_t uxDummy7;
     portMUX_TYPE muxDummy;
     /** @endcond */
 } StaticRingbuffer_t;
@@ -91,6 +100,30 @@ RingbufHandle_t xRingbufferCreate(size_t xBufferSize, RingbufferType_t xBufferTy
  */
 RingbufHandle_t xRingbufferCreateNoSplit(size_t xItemSize, size_t xItemNum);
 
+/**
+ * @brief       Create a single-producer single-consumer ring buffer
+ *
+ * This API is similar to xRingbufferCreate(), but the created ring buffer may
+ * only be written by one task (or ISR) and read by one task (or ISR) at a time.
+ * Sending and receiving use atomic read/write pointers instead of a critical
+ * section, so neither side disables interrupts unless it has to block because
+ * the buffer is full or empty, or has to wake the other side blocked on it.
+ *
+ * @param[in]   xBufferSize Size of the buffer in bytes. Note that items require
+ *              space for a header in no-split buffers
+ * @param[in]   xBufferType Type of ring buffer, RINGBUF_TYPE_NOSPLIT or RINGBUF_TYPE_BYTEBUF
+ *
+ * @note    xBufferSize of no-split buffers will be rounded up to the nearest 32-bit aligned size.
+ * @note    A few bytes of storage are allocated in addition to xBufferSize to tell a full
+ *          buffer from an empty one without a shared full flag.
+ * @note    xRingbufferSendAcquire(), xRingbufferSendComplete() and queue sets are not supported
+ *          by these ring buffers, and vRingbufferGetInfo() does not report the number of items
+ *          waiting in no-split buffers.
+ *
+ * @return  A handle to the created ring buffer, or NULL in case of error.
+ */
+RingbufHandle_t xRingbufferCreateSPSC(size_t xBufferSize, RingbufferType_t xBufferType);
+
 /**
  * @brief       Create a ring buffer but manually provide the required memory
  *
@@ -168,6 +201,31 @@ BaseType_t xRingbufferSendFromISR(RingbufHandle_t xRingbuffer,
                                   size_t xItemSize,
                                   BaseType_t *pxHigherPriorityTaskWoken);
 
+/**
+ * @brief       Insert an item made of several parts into the ring buffer
+ *
+ * Same as xRingbufferSend(), except that the data of the item is gathered from
+ * several parts (e.g., a header and a payload), which are copied one after the
+ * other into the ring buffer. The parts form a single item of the total size of
+ * the parts, sent atomically. This avoids assembling the item in a temporary
+ * buffer first.
+ *
+ * @param[in]   xRingbuffer     Ring buffer to insert the item into
+ * @param[in]   pxIOVec         Array of the parts of the item. NULL is allowed if xIOVecCount is 0.
+ * @param[in]   xIOVecCount     Number of parts in pxIOVec
+ * @param[in]   xTicksToWait    Ticks to wait for room in the ring buffer.
+ *
+ * @note    Applicable to all types of ring buffers. Parts of size 0 are allowed.
+ *
+ * @return
+ *      - pdTRUE if succeeded
+ *      - pdFALSE on time-out or when the data is larger than the maximum permissible size of the buffer
+ */
+BaseType_t xRingbufferSendv(RingbufHandle_t xRingbuffer,
+                            const RingbufferIOVec_t *pxIOVec,
+                            size_t xIOVecCount,
+                            TickType_t xTicksToWait);
+
 /**
  * @brief Acquire memory from the ring buffer to be written to by an external
  *        source and to be sent later.
@@ -384,6 +442,43 @@ void vRingbufferReturnItem(RingbufHandle_t xRingbuffer, void *pvItem);
  */
 void vRingbufferReturnItemFromISR(RingbufHandle_t xRingbuffer, void *pvItem, BaseType_t *pxHigherPriorityTaskWoken);
 
+/**
+ * @brief   Retrieve several items from a no-split ring buffer
+ *
+ * Attempt to retrieve up to xMaxItems items from the ring buffer in a single call.
+ * This function will block until at least one item is available or until it
+ * times out, then retrieves the first item and the items already waiting behind
+ * it, in the order they were sent.
+ *
+ * @param[in]   xRingbuffer     Ring buffer to retrieve the items from
+ * @param[out]  ppvItems        Array of at least xMaxItems entries, filled with pointers to the retrieved items
+ * @param[out]  pxItemSizes     Array of at least xMaxItems entries, filled with the sizes of the retrieved items
+ * @param[in]   xMaxItems       Maximum number of items to retrieve
+ * @param[in]   xTicksToWait    Ticks to wait for items in the ring buffer.
+ *
+ * @note    Only applicable for no-split ring buffers.
+ * @note    The items retrieved must be returned to the ring buffer, either by
+ *          a call to vRingbufferReturnMultiple() or by calls to vRingbufferReturnItem().
+ *
+ * @return  Number of items retrieved, 0 on timeout.
+ */
+size_t xRingbufferReceiveMultiple(RingbufHandle_t xRingbuffer,
+                                  void **ppvItems,
+                                  size_t *pxItemSizes,
+                                  size_t xMaxItems,
+                                  TickType_t xTicksToWait);
+
+/**
+ * @brief   Return several previously-retrieved items to the ring buffer
+ *
+ * Same as calling vRingbufferReturnItem() for each item, with a single critical section.
+ *
+ * @param[in]   xRingbuffer Ring buffer the items were retrieved from
+ * @param[in]   ppvItems    Array of the items that were received earlier (e.g., by xRingbufferReceiveMultiple())
+ * @param[in]   xItemCount  Number of items in ppvItems
+ */
+void vRingbufferReturnMultiple(RingbufHandle_t xRingbuffer, void **ppvItems, size_t xItemCount);
+
 /**
  * @brief   Delete a ring buffer
  *
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2023-2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2023-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -27,6 +27,15 @@
 #define rbBUFFER_FULL_FLAG          ( ( UBaseType_t ) 4 )   //The ring buffer is currently full (write pointer == free pointer)
 #define rbBUFFER_STATIC_FLAG        ( ( UBaseType_t ) 8 )   //The ring buffer is statically allocated
 #define rbUSING_QUEUE_SET           ( ( UBaseType_t ) 16 )  //The ring buffer has been added to a queue set
+#define rbSPSC_FLAG                 ( ( UBaseType_t ) 32 )  //The ring buffer has a single producer and a single consumer (lock-free)
+
+//Waiter flags of single-producer single-consumer ring buffers
+#define rbSPSC_SENDER_WAITING       ( ( UBaseType_t ) 1 )   //The producer is blocked (or about to block) until there is free space
+#define rbSPSC_RECEIVER_WAITING     ( ( UBaseType_t ) 2 )   //The consumer is blocked (or about to block) until there is data
+
+//Atomic accesses to the pointers shared between the producer and the consumer of SPSC ring buffers
+#define rbLOAD_ACQUIRE( pucPtr )            __atomic_load_n( &( pucPtr ), __ATOMIC_ACQUIRE )
+#define rbSTORE_RELEASE( pucPtr, pucVal )   __atomic_store_n( &( pucPtr ), ( pucVal ), __ATOMIC_RELEASE )
 
 //Item flags
 #define rbITEM_FREE_FLAG            ( ( UBaseType_t ) 1 )   //Item has been retrieved and returned by application, free to overwrite
@@ -41,9 +50,15 @@ typedef struct {
 } ItemHeader_t;
 
 #define rbHEADER_SIZE     sizeof(ItemHeader_t)
+
+typedef struct {
+    const RingbufferIOVec_t *pxPart;            //Part of the item being copied
+    size_t xOffset;                             //Number of bytes of the part already copied
+} IOVecCursor_t;
+
 typedef struct RingbufferDefinition Ringbuffer_t;
 typedef BaseType_t (*CheckItemFitsFunction_t)(Ringbuffer_t *pxRingbuffer, size_t xItemSize);
-typedef void (*CopyItemFunction_t)(Ringbuffer_t *pxRingbuffer, const uint8_t *pcItem, size_t xItemSize);
+typedef void (*CopyItemFunction_t)(Ringbuffer_t *pxRingbuffer, const RingbufferIOVec_t *pxItem, size_t xItemSize);
 typedef BaseType_t (*CheckItemAvailFunction_t)(Ringbuffer_t *pxRingbuffer);
 typedef void *(*GetItemFunction_t)(Ringbuffer_t *pxRingbuffer, BaseType_t *pxIsSplit, size_t xMaxSize, size_t *pxItemSize);
 typedef void (*ReturnItemFunction_t)(Ringbuffer_t *pxRingbuffer, uint8_t *pvItem);
@@ -71,6 +86,7 @@ typedef struct RingbufferDefinition {
     List_t xTasksWaitingToSend;                 //List of tasks that are blocked waiting to send/acquire onto this ring buffer. Stored in priority order.
     List_t xTasksWaitingToReceive;              //List of tasks that are blocked waiting to receive from this ring buffer. Stored in priority order.
     QueueSetHandle_t xQueueSet;                 //Ring buffer's read queue set handle.
+    UBaseType_t uxSPSCWaiters;                  //SPSC ring buffers only. Waiter flags, only modified within a critical section
 
     portMUX_TYPE mux;                           //Spinlock required for SMP
 } Ringbuffer_t;
@@ -97,6 +113,9 @@ static size_t prvGetFreeSize(Ringbuffer_t *pxRingbuffer);
 //Checks if an item/data is currently available for retrieval
 static BaseType_t prvCheckItemAvail(Ringbuffer_t *pxRingbuffer);
 
+//Copies the next xLen bytes of an item made of one or more parts, and advances the cursor past them
+static void prvCopyFromIOVec(uint8_t *pucDest, IOVecCursor_t *pxCursor, size_t xLen);
+
 //Checks if an item will currently fit in a no-split/allow-split ring buffer
 static BaseType_t prvCheckItemFitsDefault(Ringbuffer_t *pxRingbuffer, size_t xItemSize);
 
@@ -112,7 +131,7 @@ Exit:
     - pucAcquire and pucWrite updated.
     - Dummy item added if necessary
 */
-static void prvCopyItemNoSplit(Ringbuffer_t *pxRingbuffer, const uint8_t *pucItem, size_t xItemSize);
+static void prvCopyItemNoSplit(Ringbuffer_t *pxRingbuffer, const RingbufferIOVec_t *pxItem, size_t xItemSize);
 
 /*
 Copies an item to a allow-split ring buffer
@@ -123,10 +142,10 @@ Exit:
     - pucAcquire and pucWrite updated
     - Item may be split
 */
-static void prvCopyItemAllowSplit(Ringbuffer_t *pxRingbuffer, const uint8_t *pucItem, size_t xItemSize);
+static void prvCopyItemAllowSplit(Ringbuffer_t *pxRingbuffer, const RingbufferIOVec_t *pxItem, size_t xItemSize);
 
 //Copies an item to a byte buffer. Only call this function  after calling prvCheckItemFitsByteBuffer()
-static void prvCopyItemByteBuf(Ringbuffer_t *pxRingbuffer, const uint8_t *pucItem, size_t xItemSize);
+static void prvCopyItemByteBuf(Ringbuffer_t *pxRingbuffer, const RingbufferIOVec_t *pxItem, size_t xItemSize);
 
 //Retrieve item from no-split/allow-split ring buffer. *pxIsSplit is set to pdTRUE if the retrieved item is split
 /*
@@ -171,11 +190,11 @@ static size_t prvGetCurMaxSizeByteBuf(Ringbuffer_t *pxRingbuffer);
 
 /*
 Generic function used to send or acquire an item/buffer.
-- If sending, set ppvItem to NULL. pvItem remains unchanged on failure.
-- If acquiring, set pvItem to NULL. ppvItem remains unchanged on failure.
+- If sending, set ppvItem to NULL. pxItem holds the parts of the item, xItemSize bytes in total.
+- If acquiring, set pxItem to NULL. ppvItem remains unchanged on failure.
 */
 static BaseType_t prvSendAcquireGeneric(Ringbuffer_t *pxRingbuffer,
-                                        const void *pvItem,
+                                        const RingbufferIOVec_t *pxItem,
                                         void **ppvItem,
                                         size_t xItemSize,
                                         TickType_t xTicksToWait);
@@ -202,6 +221,85 @@ static BaseType_t prvReceiveGenericFromISR(Ringbuffer_t *pxRingbuffer,
                                            size_t *xItemSize2,
                                            size_t xMaxSize);
 
+/*
+Generic function used to retrieve up to xMaxItems items from no-split ring
+buffers, blocking only until the first item is available. The items already
+waiting behind the first item are retrieved in the same critical section.
+Returns the number of items retrieved.
+*/
+static size_t prvReceiveMultipleGeneric(Ringbuffer_t *pxRingbuffer,
+                                        void **ppvItems,
+                                        size_t *pxItemSizes,
+                                        size_t xMaxItems,
+                                        TickType_t xTicksToWait);
+
+/*
+ * Single-producer single-consumer (SPSC) ring buffers
+ *
+ * The following functions are lock-free and MUST NOT be called within a critical
+ * section. The producer owns pucAcquire and pucWrite, the consumer owns pucRead
+ * and pucFree. Each side only reads the pointer published by the other side
+ * (pucWrite or pucFree) with an acquire load, and publishes its own one with a
+ * release store once the data/space behind it is ready. The write pointer never
+ * catches up with the free pointer (a gap is kept), so that an empty buffer
+ * (pucRead == pucWrite) is never confused with a full one without a full flag
+ * shared by both sides.
+ */
+
+//Checks if an item will currently fit in a SPSC no-split ring buffer
+static BaseType_t prvCheckItemFitsSPSCNoSplit(Ringbuffer_t *pxRingbuffer, size_t xItemSize);
+
+//Checks if data will currently fit in a SPSC byte buffer
+static BaseType_t prvCheckItemFitsSPSCByteBuf(Ringbuffer_t *pxRingbuffer, size_t xItemSize);
+
+//Copies an item to a SPSC no-split ring buffer and publishes the write pointer
+static void prvCopyItemSPSCNoSplit(Ringbuffer_t *pxRingbuffer, const RingbufferIOVec_t *pxItem, size_t xItemSize);
+
+//Copies data to a SPSC byte buffer and publishes the write pointer
+static void prvCopyItemSPSCByteBuf(Ringbuffer_t *pxRingbuffer, const RingbufferIOVec_t *pxItem, size_t xItemSize);
+
+//Checks if an item/data is currently available for retrieval from a SPSC ring buffer
+static BaseType_t prvCheckItemAvailSPSC(Ringbuffer_t *pxRingbuffer);
+
+//Retrieve item from a SPSC no-split ring buffer. Only call after prvCheckItemAvailSPSC()
+static void *prvGetItemSPSCNoSplit(Ringbuffer_t *pxRingbuffer,
+                                   BaseType_t *pxIsSplit,
+                                   size_t xUnusedParam,
+                                   size_t *pxItemSize);
+
+//Retrieve data from a SPSC byte buffer. Only call after prvCheckItemAvailSPSC()
+static void *prvGetItemSPSCByteBuf(Ringbuffer_t *pxRingbuffer,
+                                   BaseType_t *pxUnusedParam,
+                                   size_t xMaxSize,
+                                   size_t *pxItemSize);
+
+//Return an item to a SPSC no-split ring buffer and publish the free pointer
+static void prvReturnItemSPSCNoSplit(Ringbuffer_t *pxRingbuffer, uint8_t *pucItem);
+
+//Return data to a SPSC byte buffer and publish the free pointer
+static void prvReturnItemSPSCByteBuf(Ringbuffer_t *pxRingbuffer, uint8_t *pucItem);
+
+//Get the maximum size an item that can currently have if sent to a SPSC no-split ring buffer
+static size_t prvGetCurMaxSizeSPSCNoSplit(Ringbuffer_t *pxRingbuffer);
+
+//Get the maximum size an item that can currently have if sent to a SPSC byte buffer
+static size_t prvGetCurMaxSizeSPSCByteBuf(Ringbuffer_t *pxRingbuffer);
+
+//Wake the other side of a SPSC ring buffer if it is blocked in pxTasksWaiting (flagged by uxWaiter)
+static void prvWakeWaiterSPSC(Ringbuffer_t *pxRingbuffer, List_t *pxTasksWaiting, UBaseType_t uxWaiter);
+
+//From ISR version of prvWakeWaiterSPSC()
+static void prvWakeWaiterSPSCFromISR(Ringbuffer_t *pxRingbuffer,
+                                     List_t *pxTasksWaiting,
+                                     UBaseType_t uxWaiter,
+                                     BaseType_t *pxHigherPriorityTaskWoken);
+
+//Send an item/data (made of the parts in pxItem) to a SPSC ring buffer, blocking only if it is full
+static BaseType_t prvSendSPSC(Ringbuffer_t *pxRingbuffer, const RingbufferIOVec_t *pxItem, size_t xItemSize, TickType_t xTicksToWait);
+
+//Retrieve an item/data from a SPSC ring buffer, blocking only if it is empty
+static BaseType_t prvReceiveSPSC(Ringbuffer_t *pxRingbuffer, void **pvItem, size_t *xItemSize, size_t xMaxSize, TickType_t xTicksToWait);
+
 // ------------------------------------------------ Static Functions ---------------------------------------------------
 
 static void prvInitializeNewRingbuffer(size_t xBufferSize,
@@ -255,6 +353,7 @@ static void prvInitializeNewRingbuffer(size_t xBufferSize,
     vListInitialise(&pxNewRingbuffer->xTasksWaitingToSend);
     vListInitialise(&pxNewRingbuffer->xTasksWaitingToReceive);
     pxNewRingbuffer->xQueueSet = NULL;
+    pxNewRingbuffer->uxSPSCWaiters = 0;
 
     portMUX_INITIALIZE(&pxNewRingbuffer->mux);
 }
@@ -411,15 +510,17 @@ static void prvSendItemDoneNoSplit(Ringbuffer_t *pxRingbuffer, uint8_t* pucItem)
     }
 }
 
-static void prvCopyItemNoSplit(Ringbuffer_t *pxRingbuffer, const uint8_t *pucItem, size_t xItemSize)
+static void prvCopyItemNoSplit(Ringbuffer_t *pxRingbuffer, const RingbufferIOVec_t *pxItem, size_t xItemSize)
 {
+    IOVecCursor_t xCursor = { pxItem, 0 };
     uint8_t* item_addr = prvAcquireItemNoSplit(pxRingbuffer, xItemSize);
-    memcpy(item_addr, pucItem, xItemSize);
+    prvCopyFromIOVec(item_addr, &xCursor, xItemSize);
     prvSendItemDoneNoSplit(pxRingbuffer, item_addr);
 }
 
-static void prvCopyItemAllowSplit(Ringbuffer_t *pxRingbuffer, const uint8_t *pucItem, size_t xItemSize)
+static void prvCopyItemAllowSplit(Ringbuffer_t *pxRingbuffer, const RingbufferIOVec_t *pxItem, size_t xItemSize)
 {
+    IOVecCursor_t xCursor = { pxItem, 0 };          //Position in the parts of the item
     //Check arguments and buffer state
     size_t xAlignedItemSize = rbALIGN_SIZE(xItemSize);                  //Rounded up aligned item size
     size_t xRemLen = pxRingbuffer->pucTail - pxRingbuffer->pucAcquire;    //Length from pucAcquire until end of buffer
@@ -436,10 +537,9 @@ static void prvCopyItemAllowSplit(Ringbuffer_t *pxRingbuffer, const uint8_t *puc
         pxRingbuffer->pucAcquire += rbHEADER_SIZE;            //Advance pucAcquire past header
         xRemLen -= rbHEADER_SIZE;
         if (xRemLen > 0) {
-            memcpy(pxRingbuffer->pucAcquire, pucItem, xRemLen);
+            prvCopyFromIOVec(pxRingbuffer->pucAcquire, &xCursor, xRemLen);
             pxRingbuffer->xItemsWaiting++;
             //Update item arguments to account for data already copied
-            pucItem += xRemLen;
             xItemSize -= xRemLen;
             xAlignedItemSize -= xRemLen;
             pxFirstHeader->uxItemFlags |= rbITEM_SPLIT_FLAG;        //There must be more data
@@ -455,7 +555,7 @@ static void prvCopyItemAllowSplit(Ringbuffer_t *pxRingbuffer, const uint8_t *puc
     pxSecondHeader->xItemLen = xItemSize;
     pxSecondHeader->uxItemFlags = 0;
     pxRingbuffer->pucAcquire += rbHEADER_SIZE;     //Advance acquire pointer past header
-    memcpy(pxRingbuffer->pucAcquire, pucItem, xItemSize);
+    prvCopyFromIOVec(pxRingbuffer->pucAcquire, &xCursor, xItemSize);
     pxRingbuffer->xItemsWaiting++;
     pxRingbuffer->pucAcquire += xAlignedItemSize;  //Advance pucAcquire past item to next aligned address
 
@@ -473,23 +573,23 @@ static void prvCopyItemAllowSplit(Ringbuffer_t *pxRingbuffer, const uint8_t *puc
     pxRingbuffer->pucWrite = pxRingbuffer->pucAcquire;
 }
 
-static void prvCopyItemByteBuf(Ringbuffer_t *pxRingbuffer, const uint8_t *pucItem, size_t xItemSize)
+static void prvCopyItemByteBuf(Ringbuffer_t *pxRingbuffer, const RingbufferIOVec_t *pxItem, size_t xItemSize)
 {
+    IOVecCursor_t xCursor = { pxItem, 0 };          //Position in the parts of the item
     //Check arguments and buffer state
     configASSERT(pxRingbuffer->pucAcquire >= pxRingbuffer->pucHead && pxRingbuffer->pucAcquire < pxRingbuffer->pucTail);    //Check acquire pointer is within bounds
 
     size_t xRemLen = pxRingbuffer->pucTail - pxRingbuffer->pucAcquire;    //Length from pucAcquire until end of buffer
     if (xRemLen < xItemSize) {
         //Copy as much as possible into remaining length
-        memcpy(pxRingbuffer->pucAcquire, pucItem, xRemLen);
+        prvCopyFromIOVec(pxRingbuffer->pucAcquire, &xCursor, xRemLen);
         pxRingbuffer->xItemsWaiting += xRemLen;
         //Update item arguments to account for data already written
-        pucItem += xRemLen;
         xItemSize -= xRemLen;
         pxRingbuffer->pucAcquire = pxRingbuffer->pucHead;     //Reset acquire pointer to start of buffer
     }
     //Copy all or remaining portion of the item
-    memcpy(pxRingbuffer->pucAcquire, pucItem, xItemSize);
+    prvCopyFromIOVec(pxRingbuffer->pucAcquire, &xCursor, xItemSize);
     pxRingbuffer->xItemsWaiting += xItemSize;
     pxRingbuffer->pucAcquire += xItemSize;
 
@@ -525,6 +625,27 @@ static BaseType_t prvCheckItemAvail(Ringbuffer_t *pxRingbuffer)
     }
 }
 
+static void prvCopyFromIOVec(uint8_t *pucDest, IOVecCursor_t *pxCursor, size_t xLen)
+{
+    while (xLen > 0) {
+        const RingbufferIOVec_t *pxPart = pxCursor->pxPart;
+        size_t xCopyLen = pxPart->xLen - pxCursor->xOffset;
+        if (xCopyLen == 0) {
+            //Part completely copied (or empty), move on to the next one
+            pxCursor->pxPart++;
+            pxCursor->xOffset = 0;
+            continue;
+        }
+        if (xCopyLen > xLen) {
+            xCopyLen = xLen;
+        }
+        memcpy(pucDest, (const uint8_t *)pxPart->pvData + pxCursor->xOffset, xCopyLen);
+        pucDest += xCopyLen;
+        pxCursor->xOffset += xCopyLen;
+        xLen -= xCopyLen;
+    }
+}
+
 static void *prvGetItemDefault(Ringbuffer_t *pxRingbuffer,
                                BaseType_t *pxIsSplit,
                                size_t xUnusedParam,
@@ -756,7 +877,7 @@ static size_t prvGetCurMaxSizeByteBuf(Ringbuffer_t *pxRingbuffer)
 }
 
 static BaseType_t prvSendAcquireGeneric(Ringbuffer_t *pxRingbuffer,
-                                        const void *pvItem,
+                                        const RingbufferIOVec_t *pxItem,
                                         void **ppvItem,
                                         size_t xItemSize,
                                         TickType_t xTicksToWait)
@@ -776,7 +897,7 @@ static BaseType_t prvSendAcquireGeneric(Ringbuffer_t *pxRingbuffer,
                 *ppvItem = prvAcquireItemNoSplit(pxRingbuffer, xItemSize);
             } else {
                 //Copy item into buffer
-                pxRingbuffer->vCopyItem(pxRingbuffer, pvItem, xItemSize);
+                pxRingbuffer->vCopyItem(pxRingbuffer, pxItem, xItemSize);
                 if (pxRingbuffer->xQueueSet) {
                     //If ring buffer was added to a queue set, notify the queue set
                     xNotifyQueueSet = pdTRUE;
@@ -837,6 +958,10 @@ static BaseType_t prvReceiveGeneric(Ringbuffer_t *pxRingbuffer,
 
     ESP_STATIC_ANALYZER_CHECK(!pvItem1 || !xItemSize1, pdFALSE);
 
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        return prvReceiveSPSC(pxRingbuffer, pvItem1, xItemSize1, xMaxSize, xTicksToWait);
+    }
+
     while (xExitLoop == pdFALSE) {
         portENTER_CRITICAL(&pxRingbuffer->mux);
         if (prvCheckItemAvail(pxRingbuffer) == pdTRUE) {
@@ -899,6 +1024,15 @@ static BaseType_t prvReceiveGenericFromISR(Ringbuffer_t *pxRingbuffer,
 
     ESP_STATIC_ANALYZER_CHECK(!pvItem1 || !xItemSize1, pdFALSE);
 
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        if (prvCheckItemAvailSPSC(pxRingbuffer) == pdFALSE) {
+            return pdFALSE;
+        }
+        BaseType_t xIsSplit;
+        *pvItem1 = pxRingbuffer->pvGetItem(pxRingbuffer, &xIsSplit, xMaxSize, xItemSize1);
+        return pdTRUE;
+    }
+
     portENTER_CRITICAL_ISR(&pxRingbuffer->mux);
     if (prvCheckItemAvail(pxRingbuffer) == pdTRUE) {
         BaseType_t xIsSplit = pdFALSE;
@@ -929,6 +1063,435 @@ static BaseType_t prvReceiveGenericFromISR(Ringbuffer_t *pxRingbuffer,
     return xReturn;
 }
 
+static size_t prvReceiveMultipleGeneric(Ringbuffer_t *pxRingbuffer,
+                                        void **ppvItems,
+                                        size_t *pxItemSizes,
+                                        size_t xMaxItems,
+                                        TickType_t xTicksToWait)
+{
+    size_t xReturn = 0;
+    BaseType_t xExitLoop = pdFALSE;
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+    BaseType_t xIsSplit;
+
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        if (prvReceiveSPSC(pxRingbuffer, &ppvItems[0], &pxItemSizes[0], 0, xTicksToWait) == pdFALSE) {
+            return 0;
+        }
+        //Lock-free, simply get the items which have been published in the meantime
+        for (xReturn = 1; xReturn < xMaxItems && prvCheckItemAvailSPSC(pxRingbuffer) == pdTRUE; xReturn++) {
+            ppvItems[xReturn] = pxRingbuffer->pvGetItem(pxRingbuffer, &xIsSplit, 0, &pxItemSizes[xReturn]);
+        }
+        return xReturn;
+    }
+
+    while (xExitLoop == pdFALSE) {
+        portENTER_CRITICAL(&pxRingbuffer->mux);
+        if (prvCheckItemAvail(pxRingbuffer) == pdTRUE) {
+            //Get all the items available, up to xMaxItems
+            do {
+                ppvItems[xReturn] = pxRingbuffer->pvGetItem(pxRingbuffer, &xIsSplit, 0, &pxItemSizes[xReturn]);
+                xReturn++;
+            } while (xReturn < xMaxItems && prvCheckItemAvail(pxRingbuffer) == pdTRUE);
+            xExitLoop = pdTRUE;
+            goto loop_end;
+        } else if (xTicksToWait == (TickType_t) 0) {
+            //No block time. Return immediately.
+            xExitLoop = pdTRUE;
+            goto loop_end;
+        } else if (xEntryTimeSet == pdFALSE) {
+            //This is our first block. Set entry time
+            vTaskInternalSetTimeOutState(&xTimeOut);
+            xEntryTimeSet = pdTRUE;
+        }
+
+        if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) == pdFALSE) {
+            //Not timed out yet. Block the current task
+            vTaskPlaceOnEventList(&pxRingbuffer->xTasksWaitingToReceive, xTicksToWait);
+            portYIELD_WITHIN_API();
+        } else {
+            //We have timed out.
+            xExitLoop = pdTRUE;
+        }
+loop_end:
+        portEXIT_CRITICAL(&pxRingbuffer->mux);
+    }
+
+    return xReturn;
+}
+
+static BaseType_t prvCheckItemFitsSPSCNoSplit(Ringbuffer_t *pxRingbuffer, size_t xItemSize)
+{
+    uint8_t *pucWrite = pxRingbuffer->pucWrite;     //Only written by the producer (i.e., the caller)
+    uint8_t *pucFree = rbLOAD_ACQUIRE(pxRingbuffer->pucFree);
+    configASSERT(rbCHECK_ALIGNED(pucWrite));
+
+    size_t xTotalItemSize = rbALIGN_SIZE(xItemSize) + rbHEADER_SIZE;    //Rounded up aligned item size with header
+    if (pucFree > pucWrite) {
+        //Free space does not wrap around. pucWrite must stay behind pucFree
+        return (xTotalItemSize < pucFree - pucWrite) ? pdTRUE : pdFALSE;
+    }
+    //Free space wraps around (or the buffer is empty)
+    if (xTotalItemSize <= pxRingbuffer->pucTail - pucWrite) {
+        //Item fits without wrapping around, unless pucWrite would wrap around onto pucFree after it
+        if (pxRingbuffer->pucTail - (pucWrite + xTotalItemSize) >= rbHEADER_SIZE || pucFree != pxRingbuffer->pucHead) {
+            return pdTRUE;
+        }
+    }
+    //Check if item fits by wrapping
+    return (xTotalItemSize < pucFree - pxRingbuffer->pucHead) ? pdTRUE : pdFALSE;
+}
+
+static BaseType_t prvCheckItemFitsSPSCByteBuf(Ringbuffer_t *pxRingbuffer, size_t xItemSize)
+{
+    uint8_t *pucFree = rbLOAD_ACQUIRE(pxRingbuffer->pucFree);
+    //One byte is kept free so that pucWrite never catches up with pucFree
+    BaseType_t xFreeSize = pucFree - pxRingbuffer->pucWrite - 1;
+    if (xFreeSize < 0) {
+        xFreeSize += pxRingbuffer->xSize;
+    }
+    return (xItemSize <= xFreeSize) ? pdTRUE : pdFALSE;
+}
+
+static void prvCopyItemSPSCNoSplit(Ringbuffer_t *pxRingbuffer, const RingbufferIOVec_t *pxItem, size_t xItemSize)
+{
+    IOVecCursor_t xCursor = { pxItem, 0 };
+    uint8_t *pucWrite = pxRingbuffer->pucWrite;
+    size_t xAlignedItemSize = rbALIGN_SIZE(xItemSize);                  //Rounded up aligned item size
+    configASSERT(pucWrite >= pxRingbuffer->pucHead && pucWrite < pxRingbuffer->pucTail);    //Check write pointer is within bounds
+    configASSERT(pxRingbuffer->pucTail - pucWrite >= rbHEADER_SIZE);    //Remaining length must be able to at least fit an item header
+
+    //If remaining length can't fit item, set as dummy data and wrap around
+    if (pxRingbuffer->pucTail - pucWrite < xAlignedItemSize + rbHEADER_SIZE) {
+        ItemHeader_t *pxDummy = (ItemHeader_t *)pucWrite;
+        pxDummy->uxItemFlags = rbITEM_DUMMY_DATA_FLAG;
+        pxDummy->xItemLen = 0;
+        pucWrite = pxRingbuffer->pucHead;
+    }
+
+    //Set item header and copy data
+    ItemHeader_t *pxHeader = (ItemHeader_t *)pucWrite;
+    pxHeader->xItemLen = xItemSize;
+    pxHeader->uxItemFlags = rbITEM_WRITTEN_FLAG;
+    prvCopyFromIOVec(pucWrite + rbHEADER_SIZE, &xCursor, xItemSize);
+    pucWrite += rbHEADER_SIZE + xAlignedItemSize;
+
+    //If current remaining length can't fit a header, wrap around write pointer
+    if (pxRingbuffer->pucTail - pucWrite < rbHEADER_SIZE) {
+        pucWrite = pxRingbuffer->pucHead;
+    }
+    //Only for debugging (see vRingbufferGetInfo()), pucAcquire is not read by the consumer
+    pxRingbuffer->pucAcquire = pucWrite;
+    //Publish the item to the consumer
+    rbSTORE_RELEASE(pxRingbuffer->pucWrite, pucWrite);
+}
+
+static void prvCopyItemSPSCByteBuf(Ringbuffer_t *pxRingbuffer, const RingbufferIOVec_t *pxItem, size_t xItemSize)
+{
+    IOVecCursor_t xCursor = { pxItem, 0 };
+    uint8_t *pucWrite = pxRingbuffer->pucWrite;
+    size_t xRemLen = pxRingbuffer->pucTail - pucWrite;     //Length from pucWrite until end of buffer
+    configASSERT(pucWrite >= pxRingbuffer->pucHead && pucWrite < pxRingbuffer->pucTail);    //Check write pointer is within bounds
+
+    if (xRemLen < xItemSize) {
+        //Copy as much as possible into remaining length, then wrap around
+        prvCopyFromIOVec(pucWrite, &xCursor, xRemLen);
+        xItemSize -= xRemLen;
+        pucWrite = pxRingbuffer->pucHead;
+    }
+    prvCopyFromIOVec(pucWrite, &xCursor, xItemSize);
+    pucWrite += xItemSize;
+
+    //Wrap around pucWrite if it reaches the end
+    if (pucWrite == pxRingbuffer->pucTail) {
+        pucWrite = pxRingbuffer->pucHead;
+    }
+    pxRingbuffer->pucAcquire = pucWrite;
+    //Publish the data to the consumer
+    rbSTORE_RELEASE(pxRingbuffer->pucWrite, pucWrite);
+}
+
+static BaseType_t prvCheckItemAvailSPSC(Ringbuffer_t *pxRingbuffer)
+{
+    if ((pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) && pxRingbuffer->pucRead != pxRingbuffer->pucFree) {
+        return pdFALSE;     //Byte buffers do not allow multiple retrievals before return
+    }
+    //pucWrite never catches up with pucFree, so pucRead == pucWrite only if there is nothing to read
+    return (pxRingbuffer->pucRead != rbLOAD_ACQUIRE(pxRingbuffer->pucWrite)) ? pdTRUE : pdFALSE;
+}
+
+static void *prvGetItemSPSCNoSplit(Ringbuffer_t *pxRingbuffer,
+                                   BaseType_t *pxIsSplit,
+                                   size_t xUnusedParam,
+                                   size_t *pxItemSize)
+{
+    ItemHeader_t *pxHeader = (ItemHeader_t *)pxRingbuffer->pucRead;
+    configASSERT(rbCHECK_ALIGNED(pxRingbuffer->pucRead));
+    configASSERT(pxRingbuffer->pucRead >= pxRingbuffer->pucHead && pxRingbuffer->pucRead < pxRingbuffer->pucTail);      //Check read pointer is within bounds
+
+    //Wrap around if dummy data (dummy data indicates wrap around in no-split buffers)
+    if (pxHeader->uxItemFlags & rbITEM_DUMMY_DATA_FLAG) {
+        pxRingbuffer->pucRead = pxRingbuffer->pucHead;
+        pxHeader = (ItemHeader_t *)pxRingbuffer->pucRead;
+    }
+    configASSERT(pxHeader->xItemLen <= pxRingbuffer->xMaxItemSize);
+    uint8_t *pcReturn = pxRingbuffer->pucRead + rbHEADER_SIZE;
+    *pxItemSize = pxHeader->xItemLen;
+    *pxIsSplit = pdFALSE;
+
+    pxRingbuffer->pucRead += rbHEADER_SIZE + rbALIGN_SIZE(pxHeader->xItemLen);   //Update pucRead
+    //Check if pucRead requires wrap around
+    if ((pxRingbuffer->pucTail - pxRingbuffer->pucRead) < rbHEADER_SIZE) {
+        pxRingbuffer->pucRead = pxRingbuffer->pucHead;
+    }
+    return (void *)pcReturn;
+}
+
+static void *prvGetItemSPSCByteBuf(Ringbuffer_t *pxRingbuffer,
+                                   BaseType_t *pxUnusedParam,
+                                   size_t xMaxSize,
+                                   size_t *pxItemSize)
+{
+    uint8_t *pucWrite = rbLOAD_ACQUIRE(pxRingbuffer->pucWrite);
+    uint8_t *ret = pxRingbuffer->pucRead;
+    configASSERT(pxRingbuffer->pucRead >= pxRingbuffer->pucHead && pxRingbuffer->pucRead < pxRingbuffer->pucTail);    //Check read pointer is within bounds
+    configASSERT(pxRingbuffer->pucRead == pxRingbuffer->pucFree);
+
+    //Return contiguous piece from read pointer until write pointer or buffer tail, or xMaxSize
+    size_t xSize = (pucWrite > ret) ? (size_t)(pucWrite - ret) : (size_t)(pxRingbuffer->pucTail - ret);
+    if (xMaxSize != 0 && xSize > xMaxSize) {
+        xSize = xMaxSize;
+    }
+    *pxItemSize = xSize;
+    pxRingbuffer->pucRead += xSize;
+    if (pxRingbuffer->pucRead == pxRingbuffer->pucTail) {
+        pxRingbuffer->pucRead = pxRingbuffer->pucHead;  //Wrap around read pointer
+    }
+    return (void *)ret;
+}
+
+static void prvReturnItemSPSCNoSplit(Ringbuffer_t *pxRingbuffer, uint8_t *pucItem)
+{
+    //Check arguments and buffer state
+    configASSERT(rbCHECK_ALIGNED(pucItem));
+    configASSERT(pucItem >= pxRingbuffer->pucHead);
+    configASSERT(pucItem <= pxRingbuffer->pucTail);     //Inclusive of pucTail in the case of zero length item at the very end
+
+    ItemHeader_t *pxCurHeader = (ItemHeader_t *)(pucItem - rbHEADER_SIZE);
+    configASSERT(pxCurHeader->xItemLen <= pxRingbuffer->xMaxItemSize);
+    configASSERT((pxCurHeader->uxItemFlags & (rbITEM_DUMMY_DATA_FLAG | rbITEM_FREE_FLAG)) == 0);    //Not a dummy item, not returned before
+    pxCurHeader->uxItemFlags |= rbITEM_FREE_FLAG;
+
+    /*
+     * Same as prvReturnItemDefault(), items might not be returned in the order they were
+     * retrieved. Items between pucFree and pucRead belong to the consumer, the header at
+     * pucRead must not be read as the producer might be writing it.
+     */
+    uint8_t *pucFree = pxRingbuffer->pucFree;
+    while (pucFree != pxRingbuffer->pucRead) {
+        pxCurHeader = (ItemHeader_t *)pucFree;
+        if (pxCurHeader->uxItemFlags & rbITEM_DUMMY_DATA_FLAG) {
+            pucFree = pxRingbuffer->pucHead;    //Wrap around due to dummy data
+        } else if (pxCurHeader->uxItemFlags & rbITEM_FREE_FLAG) {
+            pucFree += rbALIGN_SIZE(pxCurHeader->xItemLen) + rbHEADER_SIZE;
+            configASSERT(pucFree <= pxRingbuffer->pucTail);
+            //Check if pucFree requires wrap around
+            if ((pxRingbuffer->pucTail - pucFree) < rbHEADER_SIZE) {
+                pucFree = pxRingbuffer->pucHead;
+            }
+        } else {
+            break;      //Item has not been returned yet
+        }
+    }
+    //Hand the space over to the producer
+    rbSTORE_RELEASE(pxRingbuffer->pucFree, pucFree);
+}
+
+static void prvReturnItemSPSCByteBuf(Ringbuffer_t *pxRingbuffer, uint8_t *pucItem)
+{
+    //Check pointer points to address inside buffer
+    configASSERT((uint8_t *)pucItem >= pxRingbuffer->pucHead);
+    configASSERT((uint8_t *)pucItem < pxRingbuffer->pucTail);
+    //Byte buffers do not allow multiple outstanding reads, free everything up to the read pointer
+    rbSTORE_RELEASE(pxRingbuffer->pucFree, pxRingbuffer->pucRead);
+}
+
+static size_t prvGetCurMaxSizeSPSCNoSplit(Ringbuffer_t *pxRingbuffer)
+{
+    BaseType_t xFreeSize;
+    uint8_t *pucWrite = rbLOAD_ACQUIRE(pxRingbuffer->pucWrite);
+    uint8_t *pucFree = rbLOAD_ACQUIRE(pxRingbuffer->pucFree);
+
+    if (pucWrite < pucFree) {
+        //Free space is contiguous between pucWrite and pucFree, minus the gap
+        xFreeSize = pucFree - pucWrite - (rbALIGN_MASK + 1);
+    } else {
+        //Free space wraps around, select largest contiguous free space
+        BaseType_t xSize1 = pxRingbuffer->pucTail - pucWrite;
+        BaseType_t xSize2 = pucFree - pxRingbuffer->pucHead - (rbALIGN_MASK + 1);
+        if (pucFree == pxRingbuffer->pucHead) {
+            //pucWrite must not wrap around onto pucFree after the item
+            xSize1 -= rbHEADER_SIZE;
+        }
+        xFreeSize = (xSize1 > xSize2) ? xSize1 : xSize2;
+    }
+
+    //No-split ring buffer items need space for a header
+    xFreeSize -= rbHEADER_SIZE;
+    if (xFreeSize < 0) {
+        xFreeSize = 0;
+    } else if (xFreeSize > pxRingbuffer->xMaxItemSize) {
+        xFreeSize = pxRingbuffer->xMaxItemSize;
+    }
+    return xFreeSize;
+}
+
+static size_t prvGetCurMaxSizeSPSCByteBuf(Ringbuffer_t *pxRingbuffer)
+{
+    BaseType_t xFreeSize = rbLOAD_ACQUIRE(pxRingbuffer->pucFree) - rbLOAD_ACQUIRE(pxRingbuffer->pucWrite) - 1;
+    if (xFreeSize < 0) {
+        xFreeSize += pxRingbuffer->xSize;
+    }
+    return xFreeSize;
+}
+
+static void prvWakeWaiterSPSC(Ringbuffer_t *pxRingbuffer, List_t *pxTasksWaiting, UBaseType_t uxWaiter)
+{
+    //Order the store publishing the pointer before the load of the waiter flags (see prvSendSPSC())
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if ((__atomic_load_n(&pxRingbuffer->uxSPSCWaiters, __ATOMIC_RELAXED) & uxWaiter) == 0) {
+        return;     //Fast path, the other side is not blocked
+    }
+    portENTER_CRITICAL(&pxRingbuffer->mux);
+    __atomic_store_n(&pxRingbuffer->uxSPSCWaiters, pxRingbuffer->uxSPSCWaiters & ~uxWaiter, __ATOMIC_RELAXED);
+    if (listLIST_IS_EMPTY(pxTasksWaiting) == pdFALSE) {
+        if (xTaskRemoveFromEventList(pxTasksWaiting) == pdTRUE) {
+            //The unblocked task will preempt us. Trigger a yield here.
+            portYIELD_WITHIN_API();
+        }
+    }
+    portEXIT_CRITICAL(&pxRingbuffer->mux);
+}
+
+static void prvWakeWaiterSPSCFromISR(Ringbuffer_t *pxRingbuffer,
+                                     List_t *pxTasksWaiting,
+                                     UBaseType_t uxWaiter,
+                                     BaseType_t *pxHigherPriorityTaskWoken)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if ((__atomic_load_n(&pxRingbuffer->uxSPSCWaiters, __ATOMIC_RELAXED) & uxWaiter) == 0) {
+        return;
+    }
+    portENTER_CRITICAL_ISR(&pxRingbuffer->mux);
+    __atomic_store_n(&pxRingbuffer->uxSPSCWaiters, pxRingbuffer->uxSPSCWaiters & ~uxWaiter, __ATOMIC_RELAXED);
+    if (listLIST_IS_EMPTY(pxTasksWaiting) == pdFALSE) {
+        if (xTaskRemoveFromEventList(pxTasksWaiting) == pdTRUE) {
+            //The unblocked task will preempt us. Record that a context switch is required.
+            if (pxHigherPriorityTaskWoken != NULL) {
+                *pxHigherPriorityTaskWoken = pdTRUE;
+            }
+        }
+    }
+    portEXIT_CRITICAL_ISR(&pxRingbuffer->mux);
+}
+
+static BaseType_t prvSendSPSC(Ringbuffer_t *pxRingbuffer, const RingbufferIOVec_t *pxItem, size_t xItemSize, TickType_t xTicksToWait)
+{
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+
+    while (pxRingbuffer->xCheckItemFits(pxRingbuffer, xItemSize) == pdFALSE) {
+        BaseType_t xTimedOut = pdFALSE;
+        BaseType_t xBlocked = pdFALSE;
+        if (xTicksToWait == (TickType_t) 0) {
+            //No block time. Return immediately.
+            return pdFALSE;
+        }
+        /*
+         * The buffer is full. Flag the producer as waiting, then check again within the
+         * critical section. The consumer publishes pucFree before checking the flag in
+         * prvWakeWaiterSPSC(), so either the check below sees the freed space, or the
+         * consumer sees the flag and takes the critical section (held until this task is
+         * on the event list) to unblock this task.
+         */
+        portENTER_CRITICAL(&pxRingbuffer->mux);
+        __atomic_store_n(&pxRingbuffer->uxSPSCWaiters, pxRingbuffer->uxSPSCWaiters | rbSPSC_SENDER_WAITING, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (pxRingbuffer->xCheckItemFits(pxRingbuffer, xItemSize) == pdFALSE) {
+            if (xEntryTimeSet == pdFALSE) {
+                //This is our first block. Set entry time
+                vTaskInternalSetTimeOutState(&xTimeOut);
+                xEntryTimeSet = pdTRUE;
+            }
+            if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) == pdFALSE) {
+                //Not timed out yet. Block the current task, the flag is cleared by the task that unblocks it
+                vTaskPlaceOnEventList(&pxRingbuffer->xTasksWaitingToSend, xTicksToWait);
+                portYIELD_WITHIN_API();
+                xBlocked = pdTRUE;
+            } else {
+                xTimedOut = pdTRUE;
+            }
+        }
+        if (xBlocked == pdFALSE) {
+            __atomic_store_n(&pxRingbuffer->uxSPSCWaiters, pxRingbuffer->uxSPSCWaiters & ~rbSPSC_SENDER_WAITING, __ATOMIC_RELAXED);
+        }
+        portEXIT_CRITICAL(&pxRingbuffer->mux);
+        if (xTimedOut == pdTRUE) {
+            return pdFALSE;
+        }
+    }
+    pxRingbuffer->vCopyItem(pxRingbuffer, pxItem, xItemSize);
+    //If the consumer is waiting for data to arrive on the ring buffer, unblock it
+    prvWakeWaiterSPSC(pxRingbuffer, &pxRingbuffer->xTasksWaitingToReceive, rbSPSC_RECEIVER_WAITING);
+    return pdTRUE;
+}
+
+static BaseType_t prvReceiveSPSC(Ringbuffer_t *pxRingbuffer, void **pvItem, size_t *xItemSize, size_t xMaxSize, TickType_t xTicksToWait)
+{
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+
+    while (prvCheckItemAvailSPSC(pxRingbuffer) == pdFALSE) {
+        BaseType_t xTimedOut = pdFALSE;
+        BaseType_t xBlocked = pdFALSE;
+        if (xTicksToWait == (TickType_t) 0) {
+            //No block time. Return immediately.
+            return pdFALSE;
+        }
+        //The buffer is empty. Same as prvSendSPSC(), with pucWrite published by the producer
+        portENTER_CRITICAL(&pxRingbuffer->mux);
+        __atomic_store_n(&pxRingbuffer->uxSPSCWaiters, pxRingbuffer->uxSPSCWaiters | rbSPSC_RECEIVER_WAITING, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (prvCheckItemAvailSPSC(pxRingbuffer) == pdFALSE) {
+            if (xEntryTimeSet == pdFALSE) {
+                //This is our first block. Set entry time
+                vTaskInternalSetTimeOutState(&xTimeOut);
+                xEntryTimeSet = pdTRUE;
+            }
+            if (xTaskCheckForTimeOut(&xTimeOut, &xTicksToWait) == pdFALSE) {
+                //Not timed out yet. Block the current task, the flag is cleared by the task that unblocks it
+                vTaskPlaceOnEventList(&pxRingbuffer->xTasksWaitingToReceive, xTicksToWait);
+                portYIELD_WITHIN_API();
+                xBlocked = pdTRUE;
+            } else {
+                xTimedOut = pdTRUE;
+            }
+        }
+        if (xBlocked == pdFALSE) {
+            __atomic_store_n(&pxRingbuffer->uxSPSCWaiters, pxRingbuffer->uxSPSCWaiters & ~rbSPSC_RECEIVER_WAITING, __ATOMIC_RELAXED);
+        }
+        portEXIT_CRITICAL(&pxRingbuffer->mux);
+        if (xTimedOut == pdTRUE) {
+            return pdFALSE;
+        }
+    }
+    //The space of the item is only freed when it is returned, the producer is not woken here
+    BaseType_t xIsSplit;
+    *pvItem = pxRingbuffer->pvGetItem(pxRingbuffer, &xIsSplit, xMaxSize, xItemSize);
+    return pdTRUE;
+}
+
 // ------------------------------------------------ Public Functions ---------------------------------------------------
 
 RingbufHandle_t xRingbufferCreate(size_t xBufferSize, RingbufferType_t xBufferType)
@@ -961,6 +1524,53 @@ RingbufHandle_t xRingbufferCreateNoSplit(size_t xItemSize, size_t xItemNum)
     return xRingbufferCreate((rbALIGN_SIZE(xItemSize) + rbHEADER_SIZE) * xItemNum, RINGBUF_TYPE_NOSPLIT);
 }
 
+RingbufHandle_t xRingbufferCreateSPSC(size_t xBufferSize, RingbufferType_t xBufferType)
+{
+    configASSERT(xBufferSize > 0);
+    configASSERT(xBufferType == RINGBUF_TYPE_NOSPLIT || xBufferType == RINGBUF_TYPE_BYTEBUF);
+
+    /*
+     * Allocate memory. The write pointer never catches up with the free pointer, so some
+     * storage is added for the gap between them: one byte for byte buffers, a header for
+     * no-split buffers, so that items filling xBufferSize still leave room for a header
+     * instead of wrapping the write pointer onto the free pointer.
+     */
+    size_t xStorageSize;
+    if (xBufferType == RINGBUF_TYPE_BYTEBUF) {
+        xStorageSize = xBufferSize + 1;
+    } else {
+        xBufferSize = rbALIGN_SIZE(xBufferSize);    //xBufferSize is rounded up for no-split buffers
+        xStorageSize = xBufferSize + rbHEADER_SIZE;
+    }
+    Ringbuffer_t *pxNewRingbuffer = calloc(1, sizeof(Ringbuffer_t));
+    uint8_t *pucRingbufferStorage = malloc(xStorageSize);
+    if (pxNewRingbuffer == NULL || pucRingbufferStorage == NULL) {
+        free(pxNewRingbuffer);
+        free(pucRingbufferStorage);
+        return NULL;
+    }
+
+    prvInitializeNewRingbuffer(xStorageSize, xBufferType, pxNewRingbuffer, pucRingbufferStorage);
+    pxNewRingbuffer->uxRingbufferFlags |= rbSPSC_FLAG;
+    if (xBufferType == RINGBUF_TYPE_BYTEBUF) {
+        pxNewRingbuffer->xCheckItemFits = prvCheckItemFitsSPSCByteBuf;
+        pxNewRingbuffer->vCopyItem = prvCopyItemSPSCByteBuf;
+        pxNewRingbuffer->pvGetItem = prvGetItemSPSCByteBuf;
+        pxNewRingbuffer->vReturnItem = prvReturnItemSPSCByteBuf;
+        pxNewRingbuffer->xGetCurMaxSize = prvGetCurMaxSizeSPSCByteBuf;
+        pxNewRingbuffer->xMaxItemSize = xBufferSize;
+    } else {
+        pxNewRingbuffer->xCheckItemFits = prvCheckItemFitsSPSCNoSplit;
+        pxNewRingbuffer->vCopyItem = prvCopyItemSPSCNoSplit;
+        pxNewRingbuffer->pvGetItem = prvGetItemSPSCNoSplit;
+        pxNewRingbuffer->vReturnItem = prvReturnItemSPSCNoSplit;
+        pxNewRingbuffer->xGetCurMaxSize = prvGetCurMaxSizeSPSCNoSplit;
+        //Same as xRingbufferCreate(), the gap makes sure an item of this size always fits in an empty buffer
+        pxNewRingbuffer->xMaxItemSize = rbALIGN_SIZE(xBufferSize / 2) - rbHEADER_SIZE;
+    }
+    return (RingbufHandle_t)pxNewRingbuffer;
+}
+
 RingbufHandle_t xRingbufferCreateStatic(size_t xBufferSize,
                                         RingbufferType_t xBufferType,
                                         uint8_t *pucRingbufferStorage,
@@ -989,6 +1599,7 @@ BaseType_t xRingbufferSendAcquire(RingbufHandle_t xRingbuffer, void **ppvItem, s
     configASSERT(pxRingbuffer);
     configASSERT(ppvItem != NULL);
     configASSERT((pxRingbuffer->uxRingbufferFlags & (rbBYTE_BUFFER_FLAG | rbALLOW_SPLIT_FLAG)) == 0); //Send acquire currently only supported in NoSplit buffers
+    configASSERT((pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) == 0);     //Nor in SPSC buffers
 
     *ppvItem = NULL;
     if (xItemSize > pxRingbuffer->xMaxItemSize) {
@@ -1006,7 +1617,7 @@ BaseType_t xRingbufferSendComplete(RingbufHandle_t xRingbuffer, void *pvItem)
     //Check arguments
     configASSERT(pxRingbuffer);
     configASSERT(pvItem != NULL);
-    configASSERT((pxRingbuffer->uxRingbufferFlags & (rbBYTE_BUFFER_FLAG | rbALLOW_SPLIT_FLAG)) == 0);
+    configASSERT((pxRingbuffer->uxRingbufferFlags & (rbBYTE_BUFFER_FLAG | rbALLOW_SPLIT_FLAG | rbSPSC_FLAG)) == 0);
 
     portENTER_CRITICAL(&pxRingbuffer->mux);
     prvSendItemDoneNoSplit(pxRingbuffer, pvItem);
@@ -1046,8 +1657,40 @@ BaseType_t xRingbufferSend(RingbufHandle_t xRingbuffer,
     if ((pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) && xItemSize == 0) {
         return pdTRUE;      //Sending 0 bytes to byte buffer has no effect
     }
+    const RingbufferIOVec_t xItem = { .pvData = pvItem, .xLen = xItemSize };
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        return prvSendSPSC(pxRingbuffer, &xItem, xItemSize, xTicksToWait);
+    }
+
+    return prvSendAcquireGeneric(pxRingbuffer, &xItem, NULL, xItemSize, xTicksToWait);
+}
+
+BaseType_t xRingbufferSendv(RingbufHandle_t xRingbuffer,
+                            const RingbufferIOVec_t *pxIOVec,
+                            size_t xIOVecCount,
+                            TickType_t xTicksToWait)
+{
+    Ringbuffer_t *pxRingbuffer = (Ringbuffer_t *)xRingbuffer;
+
+    //Check arguments
+    configASSERT(pxRingbuffer);
+    configASSERT(pxIOVec != NULL || xIOVecCount == 0);
+    size_t xItemSize = 0;
+    for (size_t i = 0; i < xIOVecCount; i++) {
+        configASSERT(pxIOVec[i].pvData != NULL || pxIOVec[i].xLen == 0);
+        xItemSize += pxIOVec[i].xLen;
+    }
+    if (xItemSize > pxRingbuffer->xMaxItemSize) {
+        return pdFALSE;     //Data will never ever fit in the queue.
+    }
+    if ((pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) && xItemSize == 0) {
+        return pdTRUE;      //Sending 0 bytes to byte buffer has no effect
+    }
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        return prvSendSPSC(pxRingbuffer, pxIOVec, xItemSize, xTicksToWait);
+    }
 
-    return prvSendAcquireGeneric(pxRingbuffer, pvItem, NULL, xItemSize, xTicksToWait);
+    return prvSendAcquireGeneric(pxRingbuffer, pxIOVec, NULL, xItemSize, xTicksToWait);
 }
 
 BaseType_t xRingbufferSendFromISR(RingbufHandle_t xRingbuffer,
@@ -1068,10 +1711,19 @@ BaseType_t xRingbufferSendFromISR(RingbufHandle_t xRingbuffer,
     if ((pxRingbuffer->uxRingbufferFlags & rbBYTE_BUFFER_FLAG) && xItemSize == 0) {
         return pdTRUE;      //Sending 0 bytes to byte buffer has no effect
     }
+    const RingbufferIOVec_t xItem = { .pvData = pvItem, .xLen = xItemSize };
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        if (pxRingbuffer->xCheckItemFits(pxRingbuffer, xItemSize) == pdFALSE) {
+            return pdFALSE;
+        }
+        pxRingbuffer->vCopyItem(pxRingbuffer, &xItem, xItemSize);
+        prvWakeWaiterSPSCFromISR(pxRingbuffer, &pxRingbuffer->xTasksWaitingToReceive, rbSPSC_RECEIVER_WAITING, pxHigherPriorityTaskWoken);
+        return pdTRUE;
+    }
 
     portENTER_CRITICAL_ISR(&pxRingbuffer->mux);
     if (pxRingbuffer->xCheckItemFits(xRingbuffer, xItemSize) == pdTRUE) {
-        pxRingbuffer->vCopyItem(xRingbuffer, pvItem, xItemSize);
+        pxRingbuffer->vCopyItem(xRingbuffer, &xItem, xItemSize);
         if (pxRingbuffer->xQueueSet) {
             //If ring buffer was added to a queue set, notify the queue set
             xNotifyQueueSet = pdTRUE;
@@ -1210,6 +1862,13 @@ void vRingbufferReturnItem(RingbufHandle_t xRingbuffer, void *pvItem)
     configASSERT(pxRingbuffer);
     configASSERT(pvItem != NULL);
 
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        pxRingbuffer->vReturnItem(pxRingbuffer, (uint8_t *)pvItem);
+        //If the producer is waiting for space to send, unblock it
+        prvWakeWaiterSPSC(pxRingbuffer, &pxRingbuffer->xTasksWaitingToSend, rbSPSC_SENDER_WAITING);
+        return;
+    }
+
     portENTER_CRITICAL(&pxRingbuffer->mux);
     pxRingbuffer->vReturnItem(pxRingbuffer, (uint8_t *)pvItem);
     //If a task was waiting for space to send, unblock it immediately.
@@ -1228,6 +1887,12 @@ void vRingbufferReturnItemFromISR(RingbufHandle_t xRingbuffer, void *pvItem, Bas
     configASSERT(pxRingbuffer);
     configASSERT(pvItem != NULL);
 
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        pxRingbuffer->vReturnItem(pxRingbuffer, (uint8_t *)pvItem);
+        prvWakeWaiterSPSCFromISR(pxRingbuffer, &pxRingbuffer->xTasksWaitingToSend, rbSPSC_SENDER_WAITING, pxHigherPriorityTaskWoken);
+        return;
+    }
+
     portENTER_CRITICAL_ISR(&pxRingbuffer->mux);
     pxRingbuffer->vReturnItem(pxRingbuffer, (uint8_t *)pvItem);
     //If a task was waiting for space to send, unblock it immediately.
@@ -1242,6 +1907,55 @@ void vRingbufferReturnItemFromISR(RingbufHandle_t xRingbuffer, void *pvItem, Bas
     portEXIT_CRITICAL_ISR(&pxRingbuffer->mux);
 }
 
+size_t xRingbufferReceiveMultiple(RingbufHandle_t xRingbuffer,
+                                  void **ppvItems,
+                                  size_t *pxItemSizes,
+                                  size_t xMaxItems,
+                                  TickType_t xTicksToWait)
+{
+    Ringbuffer_t *pxRingbuffer = (Ringbuffer_t *)xRingbuffer;
+
+    //Check arguments
+    configASSERT(pxRingbuffer && ppvItems && pxItemSizes);
+    configASSERT((pxRingbuffer->uxRingbufferFlags & (rbBYTE_BUFFER_FLAG | rbALLOW_SPLIT_FLAG)) == 0);    //This function should only be called for no-split buffers
+
+    if (xMaxItems == 0) {
+        return 0;
+    }
+    return prvReceiveMultipleGeneric(pxRingbuffer, ppvItems, pxItemSizes, xMaxItems, xTicksToWait);
+}
+
+void vRingbufferReturnMultiple(RingbufHandle_t xRingbuffer, void **ppvItems, size_t xItemCount)
+{
+    Ringbuffer_t *pxRingbuffer = (Ringbuffer_t *)xRingbuffer;
+    configASSERT(pxRingbuffer);
+    configASSERT(ppvItems != NULL || xItemCount == 0);
+
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        for (size_t i = 0; i < xItemCount; i++) {
+            configASSERT(ppvItems[i] != NULL);
+            pxRingbuffer->vReturnItem(pxRingbuffer, (uint8_t *)ppvItems[i]);
+        }
+        //If the producer is waiting for space to send, unblock it
+        prvWakeWaiterSPSC(pxRingbuffer, &pxRingbuffer->xTasksWaitingToSend, rbSPSC_SENDER_WAITING);
+        return;
+    }
+
+    portENTER_CRITICAL(&pxRingbuffer->mux);
+    for (size_t i = 0; i < xItemCount; i++) {
+        configASSERT(ppvItems[i] != NULL);
+        pxRingbuffer->vReturnItem(pxRingbuffer, (uint8_t *)ppvItems[i]);
+    }
+    //As many tasks waiting for space to send as items returned may fit now, unblock them immediately.
+    for (size_t i = 0; i < xItemCount && listLIST_IS_EMPTY(&pxRingbuffer->xTasksWaitingToSend) == pdFALSE; i++) {
+        if (xTaskRemoveFromEventList(&pxRingbuffer->xTasksWaitingToSend) == pdTRUE) {
+            //The unblocked task will preempt us. Trigger a yield here.
+            portYIELD_WITHIN_API();
+        }
+    }
+    portEXIT_CRITICAL(&pxRingbuffer->mux);
+}
+
 void vRingbufferDelete(RingbufHandle_t xRingbuffer)
 {
     Ringbuffer_t *pxRingbuffer = (Ringbuffer_t *)xRingbuffer;
@@ -1266,6 +1980,10 @@ size_t xRingbufferGetCurFreeSize(RingbufHandle_t xRingbuffer)
     Ringbuffer_t *pxRingbuffer = (Ringbuffer_t *)xRingbuffer;
     configASSERT(pxRingbuffer);
 
+    if (pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) {
+        return pxRingbuffer->xGetCurMaxSize(pxRingbuffer);      //Lock-free
+    }
+
     size_t xFreeSize;
     portENTER_CRITICAL(&pxRingbuffer->mux);
     xFreeSize = pxRingbuffer->xGetCurMaxSize(pxRingbuffer);
@@ -1279,6 +1997,7 @@ BaseType_t xRingbufferAddToQueueSetRead(RingbufHandle_t xRingbuffer, QueueSetHan
     BaseType_t xReturn;
 
     configASSERT(pxRingbuffer && xQueueSet);
+    configASSERT((pxRingbuffer->uxRingbufferFlags & rbSPSC_FLAG) == 0);     //Queue sets are not supported by SPSC buffers
 
     portENTER_CRITICAL(&pxRingbuffer->mux);
     if (pxRingbuffer->xQueueSet != NULL || prvCheckItemAvail(pxRingbuffer) == pdTRUE) {
@@ -1345,7 +2064,13 @@ void vRingbufferGetInfo(RingbufHandle_t xRingbuffer,
         *uxAcquire = (UBaseType_t)(pxRingbuffer->pucAcquire - pxRingbuffer->pucHead);
     }
     if (uxItemsWaiting != NULL) {
-        *uxItemsWaiting = (UBaseType_t)(pxRingbuffer->xItemsWaiting);
+        if ((pxRingbuffer->uxRingbufferFlags & (rbSPSC_FLAG | rbBYTE_BUFFER_FLAG)) == (rbSPSC_FLAG | rbBYTE_BUFFER_FLAG)) {
+            //Not counted by SPSC buffers, which do not share a counter between the producer and consumer
+            BaseType_t xBytesWaiting = rbLOAD_ACQUIRE(pxRingbuffer->pucWrite) - pxRingbuffer->pucRead;
+            *uxItemsWaiting = (UBaseType_t)((xBytesWaiting < 0) ? xBytesWaiting + pxRingbuffer->xSize : xBytesWaiting);
+        } else {
+            *uxItemsWaiting = (UBaseType_t)(pxRingbuffer->xItemsWaiting);
+        }
     }
     portEXIT_CRITICAL(&pxRingbuffer->mux);
 }
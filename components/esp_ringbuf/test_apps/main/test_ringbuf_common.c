@@ -918,6 +918,38 @@ TEST_CASE("Test static ring buffer SMP", "[esp_ringbuf][linux]")
 }
 #endif
 
+TEST_CASE("Test SPSC ring buffer SMP", "[esp_ringbuf][linux]")
+{
+    setup();
+    //Iterate through the buffer types supported by SPSC ring buffers
+    const RingbufferType_t buf_types[] = {RINGBUF_TYPE_NOSPLIT, RINGBUF_TYPE_BYTEBUF};
+    for (int i = 0; i < sizeof(buf_types) / sizeof(buf_types[0]); i++) {
+        //Create buffer
+        task_args_t task_args;
+        task_args.buffer = xRingbufferCreateSPSC(CONT_DATA_TEST_BUFF_LEN, buf_types[i]);
+        task_args.type = buf_types[i];
+        TEST_ASSERT_MESSAGE(task_args.buffer != NULL, "Failed to create ring buffer");
+
+        for (int prior_mod = -1; prior_mod < 2; prior_mod++) {  //Test different relative priorities
+            //Test every permutation of core affinity
+            for (int send_core = 0; send_core < CONFIG_FREERTOS_NUMBER_OF_CORES; send_core++) {
+                for (int rec_core = 0; rec_core < CONFIG_FREERTOS_NUMBER_OF_CORES; rec_core ++) {
+                    esp_rom_printf("Type: %d, PM: %d, SC: %d, RC: %d\n", buf_types[i], prior_mod, send_core, rec_core);
+                    xTaskCreatePinnedToCore(send_task, "send tsk", 2048, (void *)&task_args, 10 + prior_mod, NULL, send_core);
+                    xTaskCreatePinnedToCore(rec_task, "rec tsk", 2048, (void *)&task_args, 10, NULL, rec_core);
+                    xSemaphoreTake(tasks_done, portMAX_DELAY);
+                    vTaskDelay(5);  //Allow idle to clean up
+                }
+            }
+        }
+
+        //Delete ring buffer
+        vRingbufferDelete(task_args.buffer);
+        vTaskDelay(10);
+    }
+    cleanup();
+}
+
 #endif //!CONFIG_FREERTOS_UNICORE
 
 /* ------------------------ Test ring buffer 0 Item Size -----------------------
@@ -1124,3 +1156,173 @@ TEST_CASE("Test no-split buffers can receive items if the acquire pointer wraps
     // Cleanup
     vRingbufferDelete(buffer_handle);
 }
+
+/* ------------------------------ Test SPSC ring buffers -------------------------------
+ * The following test case tests the basic behavior of single-producer single-consumer
+ * ring buffers, which use atomic pointers instead of critical sections.
+ * 1) Completely fill a no-split buffer and verify that another item does not fit
+ * 2) Return items out of order and verify the space is only freed once the first item is returned
+ * 3) Completely fill a byte buffer, then receive and check the data wrapping around
+ */
+TEST_CASE("Test SPSC ring buffers", "[esp_ringbuf][linux]")
+{
+    //SPSC buffers only support no-split and byte buffers
+    RingbufHandle_t no_split_rb = xRingbufferCreateSPSC(BUFFER_SIZE, RINGBUF_TYPE_NOSPLIT);
+    RingbufHandle_t byte_rb = xRingbufferCreateSPSC(BUFFER_SIZE, RINGBUF_TYPE_BYTEBUF);
+    TEST_ASSERT_MESSAGE(no_split_rb && byte_rb, "Failed to create ring buffers");
+    TEST_ASSERT_EQUAL(BUFFER_SIZE, xRingbufferGetMaxItemSize(byte_rb));
+    TEST_ASSERT_EQUAL(xRingbufferGetMaxItemSize(no_split_rb), xRingbufferGetCurFreeSize(no_split_rb));
+
+    //The whole buffer size can be used, as with other ring buffers
+    uint8_t medium_item[MEDIUM_ITEM_SIZE];
+    for (int i = 0; i < MEDIUM_ITEM_SIZE; i++) {
+        medium_item[i] = i;
+    }
+    void *items[BUFFER_SIZE / (MEDIUM_ITEM_SIZE + ITEM_HDR_SIZE)];
+    for (int i = 0; i < sizeof(items) / sizeof(items[0]); i++) {
+        send_item_and_check(no_split_rb, medium_item, MEDIUM_ITEM_SIZE, 0, false);
+    }
+    send_item_and_check_failure(no_split_rb, medium_item, MEDIUM_ITEM_SIZE, TIMEOUT_TICKS, false);
+    TEST_ASSERT_EQUAL(0, xRingbufferGetCurFreeSize(no_split_rb));
+
+    //Space is freed only once all items before a returned item are returned
+    size_t item_size;
+    for (int i = 0; i < sizeof(items) / sizeof(items[0]); i++) {
+        items[i] = xRingbufferReceive(no_split_rb, &item_size, 0);
+        TEST_ASSERT_NOT_NULL(items[i]);
+        TEST_ASSERT_EQUAL(MEDIUM_ITEM_SIZE, item_size);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(medium_item, items[i], MEDIUM_ITEM_SIZE);
+    }
+    TEST_ASSERT_NULL(xRingbufferReceive(no_split_rb, &item_size, 0));
+    vRingbufferReturnItem(no_split_rb, items[1]);
+    TEST_ASSERT_EQUAL(0, xRingbufferGetCurFreeSize(no_split_rb));
+    vRingbufferReturnItem(no_split_rb, items[0]);
+    TEST_ASSERT_NOT_EQUAL(0, xRingbufferGetCurFreeSize(no_split_rb));
+    for (int i = 2; i < sizeof(items) / sizeof(items[0]); i++) {
+        vRingbufferReturnItem(no_split_rb, items[i]);
+    }
+    TEST_ASSERT_EQUAL(xRingbufferGetMaxItemSize(no_split_rb), xRingbufferGetCurFreeSize(no_split_rb));
+
+    //Fill the byte buffer, then make the data wrap around
+    for (int i = 0; i < BUFFER_SIZE / SMALL_ITEM_SIZE; i++) {
+        send_item_and_check(byte_rb, small_item, SMALL_ITEM_SIZE, 0, false);
+    }
+    send_item_and_check_failure(byte_rb, small_item, 1, 0, false);
+    receive_check_and_return_item_byte_buffer(byte_rb, small_item, SMALL_ITEM_SIZE, 0, false);
+    receive_check_and_return_item_byte_buffer(byte_rb, small_item, SMALL_ITEM_SIZE, 0, false);
+    send_item_and_check(byte_rb, large_item, LARGE_ITEM_SIZE, 0, false);
+    for (int i = 2; i < BUFFER_SIZE / SMALL_ITEM_SIZE; i++) {
+        receive_check_and_return_item_byte_buffer(byte_rb, small_item, SMALL_ITEM_SIZE, 0, false);
+    }
+    receive_check_and_return_item_byte_buffer(byte_rb, large_item, LARGE_ITEM_SIZE, 0, false);
+    TEST_ASSERT_NULL(xRingbufferReceiveUpTo(byte_rb, &item_size, 0, BUFFER_SIZE));
+
+    //Cleanup
+    vRingbufferDelete(no_split_rb);
+    vRingbufferDelete(byte_rb);
+}
+
+/* --------------------- Test vectored send and multiple receive -----------------------
+ * The following test case tests sending items gathered from several parts, and
+ * retrieving/returning several items at once.
+ * 1) Send items made of a header, an empty part and a payload to every type of ring
+ *    buffer, enough times for the items to wrap around, and check the received data
+ * 2) Retrieve up to a number of items from no-split buffers, check they are received
+ *    in order, then return them all at once
+ */
+#define IOVEC_ROUNDS    16
+
+static void receive_and_check_iovec(RingbufHandle_t handle, RingbufferType_t buf_type, const uint8_t *expected_data, size_t expected_size)
+{
+    uint8_t data[MEDIUM_ITEM_SIZE];
+    size_t received = 0;
+    while (received < expected_size) {
+        size_t item_size;
+        void *item;
+        void *tail_item = NULL;
+        size_t tail_item_size = 0;
+        if (buf_type == RINGBUF_TYPE_ALLOWSPLIT) {
+            //The item may have been split
+            TEST_ASSERT_EQUAL(pdTRUE, xRingbufferReceiveSplit(handle, &item, &tail_item, &item_size, &tail_item_size, 0));
+        } else if (buf_type == RINGBUF_TYPE_BYTEBUF) {
+            //The data may wrap around
+            item = xRingbufferReceiveUpTo(handle, &item_size, 0, expected_size - received);
+        } else {
+            item = xRingbufferReceive(handle, &item_size, 0);
+        }
+        TEST_ASSERT_NOT_NULL(item);
+        memcpy(data + received, item, item_size);
+        vRingbufferReturnItem(handle, item);
+        received += item_size;
+        if (tail_item != NULL) {
+            memcpy(data + received, tail_item, tail_item_size);
+            vRingbufferReturnItem(handle, tail_item);
+            received += tail_item_size;
+        }
+    }
+    TEST_ASSERT_EQUAL(expected_size, received);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected_data, data, expected_size);
+}
+
+TEST_CASE("Test ring buffer vectored send and multiple receive", "[esp_ringbuf][linux]")
+{
+    //The last two buffers are SPSC buffers
+    const RingbufferType_t buf_types[] = { RINGBUF_TYPE_NOSPLIT, RINGBUF_TYPE_ALLOWSPLIT, RINGBUF_TYPE_BYTEBUF, RINGBUF_TYPE_NOSPLIT, RINGBUF_TYPE_BYTEBUF };
+    RingbufHandle_t handles[5];
+    for (int i = 0; i < 5; i++) {
+        handles[i] = (i < 3) ? xRingbufferCreate(BUFFER_SIZE, buf_types[i]) : xRingbufferCreateSPSC(BUFFER_SIZE, buf_types[i]);
+    }
+
+    //The item is made of a 4 byte header and the rest of a medium item
+    uint8_t expected_data[MEDIUM_ITEM_SIZE];
+    for (int i = 0; i < MEDIUM_ITEM_SIZE; i++) {
+        expected_data[i] = i;
+    }
+    const RingbufferIOVec_t iovec[] = {
+        { .pvData = expected_data, .xLen = 4 },
+        { .pvData = NULL, .xLen = 0 },
+        { .pvData = expected_data + 4, .xLen = MEDIUM_ITEM_SIZE - 4 },
+    };
+
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_MESSAGE(handles[i] != NULL, "Failed to create ring buffer");
+        const RingbufferType_t buf_type = buf_types[i];
+        for (int round = 0; round < IOVEC_ROUNDS; round++) {
+            TEST_ASSERT_EQUAL(pdTRUE, xRingbufferSendv(handles[i], iovec, sizeof(iovec) / sizeof(iovec[0]), 0));
+            TEST_ASSERT_EQUAL(pdTRUE, xRingbufferSendv(handles[i], iovec, sizeof(iovec) / sizeof(iovec[0]), 0));
+            receive_and_check_iovec(handles[i], buf_type, expected_data, MEDIUM_ITEM_SIZE);
+            receive_and_check_iovec(handles[i], buf_type, expected_data, MEDIUM_ITEM_SIZE);
+        }
+        //Items larger than the maximum item size are rejected
+        const RingbufferIOVec_t too_large[] = {
+            { .pvData = expected_data, .xLen = xRingbufferGetMaxItemSize(handles[i]) },
+            { .pvData = expected_data, .xLen = 1 },
+        };
+        TEST_ASSERT_EQUAL(pdFALSE, xRingbufferSendv(handles[i], too_large, 2, 0));
+    }
+
+    //Multiple receive is only supported by no-split buffers
+    for (int i = 0; i < 5; i += 3) {
+        void *items[4];
+        size_t item_sizes[4];
+        TEST_ASSERT_EQUAL(0, xRingbufferReceiveMultiple(handles[i], items, item_sizes, 4, TIMEOUT_TICKS));
+        for (int round = 0; round < IOVEC_ROUNDS; round++) {
+            //Send small items with different contents, so that the order can be checked
+            for (int j = 0; j < 3; j++) {
+                send_item_and_check(handles[i], small_item + j, SMALL_ITEM_SIZE - j, 0, false);
+            }
+            TEST_ASSERT_EQUAL(2, xRingbufferReceiveMultiple(handles[i], items, item_sizes, 2, 0));
+            TEST_ASSERT_EQUAL(1, xRingbufferReceiveMultiple(handles[i], items + 2, item_sizes + 2, 4, 0));
+            for (int j = 0; j < 3; j++) {
+                TEST_ASSERT_EQUAL(SMALL_ITEM_SIZE - j, item_sizes[j]);
+                TEST_ASSERT_EQUAL_HEX8_ARRAY(small_item + j, items[j], SMALL_ITEM_SIZE - j);
+            }
+            vRingbufferReturnMultiple(handles[i], items, 3);
+        }
+    }
+
+    //Cleanup
+    for (int i = 0; i < 5; i++) {
+        vRingbufferDelete(handles[i]);
+    }
+}
@@ -1,5 +1,5 @@
 /*
- * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ * SPDX-FileCopyrightText: 2024-2025 Espressif Systems (Shanghai) CO LTD
  *
  * SPDX-License-Identifier: Apache-2.0
  */
@@ -12,6 +12,7 @@
 #include "sdkconfig.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <inttypes.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
@@ -22,6 +23,7 @@
 #include "esp_heap_caps.h"
 #include "unity.h"
 #include "esp_rom_sys.h"
+#include "esp_timer.h"
 
 #include "test_functions.h"
 
@@ -193,3 +195,90 @@ TEST_CASE("Test ringbuffer with caps", "[esp_ringbuf]")
     // Free the ring buffer
     vRingbufferDeleteWithCaps(rb_handle);
 }
+
+/* ------------------------ Test SPSC ring buffer throughput ------------------------
+ * The following test case compares the throughput of SPSC ring buffers against
+ * ring buffers using critical sections, for no-split and byte buffers. A sending
+ * task and a receiving task (on different cores if possible) transfer a fixed
+ * amount of data in items of a given size.
+ */
+
+#define BENCHMARK_BUFFER_SIZE       2048
+#define BENCHMARK_BYTES             (128 * 1024)
+
+typedef struct {
+    RingbufHandle_t buffer;
+    RingbufferType_t type;
+    size_t item_size;
+    SemaphoreHandle_t done;
+} benchmark_args_t;
+
+static void benchmark_send_task(void *args)
+{
+    benchmark_args_t *bench_args = (benchmark_args_t *)args;
+    static uint8_t item[128];
+    for (size_t sent = 0; sent < BENCHMARK_BYTES; sent += bench_args->item_size) {
+        TEST_ASSERT(xRingbufferSend(bench_args->buffer, item, bench_args->item_size, portMAX_DELAY) == pdTRUE);
+    }
+    xSemaphoreGive(bench_args->done);
+    vTaskDelete(NULL);
+}
+
+static void benchmark_rec_task(void *args)
+{
+    benchmark_args_t *bench_args = (benchmark_args_t *)args;
+    size_t received = 0;
+    while (received < BENCHMARK_BYTES) {
+        size_t item_size;
+        void *item;
+        if (bench_args->type == RINGBUF_TYPE_BYTEBUF) {
+            item = xRingbufferReceiveUpTo(bench_args->buffer, &item_size, portMAX_DELAY, bench_args->item_size);
+        } else {
+            item = xRingbufferReceive(bench_args->buffer, &item_size, portMAX_DELAY);
+        }
+        TEST_ASSERT_NOT_NULL(item);
+        received += item_size;
+        vRingbufferReturnItem(bench_args->buffer, item);
+    }
+    TEST_ASSERT_EQUAL(BENCHMARK_BYTES, received);
+    xSemaphoreGive(bench_args->done);
+    vTaskDelete(NULL);
+}
+
+//Returns the throughput in KB/s
+static uint32_t benchmark_throughput(RingbufferType_t type, bool spsc, size_t item_size)
+{
+    benchmark_args_t bench_args = {
+        .buffer = spsc ? xRingbufferCreateSPSC(BENCHMARK_BUFFER_SIZE, type) : xRingbufferCreate(BENCHMARK_BUFFER_SIZE, type),
+        .type = type,
+        .item_size = item_size,
+        .done = xSemaphoreCreateCounting(2, 0),
+    };
+    TEST_ASSERT(bench_args.buffer != NULL && bench_args.done != NULL);
+
+    int64_t start = esp_timer_get_time();
+    xTaskCreatePinnedToCore(benchmark_send_task, "send tsk", 2048, &bench_args, 10, NULL, 0);
+    xTaskCreatePinnedToCore(benchmark_rec_task, "rec tsk", 2048, &bench_args, 10, NULL, CONFIG_FREERTOS_NUMBER_OF_CORES - 1);
+    xSemaphoreTake(bench_args.done, portMAX_DELAY);
+    xSemaphoreTake(bench_args.done, portMAX_DELAY);
+    int64_t elapsed = esp_timer_get_time() - start;
+
+    vRingbufferDelete(bench_args.buffer);
+    vSemaphoreDelete(bench_args.done);
+    vTaskDelay(5);  //Allow idle to clean up
+    return (uint32_t)((int64_t)BENCHMARK_BYTES * 1000000 / 1024 / elapsed);
+}
+
+TEST_CASE("Test SPSC ring buffer throughput", "[esp_ringbuf][qemu-ignore]")
+{
+    const RingbufferType_t buf_types[] = {RINGBUF_TYPE_NOSPLIT, RINGBUF_TYPE_BYTEBUF};
+    const size_t item_sizes[] = {16, 128};
+    for (int i = 0; i < sizeof(buf_types) / sizeof(buf_types[0]); i++) {
+        for (int j = 0; j < sizeof(item_sizes) / sizeof(item_sizes[0]); j++) {
+            uint32_t default_kbps = benchmark_throughput(buf_types[i], false, item_sizes[j]);
+            uint32_t spsc_kbps = benchmark_throughput(buf_types[i], true, item_sizes[j]);
+            printf("%s buffer, %zu byte items: %" PRIu32 " KB/s, SPSC %" PRIu32 " KB/s\n",
+                   (buf_types[i] == RINGBUF_TYPE_BYTEBUF) ? "Byte" : "No-split", item_sizes[j], default_kbps, spsc_kbps);
+        }
+    }
+}
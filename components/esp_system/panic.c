@@ -56,6 +56,12 @@
 #include "hal/uart_hal.h"
 #endif
 
+#if CONFIG_LOG_DEFERRED && !CONFIG_ESP_SYSTEM_PANIC_SILENT_REBOOT
+#include "esp_private/log_deferred.h"
+#include "esp_private/cache_utils.h"
+#include "esp_private/cache_err_int.h"
+#endif
+
 #if CONFIG_ESP_SYSTEM_PANIC_GDBSTUB
 #include "esp_gdbstub.h"
 #endif
@@ -279,6 +285,17 @@ void esp_panic_handler_increment_entry_count(void)
     }
 }
 
+#if CONFIG_LOG_DEFERRED && !CONFIG_ESP_SYSTEM_PANIC_SILENT_REBOOT
+static bool panic_flash_cache_usable(void)
+{
+#if CONFIG_APP_BUILD_TYPE_PURE_RAM_APP
+    return true;
+#else
+    return spi_flash_cache_enabled() && esp_cache_err_get_cpuid() == -1;
+#endif
+}
+#endif
+
 // Control arrives from chip-specific panic handler, environment prepared for
 // the 'main' logic of panic handling. This means that chip-specific stuff have
 // already been done, and panic_info_t has been filled.
@@ -395,6 +412,16 @@ void esp_panic_handler(panic_info_t *info)
 
     panic_print_str("\r\n");
 
+#if CONFIG_LOG_DEFERRED && !CONFIG_ESP_SYSTEM_PANIC_SILENT_REBOOT
+    // Print the log messages which the writer task did not print yet, they often explain the panic.
+    // They are formatted by code and strings in flash, so only once the panic is reported, and only
+    // if the cache works.
+    if (panic_flash_cache_usable()) {
+        esp_panic_handler_feed_wdts();
+        esp_log_deferred_panic_flush();
+    }
+#endif
+
 #if CONFIG_APPTRACE_ENABLE
     esp_panic_handler_feed_wdts();
 #if CONFIG_APPTRACE_SV_ENABLE
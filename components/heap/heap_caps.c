@@ -10,6 +10,7 @@
 #include <sys/param.h>
 #include "esp_attr.h"
 #include "esp_heap_caps.h"
+#include "esp_heap_caps_pool.h"
 #include "multi_heap.h"
 #include "esp_log.h"
 #include "heap_private.h"
@@ -408,6 +409,14 @@ void heap_caps_print_heap_info( uint32_t caps )
     heap_caps_get_info(&info, caps);
 
     printf("    free %d allocated %d min_free %d largest_free_block %d\n", info.total_free_bytes, info.total_allocated_bytes, info.minimum_free_bytes, info.largest_free_block);
+
+    heap_caps_pool_info_t pools_info;
+    heap_caps_get_pools_info(&pools_info, caps);
+    if (pools_info.pools > 0) {
+        printf("  Pools (included in allocated):\n");
+        printf("    pools %d objects %d free %d free_objects %d min_free %d\n", pools_info.pools, pools_info.total_objects,
+               pools_info.free_bytes, pools_info.free_objects, pools_info.minimum_free_bytes);
+    }
 }
 
 bool heap_caps_check_integrity(uint32_t caps, bool print_errors)
@@ -450,6 +459,7 @@ void heap_caps_dump(uint32_t caps)
             multi_heap_dump(heap->heap);
         }
     }
+    heap_caps_pool_dump(caps);
 }
 
 void heap_caps_dump_all(void)
@@ -457,6 +467,20 @@ void heap_caps_dump_all(void)
     heap_caps_dump(MALLOC_CAP_INVALID);
 }
 
+size_t heap_caps_cache_flush(uint32_t caps)
+{
+    bool all_heaps = caps & MALLOC_CAP_INVALID;
+    size_t flushed = 0;
+    heap_t *heap;
+    SLIST_FOREACH(heap, &registered_heaps, next) {
+        if (heap->heap != NULL
+            && (all_heaps || (get_all_caps(heap) & caps) == caps)) {
+            flushed += multi_heap_cache_flush(heap->heap);
+        }
+    }
+    return flushed;
+}
+
 size_t heap_caps_get_allocated_size( void *ptr )
 {
     // add the block owner bytes back to ptr before handing over
@@ -0,0 +1,183 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <assert.h>
+#include "esp_heap_caps.h"
+#include "esp_heap_caps_arena.h"
+
+/*
+Arenas hand out memory by advancing a pointer through the current chunk, and get a new chunk from
+heap_caps_malloc() when it is full. The chunks in use form a list, the current chunk first, and the
+chunks released by a reset are kept in a second list to be reused before allocating new ones.
+*/
+
+#define ARENA_ALIGNMENT _Alignof(max_align_t)
+#define ARENA_ALIGN_UP(x) (((x) + ARENA_ALIGNMENT - 1) & ~(uintptr_t)(ARENA_ALIGNMENT - 1))
+
+typedef struct heap_caps_arena_chunk {
+    struct heap_caps_arena_chunk *next;
+    size_t size;                                ///< size of the chunk including this header
+} heap_caps_arena_chunk_t;
+
+struct heap_caps_arena {
+    heap_caps_arena_chunk_t *chunks;            ///< chunks in use, current chunk first
+    heap_caps_arena_chunk_t *free_chunks;       ///< chunks kept by heap_caps_arena_reset()
+    uintptr_t ptr;                              ///< first free byte of the current chunk
+    uintptr_t end;                              ///< end of the current chunk
+    size_t chunk_size;
+    uint32_t caps;
+    heap_caps_arena_info_t info;
+};
+
+heap_caps_arena_t *heap_caps_arena_create(size_t chunk_size, uint32_t caps)
+{
+    if (chunk_size <= sizeof(heap_caps_arena_chunk_t) + ARENA_ALIGNMENT) {
+        return NULL;
+    }
+    heap_caps_arena_t *arena = heap_caps_malloc(sizeof(heap_caps_arena_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (arena == NULL) {
+        return NULL;
+    }
+    memset(arena, 0, sizeof(heap_caps_arena_t));
+    arena->chunk_size = chunk_size;
+    arena->caps = caps;
+    return arena;
+}
+
+static void free_chunks(heap_caps_arena_chunk_t *chunk)
+{
+    while (chunk != NULL) {
+        heap_caps_arena_chunk_t *next = chunk->next;
+        heap_caps_free(chunk);
+        chunk = next;
+    }
+}
+
+void heap_caps_arena_destroy(heap_caps_arena_t *arena)
+{
+    if (arena == NULL) {
+        return;
+    }
+    free_chunks(arena->chunks);
+    free_chunks(arena->free_chunks);
+    heap_caps_free(arena);
+}
+
+static void add_chunk_bytes(heap_caps_arena_t *arena, size_t size)
+{
+    arena->info.chunk_bytes += size;
+    arena->info.chunks++;
+    if (arena->info.chunk_bytes > arena->info.peak_chunk_bytes) {
+        arena->info.peak_chunk_bytes = arena->info.chunk_bytes;
+    }
+}
+
+static void *alloc_dedicated_chunk(heap_caps_arena_t *arena, size_t size)
+{
+    size_t chunk_size;
+    if (__builtin_add_overflow(size, ARENA_ALIGN_UP(sizeof(heap_caps_arena_chunk_t)) + ARENA_ALIGNMENT, &chunk_size)) {
+        return NULL;
+    }
+    heap_caps_arena_chunk_t *chunk = heap_caps_malloc(chunk_size, arena->caps);
+    if (chunk == NULL) {
+        return NULL;
+    }
+    chunk->size = chunk_size;
+    add_chunk_bytes(arena, chunk_size);
+
+    /* Keep the current chunk first so that its free space is still used */
+    if (arena->chunks != NULL) {
+        chunk->next = arena->chunks->next;
+        arena->chunks->next = chunk;
+    } else {
+        chunk->next = NULL;
+        arena->chunks = chunk;
+        arena->ptr = arena->end = (uintptr_t)chunk + chunk_size;
+    }
+    return (void *)ARENA_ALIGN_UP((uintptr_t)(chunk + 1));
+}
+
+static bool next_chunk(heap_caps_arena_t *arena)
+{
+    heap_caps_arena_chunk_t *chunk = arena->free_chunks;
+    if (chunk != NULL) {
+        arena->free_chunks = chunk->next;
+    } else {
+        chunk = heap_caps_malloc(arena->chunk_size, arena->caps);
+        if (chunk == NULL) {
+            return false;
+        }
+        chunk->size = arena->chunk_size;
+        add_chunk_bytes(arena, arena->chunk_size);
+    }
+    chunk->next = arena->chunks;
+    arena->chunks = chunk;
+    arena->ptr = (uintptr_t)(chunk + 1);
+    arena->end = (uintptr_t)chunk + chunk->size;
+    return true;
+}
+
+void *heap_caps_arena_alloc(heap_caps_arena_t *arena, size_t size)
+{
+    assert(arena != NULL);
+
+    if (size == 0) {
+        return NULL;
+    }
+
+    void *ptr;
+    uintptr_t start = ARENA_ALIGN_UP(arena->ptr);
+    if (start <= arena->end && size <= arena->end - start) {
+        ptr = (void *)start;
+        arena->ptr = start + size;
+    } else if (size > arena->chunk_size - sizeof(heap_caps_arena_chunk_t) - ARENA_ALIGNMENT) {
+        ptr = alloc_dedicated_chunk(arena, size);
+    } else if (next_chunk(arena)) {
+        start = ARENA_ALIGN_UP(arena->ptr);
+        ptr = (void *)start;
+        arena->ptr = start + size;
+    } else {
+        ptr = NULL;
+    }
+
+    if (ptr != NULL) {
+        arena->info.allocated_bytes += size;
+        if (arena->info.allocated_bytes > arena->info.peak_allocated_bytes) {
+            arena->info.peak_allocated_bytes = arena->info.allocated_bytes;
+        }
+    }
+    return ptr;
+}
+
+void heap_caps_arena_reset(heap_caps_arena_t *arena)
+{
+    assert(arena != NULL);
+
+    heap_caps_arena_chunk_t *chunk = arena->chunks;
+    while (chunk != NULL) {
+        heap_caps_arena_chunk_t *next = chunk->next;
+        if (chunk->size == arena->chunk_size) {
+            chunk->next = arena->free_chunks;
+            arena->free_chunks = chunk;
+        } else {
+            arena->info.chunk_bytes -= chunk->size;
+            arena->info.chunks--;
+            heap_caps_free(chunk);
+        }
+        chunk = next;
+    }
+    arena->chunks = NULL;
+    arena->ptr = arena->end = 0;
+    arena->info.allocated_bytes = 0;
+}
+
+void heap_caps_arena_get_info(const heap_caps_arena_t *arena, heap_caps_arena_info_t *info)
+{
+    assert(arena != NULL);
+    *info = arena->info;
+}
@@ -12,16 +12,7 @@
 #include "multi_heap.h"
 #include "esp_log.h"
 #include "heap_private.h"
-
-#ifdef CONFIG_HEAP_USE_HOOKS
-#define CALL_HOOK(hook, ...) {      \
-    if (hook != NULL) {             \
-        hook(__VA_ARGS__);          \
-    }                               \
-}
-#else
-#define CALL_HOOK(hook, ...) {}
-#endif
+#include "heap_profile_private.h"
 
 //This is normally provided by the heap-memalign-hw component.
 extern void esp_heap_adjust_alignment_to_hw(size_t *p_alignment, size_t *p_size, uint32_t *p_caps);
@@ -62,6 +53,9 @@ HEAP_IRAM_ATTR void heap_caps_free( void *ptr)
         return;
     }
 
+    // Forget the block before it can be allocated again
+    HEAP_PROFILE_FREE(ptr);
+
     if ((!esp_dram_match_iram() && esp_ptr_in_diram_iram(ptr)) ||
         (!esp_rtc_dram_match_rtc_iram() && esp_ptr_in_rtc_iram_fast(ptr))) {
         //Memory allocated here is actually allocated in the DRAM alias region and
@@ -150,6 +144,7 @@ HEAP_IRAM_ATTR NOINLINE_ATTR void *heap_caps_aligned_alloc_base(size_t alignment
                             MULTI_HEAP_SET_BLOCK_OWNER(ret);
                             ret = MULTI_HEAP_ADD_BLOCK_OWNER_OFFSET(ret);
                             uint32_t *iptr = dram_alloc_to_iram_addr(ret, size + 4);  // int overflow checked above
+                            HEAP_PROFILE_ALLOC(iptr, size);
                             CALL_HOOK(esp_heap_trace_alloc_hook, iptr, size, caps);
                             return iptr;
                         }
@@ -160,6 +155,7 @@ HEAP_IRAM_ATTR NOINLINE_ATTR void *heap_caps_aligned_alloc_base(size_t alignment
                         if (ret != NULL) {
                             MULTI_HEAP_SET_BLOCK_OWNER(ret);
                             ret = MULTI_HEAP_ADD_BLOCK_OWNER_OFFSET(ret);
+                            HEAP_PROFILE_ALLOC(ret, size);
                             CALL_HOOK(esp_heap_trace_alloc_hook, ret, size, caps);
                             return ret;
                         }
@@ -242,10 +238,13 @@ HEAP_IRAM_ATTR NOINLINE_ATTR void *heap_caps_realloc_base( void *ptr, size_t siz
     if (compatible_caps && !ptr_in_diram_case && alignment<=UNALIGNED_MEM_ALIGNMENT_BYTES) {
         // try to reallocate this memory within the same heap
         // (which will resize the block if it can)
+        uintptr_t profile_token = HEAP_PROFILE_REALLOC_BEGIN(MULTI_HEAP_ADD_BLOCK_OWNER_OFFSET(ptr));
         void *r = multi_heap_realloc(heap->heap, ptr, MULTI_HEAP_ADD_BLOCK_OWNER_SIZE(size));
+        HEAP_PROFILE_REALLOC_END(profile_token, r != NULL);
         if (r != NULL) {
             MULTI_HEAP_SET_BLOCK_OWNER(r);
             r = MULTI_HEAP_ADD_BLOCK_OWNER_OFFSET(r);
+            HEAP_PROFILE_ALLOC(r, size);
             CALL_HOOK(esp_heap_trace_alloc_hook, r, size, caps);
             return r;
         }
@@ -74,6 +74,17 @@ static void register_heap(heap_t *region)
     }
 }
 
+static void enable_heap_cache(heap_t *heap)
+{
+#if CONFIG_HEAP_CACHE
+    if (!multi_heap_cache_enable(heap->heap, CONFIG_HEAP_CACHE_SIZE)) {
+        ESP_EARLY_LOGW(TAG, "No memory to cache small blocks of heap at %p", heap->heap);
+    }
+#else
+    (void) heap;
+#endif
+}
+
 void heap_caps_enable_nonos_stack_heaps(void)
 {
     heap_t *heap;
@@ -84,6 +95,7 @@ void heap_caps_enable_nonos_stack_heaps(void)
             register_heap(heap);
             if (heap->heap != NULL) {
                 multi_heap_set_lock(heap->heap, &heap->heap_mux);
+                enable_heap_cache(heap);
             }
         }
     }
@@ -190,6 +202,7 @@ void heap_caps_init(void)
     for (size_t i = 0; i < num_heaps; i++) {
         if (heaps_array[i].heap != NULL) {
             multi_heap_set_lock(heaps_array[i].heap, &heaps_array[i].heap_mux);
+            enable_heap_cache(&heaps_array[i]);
         }
         /* Since the registered heaps list is always traversed from head
          * to tail when looking for a suitable heap when allocating memory, it is
@@ -290,6 +303,7 @@ esp_err_t heap_caps_add_region_with_caps(const uint32_t caps[], intptr_t start,
         goto done;
     }
     multi_heap_set_lock(p_new->heap, &p_new->heap_mux);
+    enable_heap_cache(p_new);
 
     /* (This insertion is atomic to registered_heaps, so
        we don't need to worry about thread safety for readers,
@@ -12,6 +12,7 @@
 
 #include "esp_attr.h"
 #include "esp_heap_caps.h"
+#include "heap_profile_private.h"
 
 #ifdef CONFIG_HEAP_ABORT_WHEN_ALLOCATION_FAILS
 #include "esp_system.h"
@@ -50,6 +51,7 @@ static void *heap_caps_malloc_base( size_t size, uint32_t caps)
 {
 
     void *ptr = malloc(size);
+    HEAP_PROFILE_ALLOC(ptr, size);
 
     if (!ptr && size > 0) {
         heap_caps_alloc_failed(size, caps, __func__);
@@ -84,13 +86,16 @@ void *heap_caps_malloc_prefer( size_t size, size_t num, ... )
 
 static void *heap_caps_realloc_base( void *ptr, size_t size, uint32_t caps)
 {
-    ptr = realloc(ptr, size);
+    uintptr_t profile_token = HEAP_PROFILE_REALLOC_BEGIN(ptr);
+    void *new_ptr = realloc(ptr, size);
+    HEAP_PROFILE_REALLOC_END(profile_token, new_ptr != NULL || size == 0);
+    HEAP_PROFILE_ALLOC(new_ptr, size);
 
-    if (ptr == NULL && size > 0) {
+    if (new_ptr == NULL && size > 0) {
         heap_caps_alloc_failed(size, caps, __func__);
     }
 
-    return ptr;
+    return new_ptr;
 }
 
 void *heap_caps_realloc( void *ptr, size_t size, uint32_t caps)
@@ -110,6 +115,7 @@ void *heap_caps_realloc_prefer( void *ptr, size_t size, size_t num, ... )
 
 void heap_caps_free( void *ptr)
 {
+    HEAP_PROFILE_FREE(ptr);
     free(ptr);
 }
 
@@ -121,7 +127,9 @@ static void *heap_caps_calloc_base( size_t n, size_t size, uint32_t caps)
         return NULL;
     }
 
-    return calloc(n, size);
+    void *ptr = calloc(n, size);
+    HEAP_PROFILE_ALLOC(ptr, size_bytes);
+    return ptr;
 }
 
 void *heap_caps_calloc( size_t n, size_t size, uint32_t caps)
@@ -195,6 +203,11 @@ void heap_caps_dump_all(void)
     heap_caps_dump(MALLOC_CAP_INVALID);
 }
 
+size_t heap_caps_cache_flush(uint32_t caps)
+{
+    return 0;
+}
+
 size_t heap_caps_get_allocated_size( void *ptr )
 {
     return 0;
@@ -203,6 +216,7 @@ size_t heap_caps_get_allocated_size( void *ptr )
 void *heap_caps_aligned_alloc(size_t alignment, size_t size, uint32_t caps)
 {
     void *ptr = aligned_alloc(alignment, size);
+    HEAP_PROFILE_ALLOC(ptr, size);
 
     if (!ptr && size > 0) {
         heap_caps_alloc_failed(size, caps, __func__);
@@ -0,0 +1,215 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <stdatomic.h>
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include "esp_heap_caps_pool.h"
+#include "heap_private.h"
+
+/*
+Pools of fixed size objects. The free objects of a pool form a stack, linked through an array of object
+indexes kept next to the pool. The top of the stack is a single 32-bit word holding the index of the top
+object plus one (0 when the stack is empty) in its lower half and a tag in its upper half. The tag is
+incremented by every push and pop, so that a compare-and-swap of the top of the stack fails if the stack
+was changed in between, even if the same object is on top again.
+
+The tag has only 16 bits, as the 32-bit compare-and-swap is the widest one the chips provide. A task
+preempted between reading the top and its compare-and-swap while exactly a multiple of 65536 pushes and
+pops are done by others would see the same tag again, and could corrupt the stack.
+*/
+
+#define POOL_INDEX_MASK 0xFFFFu
+#define POOL_TAG_INCREMENT 0x10000u
+
+struct heap_caps_pool {
+    atomic_uint_least32_t top;                  ///< tag and index plus one of the first free object
+    atomic_uint_least32_t free_objects;         ///< number of free objects
+    atomic_uint_least32_t minimum_free_objects; ///< lifetime minimum of free_objects
+    size_t object_size;                         ///< size of each object, aligned
+    size_t count;                               ///< number of objects
+    uint8_t *objects;                           ///< memory of the objects, allocated with the caps of the pool
+    atomic_uint_least16_t *next;                ///< index plus one of the next free object, for each object
+    uint32_t caps;                              ///< caps the pool was created with
+    SLIST_ENTRY(heap_caps_pool) entries;
+};
+
+static SLIST_HEAD(heap_caps_pool_ll, heap_caps_pool) pools = SLIST_HEAD_INITIALIZER(pools);
+static multi_heap_lock_t pools_lock = MULTI_HEAP_LOCK_STATIC_INITIALIZER;
+
+heap_caps_pool_handle_t heap_caps_pool_create(size_t obj_size, size_t count, uint32_t caps)
+{
+    if (obj_size == 0 || count == 0 || count > HEAP_CAPS_POOL_MAX_OBJECTS) {
+        return NULL;
+    }
+
+    const size_t object_size = (obj_size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+    size_t objects_size;
+    if (object_size < obj_size || __builtin_mul_overflow(object_size, count, &objects_size)) {
+        return NULL;
+    }
+
+    /* The pool and its links are accessed atomically, so they are kept in internal memory
+       whatever the caps of the objects */
+    heap_caps_pool_handle_t pool = heap_caps_malloc(sizeof(struct heap_caps_pool) + count * sizeof(atomic_uint_least16_t),
+                                                    MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (pool == NULL) {
+        return NULL;
+    }
+    pool->objects = heap_caps_malloc(objects_size, caps);
+    if (pool->objects == NULL) {
+        heap_caps_free(pool);
+        return NULL;
+    }
+
+    pool->object_size = object_size;
+    pool->count = count;
+    pool->caps = caps;
+    pool->next = (atomic_uint_least16_t *)(pool + 1);
+    for (size_t i = 0; i < count; i++) {
+        atomic_init(&pool->next[i], (i + 1 < count) ? i + 2 : 0);
+    }
+    atomic_init(&pool->top, 1);
+    atomic_init(&pool->free_objects, count);
+    atomic_init(&pool->minimum_free_objects, count);
+
+    MULTI_HEAP_LOCK(&pools_lock);
+    SLIST_INSERT_HEAD(&pools, pool, entries);
+    MULTI_HEAP_UNLOCK(&pools_lock);
+
+    return pool;
+}
+
+void heap_caps_pool_delete(heap_caps_pool_handle_t pool)
+{
+    if (pool == NULL) {
+        return;
+    }
+
+    MULTI_HEAP_LOCK(&pools_lock);
+    SLIST_REMOVE(&pools, pool, heap_caps_pool, entries);
+    MULTI_HEAP_UNLOCK(&pools_lock);
+
+    heap_caps_free(pool->objects);
+    heap_caps_free(pool);
+}
+
+HEAP_IRAM_ATTR void *heap_caps_pool_alloc(heap_caps_pool_handle_t pool)
+{
+    assert(pool != NULL);
+
+    uint32_t top = atomic_load_explicit(&pool->top, memory_order_acquire);
+    uint32_t new_top;
+    do {
+        if ((top & POOL_INDEX_MASK) == 0) {
+            return NULL;
+        }
+        const uint32_t next = atomic_load_explicit(&pool->next[(top & POOL_INDEX_MASK) - 1], memory_order_relaxed);
+        new_top = ((top & ~POOL_INDEX_MASK) + POOL_TAG_INCREMENT) | next;
+    } while (!atomic_compare_exchange_weak_explicit(&pool->top, &top, new_top,
+                                                    memory_order_acquire, memory_order_acquire));
+    const uint32_t index = top & POOL_INDEX_MASK;
+
+    /* Keep the lifetime minimum of free objects, the counter may briefly lag behind the stack */
+    uint32_t free_objects = atomic_fetch_sub_explicit(&pool->free_objects, 1, memory_order_relaxed) - 1;
+    uint32_t minimum = atomic_load_explicit(&pool->minimum_free_objects, memory_order_relaxed);
+    while (free_objects < minimum
+           && !atomic_compare_exchange_weak_explicit(&pool->minimum_free_objects, &minimum, free_objects,
+                                                     memory_order_relaxed, memory_order_relaxed)) {
+    }
+
+    void *ptr = pool->objects + (index - 1) * pool->object_size;
+    CALL_HOOK(esp_heap_trace_alloc_hook, ptr, pool->object_size, pool->caps);
+    return ptr;
+}
+
+HEAP_IRAM_ATTR void heap_caps_pool_free(heap_caps_pool_handle_t pool, void *ptr)
+{
+    assert(pool != NULL);
+
+    if (ptr == NULL) {
+        return;
+    }
+
+    const size_t offset = (uint8_t *)ptr - pool->objects;
+    assert((uint8_t *)ptr >= pool->objects && offset < pool->count * pool->object_size
+           && offset % pool->object_size == 0 && "free() target pointer is not an object of the pool");
+    const uint32_t index = offset / pool->object_size + 1;
+
+    uint32_t top = atomic_load_explicit(&pool->top, memory_order_relaxed);
+    do {
+        atomic_store_explicit(&pool->next[index - 1], top & POOL_INDEX_MASK, memory_order_relaxed);
+    } while (!atomic_compare_exchange_weak_explicit(&pool->top, &top,
+                                                    ((top & ~POOL_INDEX_MASK) + POOL_TAG_INCREMENT) | index,
+                                                    memory_order_release, memory_order_relaxed));
+
+    atomic_fetch_add_explicit(&pool->free_objects, 1, memory_order_relaxed);
+    CALL_HOOK(esp_heap_trace_free_hook, ptr);
+}
+
+size_t heap_caps_pool_get_object_size(heap_caps_pool_handle_t pool)
+{
+    assert(pool != NULL);
+    return pool->object_size;
+}
+
+static void add_pool_info(heap_caps_pool_handle_t pool, heap_caps_pool_info_t *info)
+{
+    info->total_bytes += pool->count * pool->object_size;
+    info->free_bytes += atomic_load(&pool->free_objects) * pool->object_size;
+    info->minimum_free_bytes += atomic_load(&pool->minimum_free_objects) * pool->object_size;
+    info->total_objects += pool->count;
+    info->free_objects += atomic_load(&pool->free_objects);
+    info->pools++;
+}
+
+void heap_caps_pool_get_info(heap_caps_pool_handle_t pool, heap_caps_pool_info_t *info)
+{
+    assert(pool != NULL);
+    memset(info, 0, sizeof(heap_caps_pool_info_t));
+    add_pool_info(pool, info);
+}
+
+/* Check if the objects of a pool are in a heap with the given caps */
+static bool pool_matches_caps(heap_caps_pool_handle_t pool, uint32_t caps)
+{
+    if (caps & MALLOC_CAP_INVALID) {
+        return true;
+    }
+    heap_t *heap = find_containing_heap(pool->objects);
+    return heap != NULL && heap_caps_match(heap, caps);
+}
+
+void heap_caps_get_pools_info(heap_caps_pool_info_t *info, uint32_t caps)
+{
+    memset(info, 0, sizeof(heap_caps_pool_info_t));
+
+    heap_caps_pool_handle_t pool;
+    MULTI_HEAP_LOCK(&pools_lock);
+    SLIST_FOREACH(pool, &pools, entries) {
+        if (pool_matches_caps(pool, caps)) {
+            add_pool_info(pool, info);
+        }
+    }
+    MULTI_HEAP_UNLOCK(&pools_lock);
+}
+
+void heap_caps_pool_dump(uint32_t caps)
+{
+    heap_caps_pool_handle_t pool;
+    MULTI_HEAP_LOCK(&pools_lock);
+    SLIST_FOREACH(pool, &pools, entries) {
+        if (pool_matches_caps(pool, caps)) {
+            MULTI_HEAP_STDERR_PRINTF("Pool %p objects at %p, object size: %u bytes, free objects: %u of %u, minimum: %u\n",
+                                     (void *)pool, (void *)pool->objects, (unsigned)pool->object_size,
+                                     (unsigned)atomic_load(&pool->free_objects), (unsigned)pool->count,
+                                     (unsigned)atomic_load(&pool->minimum_free_objects));
+        }
+    }
+    MULTI_HEAP_UNLOCK(&pools_lock);
+}
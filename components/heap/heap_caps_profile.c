@@ -0,0 +1,425 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#include "sdkconfig.h"
+#include "esp_attr.h"
+#include "esp_macros.h"
+#include "esp_heap_caps.h"
+#include "esp_heap_profile.h"
+#include "heap_profile_private.h"
+
+#if CONFIG_IDF_TARGET_LINUX
+#include <pthread.h>
+#include <execinfo.h>
+#else
+#include "soc/soc_memory_layout.h"
+#include "multi_heap_platform.h"
+#endif
+
+/*
+Sampling heap profiler. Every allocation subtracts its size from a countdown of bytes, and the allocation
+which takes the countdown to zero or below is sampled: its call stack is recorded and it is accounted to
+the call stack for the bytes allocated since the previous sample. Other allocations only cost the
+subtraction.
+
+Sampled blocks are kept in a small set-associative table, indexed by their address, so that freeing them
+can be accounted to their call stack. Frees only look up the table while sampled blocks are live.
+*/
+
+#define STACK_DEPTH CONFIG_HEAP_PROFILING_STACK_DEPTH
+#define MAX_SITES CONFIG_HEAP_PROFILING_MAX_SITES
+#define SAMPLE_WAYS 4
+#define SAMPLE_SETS (CONFIG_HEAP_PROFILING_MAX_SAMPLES / SAMPLE_WAYS)
+
+#if CONFIG_IDF_TARGET_LINUX
+static pthread_mutex_t profile_lock = PTHREAD_MUTEX_INITIALIZER;
+#define PROFILE_LOCK() pthread_mutex_lock(&profile_lock)
+#define PROFILE_UNLOCK() pthread_mutex_unlock(&profile_lock)
+#else
+static multi_heap_lock_t profile_lock = MULTI_HEAP_LOCK_STATIC_INITIALIZER;
+#define PROFILE_LOCK() MULTI_HEAP_LOCK(&profile_lock)
+#define PROFILE_UNLOCK() MULTI_HEAP_UNLOCK(&profile_lock)
+#endif
+
+/* Allocations sampled from one call stack */
+typedef struct {
+    void *callers[STACK_DEPTH];
+    uint32_t hash;
+    size_t live_samples;
+    size_t live_bytes;
+    size_t alloc_samples;
+    size_t alloc_bytes;
+} profile_site_t;
+
+/* A sampled block which is not freed yet */
+typedef struct {
+    atomic_uintptr_t address;       ///< address of the block, 0 if the entry is unused
+    uint32_t site;                  ///< index of the call stack in sites
+    size_t bytes;                   ///< bytes accounted to the call stack for this sample
+} profile_sample_t;
+
+static atomic_size_t sample_interval;          ///< 0 when not sampling
+static atomic_intptr_t bytes_until_sample;
+static atomic_size_t live_samples;
+static size_t dropped_samples;
+static size_t site_count;
+static profile_site_t sites[MAX_SITES];
+static profile_sample_t samples[SAMPLE_SETS * SAMPLE_WAYS];
+
+#if CONFIG_IDF_TARGET_LINUX
+
+/* Frames of get_call_stack, sample_alloc and heap_profile_record_alloc */
+#define STACK_OFFSET 3
+
+static __attribute__((noinline)) void get_call_stack(void **callers)
+{
+    void *frames[STACK_OFFSET + STACK_DEPTH];
+    int n = backtrace(frames, STACK_OFFSET + STACK_DEPTH);
+    memset(callers, 0, sizeof(void *) * STACK_DEPTH);
+    if (n > STACK_OFFSET) {
+        memcpy(callers, frames + STACK_OFFSET, sizeof(void *) * (n - STACK_OFFSET));
+    }
+}
+
+#elif CONFIG_IDF_TARGET_ARCH_XTENSA
+
+#define HEAP_ARCH_INVALID_PC  0x40000000
+
+/* Frames of sample_alloc and heap_profile_record_alloc */
+#define STACK_OFFSET  2
+
+#define TEST_STACK(N) do {                                              \
+        if (STACK_DEPTH == N) {                                         \
+            return;                                                     \
+        }                                                               \
+        callers[N] = __builtin_return_address(N+STACK_OFFSET);          \
+        if (!esp_ptr_executable(callers[N])                             \
+            || callers[N] == (void*) HEAP_ARCH_INVALID_PC) {            \
+            callers[N] = 0;                                             \
+            return;                                                     \
+        }                                                               \
+    } while(0)
+
+/* Calls to __builtin_return_address are "unrolled" via TEST_STACK macro as gcc requires the
+   argument to be a compile-time constant. */
+static HEAP_IRAM_ATTR __attribute__((noinline)) void get_call_stack(void **callers)
+{
+    memset(callers, 0, sizeof(void *) * STACK_DEPTH);
+    TEST_STACK(0);
+    TEST_STACK(1);
+    TEST_STACK(2);
+    TEST_STACK(3);
+    TEST_STACK(4);
+    TEST_STACK(5);
+    TEST_STACK(6);
+    TEST_STACK(7);
+    TEST_STACK(8);
+    TEST_STACK(9);
+    TEST_STACK(10);
+    TEST_STACK(11);
+    TEST_STACK(12);
+    TEST_STACK(13);
+    TEST_STACK(14);
+    TEST_STACK(15);
+    TEST_STACK(16);
+    TEST_STACK(17);
+    TEST_STACK(18);
+    TEST_STACK(19);
+    TEST_STACK(20);
+    TEST_STACK(21);
+    TEST_STACK(22);
+    TEST_STACK(23);
+    TEST_STACK(24);
+    TEST_STACK(25);
+    TEST_STACK(26);
+    TEST_STACK(27);
+    TEST_STACK(28);
+    TEST_STACK(29);
+    TEST_STACK(30);
+    TEST_STACK(31);
+}
+
+#else // RISC-V, with CONFIG_ESP_SYSTEM_USE_FRAME_POINTER
+
+extern uint32_t esp_fp_get_callers(uint32_t frame, void** callers, void** stacks, uint32_t depth);
+
+static HEAP_IRAM_ATTR __attribute__((noinline)) void get_call_stack(void **callers)
+{
+    uint32_t fp = (uint32_t) __builtin_frame_address(0);
+    memset(callers, 0, sizeof(void *) * STACK_DEPTH);
+    esp_fp_get_callers(fp, callers, NULL, STACK_DEPTH);
+}
+
+#endif
+
+ESP_STATIC_ASSERT(STACK_DEPTH >= 1 && STACK_DEPTH <= 32, "CONFIG_HEAP_PROFILING_STACK_DEPTH must be in range 1-32");
+
+static HEAP_IRAM_ATTR uint32_t hash_call_stack(void *const *callers)
+{
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < STACK_DEPTH; i++) {
+        hash = (hash ^ (uint32_t)(uintptr_t)callers[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static HEAP_IRAM_ATTR profile_sample_t *sample_set(uintptr_t address)
+{
+    /* Blocks are at least 4 byte aligned, mix the higher bits into the index of the set */
+    uint32_t hash = (uint32_t)(address >> 2) * 2654435761u;
+    return &samples[(hash >> 8) % SAMPLE_SETS * SAMPLE_WAYS];
+}
+
+/* Find the site of a call stack, or add it. Called with the lock held. */
+static HEAP_IRAM_ATTR profile_site_t *get_site(void *const *callers)
+{
+    const uint32_t hash = hash_call_stack(callers);
+    for (size_t i = 0; i < site_count; i++) {
+        if (sites[i].hash == hash && memcmp(sites[i].callers, callers, sizeof(sites[i].callers)) == 0) {
+            return &sites[i];
+        }
+    }
+    if (site_count == MAX_SITES) {
+        return NULL;
+    }
+    profile_site_t *site = &sites[site_count++];
+    memcpy(site->callers, callers, sizeof(site->callers));
+    site->hash = hash;
+    return site;
+}
+
+static HEAP_IRAM_ATTR __attribute__((noinline)) void sample_alloc(void *ptr)
+{
+    void *callers[STACK_DEPTH];
+    get_call_stack(callers);
+
+    PROFILE_LOCK();
+    const size_t interval = atomic_load_explicit(&sample_interval, memory_order_relaxed);
+    const intptr_t left = atomic_load_explicit(&bytes_until_sample, memory_order_relaxed);
+    if (interval == 0 || left > 0) {
+        /* the profiler was stopped, or another allocation took this sample */
+        PROFILE_UNLOCK();
+        return;
+    }
+    /* Large allocations may stand for several sampling intervals */
+    const size_t bytes = (1 + (size_t)(-left) / interval) * interval;
+    atomic_fetch_add_explicit(&bytes_until_sample, bytes, memory_order_relaxed);
+
+    profile_site_t *site = get_site(callers);
+    profile_sample_t *sample = NULL;
+    if (site != NULL) {
+        profile_sample_t *set = sample_set((uintptr_t)ptr);
+        for (int i = 0; i < SAMPLE_WAYS && sample == NULL; i++) {
+            uintptr_t unused = 0;
+            if (atomic_compare_exchange_strong(&set[i].address, &unused, (uintptr_t)ptr)) {
+                sample = &set[i];
+            }
+        }
+    }
+    if (sample == NULL) {
+        dropped_samples++;
+        PROFILE_UNLOCK();
+        return;
+    }
+
+    sample->site = site - sites;
+    sample->bytes = bytes;
+    site->live_samples++;
+    site->live_bytes += bytes;
+    site->alloc_samples++;
+    site->alloc_bytes += bytes;
+    atomic_fetch_add_explicit(&live_samples, 1, memory_order_relaxed);
+    PROFILE_UNLOCK();
+}
+
+HEAP_IRAM_ATTR void heap_profile_record_alloc(void *ptr, size_t size)
+{
+    if (ptr == NULL || atomic_load_explicit(&sample_interval, memory_order_relaxed) == 0) {
+        return;
+    }
+    if (atomic_fetch_sub_explicit(&bytes_until_sample, size, memory_order_relaxed) > (intptr_t)size) {
+        return;
+    }
+    sample_alloc(ptr);
+}
+
+static HEAP_IRAM_ATTR __attribute__((noinline)) void forget_sample(profile_sample_t *sample, uintptr_t address)
+{
+    PROFILE_LOCK();
+    /* the profiler may have been restarted in between */
+    if (atomic_load_explicit(&sample->address, memory_order_relaxed) == address) {
+        profile_site_t *site = &sites[sample->site];
+        site->live_samples--;
+        site->live_bytes -= sample->bytes;
+        atomic_store_explicit(&sample->address, 0, memory_order_relaxed);
+        atomic_fetch_sub_explicit(&live_samples, 1, memory_order_relaxed);
+    }
+    PROFILE_UNLOCK();
+}
+
+HEAP_IRAM_ATTR void heap_profile_record_free(void *ptr)
+{
+    if (ptr == NULL || atomic_load_explicit(&live_samples, memory_order_relaxed) == 0) {
+        return;
+    }
+    profile_sample_t *set = sample_set((uintptr_t)ptr);
+    for (int i = 0; i < SAMPLE_WAYS; i++) {
+        if (atomic_load_explicit(&set[i].address, memory_order_relaxed) == (uintptr_t)ptr) {
+            forget_sample(&set[i], (uintptr_t)ptr);
+            return;
+        }
+    }
+}
+
+/* Set in the address of the sample of a block being reallocated, so that the block allocated at the same
+   address once the old block is released by the realloc is neither mistaken for it nor loses its own sample */
+#define SAMPLE_MOVING_TAG 1
+
+HEAP_IRAM_ATTR uintptr_t heap_profile_record_realloc_begin(void *ptr)
+{
+    if (ptr == NULL || atomic_load_explicit(&live_samples, memory_order_relaxed) == 0) {
+        return 0;
+    }
+    profile_sample_t *set = sample_set((uintptr_t)ptr);
+    for (int i = 0; i < SAMPLE_WAYS; i++) {
+        uintptr_t address = (uintptr_t)ptr;
+        if (atomic_compare_exchange_strong(&set[i].address, &address, (uintptr_t)ptr | SAMPLE_MOVING_TAG)) {
+            return (uintptr_t)ptr | SAMPLE_MOVING_TAG;
+        }
+    }
+    return 0;
+}
+
+HEAP_IRAM_ATTR void heap_profile_record_realloc_end(uintptr_t tagged, bool released)
+{
+    if (tagged == 0) {
+        return;
+    }
+    /* the tag does not change the set */
+    profile_sample_t *set = sample_set(tagged);
+    for (int i = 0; i < SAMPLE_WAYS; i++) {
+        uintptr_t address = tagged;
+        if (released) {
+            if (atomic_load_explicit(&set[i].address, memory_order_relaxed) == tagged) {
+                forget_sample(&set[i], tagged);
+                return;
+            }
+        } else if (atomic_compare_exchange_strong(&set[i].address, &address, tagged & ~(uintptr_t)SAMPLE_MOVING_TAG)) {
+            /* the block is left untouched when the realloc fails */
+            return;
+        }
+    }
+}
+
+esp_err_t heap_profile_start(size_t interval)
+{
+    if (interval == 0 || interval > INTPTR_MAX / 2) {
+        return ESP_ERR_INVALID_ARG;
+    }
+#if CONFIG_IDF_TARGET_LINUX
+    /* The first call of backtrace() may allocate memory to load the unwinder, do it now */
+    void *frame;
+    backtrace(&frame, 1);
+#endif
+
+    PROFILE_LOCK();
+    if (atomic_load_explicit(&sample_interval, memory_order_relaxed) != 0) {
+        PROFILE_UNLOCK();
+        return ESP_ERR_INVALID_STATE;
+    }
+    for (size_t i = 0; i < SAMPLE_SETS * SAMPLE_WAYS; i++) {
+        atomic_store_explicit(&samples[i].address, 0, memory_order_relaxed);
+    }
+    memset(sites, 0, sizeof(sites));
+    site_count = 0;
+    dropped_samples = 0;
+    atomic_store_explicit(&live_samples, 0, memory_order_relaxed);
+    atomic_store_explicit(&bytes_until_sample, interval, memory_order_relaxed);
+    atomic_store_explicit(&sample_interval, interval, memory_order_relaxed);
+    PROFILE_UNLOCK();
+    return ESP_OK;
+}
+
+esp_err_t heap_profile_stop(void)
+{
+    esp_err_t err = ESP_OK;
+    PROFILE_LOCK();
+    if (atomic_load_explicit(&sample_interval, memory_order_relaxed) == 0) {
+        err = ESP_ERR_INVALID_STATE;
+    }
+    atomic_store_explicit(&sample_interval, 0, memory_order_relaxed);
+    PROFILE_UNLOCK();
+    return err;
+}
+
+void heap_profile_get_info(heap_profile_info_t *info)
+{
+    PROFILE_LOCK();
+    info->sample_interval = atomic_load_explicit(&sample_interval, memory_order_relaxed);
+    info->live_samples = atomic_load_explicit(&live_samples, memory_order_relaxed);
+    info->sites = site_count;
+    info->dropped_samples = dropped_samples;
+    PROFILE_UNLOCK();
+}
+
+esp_err_t heap_profile_write(heap_profile_write_cb_t write, void *arg)
+{
+    char line[96 + STACK_DEPTH * (2 + 2 * sizeof(void *) + 1)];
+    profile_site_t site;
+    profile_site_t total = { 0 };
+    size_t count;
+
+    PROFILE_LOCK();
+    count = site_count;
+    for (size_t i = 0; i < count; i++) {
+        total.live_samples += sites[i].live_samples;
+        total.live_bytes += sites[i].live_bytes;
+        total.alloc_samples += sites[i].alloc_samples;
+        total.alloc_bytes += sites[i].alloc_bytes;
+    }
+    PROFILE_UNLOCK();
+
+    int len = snprintf(line, sizeof(line), "heap profile: %u: %u [%u: %u] @ heapprofile\n",
+                       (unsigned)total.live_samples, (unsigned)total.live_bytes,
+                       (unsigned)total.alloc_samples, (unsigned)total.alloc_bytes);
+    esp_err_t err = write(arg, line, len);
+
+    /* Sites are only added until the profiler is restarted, copy them one at a time so that
+       the lock is not held while writing */
+    for (size_t i = 0; i < count && err == ESP_OK; i++) {
+        PROFILE_LOCK();
+        site = sites[i];
+        PROFILE_UNLOCK();
+
+        len = snprintf(line, sizeof(line), "%u: %u [%u: %u] @",
+                       (unsigned)site.live_samples, (unsigned)site.live_bytes,
+                       (unsigned)site.alloc_samples, (unsigned)site.alloc_bytes);
+        for (int j = 0; j < STACK_DEPTH && site.callers[j] != NULL; j++) {
+            len += snprintf(line + len, sizeof(line) - len, " 0x%" PRIxPTR, (uintptr_t)site.callers[j]);
+        }
+        len += snprintf(line + len, sizeof(line) - len, "\n");
+        err = write(arg, line, len);
+    }
+    return err;
+}
+
+static esp_err_t write_to_stream(void *arg, const char *data, size_t len)
+{
+    return fwrite(data, 1, len, (FILE *)arg) == len ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t heap_profile_dump(FILE *stream)
+{
+    esp_err_t err = heap_profile_write(write_to_stream, stream);
+    if (err == ESP_OK && fflush(stream) != 0) {
+        err = ESP_FAIL;
+    }
+    return err;
+}
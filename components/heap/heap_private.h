@@ -23,6 +23,16 @@ extern "C" {
 
 #define HEAP_SIZE_MAX (SOC_MAX_CONTIGUOUS_RAM_SIZE)
 
+#ifdef CONFIG_HEAP_USE_HOOKS
+#define CALL_HOOK(hook, ...) {      \
+    if (hook != NULL) {             \
+        hook(__VA_ARGS__);          \
+    }                               \
+}
+#else
+#define CALL_HOOK(hook, ...) {}
+#endif
+
 /* Type for describing each registered heap */
 typedef struct heap_t_ {
     uint32_t caps[SOC_MEMORY_TYPE_NO_PRIOS]; ///< Capabilities for the type of memory in this heap (as a prioritised set). Copied from soc_memory_types so it's in RAM not flash.
@@ -87,6 +97,10 @@ void *heap_caps_calloc_base(size_t n, size_t size, uint32_t caps);
 void *heap_caps_malloc_base(size_t size, uint32_t caps);
 void *heap_caps_aligned_alloc_base(size_t alignment, size_t size, uint32_t caps);
 
+/* Dump the pools created by heap_caps_pool_create() whose objects are in heaps with the given caps,
+   or all of them if caps is MALLOC_CAP_INVALID. Called by heap_caps_dump(). */
+void heap_caps_pool_dump(uint32_t caps);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,46 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef CONFIG_HEAP_PROFILING
+
+/* Called by the heap_caps_* functions with each block they return and before each block
+   they free, see esp_heap_profile.h */
+void heap_profile_record_alloc(void *ptr, size_t size);
+void heap_profile_record_free(void *ptr);
+
+/* Called before and after a block is reallocated: begin returns a token for end, which is told whether the
+   realloc released the old block (moved, resized or freed it). The old block may be released, and its address
+   allocated again, before the realloc returns, so end does not take the old pointer. */
+uintptr_t heap_profile_record_realloc_begin(void *ptr);
+void heap_profile_record_realloc_end(uintptr_t token, bool released);
+
+#define HEAP_PROFILE_ALLOC(ptr, size) heap_profile_record_alloc((ptr), (size))
+#define HEAP_PROFILE_FREE(ptr) heap_profile_record_free((ptr))
+#define HEAP_PROFILE_REALLOC_BEGIN(ptr) heap_profile_record_realloc_begin((ptr))
+#define HEAP_PROFILE_REALLOC_END(token, released) heap_profile_record_realloc_end((token), (released))
+
+#else
+
+#define HEAP_PROFILE_ALLOC(ptr, size) {}
+#define HEAP_PROFILE_FREE(ptr) {}
+#define HEAP_PROFILE_REALLOC_BEGIN(ptr) ((uintptr_t)0)
+#define HEAP_PROFILE_REALLOC_END(token, released) { (void)(token); }
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
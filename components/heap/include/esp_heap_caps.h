@@ -435,6 +435,21 @@ void heap_caps_dump(uint32_t caps);
  */
 void heap_caps_dump_all(void);
 
+/**
+ * @brief Return the small free blocks cached per core to their heaps.
+ *
+ * With CONFIG_HEAP_CACHE enabled, small blocks freed on a core are cached for
+ * later allocations on that core and are counted as allocated until flushed.
+ * Flushing makes heap_caps_get_free_size and heap_caps_get_info exact again, and
+ * allows the cached blocks to be merged into bigger free blocks.
+ *
+ * @param caps        Bitwise OR of MALLOC_CAP_* flags indicating the type
+ *                    of memory. Use MALLOC_CAP_INVALID to flush all heaps.
+ *
+ * @return Number of bytes returned to the heaps, 0 if CONFIG_HEAP_CACHE is disabled.
+ */
+size_t heap_caps_cache_flush(uint32_t caps);
+
 /**
  * @brief Return the size that a particular pointer was allocated with.
  *
@@ -0,0 +1,85 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Arena of memory created by heap_caps_arena_create() */
+typedef struct heap_caps_arena heap_caps_arena_t;
+
+/** @brief Structure to access arena metadata via heap_caps_arena_get_info */
+typedef struct {
+    size_t allocated_bytes;         ///<  Bytes allocated from the arena since it was created or last reset.
+    size_t peak_allocated_bytes;    ///<  High watermark of allocated_bytes over the lifetime of the arena.
+    size_t chunk_bytes;             ///<  Bytes of the chunks currently held by the arena.
+    size_t peak_chunk_bytes;        ///<  High watermark of chunk_bytes over the lifetime of the arena.
+    size_t chunks;                  ///<  Number of chunks currently held by the arena.
+} heap_caps_arena_info_t;
+
+/**
+ * @brief Create an arena to allocate memory which is freed all at once
+ *
+ * Memory is allocated from the arena by advancing a pointer in chunks of chunk_size bytes, which are
+ * allocated with heap_caps_malloc() when needed. Individual allocations cannot be freed: all of them
+ * are freed at once by heap_caps_arena_reset() or heap_caps_arena_destroy(). This suits the many small
+ * allocations made while handling a request, parsing a document, etc.
+ *
+ * An arena must not be used by several tasks at once.
+ *
+ * @param chunk_size Size, in bytes, of the chunks of memory of the arena
+ * @param caps        Bitwise OR of MALLOC_CAP_* flags indicating the type
+ *                    of memory of the chunks
+ *
+ * @return The arena on success, NULL if there is not enough memory.
+ */
+heap_caps_arena_t *heap_caps_arena_create(size_t chunk_size, uint32_t caps);
+
+/**
+ * @brief Allocate memory from an arena
+ *
+ * The memory is aligned for any type. Allocations which do not fit in a chunk get a dedicated
+ * chunk of their own.
+ *
+ * @param arena The arena
+ * @param size Size, in bytes, of the memory to allocate
+ *
+ * @return A pointer to the memory on success, NULL if size is 0 or there is not enough memory.
+ */
+void *heap_caps_arena_alloc(heap_caps_arena_t *arena, size_t size);
+
+/**
+ * @brief Free all the memory allocated from an arena
+ *
+ * The chunks of chunk_size bytes are kept to serve the following allocations, dedicated chunks
+ * of larger allocations are freed.
+ *
+ * @param arena The arena
+ */
+void heap_caps_arena_reset(heap_caps_arena_t *arena);
+
+/**
+ * @brief Free all the memory allocated from an arena and the arena itself
+ *
+ * @param arena The arena, may be NULL.
+ */
+void heap_caps_arena_destroy(heap_caps_arena_t *arena);
+
+/**
+ * @brief Get metadata about an arena
+ *
+ * @param arena The arena
+ * @param info Pointer to a structure which will be filled with the metadata
+ */
+void heap_caps_arena_get_info(const heap_caps_arena_t *arena, heap_caps_arena_info_t *info);
+
+#ifdef __cplusplus
+}
+#endif
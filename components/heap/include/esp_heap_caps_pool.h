@@ -0,0 +1,111 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_heap_caps.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Maximum number of objects in a pool */
+#define HEAP_CAPS_POOL_MAX_OBJECTS 0xFFFF
+
+/** @brief Handle to a pool of fixed size objects created by heap_caps_pool_create() */
+typedef struct heap_caps_pool *heap_caps_pool_handle_t;
+
+/** @brief Structure to access pool metadata via heap_caps_pool_get_info and heap_caps_get_pools_info */
+typedef struct {
+    size_t total_bytes;           ///<  Total bytes of the objects of the pools.
+    size_t free_bytes;            ///<  Bytes of the free objects of the pools.
+    size_t minimum_free_bytes;    ///<  Lifetime minimum of the bytes of the free objects of the pools.
+    size_t total_objects;         ///<  Total number of objects of the pools.
+    size_t free_objects;          ///<  Number of free objects of the pools.
+    size_t pools;                 ///<  Number of pools.
+} heap_caps_pool_info_t;
+
+/**
+ * @brief Create a pool of fixed size objects
+ *
+ * The memory of all the objects is allocated at once with heap_caps_malloc(). Objects are
+ * then allocated and freed in constant time without locking, from any task or ISR, which
+ * makes pools suited to objects of one size which are allocated and freed often.
+ *
+ * The size of the objects is rounded up to a multiple of sizeof(void *), and objects are
+ * aligned to sizeof(void *) only, even if heap_caps_malloc() would align a block of the same
+ * size and caps more strictly (e.g. to the cache line size for DMA capable PSRAM).
+ *
+ * @param obj_size Size, in bytes, of each object
+ * @param count Number of objects, up to HEAP_CAPS_POOL_MAX_OBJECTS
+ * @param caps        Bitwise OR of MALLOC_CAP_* flags indicating the type
+ *                    of memory of the objects
+ *
+ * @return Handle of the pool on success, NULL if the arguments are invalid or there is not
+ *         enough memory with the given capabilities.
+ */
+heap_caps_pool_handle_t heap_caps_pool_create(size_t obj_size, size_t count, uint32_t caps);
+
+/**
+ * @brief Delete a pool created by heap_caps_pool_create()
+ *
+ * All the objects of the pool are freed, whether they were freed with heap_caps_pool_free()
+ * or not.
+ *
+ * @param pool Handle of the pool to delete, may be NULL.
+ */
+void heap_caps_pool_delete(heap_caps_pool_handle_t pool);
+
+/**
+ * @brief Allocate an object from a pool
+ *
+ * @param pool Handle of the pool
+ *
+ * @return A pointer to the object, NULL if all the objects of the pool are allocated.
+ */
+void *heap_caps_pool_alloc(heap_caps_pool_handle_t pool);
+
+/**
+ * @brief Free an object allocated from a pool
+ *
+ * @param pool Handle of the pool the object was allocated from
+ * @param ptr Pointer returned by heap_caps_pool_alloc() for this pool, may be NULL.
+ */
+void heap_caps_pool_free(heap_caps_pool_handle_t pool, void *ptr);
+
+/**
+ * @brief Return the size of the objects of a pool
+ *
+ * @param pool Handle of the pool
+ *
+ * @return Size of the objects in bytes, which may be larger than the size requested when
+ *         creating the pool due to alignment.
+ */
+size_t heap_caps_pool_get_object_size(heap_caps_pool_handle_t pool);
+
+/**
+ * @brief Get metadata about a pool
+ *
+ * @param pool Handle of the pool
+ * @param info Pointer to a structure which will be filled with the metadata
+ */
+void heap_caps_pool_get_info(heap_caps_pool_handle_t pool, heap_caps_pool_info_t *info);
+
+/**
+ * @brief Get metadata about all the pools whose objects are in heaps with the given capabilities
+ *
+ * The memory of the objects of the pools is also reported as allocated by heap_caps_get_info().
+ *
+ * @param info Pointer to a structure which will be filled with the metadata summed over the pools
+ * @param caps        Bitwise OR of MALLOC_CAP_* flags indicating the type
+ *                    of memory
+ */
+void heap_caps_get_pools_info(heap_caps_pool_info_t *info, uint32_t caps);
+
+#ifdef __cplusplus
+}
+#endif
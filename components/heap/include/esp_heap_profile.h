@@ -0,0 +1,116 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Function called by heap_profile_write() with each part of the profile
+ *
+ * @param arg Argument given to heap_profile_write()
+ * @param data Part of the profile, not NUL terminated
+ * @param len Length of the part in bytes
+ *
+ * @return ESP_OK to continue, another value to stop writing the profile.
+ */
+typedef esp_err_t (*heap_profile_write_cb_t)(void *arg, const char *data, size_t len);
+
+/** @brief Structure to access profiler metadata via heap_profile_get_info */
+typedef struct {
+    size_t sample_interval;     ///<  Average number of bytes allocated between two samples, 0 if the profiler is stopped.
+    size_t live_samples;        ///<  Number of sampled allocations which are not freed.
+    size_t sites;               ///<  Number of distinct call stacks of the sampled allocations.
+    size_t dropped_samples;     ///<  Number of samples which were not recorded as the profiler tables were full.
+} heap_profile_info_t;
+
+/**
+ * @brief Start sampling heap allocations
+ *
+ * One allocation is sampled every sample_interval bytes allocated with the heap_caps_* functions
+ * (and so with malloc()), and the call stack of the allocation is recorded. Each sample stands for
+ * the sample_interval bytes allocated since the previous one, so that the bytes reported for a call
+ * stack estimate the bytes allocated from it. Allocations which are not sampled only cost a few
+ * instructions.
+ *
+ * The call stacks and counters of a previous profile are cleared.
+ *
+ * @param sample_interval Number of bytes allocated between two samples. Smaller values give a more
+ *                        precise profile at the cost of more overhead.
+ *
+ * @return
+ *  - ESP_OK on success
+ *  - ESP_ERR_INVALID_ARG if sample_interval is 0
+ *  - ESP_ERR_INVALID_STATE if the profiler is already started
+ */
+esp_err_t heap_profile_start(size_t sample_interval);
+
+/**
+ * @brief Stop sampling heap allocations
+ *
+ * No more allocations are sampled, but the frees of the sampled allocations are still recorded
+ * until the profiler is started again, and the profile can still be written by heap_profile_write().
+ *
+ * @return
+ *  - ESP_OK on success
+ *  - ESP_ERR_INVALID_STATE if the profiler is not started
+ */
+esp_err_t heap_profile_stop(void);
+
+/**
+ * @brief Write the profile aggregated per call stack
+ *
+ * The profile is written in the text format of gperftools heap profiles, which pprof reads:
+ * a header line with the totals, then one line per call stack:
+ *
+ *     <live samples>: <live bytes> [<allocated samples>: <allocated bytes>] @ <address> <address> ...
+ *
+ * Live bytes are the estimated bytes allocated from the call stack and not freed yet, allocated bytes
+ * are the estimated bytes allocated from it since the profiler was started. The addresses can be
+ * resolved with the ELF file of the application. Comparing profiles taken some time apart shows which
+ * call stacks hold more and more memory.
+ *
+ * The profile is written a line at a time, without holding locks, so write may print to the console,
+ * send through app_trace or write to a file. This function must not be called from an ISR.
+ *
+ * @param write Function called with each part of the profile
+ * @param arg Argument passed to write
+ *
+ * @return
+ *  - ESP_OK on success
+ *  - The error returned by write, if any
+ */
+esp_err_t heap_profile_write(heap_profile_write_cb_t write, void *arg);
+
+/**
+ * @brief Write the profile to a stream
+ *
+ * Same as heap_profile_write(), writing to a stream such as stdout or a file.
+ *
+ * @param stream The stream
+ *
+ * @return
+ *  - ESP_OK on success
+ *  - ESP_FAIL if writing to the stream failed
+ */
+esp_err_t heap_profile_dump(FILE *stream);
+
+/**
+ * @brief Get metadata about the profiler
+ *
+ * @param info Pointer to a structure which will be filled with the metadata
+ */
+void heap_profile_get_info(heap_profile_info_t *info);
+
+#ifdef __cplusplus
+}
+#endif
@@ -230,6 +230,37 @@ typedef bool (*multi_heap_walker_cb_t)(void *block_ptr, size_t block_size, int b
  */
 void multi_heap_walk(multi_heap_handle_t heap, multi_heap_walker_cb_t walker_func, void *user_data);
 
+/**
+ * @brief Cache small free blocks of the heap per core
+ *
+ * Once enabled, blocks of up to 256 bytes are kept in a cache of the core freeing
+ * them instead of being returned to the heap, and allocations of up to 256 bytes
+ * are served from the cache of the calling core first. This avoids taking the heap
+ * lock, which all the cores share, for most small allocations. On the host, each
+ * thread is given one of several caches instead.
+ *
+ * Cached blocks count as allocated in multi_heap_free_size() and multi_heap_get_info().
+ * They are returned to the heap by multi_heap_cache_flush(), and whenever an allocation
+ * would otherwise fail.
+ *
+ * The cache is not available when heap poisoning is enabled or when the heap
+ * implementation in ROM is used.
+ *
+ * @param heap Handle to a registered heap, not yet used by several cores.
+ * @param max_cached_bytes Maximum number of bytes cached per core.
+ * @return true if the cache is enabled, false if it is not available or there was
+ *         not enough memory in the heap for it.
+ */
+bool multi_heap_cache_enable(multi_heap_handle_t heap, size_t max_cached_bytes);
+
+/**
+ * @brief Return all the blocks cached by multi_heap_cache_enable() to the heap
+ *
+ * @param heap Handle to a registered heap.
+ * @return Number of bytes returned to the heap.
+ */
+size_t multi_heap_cache_flush(multi_heap_handle_t heap);
+
 #ifdef __cplusplus
 }
 #endif
@@ -75,12 +75,37 @@ void *multi_heap_get_block_address(multi_heap_block_handle_t block)
 #define ALIGN_UP_BY(num, align) (((num) + ((align) - 1)) & ~((align) - 1))
 
 
+#ifdef MULTI_HEAP_CACHE
+
+/* Free blocks of up to MULTI_HEAP_CACHE_MAX_SIZE bytes are cached in lists sorted
+   in size classes of MULTI_HEAP_CACHE_CLASS_SIZE bytes, a block of the class N has
+   at least (N + 1) * MULTI_HEAP_CACHE_CLASS_SIZE bytes */
+#define MULTI_HEAP_CACHE_CLASS_SIZE 16
+#define MULTI_HEAP_CACHE_MAX_SIZE 256
+#define MULTI_HEAP_CACHE_CLASSES (MULTI_HEAP_CACHE_MAX_SIZE / MULTI_HEAP_CACHE_CLASS_SIZE)
+
+typedef struct {
+    multi_heap_lock_t lock;
+    size_t cached_bytes;
+    void *blocks[MULTI_HEAP_CACHE_CLASSES];  // singly linked through the first word of each block
+} multi_heap_cache_slot_t;
+
+typedef struct {
+    size_t max_cached_bytes;
+    multi_heap_cache_slot_t slots[MULTI_HEAP_CACHE_SLOTS];
+} multi_heap_cache_t;
+
+#endif // MULTI_HEAP_CACHE
+
 typedef struct multi_heap_info {
     void *lock;
     size_t free_bytes;
     size_t minimum_free_bytes;
     size_t pool_size;
     void* heap_data;
+#ifdef MULTI_HEAP_CACHE
+    multi_heap_cache_t *cache;
+#endif
 } heap_t;
 
 #if CONFIG_HEAP_TLSF_USE_ROM_IMPL
@@ -148,6 +173,9 @@ multi_heap_handle_t multi_heap_register_impl(void *start_ptr, size_t size)
     }
 
     result->lock = NULL;
+#ifdef MULTI_HEAP_CACHE
+    result->cache = NULL;
+#endif
     result->free_bytes = size - tlsf_size(result->heap_data);
     result->pool_size = size;
     result->minimum_free_bytes = result->free_bytes;
@@ -198,12 +226,130 @@ bool multi_heap_is_free(multi_heap_block_handle_t block)
     return block_is_free(block);
 }
 
+#ifdef MULTI_HEAP_CACHE
+
+/* Take a block of at least size bytes from the cache slot of the calling core */
+static void *multi_heap_cache_pop(multi_heap_cache_t *cache, size_t size)
+{
+    const size_t size_class = (size + MULTI_HEAP_CACHE_CLASS_SIZE - 1) / MULTI_HEAP_CACHE_CLASS_SIZE - 1;
+    multi_heap_cache_slot_t *slot = &cache->slots[MULTI_HEAP_CACHE_SLOT()];
+
+    MULTI_HEAP_LOCK(&slot->lock);
+    void *result = slot->blocks[size_class];
+    if (result != NULL) {
+        slot->blocks[size_class] = *(void **)result;
+        slot->cached_bytes -= tlsf_block_size(result);
+    }
+    MULTI_HEAP_UNLOCK(&slot->lock);
+
+    return result;
+}
+
+/* Keep a block in the cache slot of the calling core, unless it is too big or the slot is full */
+static bool multi_heap_cache_push(multi_heap_cache_t *cache, void *p)
+{
+    const size_t size = tlsf_block_size(p);
+    if (size < MULTI_HEAP_CACHE_CLASS_SIZE || size > MULTI_HEAP_CACHE_MAX_SIZE) {
+        return false;
+    }
+
+    const size_t size_class = size / MULTI_HEAP_CACHE_CLASS_SIZE - 1;
+    multi_heap_cache_slot_t *slot = &cache->slots[MULTI_HEAP_CACHE_SLOT()];
+    bool cached = false;
+
+    MULTI_HEAP_LOCK(&slot->lock);
+    if (slot->cached_bytes + size <= cache->max_cached_bytes) {
+        *(void **)p = slot->blocks[size_class];
+        slot->blocks[size_class] = p;
+        slot->cached_bytes += size;
+        cached = true;
+    }
+    MULTI_HEAP_UNLOCK(&slot->lock);
+
+    return cached;
+}
+
+bool multi_heap_cache_enable(multi_heap_handle_t heap, size_t max_cached_bytes)
+{
+    assert(heap != NULL);
+
+    if (heap->cache != NULL) {
+        return true;
+    }
+
+    multi_heap_cache_t *cache = multi_heap_malloc_impl(heap, sizeof(multi_heap_cache_t));
+    if (cache == NULL) {
+        return false;
+    }
+
+    memset(cache, 0, sizeof(multi_heap_cache_t));
+    cache->max_cached_bytes = max_cached_bytes;
+    for (int i = 0; i < MULTI_HEAP_CACHE_SLOTS; i++) {
+        MULTI_HEAP_LOCK_INIT(&cache->slots[i].lock);
+    }
+    heap->cache = cache;
+    return true;
+}
+
+size_t multi_heap_cache_flush(multi_heap_handle_t heap)
+{
+    assert(heap != NULL);
+
+    multi_heap_cache_t *cache = heap->cache;
+    size_t flushed = 0;
+
+    if (cache == NULL) {
+        return 0;
+    }
+
+    for (int i = 0; i < MULTI_HEAP_CACHE_SLOTS; i++) {
+        multi_heap_cache_slot_t *slot = &cache->slots[i];
+        void *blocks[MULTI_HEAP_CACHE_CLASSES];
+
+        /* Detach the lists so that the slot lock is not held while freeing */
+        MULTI_HEAP_LOCK(&slot->lock);
+        memcpy(blocks, slot->blocks, sizeof(blocks));
+        memset(slot->blocks, 0, sizeof(slot->blocks));
+        slot->cached_bytes = 0;
+        MULTI_HEAP_UNLOCK(&slot->lock);
+
+        multi_heap_internal_lock(heap);
+        for (int size_class = 0; size_class < MULTI_HEAP_CACHE_CLASSES; size_class++) {
+            void *p = blocks[size_class];
+            while (p != NULL) {
+                void *next = *(void **)p;
+                const size_t size = tlsf_block_size(p);
+                heap->free_bytes += size;
+                heap->free_bytes += tlsf_alloc_overhead();
+                flushed += size;
+                tlsf_free(heap->heap_data, p);
+                p = next;
+            }
+        }
+        multi_heap_internal_unlock(heap);
+    }
+
+    return flushed;
+}
+
+#endif // MULTI_HEAP_CACHE
+
 void *multi_heap_malloc_impl(multi_heap_handle_t heap, size_t size)
 {
     if (size == 0 || heap == NULL) {
         return NULL;
     }
 
+#ifdef MULTI_HEAP_CACHE
+    if (heap->cache != NULL && size <= MULTI_HEAP_CACHE_MAX_SIZE) {
+        void *cached = multi_heap_cache_pop(heap->cache, size);
+        if (cached != NULL) {
+            return cached;
+        }
+        /* Round the size up to its class so that the block can be reused for it once cached */
+        size = ALIGN_UP_BY(size, MULTI_HEAP_CACHE_CLASS_SIZE);
+    }
+#endif
 
     multi_heap_internal_lock(heap);
     void *result = tlsf_malloc(heap->heap_data, size);
@@ -216,6 +362,13 @@ void *multi_heap_malloc_impl(multi_heap_handle_t heap, size_t size)
     }
     multi_heap_internal_unlock(heap);
 
+#ifdef MULTI_HEAP_CACHE
+    /* Cached blocks may be what is missing to satisfy the allocation */
+    if (result == NULL && heap->cache != NULL && multi_heap_cache_flush(heap) > 0) {
+        return multi_heap_malloc_impl(heap, size);
+    }
+#endif
+
     return result;
 }
 
@@ -227,6 +380,12 @@ void multi_heap_free_impl(multi_heap_handle_t heap, void *p)
 
     assert_valid_block(heap, block_from_ptr(p));
 
+#ifdef MULTI_HEAP_CACHE
+    if (heap->cache != NULL && multi_heap_cache_push(heap->cache, p)) {
+        return;
+    }
+#endif
+
     multi_heap_internal_lock(heap);
     heap->free_bytes += tlsf_block_size(p);
     heap->free_bytes += tlsf_alloc_overhead();
@@ -292,6 +451,12 @@ void *multi_heap_aligned_alloc_impl_offs(multi_heap_handle_t heap, size_t size,
     }
     multi_heap_internal_unlock(heap);
 
+#ifdef MULTI_HEAP_CACHE
+    if (result == NULL && heap->cache != NULL && multi_heap_cache_flush(heap) > 0) {
+        return multi_heap_aligned_alloc_impl_offs(heap, size, alignment, offset);
+    }
+#endif
+
     return result;
 }
 
@@ -439,6 +604,21 @@ void multi_heap_walk(multi_heap_handle_t heap, multi_heap_walker_cb_t walker_fun
 
 #endif // CONFIG_HEAP_TLSF_USE_ROM_IMPL
 
+#ifndef MULTI_HEAP_CACHE
+bool multi_heap_cache_enable(multi_heap_handle_t heap, size_t max_cached_bytes)
+{
+    (void) heap;
+    (void) max_cached_bytes;
+    return false;
+}
+
+size_t multi_heap_cache_flush(multi_heap_handle_t heap)
+{
+    (void) heap;
+    return 0;
+}
+#endif // MULTI_HEAP_CACHE
+
 size_t multi_heap_reset_minimum_free_bytes(multi_heap_handle_t heap)
 {
     multi_heap_internal_lock(heap);
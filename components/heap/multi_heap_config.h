@@ -21,3 +21,9 @@
 #define MULTI_HEAP_POISONING
 #define MULTI_HEAP_POISONING_SLOW
 #endif
+
+/* The cache of small free blocks sits below the poisoning wrappers and needs
+   fields in the heap structure, which the ROM implementation does not have */
+#if defined(CONFIG_HEAP_CACHE) && !defined(MULTI_HEAP_POISONING) && !defined(CONFIG_HEAP_TLSF_USE_ROM_IMPL)
+#define MULTI_HEAP_CACHE
+#endif
@@ -36,6 +36,10 @@ typedef portMUX_TYPE multi_heap_lock_t;
 
 #define MULTI_HEAP_LOCK_STATIC_INITIALIZER     portMUX_INITIALIZER_UNLOCKED
 
+/* Small free blocks are cached per core, see multi_heap_cache_enable() */
+#define MULTI_HEAP_CACHE_SLOTS portNUM_PROCESSORS
+#define MULTI_HEAP_CACHE_SLOT() xPortGetCoreID()
+
 /* Not safe to use std i/o while in a portmux critical section,
    can deadlock, so we use the ROM equivalent functions. */
 
@@ -89,11 +93,66 @@ inline static void multi_heap_assert(bool condition, const char *format, int lin
 
 #define MULTI_HEAP_PRINTF printf
 #define MULTI_HEAP_STDERR_PRINTF(MSG, ...) fprintf(stderr, MSG, __VA_ARGS__)
+
+#ifdef MULTI_HEAP_PTHREAD
+
+/* Host builds running several threads on the same heap (e.g. the host tests)
+   define MULTI_HEAP_PTHREAD to get real locks */
+#include <pthread.h>
+
+typedef pthread_mutex_t multi_heap_lock_t;
+
+static inline void multi_heap_pthread_lock_init(pthread_mutex_t *lock)
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+#define MULTI_HEAP_LOCK(PLOCK) do {                         \
+        if((PLOCK) != NULL) {                               \
+            pthread_mutex_lock((PLOCK));                    \
+        }                                                   \
+    } while(0)
+
+#define MULTI_HEAP_UNLOCK(PLOCK) do {                       \
+        if ((PLOCK) != NULL) {                              \
+            pthread_mutex_unlock((PLOCK));                  \
+        }                                                   \
+    } while(0)
+
+#define MULTI_HEAP_LOCK_INIT(PLOCK)  multi_heap_pthread_lock_init((PLOCK))
+#define MULTI_HEAP_LOCK_STATIC_INITIALIZER  PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP
+
+#else // MULTI_HEAP_PTHREAD
+
+typedef int multi_heap_lock_t;
+
 #define MULTI_HEAP_LOCK(PLOCK)  (void) (PLOCK)
 #define MULTI_HEAP_UNLOCK(PLOCK)  (void) (PLOCK)
 #define MULTI_HEAP_LOCK_INIT(PLOCK)  (void) (PLOCK)
 #define MULTI_HEAP_LOCK_STATIC_INITIALIZER  0
 
+#endif // MULTI_HEAP_PTHREAD
+
+/* Small free blocks are cached per thread, threads are given the cache slots in turn */
+#define MULTI_HEAP_CACHE_SLOTS 4
+
+static inline unsigned multi_heap_cache_slot(void)
+{
+    static unsigned next_slot;
+    static __thread unsigned slot; // 0 until the thread is given a slot
+
+    if (slot == 0) {
+        slot = __atomic_add_fetch(&next_slot, 1, __ATOMIC_RELAXED);
+    }
+    return (slot - 1) % MULTI_HEAP_CACHE_SLOTS;
+}
+
+#define MULTI_HEAP_CACHE_SLOT() multi_heap_cache_slot()
+
 #define MULTI_HEAP_ASSERT(CONDITION, ADDRESS) assert((CONDITION) && "Heap corrupt")
 
 #define MULTI_HEAP_BLOCK_OWNER
@@ -0,0 +1,56 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include "unity.h"
+#include "stdio.h"
+#include "string.h"
+
+#include "esp_heap_caps.h"
+
+// This test only apply when heap profiling is enabled
+#if defined(CONFIG_HEAP_PROFILING)
+
+#include "esp_heap_profile.h"
+
+#define SAMPLE_INTERVAL 512
+#define BLOCK_SIZE 32
+#define BLOCKS 64
+
+static esp_err_t count_lines(void *arg, const char *data, size_t len)
+{
+    TEST_ASSERT_EQUAL('\n', data[len - 1]);
+    (*(int *)arg)++;
+    return ESP_OK;
+}
+
+TEST_CASE("heap profiler samples allocations and their frees", "[heap]")
+{
+    TEST_ASSERT_EQUAL(ESP_OK, heap_profile_start(SAMPLE_INTERVAL));
+
+    void *p[BLOCKS];
+    for (int i = 0; i < BLOCKS; i++) {
+        p[i] = heap_caps_malloc(BLOCK_SIZE, MALLOC_CAP_DEFAULT);
+        TEST_ASSERT_NOT_NULL(p[i]);
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, heap_profile_stop());
+
+    heap_profile_info_t info;
+    heap_profile_get_info(&info);
+    TEST_ASSERT_INT_WITHIN(1, BLOCKS * BLOCK_SIZE / SAMPLE_INTERVAL, info.live_samples);
+    TEST_ASSERT_GREATER_OR_EQUAL(1, info.sites);
+
+    int lines = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, heap_profile_write(count_lines, &lines));
+    TEST_ASSERT_EQUAL(info.sites + 1, lines);
+    TEST_ASSERT_EQUAL(ESP_OK, heap_profile_dump(stdout));
+
+    for (int i = 0; i < BLOCKS; i++) {
+        heap_caps_free(p[i]);
+    }
+    heap_profile_get_info(&info);
+    TEST_ASSERT_EQUAL(0, info.live_samples);
+}
+
+#endif // CONFIG_HEAP_PROFILING
@@ -0,0 +1,159 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include "unity.h"
+#include "stdio.h"
+#include "string.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_heap_caps.h"
+#include "esp_heap_caps_pool.h"
+
+#define POOL_OBJECT_SIZE 22
+#define POOL_OBJECTS 8
+
+TEST_CASE("pool allocates each of its objects once", "[heap][pool]")
+{
+    heap_caps_pool_handle_t pool = heap_caps_pool_create(POOL_OBJECT_SIZE, POOL_OBJECTS, MALLOC_CAP_DEFAULT);
+    TEST_ASSERT_NOT_NULL(pool);
+    const size_t object_size = heap_caps_pool_get_object_size(pool);
+    TEST_ASSERT_GREATER_OR_EQUAL(POOL_OBJECT_SIZE, object_size);
+
+    uint8_t *objects[POOL_OBJECTS];
+    for (int i = 0; i < POOL_OBJECTS; i++) {
+        objects[i] = heap_caps_pool_alloc(pool);
+        TEST_ASSERT_NOT_NULL(objects[i]);
+        memset(objects[i], i, POOL_OBJECT_SIZE);
+    }
+    TEST_ASSERT_NULL(heap_caps_pool_alloc(pool));
+
+    for (int i = 0; i < POOL_OBJECTS; i++) {
+        for (int j = 0; j < POOL_OBJECT_SIZE; j++) {
+            TEST_ASSERT_EQUAL(i, objects[i][j]);
+        }
+    }
+
+    heap_caps_pool_info_t info;
+    heap_caps_pool_get_info(pool, &info);
+    TEST_ASSERT_EQUAL(1, info.pools);
+    TEST_ASSERT_EQUAL(POOL_OBJECTS, info.total_objects);
+    TEST_ASSERT_EQUAL(0, info.free_objects);
+    TEST_ASSERT_EQUAL(POOL_OBJECTS * object_size, info.total_bytes);
+    TEST_ASSERT_EQUAL(0, info.minimum_free_bytes);
+
+    /* objects are reused once freed */
+    heap_caps_pool_free(pool, objects[3]);
+    TEST_ASSERT_EQUAL_PTR(objects[3], heap_caps_pool_alloc(pool));
+
+    for (int i = 0; i < POOL_OBJECTS; i++) {
+        heap_caps_pool_free(pool, objects[i]);
+    }
+    heap_caps_pool_free(pool, NULL);
+    heap_caps_pool_get_info(pool, &info);
+    TEST_ASSERT_EQUAL(POOL_OBJECTS, info.free_objects);
+    TEST_ASSERT_EQUAL(POOL_OBJECTS * object_size, info.free_bytes);
+
+    heap_caps_pool_delete(pool);
+}
+
+TEST_CASE("pools are reported with the caps of their objects", "[heap][pool]")
+{
+    heap_caps_pool_info_t before, after;
+    heap_caps_get_pools_info(&before, MALLOC_CAP_INTERNAL);
+
+    const size_t free_size = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    heap_caps_pool_handle_t pool = heap_caps_pool_create(64, 16, MALLOC_CAP_INTERNAL);
+    TEST_ASSERT_NOT_NULL(pool);
+
+    /* the memory of the objects is allocated from the heap */
+    TEST_ASSERT_LESS_OR_EQUAL(free_size - 64 * 16, heap_caps_get_free_size(MALLOC_CAP_INTERNAL));
+
+    void *p = heap_caps_pool_alloc(pool);
+    heap_caps_get_pools_info(&after, MALLOC_CAP_INTERNAL);
+    TEST_ASSERT_EQUAL(before.pools + 1, after.pools);
+    TEST_ASSERT_EQUAL(before.total_bytes + 64 * 16, after.total_bytes);
+    TEST_ASSERT_EQUAL(before.free_bytes + 64 * 15, after.free_bytes);
+
+    heap_caps_print_heap_info(MALLOC_CAP_INTERNAL);
+
+    heap_caps_pool_free(pool, p);
+    heap_caps_pool_delete(pool);
+    heap_caps_get_pools_info(&after, MALLOC_CAP_INTERNAL);
+    TEST_ASSERT_EQUAL(before.pools, after.pools);
+
+    TEST_ASSERT_NULL(heap_caps_pool_create(0, 16, MALLOC_CAP_INTERNAL));
+    TEST_ASSERT_NULL(heap_caps_pool_create(16, 0, MALLOC_CAP_INTERNAL));
+    TEST_ASSERT_NULL(heap_caps_pool_create(16, HEAP_CAPS_POOL_MAX_OBJECTS + 1, MALLOC_CAP_INTERNAL));
+}
+
+#define POOL_STRESS_TASKS 4
+#define POOL_STRESS_ITERATIONS 10000
+
+typedef struct {
+    heap_caps_pool_handle_t pool;
+    SemaphoreHandle_t done;
+    uint32_t id;
+    bool corrupted;
+} pool_stress_args_t;
+
+static void pool_stress_task(void *arg)
+{
+    pool_stress_args_t *args = (pool_stress_args_t *)arg;
+    uint32_t *objects[4];
+
+    for (int i = 0; i < POOL_STRESS_ITERATIONS; i++) {
+        for (int j = 0; j < 4; j++) {
+            objects[j] = heap_caps_pool_alloc(args->pool);
+            if (objects[j] != NULL) {
+                *objects[j] = args->id;
+            }
+        }
+        for (int j = 0; j < 4; j++) {
+            if (objects[j] != NULL) {
+                /* another task given the same object would have overwritten it */
+                args->corrupted |= *objects[j] != args->id;
+                heap_caps_pool_free(args->pool, objects[j]);
+            }
+        }
+    }
+
+    xSemaphoreGive(args->done);
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("pool objects are allocated and freed concurrently", "[heap][pool]")
+{
+    heap_caps_pool_handle_t pool = heap_caps_pool_create(sizeof(uint32_t), POOL_STRESS_TASKS * 3, MALLOC_CAP_DEFAULT);
+    TEST_ASSERT_NOT_NULL(pool);
+    SemaphoreHandle_t done = xSemaphoreCreateCounting(POOL_STRESS_TASKS, 0);
+    TEST_ASSERT_NOT_NULL(done);
+
+    pool_stress_args_t args[POOL_STRESS_TASKS];
+    for (int i = 0; i < POOL_STRESS_TASKS; i++) {
+        args[i] = (pool_stress_args_t) {
+            .pool = pool,
+            .done = done,
+            .id = i + 1,
+            .corrupted = false,
+        };
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(pool_stress_task, "pool_stress", 2048, &args[i],
+                                                          UNITY_FREERTOS_PRIORITY - 1, NULL, i % portNUM_PROCESSORS));
+    }
+    for (int i = 0; i < POOL_STRESS_TASKS; i++) {
+        TEST_ASSERT_TRUE(xSemaphoreTake(done, portMAX_DELAY));
+    }
+    for (int i = 0; i < POOL_STRESS_TASKS; i++) {
+        TEST_ASSERT_FALSE(args[i].corrupted);
+    }
+
+    heap_caps_pool_info_t info;
+    heap_caps_pool_get_info(pool, &info);
+    TEST_ASSERT_EQUAL(POOL_STRESS_TASKS * 3, info.free_objects);
+
+    vSemaphoreDelete(done);
+    heap_caps_pool_delete(pool);
+}
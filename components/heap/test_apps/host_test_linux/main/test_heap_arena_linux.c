@@ -0,0 +1,129 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <time.h>
+#include "esp_heap_caps.h"
+#include "esp_heap_caps_arena.h"
+#include "unity.h"
+
+#define CHUNK_SIZE 1024
+
+TEST_CASE("Arena APIs", "[heap][arena]")
+{
+    TEST_ASSERT_NULL(heap_caps_arena_create(0, MALLOC_CAP_DEFAULT));
+
+    heap_caps_arena_t *arena = heap_caps_arena_create(CHUNK_SIZE, MALLOC_CAP_DEFAULT);
+    TEST_ASSERT_NOT_NULL(arena);
+    TEST_ASSERT_NULL(heap_caps_arena_alloc(arena, 0));
+
+    uint8_t *p[64];
+    for (int i = 0; i < 64; i++) {
+        p[i] = heap_caps_arena_alloc(arena, i + 1);
+        TEST_ASSERT_NOT_NULL(p[i]);
+        TEST_ASSERT_EQUAL(0, (uintptr_t)p[i] % _Alignof(max_align_t));
+        memset(p[i], i, i + 1);
+    }
+    for (int i = 0; i < 64; i++) {
+        TEST_ASSERT_EACH_EQUAL_HEX8(i, p[i], i + 1);
+    }
+
+    heap_caps_arena_info_t info;
+    heap_caps_arena_get_info(arena, &info);
+    TEST_ASSERT_EQUAL(64 * 65 / 2, info.allocated_bytes);
+    TEST_ASSERT_EQUAL(info.allocated_bytes, info.peak_allocated_bytes);
+    TEST_ASSERT_GREATER_THAN(1, info.chunks);
+    TEST_ASSERT_EQUAL(info.chunks * CHUNK_SIZE, info.chunk_bytes);
+
+    /* an allocation larger than a chunk gets a chunk of its own */
+    uint8_t *large = heap_caps_arena_alloc(arena, 4 * CHUNK_SIZE);
+    TEST_ASSERT_NOT_NULL(large);
+    memset(large, 0xAB, 4 * CHUNK_SIZE);
+    heap_caps_arena_get_info(arena, &info);
+    const size_t chunks = info.chunks - 1;
+    TEST_ASSERT_GREATER_THAN(chunks * CHUNK_SIZE + 4 * CHUNK_SIZE, info.peak_chunk_bytes);
+
+    /* reset keeps the chunks of the arena and frees the larger one */
+    heap_caps_arena_reset(arena);
+    heap_caps_arena_get_info(arena, &info);
+    TEST_ASSERT_EQUAL(0, info.allocated_bytes);
+    TEST_ASSERT_EQUAL(64 * 65 / 2 + 4 * CHUNK_SIZE, info.peak_allocated_bytes);
+    TEST_ASSERT_EQUAL(chunks, info.chunks);
+    TEST_ASSERT_EQUAL(chunks * CHUNK_SIZE, info.chunk_bytes);
+
+    for (int i = 0; i < 64; i++) {
+        TEST_ASSERT_NOT_NULL(heap_caps_arena_alloc(arena, i + 1));
+    }
+    heap_caps_arena_get_info(arena, &info);
+    TEST_ASSERT_EQUAL(chunks, info.chunks);
+
+    heap_caps_arena_destroy(arena);
+    heap_caps_arena_destroy(NULL);
+}
+
+#define BENCHMARK_REQUESTS 20000
+#define BENCHMARK_ALLOCS_PER_REQUEST 48
+
+static uint64_t time_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* Sizes of the allocations of a request: mostly small strings and structures, a few buffers */
+static size_t request_alloc_size(uint32_t *seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    const uint32_t r = *seed >> 16;
+    return (r % 8 == 0) ? 256 + r % 768 : 8 + r % 120;
+}
+
+TEST_CASE("Arena benchmark against malloc for request-shaped workloads", "[heap][arena][benchmark]")
+{
+    void *p[BENCHMARK_ALLOCS_PER_REQUEST];
+    uint32_t seed = 1;
+    uint64_t start = time_ns();
+    for (int i = 0; i < BENCHMARK_REQUESTS; i++) {
+        for (int j = 0; j < BENCHMARK_ALLOCS_PER_REQUEST; j++) {
+            const size_t size = request_alloc_size(&seed);
+            p[j] = heap_caps_malloc(size, MALLOC_CAP_DEFAULT);
+            TEST_ASSERT_NOT_NULL(p[j]);
+            memset(p[j], j, size);
+        }
+        for (int j = 0; j < BENCHMARK_ALLOCS_PER_REQUEST; j++) {
+            heap_caps_free(p[j]);
+        }
+    }
+    const uint64_t malloc_ns = time_ns() - start;
+
+    heap_caps_arena_t *arena = heap_caps_arena_create(4096, MALLOC_CAP_DEFAULT);
+    TEST_ASSERT_NOT_NULL(arena);
+    seed = 1;
+    start = time_ns();
+    for (int i = 0; i < BENCHMARK_REQUESTS; i++) {
+        for (int j = 0; j < BENCHMARK_ALLOCS_PER_REQUEST; j++) {
+            const size_t size = request_alloc_size(&seed);
+            p[j] = heap_caps_arena_alloc(arena, size);
+            TEST_ASSERT_NOT_NULL(p[j]);
+            memset(p[j], j, size);
+        }
+        heap_caps_arena_reset(arena);
+    }
+    const uint64_t arena_ns = time_ns() - start;
+
+    heap_caps_arena_info_t info;
+    heap_caps_arena_get_info(arena, &info);
+    heap_caps_arena_destroy(arena);
+
+    printf("%d requests of %d allocations: malloc/free %" PRIu64 " ns/request, arena %" PRIu64 " ns/request\n",
+           BENCHMARK_REQUESTS, BENCHMARK_ALLOCS_PER_REQUEST,
+           malloc_ns / BENCHMARK_REQUESTS, arena_ns / BENCHMARK_REQUESTS);
+    printf("arena peak: %zu bytes allocated, %zu bytes in chunks\n", info.peak_allocated_bytes, info.peak_chunk_bytes);
+}
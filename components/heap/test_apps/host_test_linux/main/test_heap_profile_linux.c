@@ -0,0 +1,98 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sdkconfig.h"
+#include "esp_heap_caps.h"
+#include "unity.h"
+
+#ifdef CONFIG_HEAP_PROFILING
+
+#include "esp_heap_profile.h"
+
+#define SAMPLE_INTERVAL 1024
+#define BLOCK_SIZE 64
+#define BLOCKS 200
+
+static __attribute__((noinline)) void *alloc_kept(void)
+{
+    return heap_caps_malloc(BLOCK_SIZE, MALLOC_CAP_DEFAULT);
+}
+
+static __attribute__((noinline)) void alloc_freed(void)
+{
+    void *p = heap_caps_malloc(BLOCK_SIZE, MALLOC_CAP_DEFAULT);
+    TEST_ASSERT_NOT_NULL(p);
+    heap_caps_free(p);
+}
+
+TEST_CASE("Profile APIs", "[heap][profile]")
+{
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, heap_profile_start(0));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, heap_profile_stop());
+    TEST_ASSERT_EQUAL(ESP_OK, heap_profile_start(SAMPLE_INTERVAL));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, heap_profile_start(SAMPLE_INTERVAL));
+
+    void *kept[BLOCKS];
+    for (int i = 0; i < BLOCKS; i++) {
+        kept[i] = alloc_kept();
+        TEST_ASSERT_NOT_NULL(kept[i]);
+    }
+    for (int i = 0; i < BLOCKS; i++) {
+        alloc_freed();
+    }
+
+    heap_profile_info_t info;
+    heap_profile_get_info(&info);
+    TEST_ASSERT_EQUAL(SAMPLE_INTERVAL, info.sample_interval);
+    TEST_ASSERT_EQUAL(0, info.dropped_samples);
+    /* one sample every 16 blocks, the samples of the freed blocks are forgotten */
+    TEST_ASSERT_INT_WITHIN(2, BLOCKS * BLOCK_SIZE / SAMPLE_INTERVAL, info.live_samples);
+    TEST_ASSERT_EQUAL(2, info.sites);
+
+    FILE *f = tmpfile();
+    TEST_ASSERT_NOT_NULL(f);
+    TEST_ASSERT_EQUAL(ESP_OK, heap_profile_dump(f));
+    rewind(f);
+
+    /* the live bytes estimate the bytes kept, the allocated bytes all the bytes allocated */
+    unsigned live_samples, live_bytes, alloc_samples, alloc_bytes;
+    TEST_ASSERT_EQUAL(4, fscanf(f, "heap profile: %u: %u [%u: %u] @ heapprofile\n",
+                                &live_samples, &live_bytes, &alloc_samples, &alloc_bytes));
+    TEST_ASSERT_EQUAL(info.live_samples, live_samples);
+    TEST_ASSERT_UINT_WITHIN(2 * SAMPLE_INTERVAL, BLOCKS * BLOCK_SIZE, live_bytes);
+    TEST_ASSERT_UINT_WITHIN(SAMPLE_INTERVAL, 2 * BLOCKS * BLOCK_SIZE, alloc_bytes);
+
+    char line[256];
+    int sites = 0;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        TEST_ASSERT_NOT_NULL(strstr(line, "] @ 0x"));
+        sites++;
+    }
+    TEST_ASSERT_EQUAL(info.sites, sites);
+    fclose(f);
+
+    /* a failed realloc leaves the block in place, with its sample */
+    for (int i = 0; i < BLOCKS; i++) {
+        TEST_ASSERT_NULL(heap_caps_realloc(kept[i], SIZE_MAX / 2, MALLOC_CAP_DEFAULT));
+    }
+    heap_profile_info_t after;
+    heap_profile_get_info(&after);
+    TEST_ASSERT_EQUAL(info.live_samples, after.live_samples);
+
+    /* frees are still recorded once stopped */
+    TEST_ASSERT_EQUAL(ESP_OK, heap_profile_stop());
+    for (int i = 0; i < BLOCKS; i++) {
+        heap_caps_free(kept[i]);
+    }
+    heap_profile_get_info(&info);
+    TEST_ASSERT_EQUAL(0, info.sample_interval);
+    TEST_ASSERT_EQUAL(0, info.live_samples);
+}
+
+#endif // CONFIG_HEAP_PROFILING
@@ -10,6 +10,11 @@ for FLAGS in "CONFIG_HEAP_POISONING_NONE" "CONFIG_HEAP_POISONING_LIGHT" "CONFIG_
     CPPFLAGS="-D${FLAGS}" make clean test || FAIL=1
 done
 
+# The cache of small blocks changes the layout of the heap structure, only run its own tests
+echo "==== Testing with config: CONFIG_HEAP_CACHE ===="
+CPPFLAGS="-DCONFIG_HEAP_CACHE" make clean all || FAIL=1
+./test_multi_heap "[cache]" || FAIL=1
+
 make clean
 
 if [ $FAIL == 0 ]; then
@@ -8,12 +8,17 @@
 #include "multi_heap.h"
 
 #include "../multi_heap_config.h"
+#include "../multi_heap_platform.h"
 #include "../tlsf/include/tlsf.h"
 #include "../tlsf/tlsf_block_functions.h"
 #include "../tlsf/tlsf_control_functions.h"
 
 #include <string.h>
 #include <assert.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
 
 /* The functions __malloc__ and __free__ are used to call the libc
  * malloc and free and allocate memory from the host heap. Since the test
@@ -621,3 +626,144 @@ TEST_CASE("multi_heap poisoning detection", "[multi_heap]")
         REQUIRE(is_heap_ok == true);
     }
 }
+
+TEST_CASE("multi_heap cache of small blocks", "[multi_heap][cache]")
+{
+    const size_t HEAP_SIZE = 16 * 1024;
+    uint8_t *heap_mem = (uint8_t *)__malloc__(HEAP_SIZE);
+    multi_heap_handle_t heap = multi_heap_register(heap_mem, HEAP_SIZE);
+    const size_t max_cached_bytes = 512;
+
+#ifdef MULTI_HEAP_CACHE
+    REQUIRE( multi_heap_cache_enable(heap, max_cached_bytes) );
+
+    const size_t free_size = multi_heap_free_size(heap);
+    multi_heap_info_t info;
+    multi_heap_get_info(heap, &info);
+    const size_t largest_free_block = info.largest_free_block;
+
+    /* a freed block is reused for the next allocation of the same size class */
+    void *p = multi_heap_malloc(heap, 40);
+    REQUIRE( p != NULL );
+    multi_heap_free(heap, p);
+    REQUIRE( multi_heap_free_size(heap) < free_size );
+    REQUIRE( multi_heap_malloc(heap, 33) == p );
+    REQUIRE( multi_heap_get_allocated_size(heap, p) >= 40 );
+    multi_heap_free(heap, p);
+
+    /* blocks over 256 bytes are never cached */
+    p = multi_heap_malloc(heap, 300);
+    REQUIRE( p != NULL );
+    const size_t free_size_cached = multi_heap_free_size(heap);
+    multi_heap_free(heap, p);
+    REQUIRE( multi_heap_free_size(heap) > free_size_cached );
+
+    /* the cache holds no more than max_cached_bytes */
+    void *blocks[32];
+    for (int i = 0; i < 32; i++) {
+        blocks[i] = multi_heap_malloc(heap, 64);
+        REQUIRE( blocks[i] != NULL );
+    }
+    for (int i = 0; i < 32; i++) {
+        multi_heap_free(heap, blocks[i]);
+    }
+    size_t flushed = multi_heap_cache_flush(heap);
+    REQUIRE( flushed > 0 );
+    REQUIRE( flushed <= max_cached_bytes );
+    REQUIRE( multi_heap_free_size(heap) == free_size );
+    REQUIRE( multi_heap_cache_flush(heap) == 0 );
+    REQUIRE( multi_heap_check(heap, true) );
+
+    /* cached blocks are flushed when an allocation fails without them */
+    for (int i = 0; i < 8; i++) {
+        blocks[i] = multi_heap_malloc(heap, 64);
+        REQUIRE( blocks[i] != NULL );
+    }
+    for (int i = 0; i < 8; i++) {
+        multi_heap_free(heap, blocks[i]);
+    }
+    p = multi_heap_malloc(heap, largest_free_block);
+    REQUIRE( p != NULL );
+    REQUIRE( multi_heap_cache_flush(heap) == 0 );
+    multi_heap_free(heap, p);
+    REQUIRE( multi_heap_free_size(heap) == free_size );
+#else
+    /* the cache is not available with heap poisoning */
+    REQUIRE( multi_heap_cache_enable(heap, max_cached_bytes) == false );
+    REQUIRE( multi_heap_cache_flush(heap) == 0 );
+#endif
+
+    __free__(heap_mem);
+}
+
+/* Allocate and free small blocks of various sizes from several threads at once,
+ * and return the number of allocations and frees per second */
+static double multi_heap_benchmark_threads(multi_heap_handle_t heap, size_t thread_count, std::atomic<size_t> &failures)
+{
+    const size_t ITERATIONS = 10000;
+    const size_t BLOCKS = 16;
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < thread_count; t++) {
+        threads.emplace_back([heap, &failures]() {
+            void *blocks[BLOCKS];
+            for (size_t i = 0; i < ITERATIONS; i++) {
+                for (size_t j = 0; j < BLOCKS; j++) {
+                    blocks[j] = multi_heap_malloc(heap, 8 + ((i + j) * 24) % 248);
+                    if (blocks[j] == NULL) {
+                        failures++;
+                    }
+                }
+                for (size_t j = 0; j < BLOCKS; j++) {
+                    multi_heap_free(heap, blocks[j]);
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return (thread_count * ITERATIONS * BLOCKS * 2) / elapsed.count();
+}
+
+TEST_CASE("multi_heap cache alloc/free throughput", "[multi_heap][cache][benchmark]")
+{
+    const size_t HEAP_SIZE = 64 * 1024;
+    const size_t thread_counts[] = { 1, 2, 4 };
+
+    for (size_t i = 0; i < sizeof(thread_counts) / sizeof(thread_counts[0]); i++) {
+        double ops_per_second[2] = { 0 };
+
+        for (int cached = 0; cached < 2; cached++) {
+            uint8_t *heap_mem = (uint8_t *)__malloc__(HEAP_SIZE);
+            multi_heap_handle_t heap = multi_heap_register(heap_mem, HEAP_SIZE);
+            multi_heap_lock_t lock;
+            MULTI_HEAP_LOCK_INIT(&lock);
+            multi_heap_set_lock(heap, &lock);
+            if (cached && !multi_heap_cache_enable(heap, 4096)) {
+                /* the cache is not available with heap poisoning */
+                __free__(heap_mem);
+                continue;
+            }
+            const size_t free_size = multi_heap_free_size(heap);
+
+            std::atomic<size_t> failures(0);
+            ops_per_second[cached] = multi_heap_benchmark_threads(heap, thread_counts[i], failures);
+            REQUIRE( failures == 0 );
+
+            multi_heap_cache_flush(heap);
+            REQUIRE( multi_heap_check(heap, true) );
+            REQUIRE( multi_heap_free_size(heap) == free_size );
+            __free__(heap_mem);
+        }
+
+        printf("%zu thread(s): %.2f Mops/s without cache", thread_counts[i], ops_per_second[0] / 1e6);
+        if (ops_per_second[1] > 0) {
+            printf(", %.2f Mops/s with cache", ops_per_second[1] / 1e6);
+        }
+        printf("\n");
+    }
+}
@@ -0,0 +1,44 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Function writing the binary log records
+ *
+ * @param data The record, including its framing
+ * @param len  Length of the record in bytes
+ *
+ * @return Number of bytes written (not used by the log library)
+ */
+typedef int (*esp_log_binary_writer_t)(const void *data, size_t len);
+
+/**
+ * @brief Set the function used to output binary log records
+ *
+ * With CONFIG_LOG_BINARY enabled, the log messages are output as binary records, by default to stdout.
+ * This function can be used to send them to another destination, such as a file or the network.
+ * Each record is passed in a single call. The messages which are still output as text go to the
+ * function set by esp_log_set_vprintf().
+ *
+ * @note The function must be re-entrant as it can be called in parallel from multiple tasks.
+ * @note Only available with CONFIG_LOG_BINARY enabled.
+ *
+ * @param writer New function used to output the binary records
+ *
+ * @return The previous function
+ */
+esp_log_binary_writer_t esp_log_binary_set_writer(esp_log_binary_writer_t writer);
+
+#ifdef __cplusplus
+}
+#endif
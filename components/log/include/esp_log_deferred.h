@@ -0,0 +1,48 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Get the number of log messages dropped by deferred logging
+ *
+ * With CONFIG_LOG_DEFERRED enabled, a message is dropped when the buffer of the core it is logged from
+ * is full, i.e. when messages are logged faster than the writer task prints them. The writer task
+ * also reports the dropped messages in the log output.
+ *
+ * @note Only available with CONFIG_LOG_DEFERRED enabled.
+ *
+ * @return Number of messages dropped since startup
+ */
+uint32_t esp_log_deferred_get_dropped(void);
+
+/**
+ * @brief Wait until the deferred log messages are printed
+ *
+ * Waits until the writer task has printed all the messages recorded before and during the call.
+ * This is useful before entering deep sleep or restarting, so that the last messages are not lost.
+ * This function must not be called from an ISR or from the function set by esp_log_set_vprintf().
+ *
+ * @note Only available with CONFIG_LOG_DEFERRED enabled.
+ *
+ * @param timeout_ms Maximum time to wait, in milliseconds
+ *
+ * @return
+ *  - ESP_OK if all the messages are printed
+ *  - ESP_ERR_TIMEOUT if messages are still waiting to be printed after timeout_ms
+ */
+esp_err_t esp_log_deferred_flush(uint32_t timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,70 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdarg.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Type of the argument of a conversion specification, after the default argument promotions.
+ */
+typedef enum {
+    ESP_LOG_ARG_NONE,           /*!< "%%", no argument */
+    ESP_LOG_ARG_INT,            /*!< int, also for "%c" and the '*' width and precision */
+    ESP_LOG_ARG_LONG,           /*!< long */
+    ESP_LOG_ARG_LONG_LONG,      /*!< long long */
+    ESP_LOG_ARG_INTMAX,         /*!< intmax_t */
+    ESP_LOG_ARG_SIZE,           /*!< size_t */
+    ESP_LOG_ARG_PTRDIFF,        /*!< ptrdiff_t */
+    ESP_LOG_ARG_DOUBLE,         /*!< double */
+    ESP_LOG_ARG_PTR,            /*!< void * */
+    ESP_LOG_ARG_STR,            /*!< const char *, packed as a NUL terminated copy of the string */
+    ESP_LOG_ARG_UNSUPPORTED,    /*!< The argument can not be packed (e.g. "%n", "%Lf", "%ls") */
+} esp_log_arg_type_t;
+
+#define ESP_LOG_ARG_PRECISION_NONE  (-1)    /*!< The conversion specification has no precision */
+#define ESP_LOG_ARG_PRECISION_STAR  (-2)    /*!< The precision is given by the last '*' argument */
+
+/**
+ * @brief Parses the conversion specification following a '%' in a format string.
+ *
+ * @param spec      Pointer to the character following the '%'.
+ * @param type      Type of the argument of the conversion.
+ * @param stars     Number of '*' in the specification, each of them takes an int argument before the argument of the conversion.
+ * @param precision Precision of the specification, ESP_LOG_ARG_PRECISION_NONE or ESP_LOG_ARG_PRECISION_STAR.
+ *
+ * @return Pointer to the character following the conversion specification.
+ */
+const char *esp_log_args_parse_conversion(const char *spec, esp_log_arg_type_t *type, int *stars, int *precision);
+
+/**
+ * @brief Packs the arguments of a format string.
+ *
+ * The arguments are packed in the order of the format string, without padding, each with the size of its
+ * type after the default argument promotions. Strings are copied up to their NUL terminator or the precision
+ * of the conversion, followed by a NUL terminator, and NULL pointers are packed as "(null)".
+ *
+ * @param format      The format string.
+ * @param args        The arguments of the format string.
+ * @param max_str_len Maximum length of a string argument.
+ * @param dest        Where to pack the arguments, or NULL to only compute their size.
+ * @param size        Size of the packed arguments.
+ *
+ * @return false if the format string has a conversion which can not be packed, or a string argument is
+ *         longer than max_str_len (after applying the precision).
+ */
+bool esp_log_args_pack(const char *format, va_list args, size_t max_str_len, uint8_t *dest, size_t *size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,37 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include "esp_log_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Outputs a log message as a binary record.
+ *
+ * @note Must not be called from a constrained environment (ISR, cache disabled, startup code).
+ *
+ * @param config    The config log
+ * @param tag       The tag of the message, or NULL.
+ * @param timestamp The timestamp of the message, recorded if formatting is required.
+ * @param format    The format string of the message.
+ * @param args      The arguments of the message. They are not consumed if false is returned.
+ *
+ * @return true if the record is output, false if the message must be output as text
+ *         (unsupported conversion in the format string, string argument longer than
+ *         CONFIG_LOG_BINARY_MAX_STRING_LEN or record too large).
+ */
+bool esp_log_binary_write(esp_log_config_t config, const char *tag, uint64_t timestamp, const char *format, va_list args);
+
+#ifdef __cplusplus
+}
+#endif
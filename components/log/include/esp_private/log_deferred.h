@@ -0,0 +1,48 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include "esp_log_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Records a log message to be printed later by the writer task.
+ *
+ * The format string and tag pointers, the timestamp and the arguments are recorded into the buffer
+ * of the current core. If the buffer is full, the message is dropped and counted.
+ *
+ * @note Must not be called from a constrained environment (ISR, cache disabled, scheduler not started).
+ *
+ * @param config    The config log
+ * @param tag       The tag of the message, or NULL.
+ * @param timestamp The timestamp of the message, used if formatting is required.
+ * @param format    The format string of the message.
+ * @param args      The arguments of the message. They are not consumed if false is returned.
+ *
+ * @return true if the message is recorded or dropped, false if it must be printed immediately
+ *         (unsupported conversion in the format string, string argument longer than
+ *         CONFIG_LOG_DEFERRED_MAX_STRING_LEN or message too large for the buffer).
+ */
+bool esp_log_deferred_write(esp_log_config_t config, const char *tag, uint64_t timestamp, const char *format, va_list args);
+
+/**
+ * @brief Prints the recorded log messages from the panic handler.
+ *
+ * The messages are printed with esp_rom_vprintf, without taking any lock or waking the writer task.
+ * The function and the format strings are in flash, it must only be called while the flash cache works.
+ */
+void esp_log_deferred_panic_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
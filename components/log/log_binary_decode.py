@@ -0,0 +1,275 @@
+#!/usr/bin/env python
+# SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+# SPDX-License-Identifier: Apache-2.0
+#
+# Decodes the binary log records output by applications built with CONFIG_LOG_BINARY.
+#
+# The format strings and tags are read from the ELF file of the application, the text output
+# around the records (bootloader, printf, logs from ISRs) is passed through unchanged.
+# The record format is described in components/log/src/os/log_binary.c.
+import argparse
+import codecs
+import datetime
+import re
+import struct
+import sys
+from typing import BinaryIO
+from typing import Callable
+from typing import Dict
+from typing import List
+from typing import Optional
+from typing import Tuple
+from typing import Union
+
+SYNC = 0xFF
+ESCAPE = 0xFE
+ESCAPE_XOR = 0x20
+
+CONFIG_LEVEL_MASK = 0x07
+CONFIG_REQUIRE_FORMATTING = 1 << 4
+CONFIG_DIS_TIMESTAMP = 1 << 6
+
+LEVEL_NAMES = ['', 'E', 'W', 'I', 'D', 'V', '', '']
+
+# Same parsing as esp_log_args_parse_conversion(): flags, width, precision, length, conversion
+CONVERSION_RE = re.compile(r'%([-+ #0]*)(\*|[0-9]*)(?:\.(\*|[0-9]*))?(hh|h|ll|l|j|z|t|L)?(.?)', re.DOTALL)
+
+# Size in bytes of the integer arguments on the chip (ILP32), by length modifier
+INT_SIZES = {None: 4, 'hh': 4, 'h': 4, 'l': 4, 'll': 8, 'j': 8, 'z': 4, 't': 4}
+# Width of the value printed, by length modifier
+INT_BITS = {None: 32, 'hh': 8, 'h': 16, 'l': 32, 'll': 64, 'j': 64, 'z': 32, 't': 32}
+
+
+class LogBinaryDecodeError(RuntimeError):
+    pass
+
+
+class ElfStrings(object):
+    """Reads NUL terminated strings from the loadable sections of an ELF file."""
+
+    def __init__(self, elf_path: str) -> None:
+        from elftools.elf.constants import SH_FLAGS
+        from elftools.elf.elffile import ELFFile
+
+        self.sections = []  # type: List[Tuple[int, bytes]]
+        self.cache = {}  # type: Dict[int, Optional[str]]
+        with open(elf_path, 'rb') as f:
+            elf = ELFFile(f)
+            for section in elf.iter_sections():
+                if section['sh_addr'] == 0 or not section['sh_flags'] & SH_FLAGS.SHF_ALLOC:
+                    continue
+                if section['sh_type'] == 'SHT_NOBITS':
+                    continue
+                self.sections.append((section['sh_addr'], section.data()))
+
+    def __call__(self, addr: int) -> Optional[str]:
+        if addr not in self.cache:
+            self.cache[addr] = None
+            for start, data in self.sections:
+                if start <= addr < start + len(data):
+                    end = data.find(b'\0', addr - start)
+                    end = len(data) if end < 0 else end
+                    self.cache[addr] = data[addr - start:end].decode('utf-8', errors='replace')
+                    break
+        return self.cache[addr]
+
+
+def format_timestamp(timestamp_ms: int, timestamp_format: str) -> str:
+    if timestamp_format == 'ms':
+        return str(timestamp_ms)
+    time = datetime.datetime.fromtimestamp(timestamp_ms // 1000, datetime.timezone.utc)
+    text = '%02d:%02d:%02d.%03d' % (time.hour, time.minute, time.second, timestamp_ms % 1000)
+    if timestamp_format == 'system_full':
+        text = '%02d-%02d-%02d %s' % (time.year % 100, time.month, time.day, text)
+    return text
+
+
+def format_message(fmt: str, args: bytes) -> str:
+    """Formats the message like printf on the chip, taking the arguments from the packed bytes."""
+    out = []
+    pos = 0
+    offset = 0
+
+    def take_value(struct_fmt: str) -> Union[int, float]:
+        nonlocal offset
+        size = struct.calcsize(struct_fmt)
+        if offset + size > len(args):
+            raise LogBinaryDecodeError('not enough arguments for "%s"' % fmt)
+        value: Union[int, float] = struct.unpack_from(struct_fmt, args, offset)[0]
+        offset += size
+        return value
+
+    def take(struct_fmt: str) -> int:
+        return int(take_value(struct_fmt))
+
+    def take_str() -> str:
+        nonlocal offset
+        end = args.find(b'\0', offset)
+        if end < 0:
+            raise LogBinaryDecodeError('unterminated string argument for "%s"' % fmt)
+        value = args[offset:end].decode('utf-8', errors='replace')
+        offset = end + 1
+        return value
+
+    while True:
+        percent = fmt.find('%', pos)
+        if percent < 0:
+            out.append(fmt[pos:])
+            break
+        out.append(fmt[pos:percent])
+        match = CONVERSION_RE.match(fmt, percent)
+        assert match  # the regular expression matches any '%'
+        flags, width, precision, length, conversion = match.groups()
+        pos = match.end()
+        if width == '*':
+            width = str(take('<i'))
+        if precision == '*':
+            value = take('<i')
+            precision = str(value) if value >= 0 else None  # a negative precision is taken as if it was omitted
+        spec = '%' + flags + width + ('.' + precision if precision is not None else '')
+        if conversion == '%':
+            out.append('%')
+            continue
+        if not conversion or length == 'L':
+            raise LogBinaryDecodeError('unsupported conversion "%s" in "%s"' % (match.group(0), fmt))
+
+        if conversion in 'diouxX':
+            bits = INT_BITS[length]
+            value = take('<Q' if INT_SIZES[length] == 8 else '<I') & ((1 << bits) - 1)
+            if conversion in 'di' and value >= 1 << (bits - 1):
+                value -= 1 << bits
+            python_conversion = 'd' if conversion in 'iu' else conversion
+            if '#' in flags and (conversion == 'o' or value == 0):
+                # Python prints '0o' for octal and a prefix for 0, unlike printf
+                spec = spec.replace('#', '')
+                if conversion == 'o' and value != 0:
+                    out.append((spec + 's') % ('0%o' % value))
+                    continue
+            out.append((spec + python_conversion) % value)
+        elif conversion == 'c' and length is None:
+            out.append((spec + 'c') % (take('<i') & 0xFF))
+        elif conversion in 'eEfFgG' and length in (None, 'l'):
+            out.append((spec + conversion) % take_value('<d'))
+        elif conversion in 'aA' and length in (None, 'l'):
+            hex_value = float.hex(take_value('<d'))
+            out.append((spec.replace('#', '').replace('0', '') + 's') % (hex_value.upper() if conversion == 'A' else hex_value))
+        elif conversion == 's' and length is None:
+            out.append((spec + 's') % take_str())
+        elif conversion == 'p' and length is None:
+            out.append((spec + 's') % ('0x%x' % take('<I')))
+        else:
+            raise LogBinaryDecodeError('unsupported conversion "%s" in "%s"' % (match.group(0), fmt))
+    return ''.join(out)
+
+
+class LogBinaryDecoder(object):
+    """Splits the console output into text and binary records, and decodes the records."""
+
+    def __init__(self, strings: Callable[[int], Optional[str]], timestamp_format: str = 'ms') -> None:
+        self.strings = strings
+        self.timestamp_format = timestamp_format
+        self.text_decoder = codecs.getincrementaldecoder('utf-8')(errors='replace')
+        self.frame = None  # type: Optional[bytearray]
+        self.escaped = False
+
+    def feed(self, data: bytes) -> str:
+        """Returns the text output and the decoded records found in data."""
+        out = []
+        text_start = 0
+        for i, byte in enumerate(data):
+            if byte == SYNC:
+                if self.frame is None:
+                    out.append(self.text_decoder.decode(data[text_start:i]))
+                else:
+                    out.append('<truncated binary log record>\n')
+                self.frame = bytearray()
+                self.escaped = False
+                continue
+            if self.frame is None:
+                continue
+            if byte == ESCAPE:
+                self.escaped = True
+                continue
+            if self.escaped:
+                byte ^= ESCAPE_XOR
+                self.escaped = False
+            self.frame.append(byte)
+            if len(self.frame) == self.frame[0] + 1:
+                out.append(self.decode_record(bytes(self.frame[1:])))
+                self.frame = None
+                text_start = i + 1
+        if self.frame is None:
+            out.append(self.text_decoder.decode(data[text_start:]))
+        return ''.join(out)
+
+    def decode_record(self, payload: bytes) -> str:
+        try:
+            config, fmt_addr, tag_addr = struct.unpack_from('<BII', payload)
+            offset = 9
+            timestamp = None
+            if config & CONFIG_REQUIRE_FORMATTING and not config & CONFIG_DIS_TIMESTAMP:
+                timestamp, shift = 0, 0
+                while True:
+                    byte = payload[offset]
+                    offset += 1
+                    timestamp |= (byte & 0x7F) << shift
+                    shift += 7
+                    if not byte & 0x80:
+                        break
+            fmt = self.strings(fmt_addr)
+            if fmt is None:
+                raise LogBinaryDecodeError('format string 0x%08x not found in the ELF file' % fmt_addr)
+            message = format_message(fmt, payload[offset:])
+        except (LogBinaryDecodeError, IndexError, struct.error) as e:
+            return '<binary log record: %s>\n' % e
+
+        if not config & CONFIG_REQUIRE_FORMATTING:
+            return message
+        tag = None
+        if tag_addr != 0:
+            tag = self.strings(tag_addr)
+            if tag is None:
+                tag = '0x%08x' % tag_addr
+        return '%s %s%s%s\n' % (LEVEL_NAMES[config & CONFIG_LEVEL_MASK],
+                                '(%s) ' % format_timestamp(timestamp, self.timestamp_format) if timestamp is not None else '',
+                                tag + ': ' if tag is not None else '',
+                                message)
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(description='Decode the binary log output of an ESP-IDF application (CONFIG_LOG_BINARY)')
+    parser.add_argument('elf_file', help='ELF file of the application')
+    parser.add_argument('input', nargs='?', default='-', help='Captured console output, "-" for stdin (default)')
+    parser.add_argument('--port', '-p', help='Read the console output from this serial port instead of input')
+    parser.add_argument('--baud', '-b', type=int, default=115200, help='Baud rate of the serial port (default: 115200)')
+    parser.add_argument('--timestamp', choices=['ms', 'system', 'system_full'], default='ms',
+                        help='How to print the timestamps, according to CONFIG_LOG_TIMESTAMP_SOURCE (default: ms)')
+    args = parser.parse_args()
+
+    decoder = LogBinaryDecoder(ElfStrings(args.elf_file), args.timestamp)
+    if args.port:
+        import serial
+        stream = serial.Serial(args.port, args.baud, timeout=0.1)  # type: BinaryIO
+    elif args.input == '-':
+        stream = sys.stdin.buffer
+    else:
+        stream = open(args.input, 'rb')
+
+    try:
+        while True:
+            # read1() returns the bytes available without waiting for more
+            data = stream.read1(4096) if hasattr(stream, 'read1') else stream.read(4096)
+            if not data:
+                if args.port:
+                    continue
+                break
+            sys.stdout.write(decoder.feed(data))
+            sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        stream.close()
+
+
+if __name__ == '__main__':
+    main()
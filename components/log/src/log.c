@@ -16,6 +16,12 @@
 #include "esp_private/log_lock.h"
 #include "esp_private/log_util.h"
 #include "esp_private/log_print.h"
+#if CONFIG_LOG_DEFERRED && !NON_OS_BUILD
+#include "esp_private/log_deferred.h"
+#endif
+#if CONFIG_LOG_BINARY && !NON_OS_BUILD
+#include "esp_private/log_binary.h"
+#endif
 #include "sdkconfig.h"
 
 static __attribute__((unused)) const char s_lvl_name[ESP_LOG_MAX] = {
@@ -53,6 +59,11 @@ void __attribute__((optimize("-O3"))) esp_log_va(esp_log_config_t config, const
 {
 #if ESP_LOG_VERSION == 1
     if (config.opts.log_level != ESP_LOG_NONE && esp_log_is_tag_loggable(config.opts.log_level, tag)) {
+#if CONFIG_LOG_DEFERRED && !NON_OS_BUILD
+        if (!esp_log_util_is_constrained() && esp_log_deferred_write(config, tag, 0, format, args)) {
+            return;
+        }
+#endif
         extern vprintf_like_t esp_log_vprint_func;
         esp_log_vprint_func(format, args);
     }
@@ -68,6 +79,16 @@ void __attribute__((optimize("-O3"))) esp_log_va(esp_log_config_t config, const
         if (!config.opts.constrained_env && tag != NULL && !esp_log_is_tag_loggable(config.opts.log_level, tag)) {
             return;
         }
+#endif
+#if CONFIG_LOG_DEFERRED && !NON_OS_BUILD
+        if (!config.opts.constrained_env && esp_log_deferred_write(config, tag, timestamp, format, args)) {
+            return;
+        }
+#endif
+#if CONFIG_LOG_BINARY && !NON_OS_BUILD
+        if (!config.opts.constrained_env && esp_log_binary_write(config, tag, timestamp, format, args)) {
+            return;
+        }
 #endif
         // formatting log
         if (config.opts.require_formatting) { // 1. print "<color_start><level_name> <(time)> <tag>: "
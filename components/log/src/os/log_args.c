@@ -0,0 +1,191 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
+#include <string.h>
+#include "esp_private/log_args.h"
+
+const char *esp_log_args_parse_conversion(const char *spec, esp_log_arg_type_t *type, int *stars, int *precision)
+{
+    *stars = 0;
+    *precision = ESP_LOG_ARG_PRECISION_NONE;
+    while (*spec != '\0' && strchr("-+ #0", *spec) != NULL) {
+        spec++;
+    }
+    for (int i = 0; i < 2; i++) { // width, then precision
+        if (i == 1) {
+            if (*spec != '.') {
+                break;
+            }
+            spec++;
+            *precision = 0;
+        }
+        if (*spec == '*') {
+            (*stars)++;
+            spec++;
+            if (i == 1) {
+                *precision = ESP_LOG_ARG_PRECISION_STAR;
+            }
+        } else {
+            while (*spec >= '0' && *spec <= '9') {
+                if (i == 1 && *precision < INT_MAX / 10 - 9) {
+                    *precision = *precision * 10 + (*spec - '0');
+                }
+                spec++;
+            }
+        }
+    }
+
+    char length = '\0';
+    esp_log_arg_type_t int_type = ESP_LOG_ARG_INT;
+    switch (*spec) {
+    case 'h':
+        length = *spec++;
+        if (*spec == 'h') {
+            spec++;
+        }
+        break;
+    case 'l':
+        length = *spec++;
+        int_type = ESP_LOG_ARG_LONG;
+        if (*spec == 'l') {
+            spec++;
+            int_type = ESP_LOG_ARG_LONG_LONG;
+        }
+        break;
+    case 'j':
+        length = *spec++;
+        int_type = ESP_LOG_ARG_INTMAX;
+        break;
+    case 'z':
+        length = *spec++;
+        int_type = ESP_LOG_ARG_SIZE;
+        break;
+    case 't':
+        length = *spec++;
+        int_type = ESP_LOG_ARG_PTRDIFF;
+        break;
+    case 'L': // long double
+        length = *spec++;
+        int_type = ESP_LOG_ARG_UNSUPPORTED;
+        break;
+    default:
+        break;
+    }
+
+    switch (*spec) {
+    case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+        *type = int_type;
+        break;
+    case 'c':
+        *type = (length == '\0') ? ESP_LOG_ARG_INT : ESP_LOG_ARG_UNSUPPORTED;
+        break;
+    case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+        *type = (length == '\0' || (length == 'l' && int_type == ESP_LOG_ARG_LONG)) ? ESP_LOG_ARG_DOUBLE : ESP_LOG_ARG_UNSUPPORTED;
+        break;
+    case 's':
+        *type = (length == '\0') ? ESP_LOG_ARG_STR : ESP_LOG_ARG_UNSUPPORTED;
+        break;
+    case 'p':
+        *type = (length == '\0') ? ESP_LOG_ARG_PTR : ESP_LOG_ARG_UNSUPPORTED;
+        break;
+    case '%':
+        *type = ESP_LOG_ARG_NONE;
+        break;
+    default: // "%n", unknown conversions and '%' at the end of the format string
+        *type = ESP_LOG_ARG_UNSUPPORTED;
+        return spec;
+    }
+    return spec + 1;
+}
+
+bool esp_log_args_pack(const char *format, va_list args, size_t max_str_len, uint8_t *dest, size_t *size)
+{
+    size_t len = 0;
+#define PACK_ARG(arg_type) do { \
+        arg_type value = va_arg(args, arg_type); \
+        if (dest) { \
+            memcpy(dest + len, &value, sizeof(value)); \
+        } \
+        len += sizeof(value); \
+    } while (0)
+
+    while ((format = strchr(format, '%')) != NULL) {
+        esp_log_arg_type_t type;
+        int stars;
+        int precision;
+        format = esp_log_args_parse_conversion(format + 1, &type, &stars, &precision);
+        for (int i = 0; i < stars; i++) {
+            int value = va_arg(args, int);
+            if (dest) {
+                memcpy(dest + len, &value, sizeof(value));
+            }
+            len += sizeof(value);
+            if (i == stars - 1 && precision == ESP_LOG_ARG_PRECISION_STAR) {
+                // A negative precision is taken as if it was omitted
+                precision = (value >= 0) ? value : ESP_LOG_ARG_PRECISION_NONE;
+            }
+        }
+        switch (type) {
+        case ESP_LOG_ARG_NONE:
+            break;
+        case ESP_LOG_ARG_INT:
+            PACK_ARG(int);
+            break;
+        case ESP_LOG_ARG_LONG:
+            PACK_ARG(long);
+            break;
+        case ESP_LOG_ARG_LONG_LONG:
+            PACK_ARG(long long);
+            break;
+        case ESP_LOG_ARG_INTMAX:
+            PACK_ARG(intmax_t);
+            break;
+        case ESP_LOG_ARG_SIZE:
+            PACK_ARG(size_t);
+            break;
+        case ESP_LOG_ARG_PTRDIFF:
+            PACK_ARG(ptrdiff_t);
+            break;
+        case ESP_LOG_ARG_DOUBLE:
+            PACK_ARG(double);
+            break;
+        case ESP_LOG_ARG_PTR:
+            PACK_ARG(void *);
+            break;
+        case ESP_LOG_ARG_STR: {
+            const char *str = va_arg(args, const char *);
+            if (str == NULL) {
+                str = "(null)";
+            }
+            // With a precision, the string is not read beyond it and does not need a NUL terminator
+            size_t limit = max_str_len + 1;
+            if (precision >= 0 && (size_t)precision < limit) {
+                limit = precision;
+            }
+            size_t str_len = strnlen(str, limit);
+            if (str_len > max_str_len) {
+                return false;
+            }
+            if (dest) {
+                memcpy(dest + len, str, str_len);
+                dest[len + str_len] = '\0';
+            }
+            len += str_len + 1;
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+#undef PACK_ARG
+    *size = len;
+    return true;
+}
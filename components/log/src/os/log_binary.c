@@ -0,0 +1,119 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "esp_log_config.h"
+#include "esp_log_binary.h"
+#include "esp_private/log_binary.h"
+#include "esp_private/log_args.h"
+#include "sdkconfig.h"
+
+/*
+ * Binary log records
+ *
+ * A record is a frame starting with LOG_BINARY_SYNC followed by the escaped payload:
+ *
+ *   u8      Length of the rest of the payload
+ *   u8      Low byte of esp_log_config_t (level, require_formatting, dis_timestamp, ...)
+ *   u32     Address of the format string
+ *   u32     Address of the tag, 0 for no tag
+ *   varint  Timestamp in milliseconds (LEB128), only if require_formatting is set and dis_timestamp is not
+ *   ...     Arguments packed by esp_log_args_pack()
+ *
+ * Multi-byte values are little-endian. In the escaped payload, the bytes '\n', '\r', LOG_BINARY_ESCAPE and
+ * LOG_BINARY_SYNC are replaced by LOG_BINARY_ESCAPE followed by the byte XORed with LOG_BINARY_ESCAPE_XOR,
+ * so that LOG_BINARY_SYNC (never found in UTF-8 text) only starts frames, and line ending conversions of
+ * the console do not alter the records. log_binary_decode.py decodes the frames with the ELF file of the
+ * application and passes the text around them through.
+ */
+
+#define LOG_BINARY_SYNC             (0xFF)
+#define LOG_BINARY_ESCAPE           (0xFE)
+#define LOG_BINARY_ESCAPE_XOR       (0x20)
+#define LOG_BINARY_MAX_PAYLOAD      (128)
+#define LOG_BINARY_MAX_HEADER       (1 + 1 + 4 + 4 + 10)
+
+static int write_stdout(const void *data, size_t len)
+{
+    // stdout is line buffered and the frames have no newline, flush each of them
+    flockfile(stdout);
+    size_t written = fwrite(data, 1, len, stdout);
+    fflush(stdout);
+    funlockfile(stdout);
+    return written;
+}
+
+static esp_log_binary_writer_t s_writer = &write_stdout;
+
+esp_log_binary_writer_t esp_log_binary_set_writer(esp_log_binary_writer_t writer)
+{
+    return __atomic_exchange_n(&s_writer, writer, __ATOMIC_SEQ_CST);
+}
+
+static size_t put_u32(uint8_t *dest, uint32_t value)
+{
+    for (int i = 0; i < 4; i++) {
+        dest[i] = value >> (8 * i);
+    }
+    return 4;
+}
+
+static size_t put_varint(uint8_t *dest, uint64_t value)
+{
+    size_t len = 0;
+    do {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        dest[len++] = byte | ((value != 0) ? 0x80 : 0);
+    } while (value != 0);
+    return len;
+}
+
+bool esp_log_binary_write(esp_log_config_t config, const char *tag, uint64_t timestamp, const char *format, va_list args)
+{
+    size_t args_size;
+    va_list args_copy;
+    va_copy(args_copy, args);
+    bool supported = esp_log_args_pack(format, args_copy, CONFIG_LOG_BINARY_MAX_STRING_LEN, NULL, &args_size);
+    va_end(args_copy);
+    if (!supported || LOG_BINARY_MAX_HEADER + args_size > LOG_BINARY_MAX_PAYLOAD) {
+        return false;
+    }
+
+    // The payload is built in the second half of the buffer, then escaped from the start of the buffer.
+    // The escaped bytes are at most twice as many, so they never overwrite payload bytes not yet read.
+    uint8_t buf[2 * LOG_BINARY_MAX_PAYLOAD + 1];
+    uint8_t *payload = &buf[LOG_BINARY_MAX_PAYLOAD + 1];
+    size_t len = 1;
+    payload[len++] = config.data & 0xFF;
+    len += put_u32(&payload[len], (uint32_t)(uintptr_t)format);
+    len += put_u32(&payload[len], (uint32_t)(uintptr_t)tag);
+    if (config.opts.require_formatting && !config.opts.dis_timestamp) {
+        len += put_varint(&payload[len], timestamp);
+    }
+    esp_log_args_pack(format, args, CONFIG_LOG_BINARY_MAX_STRING_LEN, &payload[len], &args_size);
+    len += args_size;
+    payload[0] = len - 1;
+
+    size_t out = 0;
+    buf[out++] = LOG_BINARY_SYNC;
+    for (size_t i = 0; i < len; i++) {
+        const uint8_t byte = payload[i];
+        if (byte == '\n' || byte == '\r' || byte >= LOG_BINARY_ESCAPE) {
+            buf[out++] = LOG_BINARY_ESCAPE;
+            buf[out++] = byte ^ LOG_BINARY_ESCAPE_XOR;
+        } else {
+            buf[out++] = byte;
+        }
+    }
+    s_writer(buf, out);
+    return true;
+}
@@ -0,0 +1,450 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+#include "esp_compiler.h"
+#include "esp_rom_sys.h"
+#include "esp_log_config.h"
+#include "esp_log_color.h"
+#include "esp_log_deferred.h"
+#include "esp_private/log_deferred.h"
+#include "esp_private/log_args.h"
+#include "esp_private/log_print.h"
+#include "esp_private/log_timestamp.h"
+#include "sdkconfig.h"
+
+/*
+ * Deferred logging
+ *
+ * esp_log_deferred_write() records the format string and tag pointers, the timestamp and the arguments
+ * of a message into the ring of the current core, and the writer task formats and prints the messages
+ * later. Only the code running on a core writes into the ring of this core, with interrupts masked, so
+ * no lock is shared between cores. The writer task is the only reader of the rings. The producers
+ * publish the head of their ring and the writer task publishes the tails, and a gap is kept in each
+ * ring so that head == tail always means the ring is empty.
+ *
+ * The arguments are packed by esp_log_args_pack(), the format string is parsed again by the writer
+ * task to unpack them.
+ */
+
+#define LOG_DEFERRED_RING_SIZE      (CONFIG_LOG_DEFERRED_BUFFER_SIZE & ~7)
+#define LOG_DEFERRED_LINE_SIZE      (128)   // Buffer of the writer task to gather the parts of a message
+#define LOG_DEFERRED_SPEC_SIZE      (32)    // Enough for a conversion specification with its '*' replaced
+#define LOG_DEFERRED_ALIGN(size)    (((size) + 7) & ~7)
+#define LOG_DEFERRED_POLL_MS        (100)
+
+typedef struct {
+    uint16_t size;              // Size of the record with its arguments, aligned to 8. 0 marks the end of the data before wrapping around.
+    uint16_t reserved;
+    esp_log_config_t config;
+    uint64_t timestamp;
+    const char *tag;
+    const char *format;
+    // Followed by the packed arguments
+} log_record_t;
+
+typedef struct {
+    uint32_t head;              // Offset of the next record to write, published by the producers of the core
+    uint32_t tail;              // Offset of the next record to print, published by the writer task
+    uint8_t buf[LOG_DEFERRED_RING_SIZE] __attribute__((aligned(8)));
+} log_ring_t;
+
+typedef struct {
+    esp_log_config_t config;    // Config of the record being printed
+    bool panic;                 // Printing from the panic handler, with esp_rom_vprintf
+    size_t len;
+    char buf[LOG_DEFERRED_LINE_SIZE];
+} log_output_t;
+
+static const uint8_t s_arg_size[ESP_LOG_ARG_UNSUPPORTED + 1] = {
+    [ESP_LOG_ARG_NONE] = 0,
+    [ESP_LOG_ARG_INT] = sizeof(int),
+    [ESP_LOG_ARG_LONG] = sizeof(long),
+    [ESP_LOG_ARG_LONG_LONG] = sizeof(long long),
+    [ESP_LOG_ARG_INTMAX] = sizeof(intmax_t),
+    [ESP_LOG_ARG_SIZE] = sizeof(size_t),
+    [ESP_LOG_ARG_PTRDIFF] = sizeof(ptrdiff_t),
+    [ESP_LOG_ARG_DOUBLE] = sizeof(double),
+    [ESP_LOG_ARG_PTR] = sizeof(void *),
+    [ESP_LOG_ARG_STR] = 0,          // Variable size, NUL terminated
+    [ESP_LOG_ARG_UNSUPPORTED] = 0,
+};
+
+static const char s_lvl_name[ESP_LOG_MAX] = {
+    '\0', // NONE
+    'E',  // ERROR
+    'W',  // WARNING
+    'I',  // INFO
+    'D',  // DEBUG
+    'V',  // VERBOSE
+};
+
+static const char s_lvl_color[ESP_LOG_MAX][8] = {
+    "\0",                                               // NONE
+    LOG_ANSI_COLOR_REGULAR(LOG_ANSI_COLOR_RED)"\0",     // ERROR
+    LOG_ANSI_COLOR_REGULAR(LOG_ANSI_COLOR_YELLOW)"\0",  // WARNING
+    LOG_ANSI_COLOR_REGULAR(LOG_ANSI_COLOR_GREEN)"\0",   // INFO
+    "\0",                                               // DEBUG
+    "\0",                                               // VERBOSE
+};
+
+static log_ring_t s_rings[CONFIG_FREERTOS_NUMBER_OF_CORES];
+static uint32_t s_dropped;
+static uint32_t s_dropped_reported;
+static bool s_writer_started;
+static bool s_writer_waiting;
+static TaskHandle_t s_writer_task;
+static StaticTask_t s_writer_tcb;
+static StackType_t s_writer_stack[CONFIG_LOG_DEFERRED_TASK_STACK_SIZE];
+
+/**
+ * Reserves size bytes in the ring. Returns the offset of the reserved space and the head to publish
+ * once the record is written, or UINT32_MAX if the ring is full.
+ */
+static uint32_t ring_reserve(log_ring_t *ring, uint32_t size, uint32_t *new_head)
+{
+    const uint32_t head = ring->head; // Only written by this core, with interrupts masked
+    const uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    if (head >= tail) {
+        if (head + size < LOG_DEFERRED_RING_SIZE || (head + size == LOG_DEFERRED_RING_SIZE && tail != 0)) {
+            *new_head = (head + size) % LOG_DEFERRED_RING_SIZE;
+            return head;
+        }
+        // Not enough space before the end of the ring, mark the end of the data and wrap around
+        if (size < tail) {
+            ((log_record_t *)&ring->buf[head])->size = 0;
+            *new_head = size;
+            return 0;
+        }
+    } else if (head + size < tail) {
+        *new_head = head + size;
+        return head;
+    }
+    return UINT32_MAX;
+}
+
+static bool rings_empty(void)
+{
+    for (int i = 0; i < CONFIG_FREERTOS_NUMBER_OF_CORES; i++) {
+        if (__atomic_load_n(&s_rings[i].head, __ATOMIC_ACQUIRE) != __atomic_load_n(&s_rings[i].tail, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void output_vprintf(log_output_t *out, const char *format, va_list args)
+{
+    if (out->panic) {
+        esp_rom_vprintf(format, args);
+    } else {
+        esp_log_vprintf(out->config, format, args);
+    }
+}
+
+static void output_flush(log_output_t *out)
+{
+    if (out->len != 0) {
+        if (out->panic) {
+            esp_rom_printf("%s", out->buf);
+        } else {
+            esp_log_printf(out->config, "%s", out->buf);
+        }
+        out->len = 0;
+    }
+}
+
+/**
+ * Appends to the line buffer, flushing it when full. A part which does not fit in the whole buffer
+ * is printed directly.
+ */
+static void __attribute__((format(printf, 2, 3))) output_printf(log_output_t *out, const char *format, ...)
+{
+    va_list args;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        const size_t avail = sizeof(out->buf) - out->len;
+        va_start(args, format);
+        int len = vsnprintf(out->buf + out->len, avail, format, args);
+        va_end(args);
+        if (len < 0) {
+            out->buf[out->len] = '\0';
+            return;
+        }
+        if ((size_t)len < avail) {
+            out->len += len;
+            return;
+        }
+        out->buf[out->len] = '\0';
+        output_flush(out);
+    }
+    va_start(args, format);
+    output_vprintf(out, format, args);
+    va_end(args);
+}
+
+static void output_record(log_output_t *out, const log_record_t *record)
+{
+    esp_log_config_t config = record->config;
+    out->config = config;
+    out->config.opts.constrained_env = out->panic;
+    if (config.opts.require_formatting) { // "<color_start><level_name> <(time)> <tag>: "
+        config.opts.dis_color = !ESP_LOG_SUPPORT_COLOR || config.opts.dis_color || (s_lvl_color[config.opts.log_level][0] == '\0');
+        char timestamp_buffer[32] = { 0 };
+        if (!config.opts.dis_timestamp) {
+            esp_log_timestamp_str(false, record->timestamp, timestamp_buffer);
+        }
+        output_printf(out, "%s%c %s%s%s%s%s",
+                      (!config.opts.dis_color) ? s_lvl_color[config.opts.log_level] : "",
+                      s_lvl_name[config.opts.log_level],
+                      (!config.opts.dis_timestamp) ? "(" : "",
+                      timestamp_buffer,
+                      (!config.opts.dis_timestamp) ? ") " : "",
+                      (record->tag) ? record->tag : "",
+                      (record->tag) ? ": " : "");
+    }
+
+    const uint8_t *arg = (const uint8_t *)(record + 1);
+    const char *format = record->format;
+    const char *percent;
+    while ((percent = strchr(format, '%')) != NULL) {
+        if (percent != format) {
+            output_printf(out, "%.*s", (int)(percent - format), format);
+        }
+        esp_log_arg_type_t type;
+        int stars;
+        int precision; // Applied again by the rebuilt specification
+        format = esp_log_args_parse_conversion(percent + 1, &type, &stars, &precision);
+
+        // Rebuild the conversion specification with the '*' replaced by the recorded values
+        char spec[LOG_DEFERRED_SPEC_SIZE];
+        size_t spec_len = 0;
+        for (const char *c = percent; c < format && spec_len < sizeof(spec) - 12; c++) {
+            if (*c == '*') {
+                int value;
+                memcpy(&value, arg, sizeof(value));
+                arg += sizeof(value);
+                if (value < 0 && c[-1] == '.') {
+                    spec_len--; // A negative precision is taken as if it was omitted
+                } else {
+                    spec_len += snprintf(spec + spec_len, sizeof(spec) - spec_len, "%d", value);
+                }
+            } else {
+                spec[spec_len++] = *c;
+            }
+        }
+        spec[spec_len] = '\0';
+
+#define OUTPUT_ARG(arg_type) do { \
+            arg_type value; \
+            memcpy(&value, arg, sizeof(value)); \
+            output_printf(out, spec, value); \
+        } while (0)
+
+        switch (type) {
+        case ESP_LOG_ARG_NONE:
+            output_printf(out, "%%");
+            break;
+        case ESP_LOG_ARG_INT:
+            OUTPUT_ARG(int);
+            break;
+        case ESP_LOG_ARG_LONG:
+            OUTPUT_ARG(long);
+            break;
+        case ESP_LOG_ARG_LONG_LONG:
+            OUTPUT_ARG(long long);
+            break;
+        case ESP_LOG_ARG_INTMAX:
+            OUTPUT_ARG(intmax_t);
+            break;
+        case ESP_LOG_ARG_SIZE:
+            OUTPUT_ARG(size_t);
+            break;
+        case ESP_LOG_ARG_PTRDIFF:
+            OUTPUT_ARG(ptrdiff_t);
+            break;
+        case ESP_LOG_ARG_DOUBLE:
+            OUTPUT_ARG(double);
+            break;
+        case ESP_LOG_ARG_PTR:
+            OUTPUT_ARG(void *);
+            break;
+        case ESP_LOG_ARG_STR:
+            output_printf(out, spec, (const char *)arg);
+            arg += strlen((const char *)arg) + 1;
+            break;
+        default: // Not recorded
+            break;
+        }
+#undef OUTPUT_ARG
+        arg += s_arg_size[type];
+    }
+    if (*format != '\0') {
+        output_printf(out, "%s", format);
+    }
+
+    if (config.opts.require_formatting) { // "<color_end><\n>"
+        output_printf(out, "%s", (config.opts.dis_color) ? "\n" : LOG_RESET_COLOR"\n");
+    }
+    output_flush(out);
+}
+
+static void output_dropped(log_output_t *out)
+{
+    const uint32_t dropped = __atomic_load_n(&s_dropped, __ATOMIC_RELAXED);
+    if (dropped != s_dropped_reported) {
+        out->config = ESP_LOG_CONFIG_INIT(ESP_LOG_WARN);
+        out->config.opts.constrained_env = out->panic;
+        output_printf(out, "W log: %" PRIu32 " deferred messages dropped\n", dropped - s_dropped_reported);
+        output_flush(out);
+        s_dropped_reported = dropped;
+    }
+}
+
+/**
+ * Prints the records of all the rings. Returns false if the rings were empty.
+ */
+static bool output_rings(log_output_t *out)
+{
+    bool printed = false;
+    for (int i = 0; i < CONFIG_FREERTOS_NUMBER_OF_CORES; i++) {
+        log_ring_t *ring = &s_rings[i];
+        uint32_t tail = ring->tail;
+        const uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        while (tail != head) {
+            const log_record_t *record = (const log_record_t *)&ring->buf[tail];
+            if (record->size == 0) {
+                tail = 0;
+                continue;
+            }
+            if (!out->panic) {
+                // Keep the lines of the message together, as esp_log_va() does
+                flockfile(stdout);
+            }
+            output_record(out, record);
+            if (!out->panic) {
+                funlockfile(stdout);
+            }
+            tail = (tail + record->size) % LOG_DEFERRED_RING_SIZE;
+            __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+            printed = true;
+        }
+    }
+    output_dropped(out);
+    return printed;
+}
+
+static void writer_task(void *arg)
+{
+    (void)arg;
+    log_output_t out = { .panic = false };
+    while (true) {
+        if (!output_rings(&out)) {
+            // Same handshake as wake_writer(): the flag is set before checking the rings, the producers
+            // publish their head before checking the flag, so one side always sees the other.
+            __atomic_store_n(&s_writer_waiting, true, __ATOMIC_RELAXED);
+            __atomic_thread_fence(__ATOMIC_SEQ_CST);
+            if (rings_empty()) {
+                ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(LOG_DEFERRED_POLL_MS));
+            }
+            __atomic_store_n(&s_writer_waiting, false, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static void start_writer(void)
+{
+    if (!__atomic_exchange_n(&s_writer_started, true, __ATOMIC_ACQ_REL)) {
+        TaskHandle_t task = xTaskCreateStatic(writer_task, "log_writer", CONFIG_LOG_DEFERRED_TASK_STACK_SIZE, NULL,
+                                              CONFIG_LOG_DEFERRED_TASK_PRIORITY, s_writer_stack, &s_writer_tcb);
+        __atomic_store_n(&s_writer_task, task, __ATOMIC_RELEASE);
+    }
+}
+
+static void wake_writer(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&s_writer_waiting, __ATOMIC_RELAXED) && __atomic_exchange_n(&s_writer_waiting, false, __ATOMIC_RELAXED)) {
+        TaskHandle_t task = __atomic_load_n(&s_writer_task, __ATOMIC_ACQUIRE);
+        if (task != NULL) {
+            xTaskNotifyGive(task);
+        }
+    }
+}
+
+bool esp_log_deferred_write(esp_log_config_t config, const char *tag, uint64_t timestamp, const char *format, va_list args)
+{
+    size_t args_size;
+    va_list args_copy;
+    va_copy(args_copy, args);
+    bool supported = esp_log_args_pack(format, args_copy, CONFIG_LOG_DEFERRED_MAX_STRING_LEN, NULL, &args_size);
+    va_end(args_copy);
+    const size_t size = LOG_DEFERRED_ALIGN(sizeof(log_record_t) + args_size);
+    if (!supported || size > LOG_DEFERRED_RING_SIZE / 2) {
+        return false;
+    }
+    if (unlikely(__atomic_load_n(&s_writer_task, __ATOMIC_ACQUIRE) == NULL)) {
+        start_writer();
+    }
+
+    // Masking interrupts keeps the task on this core and excludes the ISRs logging on this core
+    UBaseType_t state = portSET_INTERRUPT_MASK_FROM_ISR();
+    log_ring_t *ring = &s_rings[xPortGetCoreID()];
+    uint32_t new_head;
+    const uint32_t offset = ring_reserve(ring, size, &new_head);
+    if (offset != UINT32_MAX) {
+        log_record_t *record = (log_record_t *)&ring->buf[offset];
+        *record = (log_record_t) {
+            .size = size,
+            .config = config,
+            .timestamp = timestamp,
+            .tag = tag,
+            .format = format,
+        };
+        esp_log_args_pack(format, args, CONFIG_LOG_DEFERRED_MAX_STRING_LEN, (uint8_t *)(record + 1), &args_size);
+        __atomic_store_n(&ring->head, new_head, __ATOMIC_RELEASE);
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(state);
+
+    if (offset == UINT32_MAX) {
+        __atomic_fetch_add(&s_dropped, 1, __ATOMIC_RELAXED);
+    } else {
+        wake_writer();
+    }
+    return true;
+}
+
+void esp_log_deferred_panic_flush(void)
+{
+    log_output_t out = { .panic = true };
+    output_rings(&out);
+}
+
+uint32_t esp_log_deferred_get_dropped(void)
+{
+    return __atomic_load_n(&s_dropped, __ATOMIC_RELAXED);
+}
+
+esp_err_t esp_log_deferred_flush(uint32_t timeout_ms)
+{
+    const TickType_t start = xTaskGetTickCount();
+    while (!rings_empty()) {
+        if (xTaskGetTickCount() - start >= pdMS_TO_TICKS(timeout_ms)) {
+            return ESP_ERR_TIMEOUT;
+        }
+        wake_writer();
+        vTaskDelay(1);
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,119 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include "unity.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+
+#if CONFIG_LOG_BINARY
+#include "esp_log_binary.h"
+
+static const char * TAG = "log_binary_test";
+static const char s_format[] = "value %d, str %s";
+
+static uint8_t s_record[256];
+static size_t s_record_len;
+
+static int write_to_buffer(const void *data, size_t len)
+{
+    TEST_ASSERT_LESS_OR_EQUAL(sizeof(s_record), len);
+    memcpy(s_record, data, len);
+    s_record_len = len;
+    return len;
+}
+
+// Removes the framing of the record, returns the length of the payload
+static size_t unescape_record(uint8_t *payload)
+{
+    TEST_ASSERT_EQUAL_HEX8(0xFF, s_record[0]);
+    size_t len = 0;
+    for (size_t i = 1; i < s_record_len; i++) {
+        TEST_ASSERT_NOT_EQUAL(0xFF, s_record[i]);
+        TEST_ASSERT_NOT_EQUAL('\n', s_record[i]);
+        payload[len++] = (s_record[i] == 0xFE) ? (s_record[++i] ^ 0x20) : s_record[i];
+    }
+    TEST_ASSERT_EQUAL(len, payload[0] + 1);
+    return len;
+}
+
+TEST_CASE("binary log records hold the format address and the packed arguments", "[log_binary]")
+{
+    esp_log_binary_writer_t old_writer = esp_log_binary_set_writer(write_to_buffer);
+    s_record_len = 0;
+    int64_t start = esp_timer_get_time();
+    esp_log(ESP_LOG_CONFIG_INIT(ESP_LOG_INFO | ESP_LOG_CONFIGS_DEFAULT), TAG, s_format, 0x0a0d, "abc");
+    int64_t end = esp_timer_get_time();
+    esp_log_binary_set_writer(old_writer);
+    printf("esp_log took %" PRIi64 " usec, record of %zu bytes\n", end - start, s_record_len);
+
+    uint8_t payload[256];
+    size_t len = unescape_record(payload);
+    uint32_t format_addr, tag_addr;
+    memcpy(&format_addr, &payload[2], sizeof(format_addr));
+    memcpy(&tag_addr, &payload[6], sizeof(tag_addr));
+    TEST_ASSERT_EQUAL(ESP_LOG_INFO, payload[1] & ESP_LOG_CONFIG_LEVEL_MASK);
+    TEST_ASSERT_EQUAL_HEX32((uint32_t)s_format, format_addr);
+    TEST_ASSERT_EQUAL_HEX32((uint32_t)TAG, tag_addr);
+
+    size_t offset = 10;
+    if (!(payload[1] & ESP_LOG_CONFIG_DIS_TIMESTAMP)) {
+        while (payload[offset++] & 0x80) {
+        }
+    }
+    int value;
+    memcpy(&value, &payload[offset], sizeof(value));
+    TEST_ASSERT_EQUAL_HEX32(0x0a0d, value);
+    TEST_ASSERT_EQUAL_STRING("abc", (const char *)&payload[offset + sizeof(value)]);
+    TEST_ASSERT_EQUAL(offset + sizeof(value) + sizeof("abc"), len);
+}
+
+TEST_CASE("binary log falls back to text for unsupported conversions", "[log_binary]")
+{
+    esp_log_binary_writer_t old_writer = esp_log_binary_set_writer(write_to_buffer);
+    s_record_len = 0;
+    ESP_LOGI(TAG, "long double %Lf", (long double)1.0);
+    esp_log_binary_set_writer(old_writer);
+    TEST_ASSERT_EQUAL(0, s_record_len);
+}
+
+TEST_CASE("binary log falls back to text for strings longer than the limit", "[log_binary]")
+{
+    char str[CONFIG_LOG_BINARY_MAX_STRING_LEN + 2];
+    memset(str, 'a', sizeof(str) - 1);
+    str[sizeof(str) - 1] = '\0';
+
+    esp_log_binary_writer_t old_writer = esp_log_binary_set_writer(write_to_buffer);
+    s_record_len = 0;
+    ESP_LOGI(TAG, "str %s", str);
+    TEST_ASSERT_EQUAL(0, s_record_len);
+
+    str[CONFIG_LOG_BINARY_MAX_STRING_LEN] = '\0';
+    ESP_LOGI(TAG, "str %s", str);
+    esp_log_binary_set_writer(old_writer);
+    TEST_ASSERT_NOT_EQUAL(0, s_record_len);
+}
+
+TEST_CASE("binary log records only copy the strings up to their precision", "[log_binary]")
+{
+    // Not NUL terminated, and longer than the limit
+    char buf[2 * CONFIG_LOG_BINARY_MAX_STRING_LEN];
+    memset(buf, 'a', sizeof(buf));
+
+    esp_log_binary_writer_t old_writer = esp_log_binary_set_writer(write_to_buffer);
+    s_record_len = 0;
+    ESP_LOGI(TAG, "str %.*s", 5, buf);
+    esp_log_binary_set_writer(old_writer);
+
+    uint8_t payload[256];
+    size_t len = unescape_record(payload);
+    TEST_ASSERT_EQUAL_STRING("aaaaa", (const char *)&payload[len - sizeof("aaaaa")]);
+}
+
+#endif // CONFIG_LOG_BINARY
@@ -0,0 +1,130 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include "unity.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+
+#if CONFIG_LOG_DEFERRED
+#include "esp_log_deferred.h"
+
+static const char * TAG = "log_deferred_test";
+
+#define BUFFER_SIZE (1024)
+static char s_print_buffer[BUFFER_SIZE];
+static size_t s_print_len;
+static unsigned s_tag_lines;
+static volatile bool s_blocked;
+
+// Called from the writer task, and from the logging task for the messages printed immediately
+static int print_to_buffer(const char *format, va_list args)
+{
+    while (s_blocked) {
+        vTaskDelay(1);
+    }
+    char line[384];
+    int ret = vsnprintf(line, sizeof(line), format, args);
+    if (strstr(line, TAG) != NULL) {
+        s_tag_lines++;
+    }
+    if (s_print_len + strlen(line) < BUFFER_SIZE) {
+        strcpy(&s_print_buffer[s_print_len], line);
+        s_print_len += strlen(line);
+    }
+    return ret;
+}
+
+static void reset_buffer(void)
+{
+    s_print_len = 0;
+    s_print_buffer[0] = '\0';
+    s_tag_lines = 0;
+}
+
+TEST_CASE("deferred log messages are printed by the writer task", "[log_deferred]")
+{
+    vprintf_like_t old_vprintf = esp_log_set_vprintf(print_to_buffer);
+    reset_buffer();
+
+    char str[16] = "volatile";
+    int64_t start = esp_timer_get_time();
+    ESP_LOGI(TAG, "int %d, str %s, hex %08" PRIx32 ", ll %lld, dbl %.2f, width %*d, %%, null %s|",
+             -5, str, (uint32_t)0xbeef, 123456789012LL, 1.5, 4, 42, (char *)NULL);
+    int64_t end = esp_timer_get_time();
+    strcpy(str, "overwritten"); // The string argument must have been copied
+    TEST_ASSERT_EQUAL(ESP_OK, esp_log_deferred_flush(1000));
+    esp_log_set_vprintf(old_vprintf);
+
+    printf("ESP_LOGI took %" PRIi64 " usec: %s", end - start, s_print_buffer);
+    TEST_ASSERT_EQUAL(1, s_tag_lines);
+    TEST_ASSERT_NOT_NULL(strstr(s_print_buffer, "int -5, str volatile, hex 0000beef, ll 123456789012, dbl 1.50, width   42, %, null (null)|"));
+}
+
+TEST_CASE("deferred log messages are counted when dropped", "[log_deferred]")
+{
+    const unsigned MESSAGES = 2 * CONFIG_LOG_DEFERRED_BUFFER_SIZE / 32;
+    vprintf_like_t old_vprintf = esp_log_set_vprintf(print_to_buffer);
+    reset_buffer();
+
+    // The writer task blocks on the first message, so the buffer fills up
+    s_blocked = true;
+    uint32_t dropped = esp_log_deferred_get_dropped();
+    for (unsigned i = 0; i < MESSAGES; i++) {
+        ESP_LOGI(TAG, "message %u", i);
+    }
+    dropped = esp_log_deferred_get_dropped() - dropped;
+    TEST_ASSERT_EQUAL(ESP_ERR_TIMEOUT, esp_log_deferred_flush(10));
+    s_blocked = false;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_log_deferred_flush(1000));
+    esp_log_set_vprintf(old_vprintf);
+
+    printf("%u messages logged, %" PRIu32 " dropped\n", MESSAGES, dropped);
+    TEST_ASSERT_GREATER_THAN(0, dropped);
+    TEST_ASSERT_EQUAL(MESSAGES - dropped, s_tag_lines);
+    TEST_ASSERT_NOT_NULL(strstr(s_print_buffer, "deferred messages dropped"));
+}
+
+TEST_CASE("deferred log messages with strings over the limit are printed immediately", "[log_deferred]")
+{
+    char str[CONFIG_LOG_DEFERRED_MAX_STRING_LEN + 2];
+    memset(str, 'a', sizeof(str) - 1);
+    str[sizeof(str) - 1] = '\0';
+    vprintf_like_t old_vprintf = esp_log_set_vprintf(print_to_buffer);
+    reset_buffer();
+
+    ESP_LOGI(TAG, "str %s|", str);
+    TEST_ASSERT_EQUAL(1, s_tag_lines);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_log_deferred_flush(1000));
+    esp_log_set_vprintf(old_vprintf);
+
+    TEST_ASSERT_EQUAL(1, s_tag_lines);
+    TEST_ASSERT_NOT_NULL(strstr(s_print_buffer, str));
+}
+
+TEST_CASE("deferred log messages only copy the strings up to their precision", "[log_deferred]")
+{
+    // Not NUL terminated, and longer than the limit
+    char buf[2 * CONFIG_LOG_DEFERRED_MAX_STRING_LEN];
+    memset(buf, 'a', sizeof(buf));
+    vprintf_like_t old_vprintf = esp_log_set_vprintf(print_to_buffer);
+    reset_buffer();
+
+    ESP_LOGI(TAG, "str %.*s|%.3s|", 5, buf, buf);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_log_deferred_flush(1000));
+    esp_log_set_vprintf(old_vprintf);
+
+    TEST_ASSERT_EQUAL(1, s_tag_lines);
+    TEST_ASSERT_NOT_NULL(strstr(s_print_buffer, "str aaaaa|aaa|"));
+}
+
+#endif // CONFIG_LOG_DEFERRED
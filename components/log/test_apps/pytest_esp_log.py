@@ -6,6 +6,21 @@ from pytest_embedded_idf.utils import idf_parametrize
 
 
 @pytest.mark.generic
+@idf_parametrize('config', ['default'], indirect=['config'])
 @idf_parametrize('target', ['esp32'], indirect=['target'])
 def test_esp_log(dut: Dut) -> None:
-    dut.run_all_single_board_cases()
+    dut.run_all_single_board_cases(group='log')
+
+
+@pytest.mark.generic
+@idf_parametrize('config', ['deferred'], indirect=['config'])
+@idf_parametrize('target', ['esp32'], indirect=['target'])
+def test_esp_log_deferred(dut: Dut) -> None:
+    dut.run_all_single_board_cases(group='log_deferred')
+
+
+@pytest.mark.generic
+@idf_parametrize('config', ['binary'], indirect=['config'])
+@idf_parametrize('target', ['esp32'], indirect=['target'])
+def test_esp_log_binary(dut: Dut) -> None:
+    dut.run_all_single_board_cases(group='log_binary')
@@ -0,0 +1,121 @@
+#!/usr/bin/env python
+# SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+# SPDX-License-Identifier: Apache-2.0
+import struct
+import sys
+import unittest
+from typing import Optional
+
+try:
+    import log_binary_decode
+except ImportError:
+    sys.path.append('..')
+    import log_binary_decode
+
+FMT_ADDR = 0x3f400010
+TAG_ADDR = 0x3f400100
+STRINGS = {
+    FMT_ADDR: 'value %d, str %s, hex %08x',
+    TAG_ADDR: 'app',
+}
+
+LEVEL_INFO = 3
+REQUIRE_FORMATTING = 1 << 4
+DIS_TIMESTAMP = 1 << 6
+
+
+def varint(value: int) -> bytes:
+    out = b''
+    while True:
+        byte = value & 0x7F
+        value >>= 7
+        out += bytes([byte | (0x80 if value else 0)])
+        if not value:
+            return out
+
+
+def frame(config: int, fmt_addr: int, tag_addr: int, args: bytes, timestamp: Optional[int] = None) -> bytes:
+    """Builds a record the way esp_log_binary_write() does."""
+    payload = struct.pack('<BII', config, fmt_addr, tag_addr)
+    if timestamp is not None:
+        payload += varint(timestamp)
+    payload += args
+    payload = bytes([len(payload)]) + payload
+    out = b'\xff'
+    for byte in payload:
+        if byte in (0x0A, 0x0D, 0xFE, 0xFF):
+            out += bytes([0xFE, byte ^ 0x20])
+        else:
+            out += bytes([byte])
+    return out
+
+
+class FormatMessageTests(unittest.TestCase):
+
+    def check(self, fmt: str, args: bytes, expected: str) -> None:
+        self.assertEqual(log_binary_decode.format_message(fmt, args), expected)
+
+    def test_integers(self) -> None:
+        self.check('%d %i %u', struct.pack('<iiI', -5, 7, 4000000000), '-5 7 4000000000')
+        self.check('%x %X %o %#x %#o %#x', struct.pack('<IIIIII', 0xbeef, 0xbeef, 8, 255, 8, 0), 'beef BEEF 10 0xff 010 0')
+        self.check('%08x|%-4d|%+d|%.3d', struct.pack('<IiIi', 0xbeef, 1, 2, 3), '0000beef|1   |+2|003')
+        self.check('%hhd %hu %ld', struct.pack('<iii', 0x1ff, 0x10001, -1), '-1 1 -1')
+        self.check('%lld %llu %jd %zu %td', struct.pack('<qQqIi', -123456789012, 2**64 - 1, 5, 6, -7),
+                   '-123456789012 18446744073709551615 5 6 -7')
+
+    def test_stars(self) -> None:
+        self.check('%*d|%-*.*s|', struct.pack('<iiii', 4, 42, 6, 2) + b'abc\0', '  42|ab    |')
+        self.check('%.*s|', struct.pack('<i', -1) + b'abc\0', 'abc|')
+
+    def test_other_conversions(self) -> None:
+        self.check('%c%c %%', struct.pack('<ii', ord('o'), ord('k')), 'ok %')
+        self.check('%.2f %e %g', struct.pack('<ddd', 1.5, 1000.0, 0.25), '1.50 1.000000e+03 0.25')
+        self.check('%p %s|%5s', struct.pack('<I', 0x3ffb0000) + b'hello\0(null)\0', '0x3ffb0000 hello|(null)')
+
+    def test_errors(self) -> None:
+        with self.assertRaises(log_binary_decode.LogBinaryDecodeError):
+            log_binary_decode.format_message('%d', b'\0\0')
+        with self.assertRaises(log_binary_decode.LogBinaryDecodeError):
+            log_binary_decode.format_message('%s', b'abc')
+        with self.assertRaises(log_binary_decode.LogBinaryDecodeError):
+            log_binary_decode.format_message('%n', b'')
+
+
+class DecoderTests(unittest.TestCase):
+
+    def setUp(self) -> None:
+        self.decoder = log_binary_decode.LogBinaryDecoder(STRINGS.get)
+
+    def test_record_with_text_around(self) -> None:
+        args = struct.pack('<i', 10) + b'a\nb\0' + struct.pack('<I', 0xff0d0a)
+        data = b'I (10) boot: text\n' + frame(LEVEL_INFO | REQUIRE_FORMATTING, FMT_ADDR, TAG_ADDR, args, 1234) + b'printf\n'
+        self.assertEqual(self.decoder.feed(data), 'I (10) boot: text\nI (1234) app: value 10, str a\nb, hex 00ff0d0a\nprintf\n')
+
+    def test_record_split_across_reads(self) -> None:
+        data = frame(LEVEL_INFO | REQUIRE_FORMATTING | DIS_TIMESTAMP, FMT_ADDR, 0, struct.pack('<i', 1) + b'x\0' + struct.pack('<I', 2))
+        out = ''.join(self.decoder.feed(data[i:i + 1]) for i in range(len(data)))
+        self.assertEqual(out, 'I value 1, str x, hex 00000002\n')
+
+    def test_record_without_formatting(self) -> None:
+        data = frame(LEVEL_INFO, FMT_ADDR, TAG_ADDR, struct.pack('<i', 1) + b'x\0' + struct.pack('<I', 2))
+        self.assertEqual(self.decoder.feed(data), 'value 1, str x, hex 00000002')
+
+    def test_unknown_strings(self) -> None:
+        data = frame(LEVEL_INFO | REQUIRE_FORMATTING | DIS_TIMESTAMP, FMT_ADDR, 0x3ffb1234, struct.pack('<i', 1) + b'x\0' + struct.pack('<I', 2))
+        self.assertEqual(self.decoder.feed(data), 'I 0x3ffb1234: value 1, str x, hex 00000002\n')
+        data = frame(LEVEL_INFO, 0x12345678, 0, b'')
+        self.assertIn('0x12345678 not found', self.decoder.feed(data))
+
+    def test_truncated_record(self) -> None:
+        data = frame(LEVEL_INFO, FMT_ADDR, 0, struct.pack('<i', 1) + b'x\0' + struct.pack('<I', 2))
+        out = self.decoder.feed(data[:5] + data)
+        self.assertEqual(out, '<truncated binary log record>\nvalue 1, str x, hex 00000002')
+
+    def test_timestamp_formats(self) -> None:
+        self.assertEqual(log_binary_decode.format_timestamp(3723004, 'ms'), '3723004')
+        self.assertEqual(log_binary_decode.format_timestamp(3723004, 'system'), '01:02:03.004')
+        self.assertEqual(log_binary_decode.format_timestamp(3723004, 'system_full'), '70-01-01 01:02:03.004')
+
+
+if __name__ == '__main__':
+    unittest.main()
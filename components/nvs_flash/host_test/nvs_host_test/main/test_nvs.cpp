@@ -17,6 +17,12 @@
 #include <string.h>
 #include <string>
 #include <random>
+#include <chrono>
+#ifdef CONFIG_NVS_CONCURRENT_READS
+#include <thread>
+#include <atomic>
+#include <vector>
+#endif
 #include "test_fixtures.hpp"
 #include "spi_flash_mmap.h"
 
@@ -260,17 +266,9 @@ TEST_CASE("Page validates blob size", "[nvs]")
     TEST_ESP_OK(page.writeItem(1, nvs::ItemType::BLOB, "2", buf, nvs::Page::CHUNK_MAX_SIZE));
 }
 
-class HashListTestHelper : public nvs::HashList {
-public:
-    size_t getBlockCount()
-    {
-        return mBlockList.size();
-    }
-};
-
 TEST_CASE("HashList is cleaned up as soon as items are erased", "[nvs]")
 {
-    HashListTestHelper hashlist;
+    nvs::HashList hashlist;
     // Add items
     const size_t count = 128;
     for (size_t i = 0; i < count; ++i) {
@@ -279,13 +277,13 @@ TEST_CASE("HashList is cleaned up as soon as items are erased", "[nvs]")
         nvs::Item item(1, nvs::ItemType::U32, 1, key);
         hashlist.insert(item, i);
     }
-    INFO("Added " << count << " items, " << hashlist.getBlockCount() << " blocks");
+    INFO("Added " << count << " items, " << hashlist.getRamUsage() << " bytes");
     // Remove them in reverse order
     for (size_t i = count; i > 0; --i) {
         // Make sure that the element existed before it's erased
         CHECK(hashlist.erase(i - 1) == true);
     }
-    CHECK(hashlist.getBlockCount() == 0);
+    CHECK(hashlist.getRamUsage() == 0);
     // Add again
     for (size_t i = 0; i < count; ++i) {
         char key[16];
@@ -293,12 +291,12 @@ TEST_CASE("HashList is cleaned up as soon as items are erased", "[nvs]")
         nvs::Item item(1, nvs::ItemType::U32, 1, key);
         hashlist.insert(item, i);
     }
-    INFO("Added " << count << " items, " << hashlist.getBlockCount() << " blocks");
+    INFO("Added " << count << " items, " << hashlist.getRamUsage() << " bytes");
     // Remove them in the same order
     for (size_t i = 0; i < count; ++i) {
         CHECK(hashlist.erase(i) == true);
     }
-    CHECK(hashlist.getBlockCount() == 0);
+    CHECK(hashlist.getRamUsage() == 0);
 }
 
 TEST_CASE("can init PageManager in empty flash", "[nvs]")
@@ -412,6 +410,72 @@ TEST_CASE("storage can find items on second page if first is not fully written a
     CHECK(size == sizeof(bigdata));
 }
 
+TEST_CASE("storage finds all items after pages were garbage collected", "[nvs]")
+{
+    PartitionEmulationFixture f(0, 4);
+    nvs::Storage storage(f.part());
+    TEST_ESP_OK(storage.init(0, 4));
+    const size_t keyCount = 40;
+    char key[16];
+    // every round rewrites all keys, so older pages get freed and their items copied
+    for (uint32_t round = 0; round < 20; ++round) {
+        for (size_t i = 0; i < keyCount; ++i) {
+            snprintf(key, sizeof(key), "key%u", static_cast<unsigned>(i));
+            TEST_ESP_OK(storage.writeItem(1, key, static_cast<uint32_t>(round * keyCount + i)));
+        }
+    }
+    for (size_t i = 0; i < keyCount; ++i) {
+        snprintf(key, sizeof(key), "key%u", static_cast<unsigned>(i));
+        uint32_t value;
+        TEST_ESP_OK(storage.readItem(1, key, value));
+        CHECK(value == 19 * keyCount + i);
+    }
+    TEST_ESP_OK(storage.eraseItem(1, "key3"));
+    uint32_t value;
+    TEST_ESP_ERR(storage.readItem(1, "key3", value), ESP_ERR_NVS_NOT_FOUND);
+
+    // the index has to be rebuilt from flash contents on the next init
+    nvs::Storage storage2(f.part());
+    TEST_ESP_OK(storage2.init(0, 4));
+    TEST_ESP_OK(storage2.readItem(1, "key4", value));
+    CHECK(value == 19 * keyCount + 4);
+    TEST_ESP_ERR(storage2.readItem(1, "key3", value), ESP_ERR_NVS_NOT_FOUND);
+}
+
+TEST_CASE("benchmark key lookup latency vs. partition size", "[nvs][benchmark]")
+{
+    for (uint32_t sectors : {4, 16, 64}) {
+        PartitionEmulationFixture f(0, sectors);
+        nvs::Storage storage(f.part());
+        TEST_ESP_OK(storage.init(0, sectors));
+
+        // fill about half of the partition with primitive items
+        const size_t keyCount = (sectors - 1) * nvs::Page::ENTRY_COUNT / 2;
+        char key[16];
+        for (size_t i = 0; i < keyCount; ++i) {
+            snprintf(key, sizeof(key), "key%u", static_cast<unsigned>(i));
+            TEST_ESP_OK(storage.writeItem(1, key, static_cast<uint32_t>(i)));
+        }
+
+        esp_partition_clear_stats();
+        size_t mismatches = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < keyCount; ++i) {
+            snprintf(key, sizeof(key), "key%u", static_cast<unsigned>(i));
+            uint32_t value = 0;
+            if (storage.readItem(1, key, value) != ESP_OK || value != i) {
+                ++mismatches;
+            }
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        CHECK(mismatches == 0);
+
+        s_perf << "Key lookup, " << sectors << " sectors, " << keyCount << " keys: "
+               << elapsed.count() / keyCount << " ns/lookup, "
+               << esp_partition_get_read_ops() / static_cast<double>(keyCount) << " flash reads/lookup" << std::endl;
+    }
+}
+
 TEST_CASE("can write and read variable length data lots of times", "[nvs]")
 {
     PartitionEmulationFixture f(0, 8);
@@ -937,6 +1001,99 @@ TEST_CASE("nvs iterators tests", "[nvs]")
     TEST_ESP_OK(nvs_flash_deinit_partition(NVS_DEFAULT_PART_NAME));
 }
 
+TEST_CASE("nvs_entry_find_prefix returns entries whose key starts with the prefix", "[nvs][ordered_index]")
+{
+    const size_t pageCount = 8;
+    PartitionEmulationFixture f(0, pageCount);
+    const char* partName = f.part()->get_partition_name();
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, pageCount));
+
+    nvs_iterator_t it = nullptr;
+    CHECK(nvs_entry_find_prefix(partName, nullptr, nullptr, NVS_TYPE_ANY, &it) == ESP_ERR_INVALID_ARG);
+    CHECK(nvs_entry_find_prefix(partName, nullptr, "prefix_is_too_long", NVS_TYPE_ANY, &it) == ESP_ERR_NVS_KEY_TOO_LONG);
+    CHECK(it == nullptr);
+
+    nvs_handle_t handle_1;
+    nvs_handle_t handle_2;
+    TEST_ESP_OK(nvs_open("ns1", NVS_READWRITE, &handle_1));
+    TEST_ESP_OK(nvs_open("ns2", NVS_READWRITE, &handle_2));
+    char key[16];
+    // written in descending order, overwritten repeatedly to have pages garbage collected
+    for (int round = 0; round < 4; ++round) {
+        for (int i = 99; i >= 0; --i) {
+            snprintf(key, sizeof(key), "net.%02d", i);
+            TEST_ESP_OK(nvs_set_u32(handle_1, key, round));
+            snprintf(key, sizeof(key), "app.%02d", i);
+            TEST_ESP_OK(nvs_set_str(handle_1, key, "value"));
+        }
+    }
+    TEST_ESP_OK(nvs_set_u32(handle_1, "net", 1));
+    TEST_ESP_OK(nvs_set_u32(handle_1, "nes", 1));
+    TEST_ESP_OK(nvs_set_u32(handle_1, "neu", 1));
+    TEST_ESP_OK(nvs_set_u32(handle_2, "net.00", 1));
+    TEST_ESP_OK(nvs_erase_key(handle_1, "net.50"));
+
+    auto list = [&](const char* ns, const char* prefix, nvs_type_t type) -> std::vector<std::string> {
+        std::vector<std::string> keys;
+        nvs_iterator_t it = nullptr;
+        esp_err_t res = nvs_entry_find_prefix(partName, ns, prefix, type, &it);
+        while (res == ESP_OK) {
+            nvs_entry_info_t info;
+            TEST_ESP_OK(nvs_entry_info(it, &info));
+            CHECK(strncmp(info.key, prefix, strlen(prefix)) == 0);
+            keys.push_back(std::string(info.namespace_name) + "/" + info.key);
+            res = nvs_entry_next(&it);
+        }
+        CHECK(res == ESP_ERR_NVS_NOT_FOUND);
+        return keys;
+    };
+
+    for (int mount = 0; mount < 2; ++mount) {
+        auto keys = list("ns1", "net.", NVS_TYPE_ANY);
+        CHECK(keys.size() == 99);
+        CHECK(list("ns1", "net", NVS_TYPE_ANY).size() == 100);
+        CHECK(list("ns1", "net.", NVS_TYPE_STR).size() == 0);
+        CHECK(list("ns1", "app.", NVS_TYPE_STR).size() == 100);
+        CHECK(list("ns1", "", NVS_TYPE_ANY).size() == 202);
+        CHECK(list(nullptr, "net.0", NVS_TYPE_ANY).size() == 11);
+        CHECK(list(nullptr, "x", NVS_TYPE_ANY).size() == 0);
+        CHECK(nvs_entry_find_prefix(partName, "ns3", "", NVS_TYPE_ANY, &it) == ESP_ERR_NVS_NOT_FOUND);
+#ifdef CONFIG_NVS_ORDERED_INDEX
+        CHECK(std::is_sorted(keys.begin(), keys.end()));
+        CHECK(keys.front() == "ns1/net.00");
+        CHECK(keys.back() == "ns1/net.99");
+        auto all = list(nullptr, "net.0", NVS_TYPE_ANY);
+        CHECK(all.front() == "ns1/net.00");
+        CHECK(all.back() == "ns2/net.00");
+#endif
+        // the index is rebuilt when the partition is mounted again
+        nvs_close(handle_1);
+        nvs_close(handle_2);
+        TEST_ESP_OK(nvs_flash_deinit_partition(partName));
+        TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, pageCount));
+        TEST_ESP_OK(nvs_open("ns1", NVS_READWRITE, &handle_1));
+        TEST_ESP_OK(nvs_open("ns2", NVS_READWRITE, &handle_2));
+    }
+
+#ifdef CONFIG_NVS_ORDERED_INDEX
+    // keys written again while iterating are neither skipped nor repeated
+    size_t count = 0;
+    esp_err_t res = nvs_entry_find_prefix(partName, "ns1", "net.", NVS_TYPE_ANY, &it);
+    while (res == ESP_OK) {
+        nvs_entry_info_t info;
+        TEST_ESP_OK(nvs_entry_info(it, &info));
+        TEST_ESP_OK(nvs_set_u32(handle_1, info.key, 42));
+        ++count;
+        res = nvs_entry_next(&it);
+    }
+    CHECK(count == 99);
+#endif
+
+    nvs_close(handle_1);
+    nvs_close(handle_2);
+    TEST_ESP_OK(nvs_flash_deinit_partition(partName));
+}
+
 TEST_CASE("Iterator with not matching type iterates correctly", "[nvs]")
 {
     PartitionEmulationFixture f(0, 5);
@@ -3895,6 +4052,1007 @@ TEST_CASE("nvs find key tests", "[nvs]")
     nvs_close(handle_2);
     TEST_ESP_OK(nvs_flash_deinit_partition(NVS_DEFAULT_PART_NAME));
 }
+
+TEST_CASE("nvs transaction stages values until commit", "[nvs][transaction]")
+{
+    PartitionEmulationFixture f(0, 5);
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 5));
+
+    nvs_handle_t handle;
+    TEST_ESP_OK(nvs_open("test", NVS_READWRITE, &handle));
+    TEST_ESP_OK(nvs_set_u32(handle, "old", 1));
+    TEST_ESP_OK(nvs_set_str(handle, "str", "old value"));
+    const uint8_t oldBlob[nvs::Page::CHUNK_MAX_SIZE / 2] = {0x11};
+    TEST_ESP_OK(nvs_set_blob(handle, "blob", oldBlob, sizeof(oldBlob)));
+
+    TEST_ESP_ERR(nvs_transaction_commit(handle), ESP_ERR_INVALID_STATE);
+    TEST_ESP_ERR(nvs_transaction_abort(handle), ESP_ERR_INVALID_STATE);
+
+    TEST_ESP_OK(nvs_transaction_begin(handle));
+    TEST_ESP_ERR(nvs_transaction_begin(handle), ESP_ERR_INVALID_STATE);
+    TEST_ESP_OK(nvs_set_u32(handle, "old", 2));
+    TEST_ESP_OK(nvs_set_u32(handle, "old", 3));
+    TEST_ESP_OK(nvs_set_i8(handle, "new", -5));
+    TEST_ESP_OK(nvs_set_str(handle, "str", "new value"));
+    const uint8_t newBlob[100] = {0x22, 0x33};
+    TEST_ESP_OK(nvs_set_blob(handle, "blob", newBlob, sizeof(newBlob)));
+    TEST_ESP_ERR(nvs_set_u8(handle, "key_name_is_too_long", 1), ESP_ERR_NVS_KEY_TOO_LONG);
+    TEST_ESP_ERR(nvs_erase_key(handle, "old"), ESP_ERR_INVALID_STATE);
+    TEST_ESP_ERR(nvs_erase_all(handle), ESP_ERR_INVALID_STATE);
+
+    // nothing is visible before the commit
+    uint32_t u32;
+    int8_t i8;
+    TEST_ESP_OK(nvs_get_u32(handle, "old", &u32));
+    CHECK(u32 == 1);
+    TEST_ESP_ERR(nvs_get_i8(handle, "new", &i8), ESP_ERR_NVS_NOT_FOUND);
+
+    size_t usedBefore;
+    TEST_ESP_OK(nvs_get_used_entry_count(handle, &usedBefore));
+
+    esp_partition_clear_stats();
+    TEST_ESP_OK(nvs_transaction_commit(handle));
+    TEST_ESP_ERR(nvs_transaction_commit(handle), ESP_ERR_INVALID_STATE);
+
+    TEST_ESP_OK(nvs_get_u32(handle, "old", &u32));
+    CHECK(u32 == 3);
+    TEST_ESP_OK(nvs_get_i8(handle, "new", &i8));
+    CHECK(i8 == -5);
+    char str[16];
+    size_t len = sizeof(str);
+    TEST_ESP_OK(nvs_get_str(handle, "str", str, &len));
+    CHECK(strcmp(str, "new value") == 0);
+    uint8_t blob[sizeof(oldBlob)];
+    len = sizeof(blob);
+    TEST_ESP_OK(nvs_get_blob(handle, "blob", blob, &len));
+    CHECK(len == sizeof(newBlob));
+    CHECK(memcmp(blob, newBlob, sizeof(newBlob)) == 0);
+
+    // old values have been erased: one new u32, one new string entry and a smaller blob
+    size_t usedAfter;
+    TEST_ESP_OK(nvs_get_used_entry_count(handle, &usedAfter));
+    CHECK(usedAfter == usedBefore + 1 - (sizeof(oldBlob) - sizeof(newBlob)) / nvs::Page::ENTRY_SIZE);
+
+    // aborted values are dropped
+    TEST_ESP_OK(nvs_transaction_begin(handle));
+    TEST_ESP_OK(nvs_set_u32(handle, "old", 4));
+    TEST_ESP_OK(nvs_set_u32(handle, "aborted", 4));
+    TEST_ESP_OK(nvs_transaction_abort(handle));
+    TEST_ESP_OK(nvs_get_u32(handle, "old", &u32));
+    CHECK(u32 == 3);
+    TEST_ESP_ERR(nvs_get_u32(handle, "aborted", &u32), ESP_ERR_NVS_NOT_FOUND);
+
+    // unchanged values are not written again
+    TEST_ESP_OK(nvs_transaction_begin(handle));
+    TEST_ESP_OK(nvs_set_u32(handle, "old", 3));
+    TEST_ESP_OK(nvs_set_str(handle, "str", "new value"));
+    esp_partition_clear_stats();
+    TEST_ESP_OK(nvs_transaction_commit(handle));
+    CHECK(esp_partition_get_write_ops() == 0);
+
+    // everything is still there after re-initialization
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_deinit_partition(f.part()->get_partition_name()));
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 5));
+    TEST_ESP_OK(nvs_open("test", NVS_READWRITE, &handle));
+    TEST_ESP_OK(nvs_get_u32(handle, "old", &u32));
+    CHECK(u32 == 3);
+    TEST_ESP_OK(nvs_get_i8(handle, "new", &i8));
+    CHECK(i8 == -5);
+    len = sizeof(blob);
+    TEST_ESP_OK(nvs_get_blob(handle, "blob", blob, &len));
+    CHECK(memcmp(blob, newBlob, sizeof(newBlob)) == 0);
+    nvs_close(handle);
+
+    TEST_ESP_OK(nvs_open("test", NVS_READONLY, &handle));
+    TEST_ESP_ERR(nvs_transaction_begin(handle), ESP_ERR_NVS_READ_ONLY);
+    nvs_close(handle);
+
+    TEST_ESP_OK(nvs_flash_deinit_partition(f.part()->get_partition_name()));
+}
+
+TEST_CASE("nvs transaction which does not fit into one page is rejected", "[nvs][transaction]")
+{
+    PartitionEmulationFixture f(0, 5);
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 5));
+
+    nvs_handle_t handle;
+    TEST_ESP_OK(nvs_open("test", NVS_READWRITE, &handle));
+    TEST_ESP_OK(nvs_set_u8(handle, "first", 1));
+
+    const uint8_t blob[nvs::Page::CHUNK_MAX_SIZE / 2] = {0};
+    TEST_ESP_OK(nvs_transaction_begin(handle));
+    TEST_ESP_OK(nvs_set_blob(handle, "blob1", blob, sizeof(blob)));
+    TEST_ESP_OK(nvs_set_blob(handle, "blob2", blob, sizeof(blob)));
+    TEST_ESP_OK(nvs_set_u8(handle, "first", 2));
+    TEST_ESP_ERR(nvs_transaction_commit(handle), ESP_ERR_NVS_NOT_ENOUGH_SPACE);
+
+    uint8_t u8;
+    TEST_ESP_OK(nvs_get_u8(handle, "first", &u8));
+    CHECK(u8 == 1);
+    size_t len = sizeof(blob);
+    TEST_ESP_ERR(nvs_get_blob(handle, "blob1", nullptr, &len), ESP_ERR_NVS_NOT_FOUND);
+
+    // the transaction has ended, so further writes go to flash directly
+    TEST_ESP_OK(nvs_set_u8(handle, "first", 3));
+    TEST_ESP_OK(nvs_get_u8(handle, "first", &u8));
+    CHECK(u8 == 3);
+
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_deinit_partition(f.part()->get_partition_name()));
+}
+
+TEST_CASE("Recovery from power-off during transaction commit", "[nvs][transaction]")
+{
+    const size_t keyCount = 20;
+    char key[16];
+    char filler[(nvs::Page::ENTRY_COUNT - keyCount - 16) * nvs::Page::ENTRY_SIZE];
+    memset(filler, 'x', sizeof(filler) - 1);
+    filler[sizeof(filler) - 1] = 0;
+
+    bool committed = false;
+    for (size_t errDelay = 0; !committed; ++errDelay) {
+        INFO(errDelay);
+        PartitionEmulationFixture f(0, 4);
+        TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 4));
+
+        // old values share the first page with a long string, so that the new values
+        // are written to the next page and the old ones are erased from a different page
+        nvs_handle_t handle;
+        TEST_ESP_OK(nvs_open("test", NVS_READWRITE, &handle));
+        for (size_t i = 0; i < keyCount; ++i) {
+            snprintf(key, sizeof(key), "key%u", static_cast<unsigned>(i));
+            TEST_ESP_OK(nvs_set_u32(handle, key, i));
+        }
+        TEST_ESP_OK(nvs_set_str(handle, "filler", filler));
+
+        TEST_ESP_OK(nvs_transaction_begin(handle));
+        for (size_t i = 0; i < keyCount; ++i) {
+            snprintf(key, sizeof(key), "key%u", static_cast<unsigned>(i));
+            TEST_ESP_OK(nvs_set_u32(handle, key, i + 1000));
+        }
+        TEST_ESP_OK(nvs_set_str(handle, "new", "value"));
+
+        esp_partition_fail_after(errDelay, ESP_PARTITION_FAIL_AFTER_MODE_BOTH);
+        esp_err_t err = nvs_transaction_commit(handle);
+        esp_partition_fail_after(SIZE_MAX, ESP_PARTITION_FAIL_AFTER_MODE_BOTH);
+        committed = (err == ESP_OK);
+        nvs_close(handle);
+        TEST_ESP_OK(nvs_flash_deinit_partition(f.part()->get_partition_name()));
+
+        TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 4));
+        TEST_ESP_OK(nvs_open("test", NVS_READWRITE, &handle));
+
+        // either all keys hold their new value or all of them the old one
+        char str[8];
+        size_t len = sizeof(str);
+        const bool isNew = (nvs_get_str(handle, "new", str, &len) == ESP_OK);
+        CHECK((!committed || isNew));
+        for (size_t i = 0; i < keyCount; ++i) {
+            snprintf(key, sizeof(key), "key%u", static_cast<unsigned>(i));
+            uint32_t value;
+            TEST_ESP_OK(nvs_get_u32(handle, key, &value));
+            CHECK(value == (isNew ? i + 1000 : i));
+        }
+
+        // no stale copies of the old values are left behind
+        size_t used;
+        TEST_ESP_OK(nvs_get_used_entry_count(handle, &used));
+        CHECK(used == keyCount + nvs::Page::getItemEntryCount(nvs::ItemType::SZ, sizeof(filler))
+              + (isNew ? nvs::Page::getItemEntryCount(nvs::ItemType::SZ, sizeof("value")) : 0));
+
+        // the partition is still writable
+        TEST_ESP_OK(nvs_set_u32(handle, "key0", 42));
+        nvs_close(handle);
+        TEST_ESP_OK(nvs_flash_deinit_partition(f.part()->get_partition_name()));
+    }
+}
+
+#ifdef CONFIG_NVS_GC_STEP
+static void gc_test_write(nvs_handle_t handle, size_t i, size_t keyCount, char* filler, size_t fillerSize)
+{
+    char key[16];
+    snprintf(key, sizeof(key), "key%u", static_cast<unsigned>(i % keyCount));
+    TEST_ESP_OK(nvs_set_u32(handle, key, i));
+    snprintf(filler, fillerSize, "%u", static_cast<unsigned>(i));
+    filler[strlen(filler)] = 'x';
+    TEST_ESP_OK(nvs_set_str(handle, "filler", filler));
+}
+
+static void gc_test_check(nvs_handle_t handle, size_t writes, size_t keyCount, const char* filler, size_t fillerSize)
+{
+    char key[16];
+    for (size_t i = (writes > keyCount) ? writes - keyCount : 0; i < writes; ++i) {
+        snprintf(key, sizeof(key), "key%u", static_cast<unsigned>(i % keyCount));
+        uint32_t value;
+        TEST_ESP_OK(nvs_get_u32(handle, key, &value));
+        CHECK(value == i);
+    }
+    std::string str(fillerSize, '\0');
+    size_t len = fillerSize;
+    TEST_ESP_OK(nvs_get_str(handle, "filler", &str[0], &len));
+    CHECK(strcmp(str.c_str(), filler) == 0);
+}
+
+TEST_CASE("nvs_gc_step keeps free pages so that writes don't erase pages", "[nvs][gc]")
+{
+    const size_t keyCount = 20;
+    const size_t writeCount = 200;
+    char filler[40 * nvs::Page::ENTRY_SIZE];
+    memset(filler, 'x', sizeof(filler) - 1);
+    filler[sizeof(filler) - 1] = 0;
+
+    PartitionEmulationFixture f(0, 4);
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 4));
+    nvs_handle_t handle;
+    TEST_ESP_OK(nvs_open("test", NVS_READWRITE, &handle));
+
+    size_t gcErases = 0;
+    for (size_t i = 0; i < writeCount; ++i) {
+        esp_partition_clear_stats();
+        gc_test_write(handle, i, keyCount, filler, sizeof(filler));
+        CHECK(esp_partition_get_erase_ops() == 0);
+
+        esp_partition_clear_stats();
+        esp_err_t err;
+        while ((err = nvs_gc_step(f.part()->get_partition_name(), 0)) == ESP_ERR_NOT_FINISHED) {
+        }
+        CHECK(err == ESP_OK);
+        gcErases += esp_partition_get_erase_ops();
+    }
+    CHECK(gcErases > 0);
+    gc_test_check(handle, writeCount, keyCount, filler, sizeof(filler));
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_deinit_partition(f.part()->get_partition_name()));
+
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 4));
+    TEST_ESP_OK(nvs_open("test", NVS_READONLY, &handle));
+    gc_test_check(handle, writeCount, keyCount, filler, sizeof(filler));
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_deinit_partition(f.part()->get_partition_name()));
+}
+
+TEST_CASE("Recovery from power-off during nvs_gc_step", "[nvs][gc]")
+{
+    const size_t keyCount = 20;
+    const size_t writeCount = 25;
+    char filler[40 * nvs::Page::ENTRY_SIZE];
+    memset(filler, 'x', sizeof(filler) - 1);
+    filler[sizeof(filler) - 1] = 0;
+
+    bool done = false;
+    for (size_t errDelay = 0; !done; ++errDelay) {
+        INFO(errDelay);
+        PartitionEmulationFixture f(0, 4);
+        TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 4));
+        nvs_handle_t handle;
+        TEST_ESP_OK(nvs_open("test", NVS_READWRITE, &handle));
+        for (size_t i = 0; i < writeCount; ++i) {
+            gc_test_write(handle, i, keyCount, filler, sizeof(filler));
+        }
+
+        esp_partition_fail_after(errDelay, ESP_PARTITION_FAIL_AFTER_MODE_BOTH);
+        esp_err_t err = nvs_gc_step(f.part()->get_partition_name(), 0);
+        esp_partition_fail_after(SIZE_MAX, ESP_PARTITION_FAIL_AFTER_MODE_BOTH);
+        done = (err == ESP_OK || err == ESP_ERR_NOT_FINISHED);
+        nvs_close(handle);
+        TEST_ESP_OK(nvs_flash_deinit_partition(f.part()->get_partition_name()));
+
+        TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 4));
+        TEST_ESP_OK(nvs_open("test", NVS_READWRITE, &handle));
+        gc_test_check(handle, writeCount, keyCount, filler, sizeof(filler));
+
+        // no stale copies are left behind
+        size_t used;
+        TEST_ESP_OK(nvs_get_used_entry_count(handle, &used));
+        CHECK(used == keyCount + nvs::Page::getItemEntryCount(nvs::ItemType::SZ, sizeof(filler)));
+
+        // the partition is still writable
+        for (size_t i = writeCount; i < writeCount + 10; ++i) {
+            gc_test_write(handle, i, keyCount, filler, sizeof(filler));
+        }
+        gc_test_check(handle, writeCount + 10, keyCount, filler, sizeof(filler));
+        nvs_close(handle);
+        TEST_ESP_OK(nvs_flash_deinit_partition(f.part()->get_partition_name()));
+    }
+}
+#else
+TEST_CASE("nvs_gc_step is not supported unless enabled", "[nvs][gc]")
+{
+    PartitionEmulationFixture f(0, 4);
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 4));
+    CHECK(nvs_gc_step(f.part()->get_partition_name(), 0) == ESP_ERR_NOT_SUPPORTED);
+    TEST_ESP_OK(nvs_flash_deinit_partition(f.part()->get_partition_name()));
+}
+#endif // CONFIG_NVS_GC_STEP
+
+static void blob_stream_write(nvs_handle_t handle, const char* key, const uint8_t* data, size_t size, size_t pieceSize)
+{
+    nvs_blob_handle_t blob;
+    TEST_ESP_OK(nvs_blob_open(handle, key, NVS_READWRITE, &blob));
+    for (size_t offset = 0; offset < size; offset += pieceSize) {
+        TEST_ESP_OK(nvs_blob_write_chunk(blob, data + offset, std::min(pieceSize, size - offset)));
+    }
+    TEST_ESP_OK(nvs_blob_close(blob));
+}
+
+static void blob_stream_check(nvs_handle_t handle, const char* key, const uint8_t* data, size_t size, size_t pieceSize)
+{
+    std::unique_ptr<uint8_t[]> piece(new uint8_t[pieceSize]);
+    nvs_blob_handle_t blob;
+    TEST_ESP_OK(nvs_blob_open(handle, key, NVS_READONLY, &blob));
+    size_t offset = 0;
+    while (true) {
+        size_t length = pieceSize;
+        TEST_ESP_OK(nvs_blob_read_chunk(blob, piece.get(), &length));
+        if (length == 0) {
+            break;
+        }
+        REQUIRE(offset + length <= size);
+        CHECK(memcmp(piece.get(), data + offset, length) == 0);
+        offset += length;
+    }
+    CHECK(offset == size);
+    TEST_ESP_OK(nvs_blob_close(blob));
+
+    std::unique_ptr<uint8_t[]> whole(new uint8_t[size]);
+    size_t length = size;
+    TEST_ESP_OK(nvs_get_blob(handle, key, whole.get(), &length));
+    CHECK(length == size);
+    CHECK(memcmp(whole.get(), data, size) == 0);
+}
+
+TEST_CASE("nvs blob stream writes and reads multi-page blobs piecewise", "[nvs][blob_stream]")
+{
+    const size_t size = 5 * nvs::Page::CHUNK_MAX_SIZE + 123;
+    std::unique_ptr<uint8_t[]> data(new uint8_t[size]);
+    std::unique_ptr<uint8_t[]> data2(new uint8_t[size]);
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<uint8_t>(i * 7);
+        data2[i] = static_cast<uint8_t>(i * 13 + 1);
+    }
+
+    PartitionEmulationFixture f(0, 16);
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 16));
+    nvs_handle_t handle;
+    TEST_ESP_OK(nvs_open("test", NVS_READWRITE, &handle));
+    TEST_ESP_OK(nvs_set_u32(handle, "other", 42));
+    size_t usedBefore;
+    TEST_ESP_OK(nvs_get_used_entry_count(handle, &usedBefore));
+
+    blob_stream_write(handle, "blob", data.get(), size, 1000);
+    blob_stream_check(handle, "blob", data.get(), size, 333);
+
+    // a new version replaces the old one, which is erased when the stream is closed
+    blob_stream_write(handle, "blob", data2.get(), size - 5000, 4096);
+    blob_stream_check(handle, "blob", data2.get(), size - 5000, 5000);
+
+    // an empty blob
+    blob_stream_write(handle, "empty", data.get(), 0, 1);
+    blob_stream_check(handle, "empty", data.get(), 0, 1);
+
+    // values set with nvs_set_blob can be streamed and vice versa
+    TEST_ESP_OK(nvs_set_blob(handle, "blob", data.get(), 3000));
+    blob_stream_check(handle, "blob", data.get(), 3000, 64);
+
+    TEST_ESP_OK(nvs_erase_key(handle, "blob"));
+    TEST_ESP_OK(nvs_erase_key(handle, "empty"));
+    size_t used;
+    TEST_ESP_OK(nvs_get_used_entry_count(handle, &used));
+    CHECK(used == usedBefore);
+
+    nvs_blob_handle_t blob;
+    CHECK(nvs_blob_open(handle, "blob", NVS_READONLY, &blob) == ESP_ERR_NVS_NOT_FOUND);
+    CHECK(nvs_blob_open(handle, "key_name_is_too_long", NVS_READWRITE, &blob) == ESP_ERR_NVS_KEY_TOO_LONG);
+    nvs_close(handle);
+
+    TEST_ESP_OK(nvs_open("test", NVS_READONLY, &handle));
+    CHECK(nvs_blob_open(handle, "blob", NVS_READWRITE, &blob) == ESP_ERR_NVS_READ_ONLY);
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_deinit_partition(f.part()->get_partition_name()));
+}
+
+TEST_CASE("nvs blob stream keeps the old value unless closed successfully", "[nvs][blob_stream]")
+{
+    const size_t size = 3 * nvs::Page::CHUNK_MAX_SIZE;
+    std::unique_ptr<uint8_t[]> data(new uint8_t[size]);
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<uint8_t>(i * 7);
+    }
+
+    PartitionEmulationFixture f(0, 5);
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 5));
+    nvs_handle_t handle;
+    TEST_ESP_OK(nvs_open("test", NVS_READWRITE, &handle));
+    TEST_ESP_OK(nvs_set_blob(handle, "blob", data.get(), 100));
+    size_t usedBefore;
+    TEST_ESP_OK(nvs_get_used_entry_count(handle, &usedBefore));
+
+    // the partition is too small for another copy of the blob
+    nvs_blob_handle_t blob;
+    TEST_ESP_OK(nvs_blob_open(handle, "blob", NVS_READWRITE, &blob));
+    esp_err_t err = ESP_OK;
+    for (size_t i = 0; i < 4 && err == ESP_OK; ++i) {
+        err = nvs_blob_write_chunk(blob, data.get(), size);
+    }
+    CHECK(err == ESP_ERR_NVS_VALUE_TOO_LONG);
+    CHECK(nvs_blob_write_chunk(blob, data.get(), 1) == ESP_ERR_NVS_VALUE_TOO_LONG);
+    CHECK(nvs_blob_close(blob) == ESP_ERR_NVS_VALUE_TOO_LONG);
+    blob_stream_check(handle, "blob", data.get(), 100, 100);
+    size_t used;
+    TEST_ESP_OK(nvs_get_used_entry_count(handle, &used));
+    CHECK(used == usedBefore);
+
+    // a stream which is not closed before the partition is deinitialized
+    TEST_ESP_OK(nvs_blob_open(handle, "blob", NVS_READWRITE, &blob));
+    TEST_ESP_OK(nvs_blob_write_chunk(blob, data.get() + 1, size));
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_deinit_partition(f.part()->get_partition_name()));
+    CHECK(nvs_blob_close(blob) == ESP_ERR_NVS_INVALID_HANDLE);
+
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 5));
+    TEST_ESP_OK(nvs_open("test", NVS_READWRITE, &handle));
+    blob_stream_check(handle, "blob", data.get(), 100, 100);
+    TEST_ESP_OK(nvs_get_used_entry_count(handle, &used));
+    CHECK(used == usedBefore);
+
+    // the partition is still writable
+    blob_stream_write(handle, "blob", data.get(), size, 2048);
+    blob_stream_check(handle, "blob", data.get(), size, 2048);
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_deinit_partition(f.part()->get_partition_name()));
+}
+
+TEST_CASE("nvs_get_ram_usage reports RAM used by the partition", "[nvs][ram_usage]")
+{
+    const size_t keyCount = 100;
+    char key[16];
+    PartitionEmulationFixture f(0, 4);
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 4));
+
+    nvs_ram_usage_t before;
+    TEST_ESP_OK(nvs_get_ram_usage(f.part()->get_partition_name(), &before));
+    CHECK(before.page_count == 4);
+    CHECK(before.pages == 4 * sizeof(nvs::Page));
+
+    nvs_handle_t handle;
+    TEST_ESP_OK(nvs_open("test", NVS_READWRITE, &handle));
+    for (size_t i = 0; i < keyCount; ++i) {
+        snprintf(key, sizeof(key), "key%u", static_cast<unsigned>(i));
+        TEST_ESP_OK(nvs_set_u32(handle, key, i));
+    }
+
+    nvs_ram_usage_t usage;
+    TEST_ESP_OK(nvs_get_ram_usage(f.part()->get_partition_name(), &usage));
+    CHECK(usage.hash_lists >= before.hash_lists + keyCount * 4);
+    CHECK(usage.namespaces > before.namespaces);
+    CHECK(usage.total == usage.pages + usage.hash_lists + usage.key_index + usage.ordered_index + usage.namespaces);
+#ifdef CONFIG_NVS_GLOBAL_KEY_INDEX
+    CHECK(usage.key_index > before.key_index);
+#else
+    CHECK(usage.key_index == 0);
+#endif
+
+    for (size_t i = 0; i < keyCount; ++i) {
+        snprintf(key, sizeof(key), "key%u", static_cast<unsigned>(i));
+        TEST_ESP_OK(nvs_erase_key(handle, key));
+    }
+    // the lists shrink, only the namespace entry is left
+    const size_t hashListsBeforeErase = usage.hash_lists;
+    TEST_ESP_OK(nvs_get_ram_usage(f.part()->get_partition_name(), &usage));
+    CHECK(usage.hash_lists <= hashListsBeforeErase / 4);
+
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_deinit_partition(f.part()->get_partition_name()));
+    CHECK(nvs_get_ram_usage(f.part()->get_partition_name(), &usage) == ESP_ERR_NVS_NOT_INITIALIZED);
+}
+
+TEST_CASE("nvs fast mount skips reading items only while the snapshot is current", "[nvs][fast_mount]")
+{
+    const size_t pageCount = 8;
+    const size_t keyCount = 300;
+    char key[16];
+    PartitionEmulationFixture f(0, pageCount);
+    const char* partName = f.part()->get_partition_name();
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, pageCount));
+
+    nvs_handle_t handle;
+    TEST_ESP_OK(nvs_open("ns1", NVS_READWRITE, &handle));
+    for (size_t i = 0; i < keyCount; ++i) {
+        snprintf(key, sizeof(key), "key%u", static_cast<unsigned>(i));
+        TEST_ESP_OK(nvs_set_u32(handle, key, i));
+    }
+    std::string blob(3 * nvs::Page::CHUNK_MAX_SIZE, 'b');
+    TEST_ESP_OK(nvs_set_blob(handle, "blob", blob.data(), blob.size()));
+    nvs_close(handle);
+
+#ifndef CONFIG_NVS_FAST_MOUNT
+    CHECK(nvs_flash_write_snapshot_partition(partName) == ESP_ERR_NOT_SUPPORTED);
+    TEST_ESP_OK(nvs_flash_deinit_partition(partName));
+#else
+    // a full mount reads all items, a mount with a current snapshot only the page headers and entry tables
+    TEST_ESP_OK(nvs_flash_deinit_partition(partName));
+    esp_partition_clear_stats();
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, pageCount));
+    const size_t fullMountReadBytes = esp_partition_get_read_bytes();
+    TEST_ESP_OK(nvs_flash_write_snapshot_partition(partName));
+    TEST_ESP_OK(nvs_flash_deinit_partition(partName));
+
+    esp_partition_clear_stats();
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, pageCount));
+    CHECK(esp_partition_get_read_bytes() < fullMountReadBytes / 4);
+
+    // items of full pages are read when needed
+    TEST_ESP_OK(nvs_open("ns1", NVS_READWRITE, &handle));
+    for (size_t i = 0; i < keyCount; ++i) {
+        uint32_t value;
+        snprintf(key, sizeof(key), "key%u", static_cast<unsigned>(i));
+        TEST_ESP_OK(nvs_get_u32(handle, key, &value));
+        CHECK(value == i);
+    }
+    std::string readBlob(blob.size(), 0);
+    size_t size = readBlob.size();
+    TEST_ESP_OK(nvs_get_blob(handle, "blob", &readBlob[0], &size));
+    CHECK(readBlob == blob);
+
+    // nothing is written while the snapshot is current
+    esp_partition_clear_stats();
+    TEST_ESP_OK(nvs_flash_write_snapshot_partition(partName));
+    CHECK(esp_partition_get_write_ops() == 0);
+
+    // a stream which is not closed leaves chunks behind, which have to be removed by a full mount
+    size_t usedBefore;
+    TEST_ESP_OK(nvs_get_used_entry_count(handle, &usedBefore));
+    nvs_blob_handle_t stream;
+    TEST_ESP_OK(nvs_blob_open(handle, "blob", NVS_READWRITE, &stream));
+    TEST_ESP_OK(nvs_blob_write_chunk(stream, blob.data(), 2 * nvs::Page::CHUNK_MAX_SIZE));
+    CHECK(nvs_flash_write_snapshot_partition(partName) == ESP_ERR_NVS_INVALID_STATE);
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_deinit_partition(partName));
+    nvs_blob_close(stream);
+
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, pageCount));
+    TEST_ESP_OK(nvs_open("ns1", NVS_READWRITE, &handle));
+    size_t used;
+    TEST_ESP_OK(nvs_get_used_entry_count(handle, &used));
+    CHECK(used == usedBefore);
+
+    // changes made after the snapshot was written, without a clean shutdown, make it outdated
+    TEST_ESP_OK(nvs_flash_write_snapshot_partition(partName));
+    TEST_ESP_OK(nvs_erase_key(handle, "key0"));
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_open("ns2", NVS_READWRITE, &handle));
+    TEST_ESP_OK(nvs_set_u32(handle, "key", 2));
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_deinit_partition(partName));
+
+    esp_partition_clear_stats();
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, pageCount));
+    CHECK(esp_partition_get_read_bytes() >= fullMountReadBytes / 2);
+    uint32_t value;
+    TEST_ESP_OK(nvs_open("ns2", NVS_READONLY, &handle));
+    TEST_ESP_OK(nvs_get_u32(handle, "key", &value));
+    CHECK(value == 2);
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_open("ns1", NVS_READONLY, &handle));
+    CHECK(nvs_get_u32(handle, "key0", &value) == ESP_ERR_NVS_NOT_FOUND);
+    TEST_ESP_OK(nvs_get_u32(handle, "key1", &value));
+    CHECK(value == 1);
+    nvs_close(handle);
+    TEST_ESP_OK(nvs_flash_write_snapshot_partition(partName));
+    TEST_ESP_OK(nvs_flash_deinit_partition(partName));
+
+    // the namespaces are taken from the snapshot, which itself is not listed as an entry
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, pageCount));
+    nvs_stats_t stats;
+    TEST_ESP_OK(nvs_get_stats(partName, &stats));
+    CHECK(stats.namespace_count == 2);
+    nvs_iterator_t it = nullptr;
+    size_t entries = 0;
+    esp_err_t res = nvs_entry_find(partName, nullptr, NVS_TYPE_ANY, &it);
+    while (res == ESP_OK) {
+        ++entries;
+        res = nvs_entry_next(&it);
+    }
+    nvs_release_iterator(it);
+    CHECK(entries == keyCount + 1);
+    TEST_ESP_OK(nvs_flash_deinit_partition(partName));
+#endif
+}
+
+TEST_CASE("benchmark batched writes vs. individual writes", "[nvs][benchmark]")
+{
+    const size_t keyCount = 50;
+    char key[16];
+
+    for (bool batched : {false, true}) {
+        PartitionEmulationFixture f(0, 8);
+        TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 8));
+        nvs_handle_t handle;
+        TEST_ESP_OK(nvs_open("calib", NVS_READWRITE, &handle));
+
+        esp_partition_clear_stats();
+        auto start = std::chrono::steady_clock::now();
+        if (batched) {
+            TEST_ESP_OK(nvs_transaction_begin(handle));
+        }
+        for (size_t i = 0; i < keyCount; ++i) {
+            snprintf(key, sizeof(key), "cal%u", static_cast<unsigned>(i));
+            TEST_ESP_OK(nvs_set_u32(handle, key, i * 3));
+        }
+        if (batched) {
+            TEST_ESP_OK(nvs_transaction_commit(handle));
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+        const size_t writeOps = esp_partition_get_write_ops();
+        if (batched) {
+            CHECK(writeOps < keyCount);
+        }
+        s_perf << "Write " << keyCount << " u32 keys " << (batched ? "in one transaction" : "one by one") << ": "
+               << writeOps << " flash write ops, "
+               << esp_partition_get_total_time() << " us emulated flash time, "
+               << elapsed.count() << " us wall time" << std::endl;
+
+        for (size_t i = 0; i < keyCount; ++i) {
+            snprintf(key, sizeof(key), "cal%u", static_cast<unsigned>(i));
+            uint32_t value;
+            TEST_ESP_OK(nvs_get_u32(handle, key, &value));
+            CHECK(value == i * 3);
+        }
+        nvs_close(handle);
+        TEST_ESP_OK(nvs_flash_deinit_partition(f.part()->get_partition_name()));
+    }
+}
+
+#ifdef CONFIG_NVS_CONCURRENT_READS
+TEST_CASE("benchmark concurrent reads under write load", "[nvs][concurrency][benchmark]")
+{
+    const size_t readKeyCount = 100;
+    const size_t writeKeyCount = 50;
+    const auto duration = std::chrono::milliseconds(200);
+
+    for (size_t readerCount : {1, 2, 4}) {
+        PartitionEmulationFixture f(0, 8);
+        TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 8));
+        nvs_handle_t handle;
+        TEST_ESP_OK(nvs_open("test", NVS_READWRITE, &handle));
+        char key[16];
+        for (size_t i = 0; i < readKeyCount; ++i) {
+            snprintf(key, sizeof(key), "r%u", static_cast<unsigned>(i));
+            TEST_ESP_OK(nvs_set_u32(handle, key, i * 7));
+        }
+
+        // Catch2 assertions are not thread safe, so the threads only count their results
+        std::atomic<bool> stop(false);
+        std::atomic<size_t> reads(0);
+        std::atomic<size_t> readErrors(0);
+        std::atomic<size_t> writes(0);
+        std::atomic<size_t> writeErrors(0);
+
+        // the writer keeps overwriting its own keys, which regularly triggers page garbage collection
+        std::thread writer([&]() {
+            char wkey[16];
+            for (uint32_t n = 0; !stop; ++n) {
+                snprintf(wkey, sizeof(wkey), "w%u", static_cast<unsigned>(n % writeKeyCount));
+                if (nvs_set_u32(handle, wkey, n) != ESP_OK) {
+                    ++writeErrors;
+                }
+                ++writes;
+            }
+        });
+
+        std::vector<std::thread> readers;
+        for (size_t r = 0; r < readerCount; ++r) {
+            readers.emplace_back([&, r]() {
+                char rkey[16];
+                size_t count = 0;
+                for (size_t i = r; !stop; i = (i + 1) % readKeyCount, ++count) {
+                    snprintf(rkey, sizeof(rkey), "r%u", static_cast<unsigned>(i));
+                    uint32_t value;
+                    if (nvs_get_u32(handle, rkey, &value) != ESP_OK || value != i * 7) {
+                        ++readErrors;
+                    }
+                }
+                reads += count;
+            });
+        }
+
+        std::this_thread::sleep_for(duration);
+        stop = true;
+        writer.join();
+        for (auto& reader : readers) {
+            reader.join();
+        }
+
+        CHECK(readErrors == 0);
+        CHECK(writeErrors == 0);
+        CHECK(reads > 0);
+        s_perf << "Concurrent reads, " << readerCount << " reader(s) + 1 writer: "
+               << reads * 1000 / duration.count() << " reads/s, "
+               << writes * 1000 / duration.count() << " writes/s" << std::endl;
+
+        nvs_close(handle);
+        TEST_ESP_OK(nvs_flash_deinit_partition(f.part()->get_partition_name()));
+    }
+}
+#endif // CONFIG_NVS_CONCURRENT_READS
+
+#ifdef CONFIG_NVS_GC_STEP
+TEST_CASE("benchmark write latency with and without nvs_gc_step", "[nvs][gc][benchmark]")
+{
+    const size_t keyCount = 20;
+    const size_t writeCount = 500;
+    char filler[40 * nvs::Page::ENTRY_SIZE];
+    memset(filler, 'x', sizeof(filler) - 1);
+    filler[sizeof(filler) - 1] = 0;
+
+    for (bool gc : {false, true}) {
+        PartitionEmulationFixture f(0, 4);
+        TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 4));
+        nvs_handle_t handle;
+        TEST_ESP_OK(nvs_open("test", NVS_READWRITE, &handle));
+
+        size_t writeErases = 0;
+        size_t maxWriteTime = 0;
+        size_t totalTime = 0;
+        for (size_t i = 0; i < writeCount; ++i) {
+            esp_partition_clear_stats();
+            gc_test_write(handle, i, keyCount, filler, sizeof(filler));
+            writeErases += esp_partition_get_erase_ops();
+            maxWriteTime = std::max(maxWriteTime, esp_partition_get_total_time());
+            totalTime += esp_partition_get_total_time();
+
+            if (gc) {
+                esp_partition_clear_stats();
+                while (nvs_gc_step(f.part()->get_partition_name(), 0) == ESP_ERR_NOT_FINISHED) {
+                }
+                totalTime += esp_partition_get_total_time();
+            }
+        }
+        if (gc) {
+            CHECK(writeErases == 0);
+        }
+        s_perf << "Write " << writeCount << " u32 keys and strings " << (gc ? "with" : "without")
+               << " nvs_gc_step() in between: " << writeErases << " page erases by writes, "
+               << maxWriteTime << " us max emulated flash time per write, "
+               << totalTime << " us total emulated flash time" << std::endl;
+
+        gc_test_check(handle, writeCount, keyCount, filler, sizeof(filler));
+        nvs_close(handle);
+        TEST_ESP_OK(nvs_flash_deinit_partition(f.part()->get_partition_name()));
+    }
+}
+#endif // CONFIG_NVS_GC_STEP
+
+TEST_CASE("benchmark streamed blob writes vs. nvs_set_blob", "[nvs][blob_stream][benchmark]")
+{
+    const size_t size = 200 * 1024;
+    const size_t pieceSize = 1024;
+    std::unique_ptr<uint8_t[]> data(new uint8_t[size]);
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<uint8_t>(i * 7);
+    }
+
+    for (bool streamed : {false, true}) {
+        PartitionEmulationFixture f(0, 64);
+        TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, 64));
+        nvs_handle_t handle;
+        TEST_ESP_OK(nvs_open("test", NVS_READWRITE, &handle));
+
+        esp_partition_clear_stats();
+        if (streamed) {
+            blob_stream_write(handle, "bundle", data.get(), size, pieceSize);
+        } else {
+            TEST_ESP_OK(nvs_set_blob(handle, "bundle", data.get(), size));
+        }
+        const size_t writeTime = esp_partition_get_total_time();
+
+        esp_partition_clear_stats();
+        if (streamed) {
+            std::unique_ptr<uint8_t[]> piece(new uint8_t[pieceSize]);
+            nvs_blob_handle_t blob;
+            TEST_ESP_OK(nvs_blob_open(handle, "bundle", NVS_READONLY, &blob));
+            size_t offset = 0;
+            size_t length = pieceSize;
+            while (nvs_blob_read_chunk(blob, piece.get(), &length) == ESP_OK && length != 0) {
+                CHECK(memcmp(piece.get(), data.get() + offset, length) == 0);
+                offset += length;
+            }
+            CHECK(offset == size);
+            TEST_ESP_OK(nvs_blob_close(blob));
+        } else {
+            std::unique_ptr<uint8_t[]> whole(new uint8_t[size]);
+            size_t length = size;
+            TEST_ESP_OK(nvs_get_blob(handle, "bundle", whole.get(), &length));
+            CHECK(memcmp(whole.get(), data.get(), size) == 0);
+        }
+        const size_t readTime = esp_partition_get_total_time();
+
+        const size_t bufferSize = streamed ? sizeof(nvs_opaque_blob_t) + pieceSize : size;
+        s_perf << "Write and read a " << size / 1024 << " kB blob " << (streamed ? "streamed in 1 kB pieces" : "at once")
+               << ": " << bufferSize << " bytes of buffers, "
+               << writeTime << " us emulated flash time for writing, "
+               << readTime << " us emulated flash time for reading" << std::endl;
+
+        nvs_close(handle);
+        TEST_ESP_OK(nvs_flash_deinit_partition(f.part()->get_partition_name()));
+    }
+}
+
+TEST_CASE("benchmark RAM used by hash lists", "[nvs][ram_usage][benchmark]")
+{
+    const size_t pageCount = 16;
+    char key[16];
+
+    // small values fill pages with many items, long strings leave few items per page
+    for (size_t stringLength : {0, 200}) {
+        PartitionEmulationFixture f(0, pageCount);
+        TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, pageCount));
+        nvs_handle_t handle;
+        TEST_ESP_OK(nvs_open("test", NVS_READWRITE, &handle));
+        std::string str(stringLength, 'x');
+        size_t items = 0;
+        nvs_stats_t stats;
+        do {
+            snprintf(key, sizeof(key), "key%u", static_cast<unsigned>(items++));
+            if (stringLength) {
+                TEST_ESP_OK(nvs_set_str(handle, key, str.c_str()));
+            } else {
+                TEST_ESP_OK(nvs_set_u32(handle, key, items));
+            }
+            TEST_ESP_OK(nvs_get_stats(f.part()->get_partition_name(), &stats));
+        } while (stats.available_entries > nvs::Page::ENTRY_COUNT);
+
+        nvs_ram_usage_t usage;
+        TEST_ESP_OK(nvs_get_ram_usage(f.part()->get_partition_name(), &usage));
+        s_perf << "RAM used by hash lists of " << pageCount << " pages holding " << items
+               << (stringLength ? " strings" : " u32 values")
+#ifdef CONFIG_NVS_COMPACT_HASH_LIST
+               << " (compact layout): "
+#else
+               << " (block layout): "
+#endif
+               << usage.hash_lists << " bytes, " << usage.hash_lists / pageCount << " bytes per page, "
+               << usage.total << " bytes in total" << std::endl;
+
+        nvs_close(handle);
+        TEST_ESP_OK(nvs_flash_deinit_partition(f.part()->get_partition_name()));
+    }
+}
+
+TEST_CASE("benchmark listing keys by prefix vs. listing the namespace", "[nvs][ordered_index][benchmark]")
+{
+    const size_t pageCount = 64;
+    const size_t groupCount = 16;
+    const size_t keysPerGroup = 200;
+    char key[16];
+    PartitionEmulationFixture f(0, pageCount);
+    const char* partName = f.part()->get_partition_name();
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, pageCount));
+    nvs_handle_t handle;
+    TEST_ESP_OK(nvs_open("config", NVS_READWRITE, &handle));
+    for (size_t i = 0; i < keysPerGroup; ++i) {
+        for (size_t group = 0; group < groupCount; ++group) {
+            snprintf(key, sizeof(key), "g%02u.%03u", static_cast<unsigned>(group), static_cast<unsigned>(i));
+            TEST_ESP_OK(nvs_set_u32(handle, key, i));
+        }
+    }
+    nvs_close(handle);
+
+    for (const char* prefix : {"", "g07."}) {
+        esp_partition_clear_stats();
+        nvs_iterator_t it = nullptr;
+        size_t count = 0;
+        esp_err_t res = nvs_entry_find_prefix(partName, "config", prefix, NVS_TYPE_ANY, &it);
+        while (res == ESP_OK) {
+            ++count;
+            res = nvs_entry_next(&it);
+        }
+        CHECK(count == (*prefix ? keysPerGroup : keysPerGroup * groupCount));
+
+        s_perf << "List " << count << " of " << keysPerGroup * groupCount << " keys"
+#ifdef CONFIG_NVS_ORDERED_INDEX
+               << " (ordered index): "
+#else
+               << " (page scan): "
+#endif
+               << esp_partition_get_total_time() << " us, " << esp_partition_get_read_bytes() << " bytes read"
+               << std::endl;
+    }
+    TEST_ESP_OK(nvs_flash_deinit_partition(partName));
+}
+
+#ifdef CONFIG_NVS_FAST_MOUNT
+TEST_CASE("benchmark mount time with and without a current snapshot", "[nvs][fast_mount][benchmark]")
+{
+    // 1 MB partition, nearly full
+    const size_t pageCount = 256;
+    char key[16];
+    PartitionEmulationFixture f(0, pageCount);
+    const char* partName = f.part()->get_partition_name();
+    TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, pageCount));
+    nvs_handle_t handle;
+    TEST_ESP_OK(nvs_open("test", NVS_READWRITE, &handle));
+    size_t items = 0;
+    nvs_stats_t stats;
+    do {
+        snprintf(key, sizeof(key), "key%u", static_cast<unsigned>(items++));
+        TEST_ESP_OK(nvs_set_u32(handle, key, items));
+        TEST_ESP_OK(nvs_get_stats(partName, &stats));
+    } while (stats.available_entries > nvs::Page::ENTRY_COUNT);
+    nvs_close(handle);
+
+    for (bool snapshot : {false, true}) {
+        if (snapshot) {
+            TEST_ESP_OK(nvs_flash_write_snapshot_partition(partName));
+        }
+        TEST_ESP_OK(nvs_flash_deinit_partition(partName));
+
+        esp_partition_clear_stats();
+        TEST_ESP_OK(nvs::NVSPartitionManager::get_instance()->init_custom(f.part(), 0, pageCount));
+        const size_t mountTime = esp_partition_get_total_time();
+        const size_t mountReadBytes = esp_partition_get_read_bytes();
+
+        // reading a key of each page loads the items of all pages
+        esp_partition_clear_stats();
+        TEST_ESP_OK(nvs_open("test", NVS_READONLY, &handle));
+        for (size_t i = 0; i < items; i += 100) {
+            uint32_t value;
+            snprintf(key, sizeof(key), "key%u", static_cast<unsigned>(i));
+            TEST_ESP_OK(nvs_get_u32(handle, key, &value));
+        }
+        nvs_close(handle);
+
+        s_perf << "Mount " << pageCount << " pages holding " << items << " items "
+               << (snapshot ? "with current snapshot: " : "without snapshot: ")
+               << mountTime << " us, " << mountReadBytes << " bytes read; reading every 100th key afterwards: "
+               << esp_partition_get_total_time() << " us" << std::endl;
+    }
+    TEST_ESP_OK(nvs_flash_deinit_partition(partName));
+}
+#endif
+
+TEST_CASE("Recovery from power-off after the data and before the states of writeItems() are written", "[nvs]")
+{
+    PartitionEmulationFixture f;
+    // the data of the blob chunk starts with a 0xffffffff word, so its first data entry looks empty
+    uint8_t blob[2 * nvs::Page::ENTRY_SIZE];
+    memset(blob, 0x5a, sizeof(blob));
+    memset(blob, 0xff, sizeof(uint32_t));
+    const uint32_t value = 0x12345678;
+    const nvs::Page::ItemWrite items[] = {
+        {nvs::ItemType::BLOB_DATA, "blob", blob, sizeof(blob), 0},
+        {nvs::ItemType::U32, "value", &value, sizeof(value), nvs::Item::CHUNK_ANY},
+    };
+    const size_t entries = nvs::Page::getItemEntryCount(nvs::ItemType::BLOB_DATA, sizeof(blob))
+                           + nvs::Page::getItemEntryCount(nvs::ItemType::U32, sizeof(value));
+    {
+        nvs::Page page;
+        TEST_ESP_OK(page.load(f.part(), 0));
+        TEST_ESP_OK(page.writeItem(1, nvs::ItemType::U32, "before", &value, sizeof(value)));
+        // power is lost right after the entries are written to flash
+        esp_partition_fail_after(entries * nvs::Page::ENTRY_SIZE / 4, ESP_PARTITION_FAIL_AFTER_MODE_BOTH);
+        CHECK(page.writeItems(1, items, sizeof(items) / sizeof(items[0])) != ESP_OK);
+        esp_partition_fail_after(SIZE_MAX, ESP_PARTITION_FAIL_AFTER_MODE_BOTH);
+    }
+
+    nvs::Page page;
+    TEST_ESP_OK(page.load(f.part(), 0));
+    CHECK(page.state() == nvs::Page::PageState::ACTIVE);
+    uint32_t readVal;
+    TEST_ESP_ERR(page.readItem(1, nvs::ItemType::U32, "value", &readVal, sizeof(readVal)), ESP_ERR_NVS_NOT_FOUND);
+    TEST_ESP_OK(page.readItem(1, nvs::ItemType::U32, "before", &readVal, sizeof(readVal)));
+    CHECK(readVal == value);
+
+    // new items are not written over the entries of the lost batch
+    const uint32_t after = 0x0badf00d;
+    TEST_ESP_OK(page.writeItem(1, nvs::ItemType::U32, "after", &after, sizeof(after)));
+    TEST_ESP_OK(page.readItem(1, nvs::ItemType::U32, "after", &readVal, sizeof(readVal)));
+    CHECK(readVal == after);
+    CHECK(page.getUsedEntryCount() == 2);
+    CHECK(page.getErasedEntryCount() == entries);
+}
 /* Add new tests above */
 /* This test has to be the final one */
 
@@ -127,6 +127,11 @@ typedef struct {
  */
 typedef struct nvs_opaque_iterator_t *nvs_iterator_t;
 
+/**
+ * Opaque pointer type representing a blob opened for streaming with nvs_blob_open
+ */
+typedef struct nvs_opaque_blob_t *nvs_blob_handle_t;
+
 /**
  * @brief      Open non-volatile storage with a given namespace from the default NVS partition
  *
@@ -559,6 +564,110 @@ esp_err_t nvs_erase_key(nvs_handle_t handle, const char* key);
  */
 esp_err_t nvs_erase_all(nvs_handle_t handle);
 
+/**
+ * @brief      Open a blob for reading or writing it piecewise
+ *
+ * nvs_set_blob and nvs_get_blob need the whole blob in one buffer. Large blobs
+ * may instead be streamed with nvs_blob_write_chunk or nvs_blob_read_chunk,
+ * which only need a buffer of one flash page (about 4 kB) for the stream.
+ *
+ * If opened with NVS_READWRITE, the written data replaces the blob stored under
+ * the given key once the stream is closed with nvs_blob_close. Until then, reads
+ * of the key keep returning the previous value. If opened with NVS_READONLY, the
+ * stream reads the blob currently stored under the key.
+ *
+ * The key must not be written or erased by other calls while a stream is open on it,
+ * and a stream must not be used by several tasks at the same time.
+ *
+ * @param[in]  handle     Handle obtained from nvs_open function.
+ * @param[in]  key        Key name. Maximum length is (NVS_KEY_NAME_MAX_SIZE-1) characters. Shouldn't be empty.
+ * @param[in]  open_mode  NVS_READWRITE to write a new value, NVS_READONLY to read the stored one.
+ *                        NVS_READWRITE requires a handle opened in NVS_READWRITE mode.
+ * @param[out] out_blob   If successful (return code is zero), the stream is returned in this argument.
+ *                        It has to be released with nvs_blob_close.
+ *
+ * @return
+ *             - ESP_OK if the blob has been opened
+ *             - ESP_ERR_NVS_NOT_FOUND if opened for reading and the key doesn't exist
+ *             - ESP_ERR_NVS_INVALID_HANDLE if handle has been closed or is NULL
+ *             - ESP_ERR_NVS_READ_ONLY if opened for writing on a read-only handle
+ *             - ESP_ERR_NVS_KEY_TOO_LONG if the key name is too long
+ *             - ESP_ERR_INVALID_STATE if opened for writing while a transaction is in progress on the handle
+ *             - ESP_ERR_NO_MEM if memory for the stream could not be allocated
+ *             - ESP_ERR_INVALID_ARG if key or out_blob is NULL
+ *             - other error codes from the underlying storage driver
+ */
+esp_err_t nvs_blob_open(nvs_handle_t handle, const char *key, nvs_open_mode_t open_mode, nvs_blob_handle_t *out_blob);
+
+/**
+ * @brief      Append data to a blob opened for writing
+ *
+ * Data is collected in the buffer of the stream and written to flash whenever it fills
+ * the rest of the current page. After an error, the stream only returns that error and
+ * the data written so far is discarded by nvs_blob_close.
+ *
+ * @param[in]  blob    Stream obtained from nvs_blob_open with NVS_READWRITE.
+ * @param[in]  data    Data to append.
+ * @param[in]  length  Length of data in bytes.
+ *
+ * @return
+ *             - ESP_OK if the data has been appended
+ *             - ESP_ERR_NVS_VALUE_TOO_LONG if the blob would become larger than the partition can hold
+ *             - ESP_ERR_NVS_NOT_ENOUGH_SPACE if there is not enough space left in the partition
+ *             - ESP_ERR_NVS_READ_ONLY if the blob was opened for reading
+ *             - ESP_ERR_NVS_INVALID_HANDLE if the handle the blob was opened with has been closed
+ *             - ESP_ERR_INVALID_ARG if blob is NULL, or data is NULL while length is not zero
+ *             - other error codes from the underlying storage driver
+ */
+esp_err_t nvs_blob_write_chunk(nvs_blob_handle_t blob, const void *data, size_t length);
+
+/**
+ * @brief      Read the next part of a blob opened for reading
+ *
+ * Each call continues where the previous one stopped. Use nvs_get_blob with out_value
+ * set to NULL to get the total size of the blob in advance.
+ *
+ * @param[in]     blob      Stream obtained from nvs_blob_open with NVS_READONLY.
+ * @param[out]    out_data  Buffer to read the data into.
+ * @param[inout]  length    Size of out_data in bytes. On return, the number of bytes read,
+ *                          which is only less than requested at the end of the blob.
+ *                          0 means that the whole blob has been read.
+ *
+ * @return
+ *             - ESP_OK if the data has been read
+ *             - ESP_ERR_NVS_NOT_FOUND if a part of the blob is missing, e.g. because the key
+ *               has been written since the stream was opened
+ *             - ESP_ERR_INVALID_STATE if the blob was opened for writing
+ *             - ESP_ERR_NVS_INVALID_HANDLE if the handle the blob was opened with has been closed
+ *             - ESP_ERR_INVALID_ARG if any of the arguments is NULL
+ *             - other error codes from the underlying storage driver
+ */
+esp_err_t nvs_blob_read_chunk(nvs_blob_handle_t blob, void *out_data, size_t *length);
+
+/**
+ * @brief      Close a blob stream and release its memory
+ *
+ * For a blob opened for writing, the remaining data and the index of the blob are written,
+ * which makes the new value visible, and the previous value is erased. If writing has failed
+ * before, the data written by the stream is erased instead and the previous value is kept.
+ *
+ * The stream is released in any case, so blob must not be used afterwards.
+ *
+ * @param[in]  blob  Stream obtained from nvs_blob_open.
+ *
+ * @return
+ *             - ESP_OK if the blob has been closed and, if opened for writing, stored
+ *             - ESP_ERR_NVS_INVALID_HANDLE if the handle the blob was opened with has been closed;
+ *               data written by the stream is erased on the next initialization of the partition
+ *               or the next time the key is opened for writing
+ *             - ESP_ERR_NVS_REMOVE_FAILED if the value was written but the previous value
+ *               could not be erased; the update will be finished after re-initialization of nvs
+ *             - ESP_ERR_INVALID_ARG if blob is NULL
+ *             - the error returned by an earlier nvs_blob_write_chunk call, or other error
+ *               codes from the underlying storage driver
+ */
+esp_err_t nvs_blob_close(nvs_blob_handle_t blob);
+
 /**
  * @brief      Write any pending changes to non-volatile storage
  *
@@ -576,6 +685,66 @@ esp_err_t nvs_erase_all(nvs_handle_t handle);
  */
 esp_err_t nvs_commit(nvs_handle_t handle);
 
+/**
+ * @brief      Start a write transaction on the handle
+ *
+ * Until the transaction is committed or aborted, nvs_set_* functions called with this
+ * handle only stage the values in RAM. nvs_get_* functions keep returning the values stored
+ * in flash. nvs_erase_key and nvs_erase_all fail with ESP_ERR_INVALID_STATE.
+ *
+ * Transactions are meant for writing many small values at once, e.g. a set of calibration
+ * values at boot. All staged values are written with a single flash write operation and
+ * become visible at the same time, see nvs_transaction_commit.
+ *
+ * @param[in]  handle  Storage handle obtained with nvs_open.
+ *                     Handles that were opened read only cannot be used.
+ *
+ * @return
+ *             - ESP_OK if the transaction was started
+ *             - ESP_ERR_NVS_INVALID_HANDLE if handle has been closed or is NULL
+ *             - ESP_ERR_NVS_READ_ONLY if handle was opened as read only
+ *             - ESP_ERR_INVALID_STATE if a transaction is already in progress on the handle
+ */
+esp_err_t nvs_transaction_begin(nvs_handle_t handle);
+
+/**
+ * @brief      Write all values staged by the transaction and end it
+ *
+ * The staged values are packed into consecutive entries of a single page and written
+ * with one flash write operation. After a power loss either all of them or none of them
+ * are found. Values equal to the ones already stored are skipped. Blobs are stored as a
+ * single chunk, so all staged values together must fit into the 126 entries of one page.
+ * Each value takes one entry, strings and blobs additionally take their length rounded up
+ * to 32 byte entries, and blobs one more entry for their index.
+ *
+ * The transaction ends even if the commit fails; the staged values are discarded then.
+ *
+ * @param[in]  handle  Storage handle obtained with nvs_open.
+ *
+ * @return
+ *             - ESP_OK if all values have been written successfully
+ *             - ESP_ERR_NVS_INVALID_HANDLE if handle has been closed or is NULL
+ *             - ESP_ERR_INVALID_STATE if no transaction is in progress on the handle
+ *             - ESP_ERR_NVS_NOT_ENOUGH_SPACE if the staged values don't fit into a single page
+ *               or there is not enough space left in the partition
+ *             - ESP_ERR_NVS_REMOVE_FAILED if the values were written but the old values
+ *               could not be erased; the update will be finished after re-initialization of nvs
+ *             - other error codes from the underlying storage driver
+ */
+esp_err_t nvs_transaction_commit(nvs_handle_t handle);
+
+/**
+ * @brief      Discard all values staged by the transaction and end it
+ *
+ * @param[in]  handle  Storage handle obtained with nvs_open.
+ *
+ * @return
+ *             - ESP_OK if the transaction has been aborted
+ *             - ESP_ERR_NVS_INVALID_HANDLE if handle has been closed or is NULL
+ *             - ESP_ERR_INVALID_STATE if no transaction is in progress on the handle
+ */
+esp_err_t nvs_transaction_abort(nvs_handle_t handle);
+
 /**
  * @brief      Close the storage handle and free any allocated resources
  *
@@ -635,6 +804,79 @@ typedef struct {
  */
 esp_err_t nvs_get_stats(const char *part_name, nvs_stats_t *nvs_stats);
 
+/**
+ * @note Info about RAM used by NVS for a partition.
+ */
+typedef struct {
+    size_t page_count;        /**< Number of pages of the partition. */
+    size_t pages;             /**< Bytes used by the page objects, including their entry state tables. */
+    size_t hash_lists;        /**< Bytes used by the hash lists of all pages, see CONFIG_NVS_COMPACT_HASH_LIST. */
+    size_t key_index;         /**< Bytes used by the partition-wide key index, see CONFIG_NVS_GLOBAL_KEY_INDEX. */
+    size_t ordered_index;     /**< Bytes used by the sorted index for iteration, see CONFIG_NVS_ORDERED_INDEX. */
+    size_t namespaces;        /**< Bytes used by the list of namespaces. */
+    size_t total;             /**< Sum of the above. */
+} nvs_ram_usage_t;
+
+/**
+ * @brief      Fill structure nvs_ram_usage_t. It provides info about RAM used by NVS for a partition.
+ *
+ * The sizes count the memory requested from the heap, not the overhead of the heap allocator.
+ *
+ * @param[in]   part_name   Partition name NVS in the partition table.
+ *                          If pass a NULL than will use NVS_DEFAULT_PART_NAME ("nvs").
+ *
+ * @param[out]  ram_usage   Returns filled structure nvs_ram_usage_t.
+ *
+ * @return
+ *             - ESP_OK if ram_usage has been filled.
+ *             - ESP_ERR_NVS_NOT_INITIALIZED if the storage driver is not initialized.
+ *               Return param ram_usage will be filled 0.
+ *             - ESP_ERR_INVALID_ARG if ram_usage is equal to NULL.
+ *             - ESP_ERR_NVS_INVALID_STATE if the storage is in an invalid state.
+ *               Return param ram_usage will be filled 0.
+ */
+esp_err_t nvs_get_ram_usage(const char *part_name, nvs_ram_usage_t *ram_usage);
+
+/**
+ * @brief      Free one page of the partition ahead of time
+ *
+ * When all but one page of a partition are in use, a write which needs a new page first has to copy all
+ * items of an existing page to a new one and to erase the old one, which may take tens of milliseconds.
+ * This function does that work in advance: it copies the items of the page with the most erased entries
+ * to the active page and erases the freed page, unless the partition has
+ * CONFIG_NVS_GC_FREE_PAGES_RESERVE free pages already. At most one page is freed per call, so the
+ * function is meant to be called repeatedly, e.g. from a low priority task or when the application is idle.
+ *
+ * @note Only available with CONFIG_NVS_GC_STEP enabled. If the power is lost while this function copies the
+ *       items to the active page, IDF versions without this option do not recover the page being freed correctly
+ *       and lose items of the active page. Do not use this function if the firmware may be downgraded to them.
+ *
+ * \code{c}
+ * // Example of keeping the reserve of free pages from a low priority task:
+ * while (true) {
+ *     if (nvs_gc_step(NULL, 0) != ESP_ERR_NOT_FINISHED) {
+ *         vTaskDelay(pdMS_TO_TICKS(1000));
+ *     }
+ * }
+ * \endcode
+ *
+ * @param[in]   part_name   Partition name NVS in the partition table.
+ *                          If pass a NULL than will use NVS_DEFAULT_PART_NAME ("nvs").
+ *
+ * @param[in]   max_entries Maximum number of entries to copy in this call. Pages holding more used entries
+ *                          are not freed. Pass 0 for no limit.
+ *
+ * @return
+ *             - ESP_OK if the partition has the configured number of free pages.
+ *             - ESP_ERR_NOT_FINISHED if a page was freed, but more free pages are needed.
+ *             - ESP_ERR_NVS_NOT_ENOUGH_SPACE if no page could be freed, because no page has erased entries
+ *               or the used entries of the candidate pages do not fit into the active page or max_entries.
+ *             - ESP_ERR_NVS_NOT_INITIALIZED if the storage driver is not initialized.
+ *             - ESP_ERR_NOT_SUPPORTED if CONFIG_NVS_GC_STEP is not enabled.
+ *             - other error codes from the underlying storage driver
+ */
+esp_err_t nvs_gc_step(const char *part_name, size_t max_entries);
+
 /**
  * @brief      Calculate all entries in a namespace.
  *
@@ -718,6 +960,55 @@ esp_err_t nvs_entry_find(const char *part_name,
         nvs_type_t type,
         nvs_iterator_t *output_iterator);
 
+/**
+ * @brief       Create an iterator to enumerate NVS entries whose key starts with a given prefix
+ *
+ * Works like nvs_entry_find, but only returns entries whose key starts with \c prefix.
+ *
+ * If CONFIG_NVS_ORDERED_INDEX is enabled, the iterator returns the entries sorted by namespace and key,
+ * and creating and advancing it takes time proportional to the number of entries returned. Keys written
+ * while iterating are returned once, at their position in the order. Otherwise
+ * all entries of the partition are visited and the matching ones are returned in storage order.
+ *
+ * \code{c}
+ * // Example of listing all the keys starting with "wifi." under specified partition and namespace
+ *  nvs_iterator_t it = NULL;
+ *  esp_err_t res = nvs_entry_find_prefix(<nvs_partition_name>, <namespace>, "wifi.", NVS_TYPE_ANY, &it);
+ *  while(res == ESP_OK) {
+ *      nvs_entry_info_t info;
+ *      nvs_entry_info(it, &info);
+ *      printf("key '%s', type '%d' \n", info.key, info.type);
+ *      res = nvs_entry_next(&it);
+ *  }
+ *  nvs_release_iterator(it);
+ * \endcode
+ *
+ * @param[in]   part_name       Partition name
+ *
+ * @param[in]   namespace_name  Set this value if looking for entries with
+ *                              a specific namespace. Pass NULL otherwise.
+ *
+ * @param[in]   prefix          Key prefix, at most NVS_KEY_NAME_MAX_SIZE-1 characters.
+ *                              An empty string matches all keys.
+ *
+ * @param[in]   type            One of nvs_type_t values.
+ *
+ * @param[out] output_iterator  Same as for nvs_entry_find.
+ *
+ * @return
+ *             - ESP_OK if no internal error or programming error occurred.
+ *             - ESP_ERR_NVS_NOT_FOUND if no element of specified criteria has been found.
+ *             - ESP_ERR_NO_MEM if memory has been exhausted during allocation of internal structures.
+ *             - ESP_ERR_NVS_KEY_TOO_LONG if the prefix is longer than a key can be.
+ *             - ESP_ERR_INVALID_ARG if part_name, prefix or output_iterator is NULL.
+ *                  Note: don't release \c output_iterator in case ESP_ERR_INVALID_ARG has been returned
+ */
+esp_err_t nvs_entry_find_prefix(const char *part_name,
+        const char *namespace_name,
+        const char *prefix,
+        nvs_type_t type,
+        nvs_iterator_t *output_iterator);
+
 /**
  * @brief       Create an iterator to enumerate NVS entries based on a handle and type
  *
@@ -761,7 +1052,7 @@ esp_err_t nvs_entry_find_in_handle(nvs_handle_t handle, nvs_type_t type, nvs_ite
  *
  * Note that any copies of the iterator will be invalid after this call.
  *
- * @param[inout]   iterator Iterator obtained from nvs_entry_find or nvs_entry_find_in_handle
+ * @param[inout]   iterator Iterator obtained from nvs_entry_find, nvs_entry_find_prefix or nvs_entry_find_in_handle
  *                          function. Must be non-NULL. If any error except ESP_ERR_INVALID_ARG
  *                          occurs, \c iterator is set to NULL. If ESP_ERR_INVALID_ARG occurs, \c
  *                          iterator is not changed.
@@ -130,6 +130,36 @@ esp_err_t nvs_flash_deinit(void);
  */
 esp_err_t nvs_flash_deinit_partition(const char* partition_label);
 
+/**
+ * @brief Write the index snapshot of the default NVS partition
+ *
+ * Same as nvs_flash_write_snapshot_partition() for the partition with "nvs" label.
+ */
+esp_err_t nvs_flash_write_snapshot(void);
+
+/**
+ * @brief Write the index snapshot of the given NVS partition
+ *
+ * With CONFIG_NVS_FAST_MOUNT enabled, initialization of a partition can skip reading the items of
+ * all pages if it finds a snapshot which was written after the last modification of the partition.
+ * The snapshot is only written by this function, nvs_flash_deinit_partition() does not write it.
+ * Call it when the application is done writing to the partition, e.g. before nvs_flash_deinit_partition(),
+ * esp_restart() or entering deep sleep. Nothing is written if the existing snapshot is still current.
+ *
+ * @param[in]  partition_label   Label of the partition
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_NVS_NOT_INITIALIZED if the storage for given partition was not
+ *        initialized prior to this call
+ *      - ESP_ERR_NOT_SUPPORTED if CONFIG_NVS_FAST_MOUNT is disabled
+ *      - ESP_ERR_NOT_ALLOWED if the partition is read-only
+ *      - ESP_ERR_NVS_VALUE_TOO_LONG if the partition has too many namespaces to be stored in a snapshot
+ *      - ESP_ERR_NVS_NOT_ENOUGH_SPACE if there is not enough space left in the partition
+ *      - one of the error codes from the underlying flash storage driver
+ */
+esp_err_t nvs_flash_write_snapshot_partition(const char* partition_label);
+
 /**
  * @brief Erase the default NVS partition
  *
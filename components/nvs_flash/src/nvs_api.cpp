@@ -251,6 +251,27 @@ extern "C" esp_err_t nvs_flash_deinit(void)
     return nvs_flash_deinit_partition(NVS_DEFAULT_PART_NAME);
 }
 
+extern "C" esp_err_t nvs_flash_write_snapshot_partition(const char* partition_name)
+{
+#ifdef CONFIG_NVS_FAST_MOUNT
+    Lock lock;
+
+    nvs::Storage* storage = lookup_storage_from_name(partition_name);
+    if (storage == nullptr) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+
+    return storage->writeSnapshot();
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+extern "C" esp_err_t nvs_flash_write_snapshot(void)
+{
+    return nvs_flash_write_snapshot_partition(NVS_DEFAULT_PART_NAME);
+}
+
 static esp_err_t nvs_find_ns_handle(nvs_handle_t c_handle, NVSHandleSimple** handle)
 {
     auto it = find_if(begin(s_nvs_handles), end(s_nvs_handles), [=](NVSHandleEntry& e) -> bool {
@@ -309,7 +330,7 @@ extern "C" void nvs_close(nvs_handle_t handle)
 
 extern "C" esp_err_t nvs_find_key(nvs_handle_t c_handle, const char* key, nvs_type_t* out_type)
 {
-    Lock lock;
+    ReadLock lock;
     ESP_LOGD(TAG, "%s %s", __func__, key);
     NVSHandleSimple *handle;
     auto err = nvs_find_ns_handle(c_handle, &handle);
@@ -418,6 +439,127 @@ extern "C" esp_err_t nvs_commit(nvs_handle_t c_handle)
     return handle->commit();
 }
 
+extern "C" esp_err_t nvs_transaction_begin(nvs_handle_t c_handle)
+{
+    Lock lock;
+    ESP_LOGD(TAG, "%s %d", __func__, static_cast<int>(c_handle));
+    NVSHandleSimple *handle;
+    auto err = nvs_find_ns_handle(c_handle, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return handle->transaction_begin();
+}
+
+extern "C" esp_err_t nvs_transaction_commit(nvs_handle_t c_handle)
+{
+    Lock lock;
+    ESP_LOGD(TAG, "%s %d", __func__, static_cast<int>(c_handle));
+    NVSHandleSimple *handle;
+    auto err = nvs_find_ns_handle(c_handle, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return handle->transaction_commit();
+}
+
+extern "C" esp_err_t nvs_transaction_abort(nvs_handle_t c_handle)
+{
+    Lock lock;
+    ESP_LOGD(TAG, "%s %d", __func__, static_cast<int>(c_handle));
+    NVSHandleSimple *handle;
+    auto err = nvs_find_ns_handle(c_handle, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return handle->transaction_abort();
+}
+
+extern "C" esp_err_t nvs_blob_open(nvs_handle_t c_handle, const char* key, nvs_open_mode_t open_mode, nvs_blob_handle_t* out_blob)
+{
+    if (key == nullptr || out_blob == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    Lock lock;
+    ESP_LOGD(TAG, "%s %s %d", __func__, key, open_mode);
+    NVSHandleSimple *handle;
+    auto err = nvs_find_ns_handle(c_handle, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    nvs_blob_handle_t blob = (nvs_blob_handle_t)calloc(1, sizeof(nvs_opaque_blob_t));
+    if (blob == nullptr) {
+        return ESP_ERR_NO_MEM;
+    }
+    blob->handle = c_handle;
+
+    err = handle->open_blob_stream(key, open_mode == NVS_READWRITE, blob);
+    if (err != ESP_OK) {
+        free(blob);
+        return err;
+    }
+
+    *out_blob = blob;
+    return ESP_OK;
+}
+
+extern "C" esp_err_t nvs_blob_write_chunk(nvs_blob_handle_t blob, const void* data, size_t length)
+{
+    if (blob == nullptr || (data == nullptr && length != 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!blob->write) {
+        return ESP_ERR_NVS_READ_ONLY;
+    }
+
+    Lock lock;
+    NVSHandleSimple *handle;
+    auto err = nvs_find_ns_handle(blob->handle, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return handle->get_storage()->writeBlobStream(blob, data, length);
+}
+
+extern "C" esp_err_t nvs_blob_read_chunk(nvs_blob_handle_t blob, void* out_data, size_t* length)
+{
+    if (blob == nullptr || out_data == nullptr || length == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (blob->write) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    ReadLock lock;
+    NVSHandleSimple *handle;
+    auto err = nvs_find_ns_handle(blob->handle, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return handle->get_storage()->readBlobStream(blob, out_data, *length);
+}
+
+extern "C" esp_err_t nvs_blob_close(nvs_blob_handle_t blob)
+{
+    if (blob == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t err;
+    {
+        Lock lock;
+        NVSHandleSimple *handle;
+        err = nvs_find_ns_handle(blob->handle, &handle);
+        if (err == ESP_OK) {
+            err = handle->get_storage()->closeBlobStream(blob);
+        }
+    }
+    free(blob);
+    return err;
+}
+
 extern "C" esp_err_t nvs_set_str(nvs_handle_t c_handle, const char* key, const char* value)
 {
     Lock lock;
@@ -446,7 +588,7 @@ extern "C" esp_err_t nvs_set_blob(nvs_handle_t c_handle, const char* key, const
 template<typename T>
 static esp_err_t nvs_get(nvs_handle_t c_handle, const char* key, T* out_value)
 {
-    Lock lock;
+    ReadLock lock;
     ESP_LOGD(TAG, "%s %s %ld", __func__, key, static_cast<long int>(sizeof(T)));
     NVSHandleSimple *handle;
     auto err = nvs_find_ns_handle(c_handle, &handle);
@@ -498,7 +640,7 @@ extern "C" esp_err_t nvs_get_u64 (nvs_handle_t c_handle, const char* key, uint64
 
 static esp_err_t nvs_get_str_or_blob(nvs_handle_t c_handle, nvs::ItemType type, const char* key, void* out_value, size_t* length)
 {
-    Lock lock;
+    ReadLock lock;
     ESP_LOGD(TAG, "%s %s", __func__, key);
     NVSHandleSimple *handle;
     auto err = nvs_find_ns_handle(c_handle, &handle);
@@ -562,6 +704,46 @@ extern "C" esp_err_t nvs_get_stats(const char* part_name, nvs_stats_t* nvs_stats
     return pStorage->fillStats(*nvs_stats);
 }
 
+extern "C" esp_err_t nvs_get_ram_usage(const char* part_name, nvs_ram_usage_t* ram_usage)
+{
+    Lock lock;
+    nvs::Storage* pStorage;
+
+    if (ram_usage == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *ram_usage = {};
+
+    pStorage = lookup_storage_from_name((part_name == nullptr) ? NVS_DEFAULT_PART_NAME : part_name);
+    if (pStorage == nullptr) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+
+    if(!pStorage->isValid()){
+        return ESP_ERR_NVS_INVALID_STATE;
+    }
+
+    pStorage->fillRamUsage(*ram_usage);
+    return ESP_OK;
+}
+
+extern "C" esp_err_t nvs_gc_step(const char* part_name, size_t max_entries)
+{
+#ifdef CONFIG_NVS_GC_STEP
+    Lock lock;
+    nvs::Storage* pStorage;
+
+    pStorage = lookup_storage_from_name((part_name == nullptr) ? NVS_DEFAULT_PART_NAME : part_name);
+    if (pStorage == nullptr) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+
+    return pStorage->collectGarbage(max_entries);
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
 extern "C" esp_err_t nvs_get_used_entry_count(nvs_handle_t c_handle, size_t* used_entries)
 {
     Lock lock;
@@ -775,6 +957,21 @@ extern "C" esp_err_t nvs_entry_find(const char *part_name, const char *namespace
         return ESP_ERR_INVALID_ARG;
     }
 
+    return nvs_entry_find_prefix(part_name, namespace_name, "", type, output_iterator);
+}
+
+extern "C" esp_err_t nvs_entry_find_prefix(const char *part_name, const char *namespace_name, const char *prefix,
+                                           nvs_type_t type, nvs_iterator_t *output_iterator)
+{
+    if (part_name == nullptr || prefix == nullptr || output_iterator == nullptr) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (strlen(prefix) > Item::MAX_KEY_LENGTH) {
+        *output_iterator = nullptr;
+        return ESP_ERR_NVS_KEY_TOO_LONG;
+    }
+
     esp_err_t lock_result = Lock::init();
     if (lock_result != ESP_OK) {
         *output_iterator = nullptr;
@@ -794,8 +991,7 @@ extern "C" esp_err_t nvs_entry_find(const char *part_name, const char *namespace
         *output_iterator = nullptr;
         return ESP_ERR_NO_MEM;
     }
-
-    bool entryFound = pStorage->findEntry(it, namespace_name);
+    bool entryFound = pStorage->findEntry(it, namespace_name, prefix);
     if (!entryFound) {
         free(it);
         *output_iterator = nullptr;
@@ -25,23 +25,23 @@ esp_err_t NVSHandleLocked::set_blob(const char *key, const void* blob, size_t le
 }
 
 esp_err_t NVSHandleLocked::get_string(const char *key, char* out_str, size_t len) {
-    Lock lock;
+    ReadLock lock;
     return handle->get_string(key, out_str, len);
 }
 
 esp_err_t NVSHandleLocked::get_blob(const char *key, void* out_blob, size_t len) {
-    Lock lock;
+    ReadLock lock;
     return handle->get_blob(key, out_blob, len);
 }
 
 esp_err_t NVSHandleLocked::get_item_size(ItemType datatype, const char *key, size_t &size) {
-    Lock lock;
+    ReadLock lock;
     return handle->get_item_size(datatype, key, size);
 }
 
 esp_err_t NVSHandleLocked::find_key(const char* key, nvs_type_t &nvstype)
 {
-    Lock lock;
+    ReadLock lock;
     return handle->find_key(key, nvstype);
 }
 
@@ -71,7 +71,7 @@ esp_err_t NVSHandleLocked::set_typed_item(ItemType datatype, const char *key, co
 }
 
 esp_err_t NVSHandleLocked::get_typed_item(ItemType datatype, const char *key, void* data, size_t dataSize) {
-    Lock lock;
+    ReadLock lock;
     return handle->get_typed_item(datatype, key, data, dataSize);
 }
 
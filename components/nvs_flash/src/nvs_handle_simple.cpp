@@ -4,12 +4,19 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#if __has_include(<bsd/string.h>)
+// for strlcpy
+#include <bsd/string.h>
+#endif
 #include "nvs_handle.hpp"
 #include "nvs_partition_manager.hpp"
 
 namespace nvs {
 
 NVSHandleSimple::~NVSHandleSimple() {
+    mBatch.clearAndFreeNodes();
     NVSPartitionManager::get_instance()->close_handle(this);
 }
 
@@ -17,6 +24,7 @@ esp_err_t NVSHandleSimple::set_typed_item(ItemType datatype, const char *key, co
 {
     if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
     if (mReadOnly) return ESP_ERR_NVS_READ_ONLY;
+    if (mInTransaction) return stage_item(datatype, key, data, dataSize);
 
     return mStoragePtr->writeItem(mNsIndex, datatype, key, data, dataSize);
 }
@@ -32,6 +40,7 @@ esp_err_t NVSHandleSimple::set_string(const char *key, const char* str)
 {
     if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
     if (mReadOnly) return ESP_ERR_NVS_READ_ONLY;
+    if (mInTransaction) return stage_item(nvs::ItemType::SZ, key, str, strlen(str) + 1);
 
     return mStoragePtr->writeItem(mNsIndex, nvs::ItemType::SZ, key, str, strlen(str) + 1);
 }
@@ -40,6 +49,7 @@ esp_err_t NVSHandleSimple::set_blob(const char *key, const void* blob, size_t le
 {
     if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
     if (mReadOnly) return ESP_ERR_NVS_READ_ONLY;
+    if (mInTransaction) return stage_item(nvs::ItemType::BLOB, key, blob, len);
 
     return mStoragePtr->writeItem(mNsIndex, nvs::ItemType::BLOB, key, blob, len);
 }
@@ -86,6 +96,7 @@ esp_err_t NVSHandleSimple::erase_item(const char* key)
 {
     if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
     if (mReadOnly) return ESP_ERR_NVS_READ_ONLY;
+    if (mInTransaction) return ESP_ERR_INVALID_STATE;
 
     return mStoragePtr->eraseItem(mNsIndex, key);
 }
@@ -94,6 +105,7 @@ esp_err_t NVSHandleSimple::erase_all()
 {
     if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
     if (mReadOnly) return ESP_ERR_NVS_READ_ONLY;
+    if (mInTransaction) return ESP_ERR_INVALID_STATE;
 
     return mStoragePtr->eraseNamespace(mNsIndex);
 }
@@ -119,6 +131,87 @@ esp_err_t NVSHandleSimple::get_used_entry_count(size_t& used_entries)
     return err;
 }
 
+esp_err_t NVSHandleSimple::open_blob_stream(const char *key, bool write, nvs_opaque_blob_t *blob)
+{
+    if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
+    if (write && mReadOnly) return ESP_ERR_NVS_READ_ONLY;
+    if (write && mInTransaction) return ESP_ERR_INVALID_STATE;
+    if (strlen(key) > Item::MAX_KEY_LENGTH) return ESP_ERR_NVS_KEY_TOO_LONG;
+
+    blob->nsIndex = mNsIndex;
+    blob->write = write;
+    strlcpy(blob->key, key, sizeof(blob->key));
+    return mStoragePtr->openBlobStream(blob);
+}
+
+esp_err_t NVSHandleSimple::transaction_begin()
+{
+    if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
+    if (mReadOnly) return ESP_ERR_NVS_READ_ONLY;
+    if (mInTransaction) return ESP_ERR_INVALID_STATE;
+
+    mInTransaction = 1;
+    return ESP_OK;
+}
+
+esp_err_t NVSHandleSimple::transaction_commit()
+{
+    if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
+    if (!mInTransaction) return ESP_ERR_INVALID_STATE;
+
+    esp_err_t err = mStoragePtr->writeBatch(mNsIndex, mBatch);
+    mBatch.clearAndFreeNodes();
+    mInTransaction = 0;
+    return err;
+}
+
+esp_err_t NVSHandleSimple::transaction_abort()
+{
+    if (!valid) return ESP_ERR_NVS_INVALID_HANDLE;
+    if (!mInTransaction) return ESP_ERR_INVALID_STATE;
+
+    mBatch.clearAndFreeNodes();
+    mInTransaction = 0;
+    return ESP_OK;
+}
+
+esp_err_t NVSHandleSimple::stage_item(ItemType datatype, const char *key, const void *data, size_t dataSize)
+{
+    if (strlen(key) > Item::MAX_KEY_LENGTH) return ESP_ERR_NVS_KEY_TOO_LONG;
+    if (dataSize > Page::CHUNK_MAX_SIZE) return ESP_ERR_NVS_VALUE_TOO_LONG;
+    if (!isVariableLengthType(datatype) && dataSize > 8) return ESP_ERR_INVALID_ARG;
+
+    uint8_t *copy = new (std::nothrow) uint8_t[dataSize];
+    if (!copy) return ESP_ERR_NO_MEM;
+    memcpy(copy, data, dataSize);
+
+    // a key set more than once within the transaction keeps only its last value
+    auto it = std::find_if(mBatch.begin(), mBatch.end(), [=](const Storage::BatchItem& e) -> bool {
+#ifdef CONFIG_NVS_LEGACY_DUP_KEYS_COMPATIBILITY
+        return e.datatype == datatype && strncmp(e.key, key, sizeof(e.key)) == 0;
+#else
+        return strncmp(e.key, key, sizeof(e.key)) == 0;
+#endif
+    });
+    Storage::BatchItem *entry;
+    if (it != mBatch.end()) {
+        entry = it;
+        delete[] entry->data;
+    } else {
+        entry = new (std::nothrow) Storage::BatchItem;
+        if (!entry) {
+            delete[] copy;
+            return ESP_ERR_NO_MEM;
+        }
+        strlcpy(entry->key, key, sizeof(entry->key));
+        mBatch.push_back(entry);
+    }
+    entry->datatype = datatype;
+    entry->data = copy;
+    entry->dataSize = dataSize;
+    return ESP_OK;
+}
+
 void NVSHandleSimple::debugDump() {
     return mStoragePtr->debugDump();
 }
@@ -32,7 +32,8 @@ public:
         mStoragePtr(StoragePtr),
         mNsIndex(nsIndex),
         mReadOnly(readOnly),
-        valid(1)
+        valid(1),
+        mInTransaction(0)
     { }
 
     ~NVSHandleSimple();
@@ -61,6 +62,30 @@ public:
 
     esp_err_t get_used_entry_count(size_t &usedEntries) override;
 
+    /**
+     * Starts a write transaction. Until the transaction is committed or aborted, set_typed_item(), set_string()
+     * and set_blob() only stage the values in RAM, reads keep returning the values stored in flash and
+     * erase_item() and erase_all() are not allowed.
+     */
+    esp_err_t transaction_begin();
+
+    /**
+     * Writes all staged values to flash. They are packed into consecutive entries of one page and become
+     * visible at the same time, see Storage::writeBatch(). The transaction ends even if the commit fails.
+     */
+    esp_err_t transaction_commit();
+
+    /**
+     * Discards all staged values and ends the transaction.
+     */
+    esp_err_t transaction_abort();
+
+    /**
+     * Prepares blob for streaming the blob stored under key, see Storage::openBlobStream().
+     * Writing is not allowed while a transaction is in progress.
+     */
+    esp_err_t open_blob_stream(const char *key, bool write, nvs_opaque_blob_t *blob);
+
     esp_err_t getItemDataSize(ItemType datatype, const char *key, size_t &dataSize);
 
     void debugDump();
@@ -80,6 +105,8 @@ public:
     Storage *get_storage() const;
 
 private:
+    esp_err_t stage_item(ItemType datatype, const char *key, const void *data, size_t dataSize);
+
     /**
      * The underlying storage's object.
      */
@@ -101,6 +128,16 @@ private:
      * Upon opening, a handle is valid. It becomes invalid if the underlying storage is de-initialized.
      */
     uint8_t valid;
+
+    /**
+     * Whether a write transaction is in progress.
+     */
+    uint8_t mInTransaction;
+
+    /**
+     * Values staged by the current write transaction.
+     */
+    Storage::TBatchList mBatch;
 };
 
 } // nvs
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "nvs_item_hash_list.hpp"
+#include <algorithm>
 
 namespace nvs
 {
@@ -21,6 +22,93 @@ HashList::HashList()
 {
 }
 
+#ifdef CONFIG_NVS_COMPACT_HASH_LIST
+
+void HashList::clear()
+{
+    ExceptionlessAllocatable::operator delete[](mNodes);
+    mNodes = nullptr;
+    mCount = 0;
+    mCapacity = 0;
+}
+
+HashList::~HashList()
+{
+    clear();
+}
+
+esp_err_t HashList::resize(size_t capacity)
+{
+    if (capacity == 0) {
+        clear();
+        return ESP_OK;
+    }
+
+    auto nodes = static_cast<HashListNode*>(ExceptionlessAllocatable::operator new[](capacity * sizeof(HashListNode), std::nothrow));
+    if (!nodes) return ESP_ERR_NO_MEM;
+
+    std::copy_n(mNodes, mCount, nodes);
+    ExceptionlessAllocatable::operator delete[](mNodes);
+    mNodes = nodes;
+    mCapacity = capacity;
+    return ESP_OK;
+}
+
+esp_err_t HashList::insert(const Item& item, size_t index)
+{
+    const uint32_t hash_24 = item.calculateCrc32WithoutValue() & 0xffffff;
+    if (mCount == mCapacity) {
+        auto err = resize(mCapacity + GROW_STEP);
+        if (err != ESP_OK) return err;
+    }
+
+    // items are usually added in the order of their index, so this rarely moves any node
+    size_t pos = mCount;
+    while (pos > 0 && mNodes[pos - 1].mIndex > index) {
+        mNodes[pos] = mNodes[pos - 1];
+        --pos;
+    }
+    mNodes[pos] = HashListNode(hash_24, index);
+    mCount++;
+
+    return ESP_OK;
+}
+
+bool HashList::erase(size_t index)
+{
+    for (size_t i = 0; i < mCount; ++i) {
+        if (mNodes[i].mIndex == index) {
+            std::copy(mNodes + i + 1, mNodes + mCount, mNodes + i);
+            mCount--;
+            if (mCapacity - mCount >= 2 * GROW_STEP || mCount == 0) {
+                // failing to shrink is fine, the nodes stay where they are
+                resize(mCount ? mCapacity - GROW_STEP : 0);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t HashList::find(size_t start, const Item& item)
+{
+    const uint32_t hash_24 = item.calculateCrc32WithoutValue() & 0xffffff;
+    for (size_t i = 0; i < mCount; ++i) {
+        const HashListNode& e = mNodes[i];
+        if (e.mIndex >= start && e.mHash == hash_24) {
+            return e.mIndex;
+        }
+    }
+    return SIZE_MAX;
+}
+
+size_t HashList::getRamUsage() const
+{
+    return mCapacity * sizeof(HashListNode);
+}
+
+#else // CONFIG_NVS_COMPACT_HASH_LIST
+
 void HashList::clear()
 {
     for (auto it = mBlockList.begin(); it != mBlockList.end();) {
@@ -119,5 +207,11 @@ size_t HashList::find(size_t start, const Item& item)
     return SIZE_MAX;
 }
 
+size_t HashList::getRamUsage() const
+{
+    return mBlockList.size() * sizeof(HashListBlock);
+}
+
+#endif // CONFIG_NVS_COMPACT_HASH_LIST
 
 } // namespace nvs
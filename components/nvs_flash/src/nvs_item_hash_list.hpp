@@ -8,6 +8,7 @@
 #define nvs_item_hash_list_h
 
 #include "nvs.h"
+#include "sdkconfig.h"
 #include "nvs_types.hpp"
 #include "nvs_memory_management.hpp"
 #include "intrusive_list.h"
@@ -26,6 +27,11 @@ public:
     size_t find(size_t start, const Item& item);
     void clear();
 
+    /**
+     * Returns the number of bytes allocated for the list, not counting the overhead of the heap allocator.
+     */
+    size_t getRamUsage() const;
+
 private:
     HashList(const HashList& other);
     const HashList& operator= (const HashList& rhs);
@@ -47,6 +53,19 @@ protected:
         uint32_t mHash  : 24;
     };
 
+#ifdef CONFIG_NVS_COMPACT_HASH_LIST
+    /**
+     * Compact layout: one array of nodes sorted by index, grown and shrunk in steps of GROW_STEP nodes.
+     * It avoids the list pointers, the per block counters and the unused tail of the last block.
+     */
+    static const size_t GROW_STEP = 8;
+
+    esp_err_t resize(size_t capacity);
+
+    HashListNode* mNodes = nullptr;
+    uint16_t mCount = 0;
+    uint16_t mCapacity = 0;
+#else
     struct HashListBlock : public intrusive_list_node<HashList::HashListBlock>, public ExceptionlessAllocatable {
         HashListBlock();
 
@@ -59,6 +78,7 @@ protected:
 
     typedef intrusive_list<HashListBlock> TBlockList;
     TBlockList mBlockList;
+#endif
 }; // class HashList
 
 } // namespace nvs
@@ -0,0 +1,192 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "nvs_key_index.hpp"
+#include "nvs_page.hpp"
+
+namespace nvs
+{
+
+KeyIndex::KeyIndex()
+{
+}
+
+KeyIndex::~KeyIndex()
+{
+    clear();
+    delete[] mBuckets;
+}
+
+void KeyIndex::clear()
+{
+    for (size_t i = 0; i < mBucketCount; ++i) {
+        Node* node = mBuckets[i].mHead;
+        while (node) {
+            Node* next = node->mNext;
+            delete node;
+            node = next;
+        }
+        mBuckets[i].mHead = nullptr;
+    }
+    mCount = 0;
+}
+
+void KeyIndex::rehash(size_t bucketCount)
+{
+    Bucket* buckets = new (std::nothrow) Bucket[bucketCount];
+    if (!buckets) {
+        // keep the current table, lookups just get slower with longer chains
+        return;
+    }
+
+    for (size_t i = 0; i < mBucketCount; ++i) {
+        Node* node = mBuckets[i].mHead;
+        while (node) {
+            Node* next = node->mNext;
+            Bucket& bucket = buckets[node->mHash & (bucketCount - 1)];
+            node->mNext = bucket.mHead;
+            bucket.mHead = node;
+            node = next;
+        }
+    }
+
+    delete[] mBuckets;
+    mBuckets = buckets;
+    mBucketCount = bucketCount;
+}
+
+esp_err_t KeyIndex::insert(const Item& item, Page* page, size_t index)
+{
+    if (mBucketCount == 0) {
+        rehash(INITIAL_BUCKET_COUNT);
+        if (mBucketCount == 0) {
+            return ESP_ERR_NO_MEM;
+        }
+    } else if (mCount >= mBucketCount * MAX_LOAD_FACTOR) {
+        rehash(mBucketCount * 2);
+    }
+
+    Node* node = new (std::nothrow) Node;
+    if (!node) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    node->mPage = page;
+    node->mHash = item.calculateCrc32WithoutValue();
+    node->mIndex = static_cast<uint8_t>(index);
+
+    Bucket& bucket = bucketFor(node->mHash);
+    node->mNext = bucket.mHead;
+    bucket.mHead = node;
+    ++mCount;
+    return ESP_OK;
+}
+
+void KeyIndex::eraseIf(Bucket& bucket, Page* page, size_t index)
+{
+    Node** link = &bucket.mHead;
+    while (*link) {
+        Node* node = *link;
+        if (node->mPage == page && (index == SIZE_MAX || node->mIndex == index)) {
+            *link = node->mNext;
+            delete node;
+            --mCount;
+            if (index != SIZE_MAX) {
+                return;
+            }
+        } else {
+            link = &node->mNext;
+        }
+    }
+}
+
+void KeyIndex::erase(const Item& item, Page* page, size_t index)
+{
+    if (mBucketCount == 0) {
+        return;
+    }
+    eraseIf(bucketFor(item.calculateCrc32WithoutValue()), page, index);
+}
+
+void KeyIndex::erase(Page* page, size_t index)
+{
+    for (size_t i = 0; i < mBucketCount; ++i) {
+        eraseIf(mBuckets[i], page, index);
+    }
+}
+
+void KeyIndex::erasePage(Page* page)
+{
+    erase(page, SIZE_MAX);
+}
+
+bool KeyIndex::isIndexable(uint8_t nsIndex, ItemType datatype, const char* key, uint8_t chunkIdx)
+{
+    return nsIndex != Page::NS_ANY && key != nullptr && (datatype != ItemType::BLOB_DATA || chunkIdx != Page::CHUNK_ANY);
+}
+
+esp_err_t KeyIndex::findItem(uint8_t nsIndex, ItemType datatype, const char* key, Page* &page, Item& item,
+                             uint8_t chunkIdx, VerOffset chunkStart)
+{
+    if (mBucketCount == 0) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+
+    const uint32_t hash = Item(nsIndex, datatype, 0, key, chunkIdx).calculateCrc32WithoutValue();
+
+    // Collect the candidate pages first. Page::findItem may erase inconsistent entries, which in turn removes
+    // nodes from this index, so the bucket chain must not be walked while pages are being searched.
+    Page* pages[MAX_CANDIDATE_PAGES];
+    size_t startIndex[MAX_CANDIDATE_PAGES];
+    size_t pageCount = 0;
+    for (Node* node = bucketFor(hash).mHead; node; node = node->mNext) {
+        if (node->mHash != hash) {
+            continue;
+        }
+        size_t i;
+        for (i = 0; i < pageCount; ++i) {
+            if (pages[i] == node->mPage) {
+                startIndex[i] = std::min(startIndex[i], static_cast<size_t>(node->mIndex));
+                break;
+            }
+        }
+        if (i == pageCount) {
+            if (pageCount == MAX_CANDIDATE_PAGES) {
+                return ESP_ERR_NOT_SUPPORTED;
+            }
+            pages[pageCount] = node->mPage;
+            startIndex[pageCount] = node->mIndex;
+            ++pageCount;
+        }
+    }
+
+    Page* foundPage = nullptr;
+    uint32_t foundSeqNumber = UINT32_MAX;
+    for (size_t i = 0; i < pageCount; ++i) {
+        uint32_t seqNumber;
+        if (pages[i]->getSeqNumber(seqNumber) != ESP_OK) {
+            continue;
+        }
+        if (foundPage != nullptr && seqNumber > foundSeqNumber) {
+            continue;
+        }
+        Item candidate;
+        size_t itemIndex = startIndex[i];
+        if (pages[i]->findItem(nsIndex, datatype, key, itemIndex, candidate, chunkIdx, chunkStart) == ESP_OK) {
+            foundPage = pages[i];
+            foundSeqNumber = seqNumber;
+            item = candidate;
+        }
+    }
+
+    if (foundPage == nullptr) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    page = foundPage;
+    return ESP_OK;
+}
+
+} // namespace nvs
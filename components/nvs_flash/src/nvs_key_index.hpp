@@ -0,0 +1,122 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef nvs_key_index_hpp
+#define nvs_key_index_hpp
+
+#include "nvs.h"
+#include "nvs_types.hpp"
+#include "nvs_memory_management.hpp"
+
+namespace nvs
+{
+
+class Page;
+
+/**
+ * Partition-wide index of all written items.
+ *
+ * Maps the hash of namespace index, key and chunk index (the same hash which is used by the per-page HashList)
+ * to the page and entry index where the item is stored. Storage uses it to go directly to the page(s) holding
+ * an item instead of asking the HashList of every page in turn.
+ *
+ * The index is maintained by Page whenever an item is added to or removed from its HashList, so it stays
+ * consistent across writes, erasures, page garbage collection and the recovery done while loading pages.
+ */
+class KeyIndex
+{
+public:
+    KeyIndex();
+    ~KeyIndex();
+
+    esp_err_t insert(const Item& item, Page* page, size_t index);
+
+    /**
+     * Removes the entry of an item whose header is known.
+     */
+    void erase(const Item& item, Page* page, size_t index);
+
+    /**
+     * Removes an entry when the item header is not available (e.g. it failed the consistency check).
+     * This has to visit all buckets and should only be used on error paths.
+     */
+    void erase(Page* page, size_t index);
+
+    /**
+     * Removes all entries which point to the given page, used when the page is erased.
+     * The nodes are not linked per page, so all buckets are visited. This is small compared to the erase
+     * of the flash sector which follows.
+     */
+    void erasePage(Page* page);
+
+    void clear();
+
+    size_t size() const
+    {
+        return mCount;
+    }
+
+    size_t getRamUsage() const
+    {
+        return mBucketCount * sizeof(Bucket) + mCount * sizeof(Node);
+    }
+
+    /**
+     * Returns true if a lookup with the given parameters can be answered by the index. Same restrictions as for
+     * the per-page HashList apply: namespace and key have to be known, and for BLOB_DATA a particular chunk has to
+     * be requested.
+     */
+    static bool isIndexable(uint8_t nsIndex, ItemType datatype, const char* key, uint8_t chunkIdx);
+
+    /**
+     * Finds an item and the page it is stored on. If the item is present on more than one page (transient state
+     * during modification), the page with the lowest sequence number is returned, just like a linear search over
+     * the page list would do.
+     *
+     * @return ESP_OK if the item was found, ESP_ERR_NVS_NOT_FOUND if it's not present,
+     *         ESP_ERR_NOT_SUPPORTED if the candidate set is too large and the caller has to fall back to
+     *         a linear search.
+     */
+    esp_err_t findItem(uint8_t nsIndex, ItemType datatype, const char* key, Page* &page, Item& item,
+                       uint8_t chunkIdx, VerOffset chunkStart);
+
+private:
+    KeyIndex(const KeyIndex& other);
+    const KeyIndex& operator= (const KeyIndex& rhs);
+
+protected:
+    struct Node : public ExceptionlessAllocatable {
+        Node* mNext;
+        Page* mPage;
+        uint32_t mHash;
+        uint8_t mIndex;
+    };
+
+    struct Bucket : public ExceptionlessAllocatable {
+        Node* mHead = nullptr;
+    };
+
+    static const size_t INITIAL_BUCKET_COUNT = 64;
+    static const size_t MAX_LOAD_FACTOR = 2;
+    static const size_t MAX_CANDIDATE_PAGES = 8;
+
+    Bucket& bucketFor(uint32_t hash) const
+    {
+        return mBuckets[hash & (mBucketCount - 1)];
+    }
+
+    void rehash(size_t bucketCount);
+
+    void eraseIf(Bucket& bucket, Page* page, size_t index);
+
+    Bucket* mBuckets = nullptr;
+    size_t mBucketCount = 0;
+    size_t mCount = 0;
+}; // class KeyIndex
+
+} // namespace nvs
+
+#endif /* nvs_key_index_hpp */
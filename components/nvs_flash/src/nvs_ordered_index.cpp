@@ -0,0 +1,222 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <algorithm>
+#include <cstring>
+#include "nvs_ordered_index.hpp"
+#include "nvs_page.hpp"
+
+namespace nvs
+{
+
+OrderedIndex::OrderedIndex()
+{
+}
+
+OrderedIndex::~OrderedIndex()
+{
+    delete[] mEntries;
+}
+
+void OrderedIndex::clear()
+{
+    mCount = 0;
+    mSorted = false;
+}
+
+void OrderedIndex::sort()
+{
+    std::sort(mEntries, mEntries + mCount, less);
+    mSorted = true;
+}
+
+bool OrderedIndex::less(const Entry& lhs, const Entry& rhs)
+{
+    if (lhs.mNsIndex != rhs.mNsIndex) {
+        return lhs.mNsIndex < rhs.mNsIndex;
+    }
+    int cmp = strncmp(lhs.mKey, rhs.mKey, sizeof(lhs.mKey));
+    if (cmp != 0) {
+        return cmp < 0;
+    }
+    if (lhs.mPage != rhs.mPage) {
+        return lhs.mPage < rhs.mPage;
+    }
+    return lhs.mIndex < rhs.mIndex;
+}
+
+static int compare(const OrderedIndex::Entry& entry, uint8_t nsIndex, const char* key)
+{
+    if (entry.mNsIndex != nsIndex) {
+        return entry.mNsIndex < nsIndex ? -1 : 1;
+    }
+    return strncmp(entry.mKey, key, sizeof(entry.mKey));
+}
+
+size_t OrderedIndex::lowerBound(uint8_t nsIndex, const char* key) const
+{
+    auto pos = std::lower_bound(mEntries, mEntries + mCount, nsIndex, [key](const Entry& entry, uint8_t ns) {
+        return compare(entry, ns, key) < 0;
+    });
+    return pos - mEntries;
+}
+
+size_t OrderedIndex::upperBound(uint8_t nsIndex, const char* key) const
+{
+    auto pos = std::upper_bound(mEntries, mEntries + mCount, nsIndex, [key](uint8_t ns, const Entry& entry) {
+        return compare(entry, ns, key) > 0;
+    });
+    return pos - mEntries;
+}
+
+esp_err_t OrderedIndex::reserve(size_t capacity)
+{
+    Entry* entries = new (std::nothrow) Entry[capacity];
+    if (!entries) {
+        return ESP_ERR_NO_MEM;
+    }
+    if (mCount) {
+        memcpy(entries, mEntries, mCount * sizeof(Entry));
+    }
+    delete[] mEntries;
+    mEntries = entries;
+    mCapacity = capacity;
+    return ESP_OK;
+}
+
+bool OrderedIndex::isIndexable(const Item& item)
+{
+    if (item.nsIndex == 0 || item.datatype == ItemType::BLOB || item.datatype == ItemType::BLOB_IDX) {
+        return false;
+    }
+    return item.datatype != ItemType::BLOB_DATA
+           || item.chunkIndex == static_cast<uint8_t>(VerOffset::VER_0_OFFSET)
+           || item.chunkIndex == static_cast<uint8_t>(VerOffset::VER_1_OFFSET);
+}
+
+esp_err_t OrderedIndex::insert(const Item& item, Page* page, size_t index)
+{
+    if (!isIndexable(item)) {
+        return ESP_OK;
+    }
+
+    if (mCount == mCapacity) {
+        auto err = reserve(mCapacity ? mCapacity * 2 : INITIAL_CAPACITY);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
+    Entry entry;
+    entry.mPage = page;
+    entry.mNsIndex = item.nsIndex;
+    entry.mIndex = static_cast<uint8_t>(index);
+    entry.mDatatype = item.datatype;
+    strncpy(entry.mKey, item.key, sizeof(entry.mKey) - 1);
+    entry.mKey[sizeof(entry.mKey) - 1] = 0;
+
+    size_t pos = mCount;
+    if (mSorted) {
+        pos = std::upper_bound(mEntries, mEntries + mCount, entry, less) - mEntries;
+        memmove(&mEntries[pos + 1], &mEntries[pos], (mCount - pos) * sizeof(Entry));
+    }
+    mEntries[pos] = entry;
+    ++mCount;
+    return ESP_OK;
+}
+
+void OrderedIndex::eraseAt(size_t pos)
+{
+    memmove(&mEntries[pos], &mEntries[pos + 1], (mCount - pos - 1) * sizeof(Entry));
+    --mCount;
+}
+
+void OrderedIndex::erase(const Item& item, Page* page, size_t index)
+{
+    if (!isIndexable(item)) {
+        return;
+    }
+    if (!mSorted) {
+        erase(page, index);
+        return;
+    }
+
+    char key[sizeof(Entry::mKey)];
+    strncpy(key, item.key, sizeof(key) - 1);
+    key[sizeof(key) - 1] = 0;
+    for (size_t pos = lowerBound(item.nsIndex, key); pos < mCount; ++pos) {
+        const Entry& entry = mEntries[pos];
+        if (entry.mNsIndex != item.nsIndex || strncmp(entry.mKey, key, sizeof(key)) != 0) {
+            break;
+        }
+        if (entry.mPage == page && entry.mIndex == index) {
+            eraseAt(pos);
+            return;
+        }
+    }
+}
+
+void OrderedIndex::erase(Page* page, size_t index)
+{
+    for (size_t pos = 0; pos < mCount; ++pos) {
+        if (mEntries[pos].mPage == page && mEntries[pos].mIndex == index) {
+            eraseAt(pos);
+            return;
+        }
+    }
+}
+
+void OrderedIndex::erasePage(Page* page)
+{
+    auto end = std::remove_if(mEntries, mEntries + mCount, [page](const Entry& entry) {
+        return entry.mPage == page;
+    });
+    mCount = end - mEntries;
+}
+
+const OrderedIndex::Entry* OrderedIndex::next(uint8_t nsIndex, ItemType datatype, const char* prefix, const Entry* after)
+{
+    if (!mSorted) {
+        sort();
+    }
+
+    const size_t prefixLen = strlen(prefix);
+    size_t pos;
+    if (after) {
+        pos = upperBound(after->mNsIndex, after->mKey);
+    } else {
+        pos = lowerBound(nsIndex == Page::NS_ANY ? 0 : nsIndex, prefix);
+    }
+
+    while (pos < mCount) {
+        const Entry& entry = mEntries[pos];
+        if (nsIndex != Page::NS_ANY && entry.mNsIndex != nsIndex) {
+            break;
+        }
+        int cmp = strncmp(entry.mKey, prefix, prefixLen);
+        if (cmp < 0) {
+            // only possible when moving on to the next namespace, skip to its first key with the prefix
+            pos = lowerBound(entry.mNsIndex, prefix);
+            continue;
+        }
+        if (cmp > 0) {
+            // past the prefix range of this namespace
+            if (nsIndex != Page::NS_ANY || entry.mNsIndex == Page::NS_ANY - 1) {
+                break;
+            }
+            pos = lowerBound(entry.mNsIndex + 1, prefix);
+            continue;
+        }
+        if (datatype != ItemType::ANY && entry.mDatatype != datatype) {
+            ++pos;
+            continue;
+        }
+        return &entry;
+    }
+    return nullptr;
+}
+
+} // namespace nvs
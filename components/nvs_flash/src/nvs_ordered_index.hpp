@@ -0,0 +1,132 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef nvs_ordered_index_hpp
+#define nvs_ordered_index_hpp
+
+#include "nvs.h"
+#include "nvs_types.hpp"
+#include "nvs_memory_management.hpp"
+
+namespace nvs
+{
+
+class Page;
+
+/**
+ * Partition-wide index of all items which are visible to nvs_entry_find(), sorted by namespace index and key.
+ *
+ * Entries are kept in one array, so the entries of a namespace and, within a namespace, all keys sharing a
+ * prefix are stored next to each other. Iteration over a namespace or a key prefix starts with a binary search
+ * and then only visits the entries which are returned, without reading anything from flash.
+ *
+ * Like KeyIndex, the index is maintained by Page whenever an item is added to or removed from its HashList.
+ * While the pages are loaded, new entries are appended and the array is sorted once by sort(), afterwards
+ * entries are inserted at their position.
+ */
+class OrderedIndex
+{
+public:
+    struct Entry {
+        Page* mPage;
+        uint8_t mNsIndex;
+        uint8_t mIndex;
+        ItemType mDatatype;
+        char mKey[Item::MAX_KEY_LENGTH + 1];
+    };
+
+    OrderedIndex();
+    ~OrderedIndex();
+
+    esp_err_t insert(const Item& item, Page* page, size_t index);
+
+    /**
+     * Removes the entry of an item whose header is known.
+     */
+    void erase(const Item& item, Page* page, size_t index);
+
+    /**
+     * Removes an entry when the item header is not available (e.g. it failed the consistency check).
+     * This has to visit all entries and should only be used on error paths.
+     */
+    void erase(Page* page, size_t index);
+
+    /**
+     * Removes all entries which point to the given page, used when the page is erased.
+     */
+    void erasePage(Page* page);
+
+    void clear();
+
+    /**
+     * Sorts the entries appended since clear(). Has to be called once all pages have been loaded.
+     */
+    void sort();
+
+    size_t size() const
+    {
+        return mCount;
+    }
+
+    size_t getRamUsage() const
+    {
+        return mCapacity * sizeof(Entry);
+    }
+
+    /**
+     * Returns true for the items which are returned by the entry iterators: data items of namespaces other than
+     * the namespace table, with blobs represented by the first data chunk of each version.
+     */
+    static bool isIndexable(const Item& item);
+
+    /**
+     * Returns the next entry in namespace nsIndex (or any namespace if Page::NS_ANY is passed) whose key starts
+     * with prefix and whose type matches datatype (or any type if ItemType::ANY is passed).
+     *
+     * @param after  entry returned by the previous call, or nullptr to start from the first matching entry.
+     *               Iteration continues with the next key, so a key is returned once even if it has been
+     *               written again in the meantime. Only the values are compared, so the entry may have been
+     *               removed.
+     * @return pointer to the entry, valid until the index is modified, or nullptr if there are no more entries.
+     */
+    const Entry* next(uint8_t nsIndex, ItemType datatype, const char* prefix, const Entry* after);
+
+private:
+    OrderedIndex(const OrderedIndex& other);
+    const OrderedIndex& operator= (const OrderedIndex& rhs);
+
+protected:
+    static const size_t INITIAL_CAPACITY = 32;
+
+    /**
+     * Orders entries by namespace index and key. Entries of the same key, present on several pages during
+     * modification, are ordered by page and entry index.
+     */
+    static bool less(const Entry& lhs, const Entry& rhs);
+
+    /**
+     * Returns the position of the first entry of namespace nsIndex with a key not less than key.
+     */
+    size_t lowerBound(uint8_t nsIndex, const char* key) const;
+
+    /**
+     * Returns the position of the first entry of namespace nsIndex with a key greater than key.
+     */
+    size_t upperBound(uint8_t nsIndex, const char* key) const;
+
+    esp_err_t reserve(size_t capacity);
+
+    void eraseAt(size_t pos);
+
+    Entry* mEntries = nullptr;
+    size_t mCount = 0;
+    size_t mCapacity = 0;
+    bool mSorted = false;
+}; // class OrderedIndex
+
+} // namespace nvs
+
+#endif /* nvs_ordered_index_hpp */
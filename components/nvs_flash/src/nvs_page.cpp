@@ -9,6 +9,7 @@
 #include <cstdio>
 #include <cstring>
 #include "nvs_internal.h"
+#include "nvs_platform.hpp"
 #include "esp_partition.h"
 
 namespace nvs {
@@ -34,6 +35,7 @@ esp_err_t Page::load(Partition *partition, uint32_t sectorNumber)
     mBaseAddress = sectorNumber * SEC_SIZE;
     mUsedEntryCount = 0;
     mErasedEntryCount = 0;
+    mItemsLoaded = true;
 
     Header header;
     auto rc = mPartition->read_raw(mBaseAddress, &header, sizeof(header));
@@ -203,7 +205,7 @@ esp_err_t Page::writeItem(uint8_t nsIndex, ItemType datatype, const char* key, c
     // write first item
     size_t span = (totalSize + ENTRY_SIZE - 1) / ENTRY_SIZE;
     item = Item(nsIndex, datatype, span, key, chunkIdx);
-    err = mHashList.insert(item, mNextFreeEntry);
+    err = indexInsert(item, mNextFreeEntry);
 
     if (err != ESP_OK) {
         return err;
@@ -250,6 +252,116 @@ esp_err_t Page::writeItem(uint8_t nsIndex, ItemType datatype, const char* key, c
     return ESP_OK;
 }
 
+esp_err_t Page::writeItems(uint8_t nsIndex, const ItemWrite* items, size_t count)
+{
+    esp_err_t err;
+
+    if (mState == PageState::INVALID) {
+        return ESP_ERR_NVS_INVALID_STATE;
+    }
+
+    if (mState == PageState::UNINITIALIZED) {
+        err = initialize();
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
+    if (mState == PageState::FULL) {
+        return ESP_ERR_NVS_PAGE_FULL;
+    }
+
+    size_t entriesCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (strlen(items[i].key) > Item::MAX_KEY_LENGTH) {
+            return ESP_ERR_NVS_KEY_TOO_LONG;
+        }
+        if (items[i].dataSize > Page::CHUNK_MAX_SIZE) {
+            return ESP_ERR_NVS_VALUE_TOO_LONG;
+        }
+        if ((!isVariableLengthType(items[i].datatype)) && items[i].dataSize > 8) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        entriesCount += getItemEntryCount(items[i].datatype, items[i].dataSize);
+    }
+
+    if (entriesCount == 0) {
+        return ESP_OK;
+    }
+
+    if (mNextFreeEntry == INVALID_ENTRY || mNextFreeEntry + entriesCount > ENTRY_COUNT) {
+        // page will not fit this amount of data
+        return ESP_ERR_NVS_PAGE_FULL;
+    }
+
+    uint8_t* buffer = new (std::nothrow) uint8_t[entriesCount * ENTRY_SIZE];
+    if (!buffer) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    // lay out all items in RAM exactly as they will be stored in flash
+    const size_t begin = mNextFreeEntry;
+    size_t index = begin;
+    for (size_t i = 0; i < count; ++i) {
+        const ItemWrite& src = items[i];
+        const size_t span = getItemEntryCount(src.datatype, src.dataSize);
+        uint8_t* dst = buffer + (index - begin) * ENTRY_SIZE;
+
+        Item item(nsIndex, src.datatype, span, src.key, src.chunkIdx);
+        if (!isVariableLengthType(src.datatype)) {
+            memcpy(item.data, src.data, src.dataSize);
+        } else {
+            item.varLength.dataCrc32 = Item::calculateCrc32(static_cast<const uint8_t*>(src.data), src.dataSize);
+            item.varLength.dataSize = src.dataSize;
+            item.varLength.reserved = 0xffff;
+            std::fill_n(dst + ENTRY_SIZE, (span - 1) * ENTRY_SIZE, 0xff);
+            memcpy(dst + ENTRY_SIZE, src.data, src.dataSize);
+        }
+        item.crc32 = item.calculateCrc32();
+        memcpy(dst, &item, ENTRY_SIZE);
+
+        err = indexInsert(item, index);
+        if (err != ESP_OK) {
+            // nothing has been written yet, just forget the items inserted so far
+            for (size_t j = begin; j < index;) {
+                const Item* prev = reinterpret_cast<const Item*>(buffer + (j - begin) * ENTRY_SIZE);
+                indexErase(j, prev);
+                j += prev->span;
+            }
+            delete[] buffer;
+            return err;
+        }
+        index += span;
+    }
+
+    uint32_t phyAddr;
+    err = getEntryAddress(begin, &phyAddr);
+    if (err == ESP_OK) {
+        err = mPartition->write(phyAddr, buffer, entriesCount * ENTRY_SIZE);
+    }
+    delete[] buffer;
+    if (err != ESP_OK) {
+        mState = PageState::INVALID;
+        return err;
+    }
+
+    // alterEntryRangeState() writes the state words from the last one to the first one,
+    // so the write of the word holding the state of the first entry publishes all items
+    err = alterEntryRangeState(begin, begin + entriesCount, EntryState::WRITTEN);
+    if (err != ESP_OK) {
+        mState = PageState::INVALID;
+        return err;
+    }
+
+    if (mFirstUsedEntry == INVALID_ENTRY) {
+        mFirstUsedEntry = begin;
+    }
+    mUsedEntryCount += entriesCount;
+    mNextFreeEntry += entriesCount;
+
+    return ESP_OK;
+}
+
 esp_err_t Page::readItem(uint8_t nsIndex, ItemType datatype, const char* key, void* data, size_t dataSize, uint8_t chunkIdx, VerOffset chunkStart)
 {
     size_t index = 0;
@@ -292,9 +404,12 @@ esp_err_t Page::readItem(uint8_t nsIndex, ItemType datatype, const char* key, vo
         dst += willCopy;
     }
     if (Item::calculateCrc32(reinterpret_cast<uint8_t * >(data), item.varLength.dataSize) != item.varLength.dataCrc32) {
-        rc = eraseEntryAndSpan(index);
-        if (rc != ESP_OK) {
-            return rc;
+        // concurrent readers must not modify the page, the item will be erased by the next writer
+        if (!Lock::readersActive()) {
+            rc = eraseEntryAndSpan(index);
+            if (rc != ESP_OK) {
+                return rc;
+            }
         }
         return ESP_ERR_NVS_NOT_FOUND;
     }
@@ -390,7 +505,7 @@ esp_err_t Page::eraseEntryAndSpan(size_t index)
             return rc;
         }
         if (!item.checkHeaderConsistency(index)) {
-            mHashList.erase(index);
+            indexErase(index, nullptr);
             rc = alterEntryState(index, EntryState::ERASED);
             --mUsedEntryCount;
             ++mErasedEntryCount;
@@ -398,7 +513,7 @@ esp_err_t Page::eraseEntryAndSpan(size_t index)
                 return rc;
             }
         } else {
-            mHashList.erase(index);
+            indexErase(index, &item);
             span = item.span;
             for (ptrdiff_t i = index + span - 1; i >= static_cast<ptrdiff_t>(index); --i) {
                 rc = mEntryTable.get(i, &state);
@@ -463,8 +578,71 @@ esp_err_t Page::updateFirstUsedEntry(size_t index, size_t span)
     return ESP_OK;
 }
 
+esp_err_t Page::indexInsert(const Item& item, size_t index)
+{
+    esp_err_t err = mHashList.insert(item, index);
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (mKeyIndex) {
+        err = mKeyIndex->insert(item, this, index);
+        if (err != ESP_OK) {
+            mHashList.erase(index);
+            return err;
+        }
+    }
+    if (mOrderedIndex) {
+        err = mOrderedIndex->insert(item, this, index);
+        if (err != ESP_OK) {
+            mHashList.erase(index);
+            if (mKeyIndex) {
+                mKeyIndex->erase(item, this, index);
+            }
+            return err;
+        }
+    }
+    return ESP_OK;
+}
+
+void Page::indexErase(size_t index, const Item* item)
+{
+    mHashList.erase(index);
+    if (mKeyIndex) {
+        if (item) {
+            mKeyIndex->erase(*item, this, index);
+        } else {
+            mKeyIndex->erase(this, index);
+        }
+    }
+    if (mOrderedIndex) {
+        if (item) {
+            mOrderedIndex->erase(*item, this, index);
+        } else {
+            mOrderedIndex->erase(this, index);
+        }
+    }
+}
+
+void Page::indexClear()
+{
+    mHashList.clear();
+    if (mKeyIndex) {
+        mKeyIndex->erasePage(this);
+    }
+    if (mOrderedIndex) {
+        mOrderedIndex->erasePage(this);
+    }
+}
+
 esp_err_t Page::copyItems(Page &other)
 {
+    if (!mItemsLoaded) {
+        auto err = mLoadItems();
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
     if (mFirstUsedEntry == INVALID_ENTRY) {
         return ESP_ERR_NVS_NOT_FOUND;
     }
@@ -496,7 +674,7 @@ esp_err_t Page::copyItems(Page &other)
             return err;
         }
 
-        err = other.mHashList.insert(entry, other.mNextFreeEntry);
+        err = other.indexInsert(entry, other.mNextFreeEntry);
         if (err != ESP_OK) {
             return err;
         }
@@ -656,7 +834,7 @@ esp_err_t Page::mLoadEntryTable()
                 continue;
             }
 
-            err = mHashList.insert(item, i);
+            err = indexInsert(item, i);
             if (err != ESP_OK) {
                 mState = PageState::INVALID;
                 return err;
@@ -694,6 +872,63 @@ esp_err_t Page::mLoadEntryTable()
             }
         }
 
+        // items written by writeItems() are published by the state of their first entry, which is written last.
+        // If power failed before that, the following entries may already be written to flash, and some of their
+        // states may be set, although the entry at mNextFreeEntry looks empty (e.g. a data entry starting with
+        // 0xffffffff). None of these entries belongs to a valid item and they must not be written over, so erase
+        // everything up to the last entry which is not empty, either in the state table or in flash.
+        size_t lastDirtyEntry = INVALID_ENTRY;
+        for (size_t i = ENTRY_COUNT; i > mNextFreeEntry && lastDirtyEntry == INVALID_ENTRY; --i) {
+            err = mEntryTable.get(i - 1, &state);
+            if (err != ESP_OK) {
+                return err;
+            }
+            if (state != EntryState::EMPTY) {
+                lastDirtyEntry = i - 1;
+                continue;
+            }
+            uint32_t entryAddress;
+            err = getEntryAddress(i - 1, &entryAddress);
+            if (err != ESP_OK) {
+                return err;
+            }
+            uint32_t words[ENTRY_SIZE / sizeof(uint32_t)];
+            err = mPartition->read_raw(entryAddress, words, sizeof(words));
+            if (err != ESP_OK) {
+                mState = PageState::INVALID;
+                return err;
+            }
+            for (size_t j = 0; j < sizeof(words) / sizeof(words[0]); ++j) {
+                if (words[j] != 0xffffffff) {
+                    lastDirtyEntry = i - 1;
+                    break;
+                }
+            }
+        }
+        if (lastDirtyEntry != INVALID_ENTRY) {
+            for (size_t i = mNextFreeEntry; i <= lastDirtyEntry; ++i) {
+                err = mEntryTable.get(i, &state);
+                if (err != ESP_OK) {
+                    return err;
+                }
+                if (state == EntryState::WRITTEN) {
+                    --mUsedEntryCount;
+                }
+                if (state != EntryState::ERASED) {
+                    ++mErasedEntryCount;
+                }
+            }
+            err = alterEntryRangeState(mNextFreeEntry, lastDirtyEntry + 1, EntryState::ERASED);
+            if (err != ESP_OK) {
+                mState = PageState::INVALID;
+                return err;
+            }
+            if (mFirstUsedEntry != INVALID_ENTRY && mFirstUsedEntry >= mNextFreeEntry) {
+                mFirstUsedEntry = INVALID_ENTRY;
+            }
+            mNextFreeEntry = lastDirtyEntry + 1;
+        }
+
         // check that last item is not duplicate
         if (lastItemIndex != INVALID_ENTRY) {
             size_t findItemIndex = 0;
@@ -709,59 +944,75 @@ esp_err_t Page::mLoadEntryTable()
             }
         }
     } else if (mState == PageState::FULL || mState == PageState::FREEING) {
-        // We have already filled mHashList for page in active state.
-        // Do the same for the case when page is in full or freeing state.
-        Item item;
-        for (size_t i = mFirstUsedEntry; i < ENTRY_COUNT; ++i) {
-            auto err = mEntryTable.get(i, &state);
-            if (err != ESP_OK) {
-                return err;
-            }
-            if (state != EntryState::WRITTEN) {
-                continue;
-            }
+#ifdef CONFIG_NVS_FAST_MOUNT
+        // Items of full pages are read when the page is accessed for the first time
+        if (mState == PageState::FULL) {
+            mItemsLoaded = false;
+            return ESP_OK;
+        }
+#endif
+        return mLoadItems();
+    }
 
-            err = readEntry(i, item);
-            if (err != ESP_OK) {
-                mState = PageState::INVALID;
-                return err;
-            }
+    return ESP_OK;
+}
 
-            if (!item.checkHeaderConsistency(i)) {
-                err = eraseEntryAndSpan(i);
-                if (err != ESP_OK) {
-                    mState = PageState::INVALID;
-                    return err;
-                }
-                continue;
-            }
+esp_err_t Page::mLoadItems()
+{
+    mItemsLoaded = true;
 
-            NVS_ASSERT_OR_RETURN(item.span > 0, ESP_FAIL);
+    // We have already filled mHashList for page in active state.
+    // Do the same for the case when page is in full or freeing state.
+    EntryState state;
+    Item item;
+    for (size_t i = mFirstUsedEntry; i < ENTRY_COUNT; ++i) {
+        auto err = mEntryTable.get(i, &state);
+        if (err != ESP_OK) {
+            return err;
+        }
+        if (state != EntryState::WRITTEN) {
+            continue;
+        }
+
+        err = readEntry(i, item);
+        if (err != ESP_OK) {
+            mState = PageState::INVALID;
+            return err;
+        }
 
-            err = mHashList.insert(item, i);
+        if (!item.checkHeaderConsistency(i)) {
+            err = eraseEntryAndSpan(i);
             if (err != ESP_OK) {
                 mState = PageState::INVALID;
                 return err;
             }
+            continue;
+        }
 
-            size_t span = item.span;
+        NVS_ASSERT_OR_RETURN(item.span > 0, ESP_FAIL);
 
-            if (isVariableLengthType(item.datatype)) {
-                for (size_t j = i + 1; j < i + span; ++j) {
-                    err = mEntryTable.get(j, &state);
-                    if (err != ESP_OK) {
-                        return err;
-                    }
-                    if (state != EntryState::WRITTEN) {
-                        eraseEntryAndSpan(i);
-                        break;
-                    }
+        err = indexInsert(item, i);
+        if (err != ESP_OK) {
+            mState = PageState::INVALID;
+            return err;
+        }
+
+        size_t span = item.span;
+
+        if (isVariableLengthType(item.datatype)) {
+            for (size_t j = i + 1; j < i + span; ++j) {
+                err = mEntryTable.get(j, &state);
+                if (err != ESP_OK) {
+                    return err;
+                }
+                if (state != EntryState::WRITTEN) {
+                    eraseEntryAndSpan(i);
+                    break;
                 }
             }
-
-            i += span - 1;
         }
 
+        i += span - 1;
     }
 
     return ESP_OK;
@@ -868,6 +1119,13 @@ esp_err_t Page::findItem(uint8_t nsIndex, ItemType datatype, const char* key, si
         return ESP_ERR_NVS_NOT_FOUND;
     }
 
+    if (!mItemsLoaded) {
+        auto err = mLoadItems();
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
     size_t findBeginIndex = itemIndex;
     if (findBeginIndex >= ENTRY_COUNT) {
         return ESP_ERR_NVS_NOT_FOUND;
@@ -910,11 +1168,17 @@ esp_err_t Page::findItem(uint8_t nsIndex, ItemType datatype, const char* key, si
 
         rc = readEntry(i, item);
         if (rc != ESP_OK) {
-            mState = PageState::INVALID;
+            if (!Lock::readersActive()) {
+                mState = PageState::INVALID;
+            }
             return rc;
         }
 
         if (!item.checkHeaderConsistency(i)) {
+            // concurrent readers just skip the entry, it will be erased by the next writer
+            if (Lock::readersActive()) {
+                continue;
+            }
             rc = eraseEntryAndSpan(i);
             if (rc != ESP_OK) {
                 mState = PageState::INVALID;
@@ -1003,6 +1267,40 @@ esp_err_t Page::getSeqNumber(uint32_t &seqNumber) const
     return ESP_ERR_NVS_NOT_INITIALIZED;
 }
 
+uint32_t Page::calcStateCrc32(uint32_t crc, size_t end) const
+{
+    // an uninitialized page is taken for the active page it becomes when it is written to
+    PageState state = mState;
+    TEntryTable entryTable = mEntryTable;
+    if (state == PageState::UNINITIALIZED) {
+        state = PageState::ACTIVE;
+        std::fill_n(entryTable.data(), entryTable.byteSize() / sizeof(uint32_t), 0xffffffff);
+    }
+    for (size_t i = end; i < ENTRY_COUNT; ++i) {
+        entryTable.set(i, EntryState::EMPTY);
+    }
+    crc = esp_rom_crc32_le(crc, reinterpret_cast<const uint8_t*>(&state), sizeof(state));
+    crc = esp_rom_crc32_le(crc, reinterpret_cast<const uint8_t*>(&mSeqNumber), sizeof(mSeqNumber));
+    return esp_rom_crc32_le(crc, reinterpret_cast<const uint8_t*>(entryTable.data()), entryTable.byteSize());
+}
+
+esp_err_t Page::checkEntryTable() const
+{
+    if (mState == PageState::UNINITIALIZED) {
+        return ESP_OK;
+    }
+
+    TEntryTable entryTable;
+    auto rc = mPartition->read_raw(mBaseAddress + ENTRY_TABLE_OFFSET, entryTable.data(), entryTable.byteSize());
+    if (rc != ESP_OK) {
+        return rc;
+    }
+    if (memcmp(entryTable.data(), mEntryTable.data(), entryTable.byteSize()) != 0) {
+        return ESP_ERR_NVS_INVALID_STATE;
+    }
+    return ESP_OK;
+}
+
 esp_err_t Page::setSeqNumber(uint32_t seqNumber)
 {
     if (mState != PageState::UNINITIALIZED) {
@@ -1033,7 +1331,8 @@ esp_err_t Page::erase()
     mFirstUsedEntry = INVALID_ENTRY;
     mNextFreeEntry = INVALID_ENTRY;
     mState = PageState::UNINITIALIZED;
-    mHashList.clear();
+    mItemsLoaded = true;
+    indexClear();
     return ESP_OK;
 }
 
@@ -1064,6 +1363,24 @@ size_t Page::getVarDataTailroom() const
     return ((mNextFreeEntry < (ENTRY_COUNT - 1)) ? ((ENTRY_COUNT - mNextFreeEntry - 1) * ENTRY_SIZE) : 0);
 }
 
+size_t Page::getFreeEntryCount() const
+{
+    if (mState == PageState::UNINITIALIZED) {
+        return ENTRY_COUNT;
+    } else if (mState != PageState::ACTIVE) {
+        return 0;
+    }
+    return (mNextFreeEntry < ENTRY_COUNT) ? (ENTRY_COUNT - mNextFreeEntry) : 0;
+}
+
+size_t Page::getItemEntryCount(ItemType datatype, size_t dataSize)
+{
+    if (!isVariableLengthType(datatype)) {
+        return 1;
+    }
+    return 1 + (dataSize + ENTRY_SIZE - 1) / ENTRY_SIZE;
+}
+
 const char* Page::pageStateToName(PageState ps)
 {
     switch (ps) {
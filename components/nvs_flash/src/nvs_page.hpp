@@ -15,6 +15,8 @@
 #include "compressed_enum_table.hpp"
 #include "intrusive_list.h"
 #include "nvs_item_hash_list.hpp"
+#include "nvs_key_index.hpp"
+#include "nvs_ordered_index.hpp"
 #include "nvs_memory_management.hpp"
 #include "partition.hpp"
 #include "nvs_constants.h"
@@ -80,6 +82,23 @@ public:
 
     esp_err_t load(Partition *partition, uint32_t sectorNumber);
 
+    /**
+     * Sets the partition-wide index which is kept in sync with the HashList of this page.
+     * Has to be called before load() to have the items found during loading indexed.
+     */
+    void setKeyIndex(KeyIndex* keyIndex)
+    {
+        mKeyIndex = keyIndex;
+    }
+
+    /**
+     * Sets the sorted index used for entry iteration, see setKeyIndex().
+     */
+    void setOrderedIndex(OrderedIndex* orderedIndex)
+    {
+        mOrderedIndex = orderedIndex;
+    }
+
     esp_err_t getSeqNumber(uint32_t& seqNumber) const;
 
     esp_err_t setSeqNumber(uint32_t seqNumber);
@@ -88,6 +107,28 @@ public:
 
     esp_err_t writeItem(uint8_t nsIndex, ItemType datatype, const char* key, const void* data, size_t dataSize, uint8_t chunkIdx = CHUNK_ANY);
 
+    /**
+     * Item to be written by writeItems().
+     */
+    struct ItemWrite {
+        ItemType datatype;
+        const char* key;
+        const void* data;
+        size_t dataSize;
+        uint8_t chunkIdx;
+    };
+
+    /**
+     * Writes several items into consecutive entries of this page with a single flash write.
+     *
+     * The entry states are updated afterwards from the last entry towards the first one, so all items become
+     * visible at once when the state of the first entry is written. If power is lost before that, none of the
+     * items is found after the page is loaded again.
+     *
+     * @return ESP_ERR_NVS_PAGE_FULL if the items don't fit into the free entries of this page.
+     */
+    esp_err_t writeItems(uint8_t nsIndex, const ItemWrite* items, size_t count);
+
     esp_err_t readItem(uint8_t nsIndex, ItemType datatype, const char* key, void* data, size_t dataSize, uint8_t chunkIdx = CHUNK_ANY, VerOffset chunkStart = VerOffset::VER_ANY);
 
     esp_err_t cmpItem(uint8_t nsIndex, ItemType datatype, const char* key, const void* data, size_t dataSize, uint8_t chunkIdx = CHUNK_ANY, VerOffset chunkStart = VerOffset::VER_ANY);
@@ -133,8 +174,31 @@ public:
     {
         return mErasedEntryCount;
     }
+
+    size_t getHashListRamUsage() const
+    {
+        return mHashList.getRamUsage();
+    }
     size_t getVarDataTailroom() const ;
 
+    /**
+     * Updates crc with the state and sequence number of this page and the states of the entries before end,
+     * later entries are taken as empty.
+     */
+    uint32_t calcStateCrc32(uint32_t crc, size_t end) const;
+
+    /**
+     * Returns ESP_ERR_NVS_INVALID_STATE if the entry state table in flash differs from the loaded one.
+     */
+    esp_err_t checkEntryTable() const;
+
+    size_t getFreeEntryCount() const;
+
+    /**
+     * Returns the number of entries an item of the given type and size occupies.
+     */
+    static size_t getItemEntryCount(ItemType datatype, size_t dataSize);
+
     esp_err_t markFull();
 
     esp_err_t markFreeing();
@@ -176,6 +240,8 @@ protected:
 
     esp_err_t mLoadEntryTable();
 
+    esp_err_t mLoadItems();
+
     esp_err_t initialize();
 
     esp_err_t alterEntryState(size_t index, EntryState state);
@@ -192,6 +258,12 @@ protected:
 
     esp_err_t updateFirstUsedEntry(size_t index, size_t span);
 
+    esp_err_t indexInsert(const Item& item, size_t index);
+
+    void indexErase(size_t index, const Item* item);
+
+    void indexClear();
+
     static constexpr size_t getAlignmentForType(ItemType type)
     {
         return static_cast<uint8_t>(type) & 0x0f;
@@ -219,11 +291,26 @@ protected:
     uint16_t mUsedEntryCount = 0;
     uint16_t mErasedEntryCount = 0;
 
+    /**
+     * False while the items of a full page have not been read into mHashList yet, see CONFIG_NVS_FAST_MOUNT.
+     */
+    bool mItemsLoaded = true;
+
     /**
      * This hash list stores hashes of namespace index, key, and ChunkIndex for quick lookup when searching items.
      */
     HashList mHashList;
 
+    /**
+     * Optional partition-wide index, updated together with mHashList.
+     */
+    KeyIndex* mKeyIndex = nullptr;
+
+    /**
+     * Optional partition-wide sorted index for iteration, updated together with mHashList.
+     */
+    OrderedIndex* mOrderedIndex = nullptr;
+
     Partition *mPartition;
 
     static const uint32_t HEADER_OFFSET = NVS_CONST_PAGE_HEADER_OFFSET;
@@ -7,7 +7,8 @@
 
 namespace nvs
 {
-esp_err_t PageManager::load(Partition *partition, uint32_t baseSector, uint32_t sectorCount)
+esp_err_t PageManager::load(Partition *partition, uint32_t baseSector, uint32_t sectorCount, KeyIndex *keyIndex,
+                            OrderedIndex *orderedIndex)
 {
     if (partition == nullptr) {
         return ESP_ERR_INVALID_ARG;
@@ -22,6 +23,8 @@ esp_err_t PageManager::load(Partition *partition, uint32_t baseSector, uint32_t
     if (!mPages) return ESP_ERR_NO_MEM;
 
     for (uint32_t i = 0; i < sectorCount; ++i) {
+        mPages[i].setKeyIndex(keyIndex);
+        mPages[i].setOrderedIndex(orderedIndex);
         auto err = mPages[i].load(partition, baseSector + i);
         if (err != ESP_OK) {
             return err;
@@ -54,81 +57,265 @@ esp_err_t PageManager::load(Partition *partition, uint32_t baseSector, uint32_t
         mSeqNumber = lastSeqNo + 1;
     }
 
-    // if power went out after a new item for the given key was written,
-    // but before the old one was erased, we end up with a duplicate item
-    Page& lastPage = back();
-    size_t lastItemIndex = SIZE_MAX;
-    Item item;
-    size_t itemIndex = 0;
-    while (lastPage.findItem(Page::NS_ANY, ItemType::ANY, nullptr, itemIndex, item) == ESP_OK) {
-        itemIndex += item.span;
-        lastItemIndex = itemIndex;
-    }
+    bool snapshotCurrent = false;
+#ifdef CONFIG_NVS_FAST_MOUNT
+    snapshotCurrent = isSnapshotCurrent();
+    mHasSnapshot = snapshotCurrent;
+#endif
 
-    if (lastItemIndex != SIZE_MAX) {
+    // a current snapshot shows that no write was interrupted since the snapshot was written
+    if (!snapshotCurrent) {
+        // if power went out after a new item for the given key was written,
+        // but before the old one was erased, we end up with a duplicate item.
+        // A transaction commit writes several items to the last page at once,
+        // so all items of the last page are checked, not only the last one.
+        Page& lastPage = back();
         auto last = PageManager::TPageListIterator(&lastPage);
-        TPageListIterator it;
+        Item item;
+        size_t itemIndex = 0;
+        while (lastPage.findItem(Page::NS_ANY, ItemType::ANY, nullptr, itemIndex, item) == ESP_OK) {
+            itemIndex += item.span;
+            TPageListIterator it;
 
-        for (it = begin(); it != last; ++it) {
-
-            if ((it->state() != Page::PageState::FREEING) &&
-                    (it->eraseItem(item.nsIndex, item.datatype, item.key, item.chunkIndex) == ESP_OK)) {
-                break;
-            }
-        }
-        if ((it == last) && (item.datatype == ItemType::BLOB_IDX)) {
-            /* Rare case in which the blob was stored using old format, but power went just after writing
-             * blob index during modification. Loop again and delete the old version blob*/
             for (it = begin(); it != last; ++it) {
 
                 if ((it->state() != Page::PageState::FREEING) &&
-                        (it->eraseItem(item.nsIndex, ItemType::BLOB, item.key, item.chunkIndex) == ESP_OK)) {
+                        (it->eraseItem(item.nsIndex, item.datatype, item.key, item.chunkIndex) == ESP_OK)) {
                     break;
                 }
             }
+            if ((it == last) && (item.datatype == ItemType::BLOB_IDX)) {
+                /* Rare case in which the blob was stored using old format, but power went just after writing
+                 * blob index during modification. Loop again and delete the old version blob*/
+                for (it = begin(); it != last; ++it) {
+
+                    if ((it->state() != Page::PageState::FREEING) &&
+                            (it->eraseItem(item.nsIndex, ItemType::BLOB, item.key, item.chunkIndex) == ESP_OK)) {
+                        break;
+                    }
+                }
+            }
         }
     }
 
     // check if power went out while page was being freed
     for (auto it = begin(); it!= end(); ++it) {
         if (it->state() == Page::PageState::FREEING) {
-            Page* newPage = &mPageList.back();
-            if (newPage->state() == Page::PageState::ACTIVE) {
-                auto err = newPage->erase();
-                if (err != ESP_OK) {
-                    return err;
-                }
-                mPageList.erase(newPage);
-                mFreePageList.push_back(newPage);
-            }
-            auto err = activatePage();
+            auto err = recoverFreeingPage(it);
             if (err != ESP_OK) {
                 return err;
             }
-            newPage = &mPageList.back();
+            break;
+        }
+    }
 
-            err = it->copyItems(*newPage);
-            if (err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
-                return err;
+#ifdef CONFIG_NVS_FAST_MOUNT
+    // remove outdated snapshots, so that only the last pages have to be searched for them later
+    if (!snapshotCurrent) {
+        for (auto it = begin(); it != end(); ++it) {
+            it->eraseItem(Page::NS_INDEX, ItemType::BLOB, SNAPSHOT_KEY);
+        }
+    }
+#endif
+
+    // partition should have at least one free page
+    if (mFreePageList.empty()) {
+        return ESP_ERR_NVS_NO_FREE_PAGES;
+    }
+
+    return ESP_OK;
+}
+
+#ifdef CONFIG_NVS_FAST_MOUNT
+const char PageManager::SNAPSHOT_KEY[] = "nvs.snapshot";
+
+uint32_t PageManager::calcDigest(size_t lastPageEnd)
+{
+    uint32_t crc = UINT32_MAX;
+    for (auto it = begin(); it != end(); ++it) {
+        crc = it->calcStateCrc32(crc, (it == TPageListIterator(&back())) ? lastPageEnd : Page::ENTRY_COUNT);
+    }
+    return crc;
+}
+
+esp_err_t PageManager::readSnapshot(void* data, size_t& size)
+{
+    Page& lastPage = back();
+    if (lastPage.state() != Page::PageState::ACTIVE) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+
+    Item item;
+    size_t itemIndex = 0;
+    auto err = lastPage.findItem(Page::NS_INDEX, ItemType::BLOB, SNAPSHOT_KEY, itemIndex, item);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    // the snapshot is only current if nothing has been written after it
+    size_t dataSize = item.varLength.dataSize;
+    if (itemIndex + item.span + lastPage.getFreeEntryCount() != Page::ENTRY_COUNT
+            || dataSize < sizeof(SnapshotHeader)) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+
+    if (data == nullptr) {
+        size = dataSize;
+        return ESP_OK;
+    }
+
+    err = lastPage.readItem(Page::NS_INDEX, ItemType::BLOB, SNAPSHOT_KEY, data, size);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    uint32_t seqNumber;
+    err = lastPage.getSeqNumber(seqNumber);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    auto header = static_cast<const SnapshotHeader*>(data);
+    if (header->version != SNAPSHOT_VERSION || header->seqNumber != seqNumber
+            || header->digest != calcDigest(itemIndex)) {
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+
+    size = dataSize;
+    return ESP_OK;
+}
+
+bool PageManager::isSnapshotCurrent()
+{
+    size_t size = 0;
+    if (readSnapshot(nullptr, size) != ESP_OK) {
+        return false;
+    }
+
+    std::unique_ptr<uint8_t[]> data(new (nothrow) uint8_t[size]);
+    return data && readSnapshot(data.get(), size) == ESP_OK;
+}
+
+esp_err_t PageManager::writeSnapshot(void* data, size_t size)
+{
+    NVS_ASSERT_OR_RETURN(size >= sizeof(SnapshotHeader), ESP_ERR_INVALID_ARG);
+
+    if (size > Page::CHUNK_MAX_SIZE) {
+        return ESP_ERR_NVS_VALUE_TOO_LONG;
+    }
+
+    if (mHasSnapshot) {
+        if (isSnapshotCurrent()) {
+            return ESP_OK;
+        }
+
+        // the previous snapshot is usually found on one of the last pages
+        for (auto it = TPageListIterator(&back()); it != end(); --it) {
+            if (it->eraseItem(Page::NS_INDEX, ItemType::BLOB, SNAPSHOT_KEY) == ESP_OK) {
+                break;
             }
+        }
+        mHasSnapshot = false;
+    }
 
-            err = it->erase();
+    if (back().getVarDataTailroom() < size) {
+        if (back().state() == Page::PageState::ACTIVE) {
+            auto err = back().markFull();
             if (err != ESP_OK) {
                 return err;
             }
+        }
+        auto err = requestNewPage();
+        if (err != ESP_OK) {
+            return err;
+        }
+        if (back().getVarDataTailroom() < size) {
+            return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+        }
+    }
 
-            Page* p = static_cast<Page*>(it);
-            mPageList.erase(it);
-            mFreePageList.push_back(p);
-            break;
+    // don't write over anything which has been written without updating the loaded page
+    Page& lastPage = back();
+    auto err = lastPage.checkEntryTable();
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    // the last page may not be initialized yet, its sequence number is the last one assigned
+    auto header = static_cast<SnapshotHeader*>(data);
+    header->version = SNAPSHOT_VERSION;
+    header->seqNumber = mSeqNumber - 1;
+    header->digest = calcDigest(Page::ENTRY_COUNT - lastPage.getFreeEntryCount());
+
+    err = lastPage.writeItem(Page::NS_INDEX, ItemType::BLOB, SNAPSHOT_KEY, data, size);
+    if (err != ESP_OK) {
+        return err;
+    }
+    mHasSnapshot = true;
+    return ESP_OK;
+}
+#endif // CONFIG_NVS_FAST_MOUNT
+
+esp_err_t PageManager::recoverFreeingPage(TPageListIterator freeingPage)
+{
+    Page* newPage = &mPageList.back();
+    Item item;
+    size_t itemIndex = 0;
+
+    // Usually the items were being copied to a newly activated page, which then holds nothing but copies
+    // and can simply be erased. collectGarbage() copies them to the active page though, which also holds
+    // other items. In that case only the items which have not been copied yet are copied again.
+    bool onlyCopies = (newPage->state() == Page::PageState::ACTIVE);
+    while (onlyCopies && newPage->findItem(Page::NS_ANY, ItemType::ANY, nullptr, itemIndex, item) == ESP_OK) {
+        itemIndex += item.span;
+        onlyCopies = (freeingPage->findItem(item.nsIndex, item.datatype, item.key, item.chunkIndex) == ESP_OK);
+    }
+
+    if (onlyCopies) {
+        auto err = newPage->erase();
+        if (err != ESP_OK) {
+            return err;
+        }
+        mPageList.erase(newPage);
+        mFreePageList.push_back(newPage);
+    } else {
+        itemIndex = 0;
+        while (freeingPage->findItem(Page::NS_ANY, ItemType::ANY, nullptr, itemIndex, item) == ESP_OK) {
+            itemIndex += item.span;
+            for (auto it = begin(); it != end(); ++it) {
+                if (it != freeingPage && it->findItem(item.nsIndex, item.datatype, item.key, item.chunkIndex) == ESP_OK) {
+                    auto err = freeingPage->eraseItem(item.nsIndex, item.datatype, item.key, item.chunkIndex);
+                    if (err != ESP_OK) {
+                        return err;
+                    }
+                    break;
+                }
+            }
         }
     }
 
-    // partition should have at least one free page
-    if (mFreePageList.empty()) {
-        return ESP_ERR_NVS_NO_FREE_PAGES;
+    if (newPage == static_cast<Page*>(freeingPage) || onlyCopies
+            || newPage->getFreeEntryCount() < freeingPage->getUsedEntryCount()) {
+        auto err = activatePage();
+        if (err != ESP_OK) {
+            return err;
+        }
+        newPage = &mPageList.back();
+    }
+
+    auto err = freeingPage->copyItems(*newPage);
+    if (err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
+        return err;
+    }
+
+    err = freeingPage->erase();
+    if (err != ESP_OK) {
+        return err;
     }
 
+    Page* p = static_cast<Page*>(freeingPage);
+    mPageList.erase(freeingPage);
+    mFreePageList.push_back(p);
     return ESP_OK;
 }
 
@@ -195,6 +382,69 @@ esp_err_t PageManager::requestNewPage()
     return ESP_OK;
 }
 
+#ifdef CONFIG_NVS_GC_STEP
+esp_err_t PageManager::collectGarbage(size_t maxEntries)
+{
+    if (mFreePageList.size() >= CONFIG_NVS_GC_FREE_PAGES_RESERVE) {
+        return ESP_OK;
+    }
+
+    // Items are copied to the active page, so that the page being freed is gained as a whole.
+    // Choose the page with the highest number of erased items among the ones fitting into it.
+    Page* activePage = &mPageList.back();
+    size_t freeEntries = activePage->getFreeEntryCount();
+    if (maxEntries != 0 && maxEntries < freeEntries) {
+        freeEntries = maxEntries;
+    }
+
+    TPageListIterator maxUnusedItemsPageIt;
+    size_t maxUnusedItems = 0;
+    for (auto it = begin(); it != end(); ++it) {
+        if (&*it == activePage || it->getUsedEntryCount() > freeEntries) {
+            continue;
+        }
+
+        auto unused =  Page::ENTRY_COUNT - it->getUsedEntryCount();
+        if (unused > maxUnusedItems) {
+            maxUnusedItemsPageIt = it;
+            maxUnusedItems = unused;
+        }
+    }
+
+    if (maxUnusedItems == 0) {
+        return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+    }
+
+    Page* erasedPage = maxUnusedItemsPageIt;
+
+#ifndef NDEBUG
+    size_t usedEntries = erasedPage->getUsedEntryCount() + activePage->getUsedEntryCount();
+#endif
+    esp_err_t err = erasedPage->markFreeing();
+    if (err != ESP_OK) {
+        return err;
+    }
+    err = erasedPage->copyItems(*activePage);
+    if (err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
+        return err;
+    }
+
+    err = erasedPage->erase();
+    if (err != ESP_OK) {
+        return err;
+    }
+
+#ifndef NDEBUG
+    NVS_ASSERT_OR_RETURN(usedEntries == activePage->getUsedEntryCount(), ESP_FAIL);
+#endif
+
+    mPageList.erase(maxUnusedItemsPageIt);
+    mFreePageList.push_back(erasedPage);
+
+    return (mFreePageList.size() >= CONFIG_NVS_GC_FREE_PAGES_RESERVE) ? ESP_OK : ESP_ERR_NOT_FINISHED;
+}
+#endif // CONFIG_NVS_GC_STEP
+
 esp_err_t PageManager::activatePage()
 {
     if (mFreePageList.empty()) {
@@ -241,4 +491,14 @@ esp_err_t PageManager::fillStats(nvs_stats_t& nvsStats)
     return err;
 }
 
+void PageManager::fillRamUsage(nvs_ram_usage_t& ramUsage)
+{
+    ramUsage.page_count = mPageCount;
+    ramUsage.pages = mPageCount * sizeof(Page);
+    ramUsage.hash_lists = 0;
+    for (uint32_t i = 0; i < mPageCount; ++i) {
+        ramUsage.hash_lists += mPages[i].getHashListRamUsage();
+    }
+}
+
 } // namespace nvs
@@ -31,7 +31,8 @@ public:
 
     PageManager() {}
 
-    esp_err_t load(Partition *partition, uint32_t baseSector, uint32_t sectorCount);
+    esp_err_t load(Partition *partition, uint32_t baseSector, uint32_t sectorCount, KeyIndex *keyIndex = nullptr,
+                   OrderedIndex *orderedIndex = nullptr);
 
     TPageListIterator begin()
     {
@@ -54,18 +55,73 @@ public:
 
     esp_err_t requestNewPage();
 
+#ifdef CONFIG_NVS_GC_STEP
+    /**
+     * Frees one page ahead of time by copying its items to the active page, unless the partition has
+     * CONFIG_NVS_GC_FREE_PAGES_RESERVE free pages already. Only pages with at most maxEntries used
+     * entries are considered, 0 means no limit.
+     *
+     * @return ESP_OK if the reserve of free pages is complete, ESP_ERR_NOT_FINISHED if a page was freed
+     *         but more are needed, ESP_ERR_NVS_NOT_ENOUGH_SPACE if no page could be freed.
+     */
+    esp_err_t collectGarbage(size_t maxEntries);
+#endif
+
     esp_err_t fillStats(nvs_stats_t& nvsStats);
 
+    void fillRamUsage(nvs_ram_usage_t& ramUsage);
+
     uint32_t getBaseSector()
     {
         return mBaseSector;
     }
 
+#ifdef CONFIG_NVS_FAST_MOUNT
+    /**
+     * Header of the index snapshot, an item of the namespace table written to the active page. The digest
+     * covers the states and entry state tables of all pages right before the snapshot was written, so the
+     * snapshot is only considered current as long as nothing has been written or erased since.
+     */
+    struct SnapshotHeader {
+        uint32_t version;
+        uint32_t seqNumber;
+        uint32_t digest;
+    };
+
+    static const uint32_t SNAPSHOT_VERSION = 1;
+
+    /**
+     * Reads the snapshot into data, which has to start with a SnapshotHeader. If data is nullptr, only its
+     * size is returned.
+     *
+     * @return ESP_ERR_NVS_NOT_FOUND if there is no current snapshot.
+     */
+    esp_err_t readSnapshot(void* data, size_t& size);
+
+    /**
+     * Replaces the snapshot by data, the SnapshotHeader at its beginning is filled in. Nothing is written if
+     * the current snapshot is still valid.
+     */
+    esp_err_t writeSnapshot(void* data, size_t size);
+#endif
+
 protected:
     friend class Iterator;
 
     esp_err_t activatePage();
 
+    esp_err_t recoverFreeingPage(TPageListIterator freeingPage);
+
+#ifdef CONFIG_NVS_FAST_MOUNT
+    static const char SNAPSHOT_KEY[];
+
+    uint32_t calcDigest(size_t lastPageEnd);
+
+    bool isSnapshotCurrent();
+
+    bool mHasSnapshot = false;
+#endif
+
     TPageList mPageList;
     TPageList mFreePageList;
     std::unique_ptr<Page[]> mPages;
@@ -7,7 +7,45 @@
 
 using namespace nvs;
 
-#ifdef LINUX_TARGET
+#if defined(CONFIG_NVS_CONCURRENT_READS)
+
+Lock::Lock()
+{
+    // Statically initialized lock, lazily set up by the first call on the target
+    pthread_rwlock_wrlock(&mRwLock);
+}
+
+Lock::~Lock()
+{
+    pthread_rwlock_unlock(&mRwLock);
+}
+
+esp_err_t Lock::init()
+{
+    return ESP_OK;
+}
+
+void Lock::uninit()
+{
+    // The lock stays usable, nvs may be initialized again afterwards
+}
+
+ReadLock::ReadLock()
+{
+    pthread_rwlock_rdlock(&Lock::mRwLock);
+    Lock::mReaders.fetch_add(1, std::memory_order_relaxed);
+}
+
+ReadLock::~ReadLock()
+{
+    Lock::mReaders.fetch_sub(1, std::memory_order_relaxed);
+    pthread_rwlock_unlock(&Lock::mRwLock);
+}
+
+pthread_rwlock_t Lock::mRwLock = PTHREAD_RWLOCK_INITIALIZER;
+std::atomic<uint32_t> Lock::mReaders(0);
+
+#elif defined(LINUX_TARGET)
 Lock::Lock() {}
 Lock::~Lock() {}
 esp_err_t nvs::Lock::init() {return ESP_OK;}
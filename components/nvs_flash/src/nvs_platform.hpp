@@ -6,12 +6,19 @@
 #pragma once
 
 #include "esp_err.h"
-#ifndef LINUX_TARGET
+#include "sdkconfig.h"
+#ifdef CONFIG_NVS_CONCURRENT_READS
+#include <atomic>
+#include <pthread.h>
+#elif !defined(LINUX_TARGET)
 #include <sys/lock.h>
 #endif
 
 namespace nvs
 {
+    /**
+     * Exclusive lock, held by all operations which may modify the storage.
+     */
     class Lock
     {
     public:
@@ -19,9 +26,43 @@ namespace nvs
         ~Lock();
         static esp_err_t init();
         static void uninit();
-#ifndef LINUX_TARGET
+
+        /**
+         * Returns true if the storage is being accessed by holders of a ReadLock. As they may run in parallel,
+         * code called on their behalf must not modify any state, e.g. to erase inconsistent entries.
+         */
+        static bool readersActive()
+        {
+#ifdef CONFIG_NVS_CONCURRENT_READS
+            return mReaders.load(std::memory_order_relaxed) != 0;
+#else
+            return false;
+#endif
+        }
+
+#ifdef CONFIG_NVS_CONCURRENT_READS
+    private:
+        friend class ReadLock;
+        static pthread_rwlock_t mRwLock;
+        static std::atomic<uint32_t> mReaders;
+#elif !defined(LINUX_TARGET)
     private:
         static _lock_t mSemaphore;
 #endif
     };
+
+#ifdef CONFIG_NVS_CONCURRENT_READS
+    /**
+     * Shared lock for operations which only read the storage. Any number of readers may hold it at the same time,
+     * Lock waits until all of them have released it.
+     */
+    class ReadLock
+    {
+    public:
+        ReadLock();
+        ~ReadLock();
+    };
+#else
+    typedef Lock ReadLock;
+#endif
 } // namespace nvs
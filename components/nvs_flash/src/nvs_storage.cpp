@@ -22,6 +22,7 @@
 
 #include "esp_log.h"
 #include "spi_flash_mmap.h"
+#include "nvs_platform.hpp"
 #define TAG "nvs_storage"
 
 #if defined(SEGGER_H) && defined(GLOBAL_H)
@@ -180,17 +181,8 @@ void Storage::eraseOrphanDataBlobs(TBlobIndexList& blobIdxList)
     }
 }
 
-esp_err_t Storage::init(uint32_t baseSector, uint32_t sectorCount)
+esp_err_t Storage::loadNamespaces()
 {
-    auto err = mPageManager.load(mPartition, baseSector, sectorCount);
-    if (err != ESP_OK) {
-        mState = StorageState::INVALID;
-        return err;
-    }
-
-    // load namespaces list
-    clearNamespaces();
-    std::fill_n(mNamespaceUsage.data(), mNamespaceUsage.byteSize() / 4, 0);
     for (auto it = mPageManager.begin(); it != mPageManager.end(); ++it) {
         Page& p = *it;
         size_t itemIndex = 0;
@@ -199,12 +191,11 @@ esp_err_t Storage::init(uint32_t baseSector, uint32_t sectorCount)
             NamespaceEntry* entry = new (std::nothrow) NamespaceEntry;
 
             if (!entry) {
-                mState = StorageState::INVALID;
                 return ESP_ERR_NO_MEM;
             }
 
             item.getKey(entry->mName, sizeof(entry->mName));
-            err = item.getValue(entry->mIndex);
+            auto err = item.getValue(entry->mIndex);
             if (err != ESP_OK) {
                 delete entry;
                 return err;
@@ -217,6 +208,119 @@ esp_err_t Storage::init(uint32_t baseSector, uint32_t sectorCount)
             itemIndex += item.span;
         }
     }
+    return ESP_OK;
+}
+
+#ifdef CONFIG_NVS_FAST_MOUNT
+esp_err_t Storage::loadSnapshot()
+{
+    size_t size = 0;
+    auto err = mPageManager.readSnapshot(nullptr, size);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    std::unique_ptr<uint8_t[]> data(new (std::nothrow) uint8_t[size]);
+    if (!data) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    err = mPageManager.readSnapshot(data.get(), size);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    auto ns = reinterpret_cast<const SnapshotNamespace*>(data.get() + sizeof(PageManager::SnapshotHeader));
+    size_t count = (size - sizeof(PageManager::SnapshotHeader)) / sizeof(SnapshotNamespace);
+    for (size_t i = 0; i < count; ++i) {
+        NamespaceEntry* entry = new (std::nothrow) NamespaceEntry;
+
+        if (!entry) {
+            clearNamespaces();
+            return ESP_ERR_NO_MEM;
+        }
+
+        memcpy(entry->mName, ns[i].name, sizeof(ns[i].name));
+        entry->mName[sizeof(ns[i].name)] = 0;
+        entry->mIndex = ns[i].index;
+        if (mNamespaceUsage.set(entry->mIndex, true) != ESP_OK) {
+            delete entry;
+            clearNamespaces();
+            return ESP_FAIL;
+        }
+        mNamespaces.push_back(entry);
+    }
+    return ESP_OK;
+}
+
+esp_err_t Storage::writeSnapshot()
+{
+    if (mState != StorageState::ACTIVE) {
+        return ESP_ERR_NVS_INVALID_STATE;
+    }
+
+    if (mPartition->get_readonly()) {
+        return ESP_ERR_NOT_ALLOWED;
+    }
+
+    // chunks written by open streams are left for init() to remove
+    if (mWriteStreamCount != 0) {
+        return ESP_ERR_NVS_INVALID_STATE;
+    }
+
+    size_t size = sizeof(PageManager::SnapshotHeader) + mNamespaces.size() * sizeof(SnapshotNamespace);
+    std::unique_ptr<uint8_t[]> data(new (std::nothrow) uint8_t[size]);
+    if (!data) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    auto ns = reinterpret_cast<SnapshotNamespace*>(data.get() + sizeof(PageManager::SnapshotHeader));
+    for (auto it = mNamespaces.begin(); it != mNamespaces.end(); ++it, ++ns) {
+        strncpy(ns->name, it->mName, sizeof(ns->name));
+        ns->index = it->mIndex;
+    }
+
+    return mPageManager.writeSnapshot(data.get(), size);
+}
+#endif // CONFIG_NVS_FAST_MOUNT
+
+esp_err_t Storage::init(uint32_t baseSector, uint32_t sectorCount)
+{
+    KeyIndex* keyIndex = nullptr;
+#ifdef CONFIG_NVS_GLOBAL_KEY_INDEX
+    mKeyIndex.clear();
+    keyIndex = &mKeyIndex;
+#endif
+    OrderedIndex* orderedIndex = nullptr;
+#ifdef CONFIG_NVS_ORDERED_INDEX
+    mOrderedIndex.clear();
+    orderedIndex = &mOrderedIndex;
+#endif
+    auto err = mPageManager.load(mPartition, baseSector, sectorCount, keyIndex, orderedIndex);
+    if (err != ESP_OK) {
+        mState = StorageState::INVALID;
+        return err;
+    }
+#ifdef CONFIG_NVS_ORDERED_INDEX
+    mOrderedIndex.sort();
+#endif
+
+    // load namespaces list
+    clearNamespaces();
+    std::fill_n(mNamespaceUsage.data(), mNamespaceUsage.byteSize() / 4, 0);
+
+    // a current snapshot holds the namespaces and shows that there are no inconsistent blobs to be removed
+    bool snapshotLoaded = false;
+#ifdef CONFIG_NVS_FAST_MOUNT
+    snapshotLoaded = (loadSnapshot() == ESP_OK);
+#endif
+    if (!snapshotLoaded) {
+        err = loadNamespaces();
+        if (err != ESP_OK) {
+            mState = StorageState::INVALID;
+            return err;
+        }
+    }
     if (mNamespaceUsage.set(0, true) != ESP_OK) {
         return ESP_FAIL;
     }
@@ -224,22 +328,24 @@ esp_err_t Storage::init(uint32_t baseSector, uint32_t sectorCount)
         return ESP_FAIL;
     }
 
-    // Populate list of multi-page index entries.
-    TBlobIndexList blobIdxList;
-    err = populateBlobIndices(blobIdxList);
-    if (err != ESP_OK) {
-        mState = StorageState::INVALID;
-        return ESP_ERR_NO_MEM;
-    }
+    if (!snapshotLoaded) {
+        // Populate list of multi-page index entries.
+        TBlobIndexList blobIdxList;
+        err = populateBlobIndices(blobIdxList);
+        if (err != ESP_OK) {
+            mState = StorageState::INVALID;
+            return ESP_ERR_NO_MEM;
+        }
 
-    // remove blob indexes with mismatched blob data length or chunk count
-    eraseMismatchedBlobIndexes(blobIdxList);
+        // remove blob indexes with mismatched blob data length or chunk count
+        eraseMismatchedBlobIndexes(blobIdxList);
 
-    // Remove the entries for which there is no parent multi-page index.
-    eraseOrphanDataBlobs(blobIdxList);
+        // Remove the entries for which there is no parent multi-page index.
+        eraseOrphanDataBlobs(blobIdxList);
 
-    // Purge the blob index list
-    blobIdxList.clearAndFreeNodes();
+        // Purge the blob index list
+        blobIdxList.clearAndFreeNodes();
+    }
 
     mState = StorageState::ACTIVE;
 
@@ -256,6 +362,15 @@ bool Storage::isValid() const
 
 esp_err_t Storage::findItem(uint8_t nsIndex, ItemType datatype, const char* key, Page* &page, Item& item, uint8_t chunkIdx, VerOffset chunkStart)
 {
+#ifdef CONFIG_NVS_GLOBAL_KEY_INDEX
+    if (KeyIndex::isIndexable(nsIndex, datatype, key, chunkIdx)) {
+        auto err = mKeyIndex.findItem(nsIndex, datatype, key, page, item, chunkIdx, chunkStart);
+        if (err != ESP_ERR_NOT_SUPPORTED) {
+            return err;
+        }
+        // too many candidates, fall back to the linear search below
+    }
+#endif
     for (auto it = std::begin(mPageManager); it != std::end(mPageManager); ++it) {
         size_t itemIndex = 0;
         auto err = it->findItem(nsIndex, datatype, key, itemIndex, item, chunkIdx, chunkStart);
@@ -527,6 +642,173 @@ esp_err_t Storage::writeItem(uint8_t nsIndex, ItemType datatype, const char* key
     return ESP_OK;
 }
 
+esp_err_t Storage::writeBatch(uint8_t nsIndex, TBatchList& batch)
+{
+    if (mState != StorageState::ACTIVE) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+
+    Page* findPage = nullptr;
+    Item item;
+    esp_err_t err;
+
+    // Skip the items which are not being modified, same as writeItem() does.
+    size_t writeCount = 0;
+    size_t entryCount = 0;
+    for (auto it = batch.begin(); it != batch.end(); ++it) {
+        if (it->datatype == ItemType::BLOB) {
+            err = findItem(nsIndex, ItemType::BLOB_IDX, it->key, findPage, item);
+            it->unchanged = (err == ESP_OK && cmpMultiPageBlob(nsIndex, it->key, it->data, it->dataSize) == ESP_OK);
+        } else {
+#ifdef CONFIG_NVS_LEGACY_DUP_KEYS_COMPATIBILITY
+            err = findItem(nsIndex, it->datatype, it->key, findPage, item);
+#else
+            err = findItem(nsIndex, ItemType::ANY, it->key, findPage, item);
+#endif
+            it->unchanged = (err == ESP_OK && item.datatype == it->datatype &&
+                    findPage->cmpItem(nsIndex, it->datatype, it->key, it->data, it->dataSize) == ESP_OK);
+        }
+        if (err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
+            return err;
+        }
+        if (it->unchanged) {
+            continue;
+        }
+        if (it->datatype == ItemType::BLOB) {
+            // single data chunk followed by the blob index
+            entryCount += Page::getItemEntryCount(ItemType::BLOB_DATA, it->dataSize) + 1;
+            writeCount += 2;
+        } else {
+            entryCount += Page::getItemEntryCount(it->datatype, it->dataSize);
+            writeCount += 1;
+        }
+    }
+
+    if (writeCount == 0) {
+        return ESP_OK;
+    }
+
+    if (entryCount > Page::ENTRY_COUNT) {
+        return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+    }
+
+    // Make room for all items first, the lookups below must not be invalidated by freeing a page.
+    Page* page = &getCurrentPage();
+    if (page->getFreeEntryCount() < entryCount) {
+        if (page->state() != Page::PageState::FULL) {
+            err = page->markFull();
+            if (err != ESP_OK) {
+                return err;
+            }
+        }
+        err = mPageManager.requestNewPage();
+        if (err != ESP_OK) {
+            return err;
+        }
+        page = &getCurrentPage();
+        if (page->getFreeEntryCount() < entryCount) {
+            return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+        }
+    }
+
+    for (auto it = batch.begin(); it != batch.end(); ++it) {
+        if (it->unchanged) {
+            continue;
+        }
+        it->oldPage = nullptr;
+        it->oldBlobIndex = false;
+        if (it->datatype == ItemType::BLOB) {
+            it->chunkStart = VerOffset::VER_0_OFFSET;
+            err = findItem(nsIndex, ItemType::BLOB_IDX, it->key, findPage, item);
+            if (err == ESP_OK) {
+                it->oldBlobIndex = true;
+                it->oldChunkStart = item.blobIndex.chunkStart;
+                NVS_ASSERT_OR_RETURN(it->oldChunkStart == VerOffset::VER_0_OFFSET
+                        || it->oldChunkStart == VerOffset::VER_1_OFFSET, ESP_FAIL);
+                it->chunkStart = (it->oldChunkStart == VerOffset::VER_1_OFFSET) ? VerOffset::VER_0_OFFSET : VerOffset::VER_1_OFFSET;
+            } else if (err == ESP_ERR_NVS_NOT_FOUND) {
+                /* Support for earlier versions where BLOBS were stored without index */
+                err = findItem(nsIndex, ItemType::BLOB, it->key, findPage, item);
+                if (err == ESP_OK) {
+                    it->oldPage = findPage;
+                }
+            }
+
+            Item index;
+            std::fill_n(index.data, sizeof(index.data), 0xff);
+            index.blobIndex.dataSize = it->dataSize;
+            index.blobIndex.chunkCount = 1;
+            index.blobIndex.chunkStart = it->chunkStart;
+            memcpy(it->blobIndex, index.data, sizeof(it->blobIndex));
+        } else {
+#ifdef CONFIG_NVS_LEGACY_DUP_KEYS_COMPATIBILITY
+            err = findItem(nsIndex, it->datatype, it->key, findPage, item);
+#else
+            err = findItem(nsIndex, ItemType::ANY, it->key, findPage, item);
+#endif
+            if (err == ESP_OK) {
+                it->oldPage = findPage;
+            }
+        }
+        if (err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
+            return err;
+        }
+    }
+
+    Page::ItemWrite* writes = new (std::nothrow) Page::ItemWrite[writeCount];
+    if (!writes) {
+        return ESP_ERR_NO_MEM;
+    }
+    size_t writeIndex = 0;
+    for (auto it = batch.begin(); it != batch.end(); ++it) {
+        if (it->unchanged) {
+            continue;
+        }
+        if (it->datatype == ItemType::BLOB) {
+            writes[writeIndex++] = {ItemType::BLOB_DATA, it->key, it->data, it->dataSize, static_cast<uint8_t>(it->chunkStart)};
+            writes[writeIndex++] = {ItemType::BLOB_IDX, it->key, it->blobIndex, sizeof(it->blobIndex), Page::CHUNK_ANY};
+        } else {
+            writes[writeIndex++] = {it->datatype, it->key, it->data, it->dataSize, Page::CHUNK_ANY};
+        }
+    }
+    err = page->writeItems(nsIndex, writes, writeCount);
+    delete[] writes;
+    if (err == ESP_ERR_NVS_PAGE_FULL) {
+        return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+    }
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    // all new values are visible now, remove the old ones
+    for (auto it = batch.begin(); it != batch.end(); ++it) {
+        if (it->unchanged) {
+            continue;
+        }
+        if (it->oldBlobIndex) {
+            err = eraseMultiPageBlob(nsIndex, it->key, it->oldChunkStart);
+        } else if (it->oldPage) {
+#ifdef CONFIG_NVS_LEGACY_DUP_KEYS_COMPATIBILITY
+            err = it->oldPage->eraseItem(nsIndex, it->datatype, it->key);
+#else
+            err = it->oldPage->eraseItem(nsIndex, (it->datatype == ItemType::BLOB) ? ItemType::BLOB : ItemType::ANY, it->key);
+#endif
+        } else {
+            continue;
+        }
+        if (err == ESP_ERR_FLASH_OP_FAIL) {
+            return ESP_ERR_NVS_REMOVE_FAILED;
+        }
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+#ifdef DEBUG_STORAGE
+    debugCheck();
+#endif
+    return ESP_OK;
+}
+
 esp_err_t Storage::createOrOpenNamespace(const char* nsName, bool canCreate, uint8_t& nsIndex)
 {
     if (mState != StorageState::ACTIVE) {
@@ -621,8 +903,12 @@ esp_err_t Storage::readMultiPageBlob(uint8_t nsIndex, const char* key, void* dat
     }
 
     if (err == ESP_ERR_NVS_NOT_FOUND || err == ESP_ERR_NVS_INVALID_LENGTH) {
-        // cleanup if a chunk is not found or the size is inconsistent
-        eraseMultiPageBlob(nsIndex, key);
+        // cleanup if a chunk is not found or the size is inconsistent, init() does the same unless it finds a
+        // current snapshot
+        if (!Lock::readersActive()) {
+            eraseMultiPageBlob(nsIndex, key);
+        }
+        return ESP_ERR_NVS_NOT_FOUND;
     }
 
     NVS_ASSERT_OR_RETURN(offset == dataSize, ESP_FAIL);
@@ -729,6 +1015,14 @@ esp_err_t Storage::eraseMultiPageBlob(uint8_t nsIndex, const char* key, VerOffse
         }
     }
 
+    return eraseBlobData(nsIndex, key, chunkStart);
+}
+
+esp_err_t Storage::eraseBlobData(uint8_t nsIndex, const char* key, VerOffset chunkStart)
+{
+    Item item;
+    esp_err_t err;
+
     // setup limits for chunkIndex-es to be deleted
     uint8_t minChunkIndex = (uint8_t) VerOffset::VER_0_OFFSET;
     uint8_t maxChunkIndex = (uint8_t) VerOffset::VER_ANY;
@@ -893,6 +1187,35 @@ esp_err_t Storage::fillStats(nvs_stats_t& nvsStats)
     return mPageManager.fillStats(nvsStats);
 }
 
+void Storage::fillRamUsage(nvs_ram_usage_t& ramUsage)
+{
+    mPageManager.fillRamUsage(ramUsage);
+#ifdef CONFIG_NVS_GLOBAL_KEY_INDEX
+    ramUsage.key_index = mKeyIndex.getRamUsage();
+#else
+    ramUsage.key_index = 0;
+#endif
+#ifdef CONFIG_NVS_ORDERED_INDEX
+    ramUsage.ordered_index = mOrderedIndex.getRamUsage();
+#else
+    ramUsage.ordered_index = 0;
+#endif
+    ramUsage.namespaces = mNamespaces.size() * sizeof(NamespaceEntry);
+    ramUsage.total = ramUsage.pages + ramUsage.hash_lists + ramUsage.key_index + ramUsage.ordered_index
+                     + ramUsage.namespaces;
+}
+
+#ifdef CONFIG_NVS_GC_STEP
+esp_err_t Storage::collectGarbage(size_t maxEntries)
+{
+    if (mState != StorageState::ACTIVE) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+
+    return mPageManager.collectGarbage(maxEntries);
+}
+#endif
+
 esp_err_t Storage::calcEntriesInNamespace(uint8_t nsIndex, size_t& usedEntries)
 {
     usedEntries = 0;
@@ -934,11 +1257,16 @@ void Storage::fillEntryInfo(Item &item, nvs_entry_info_t &info)
     }
 }
 
-bool Storage::findEntry(nvs_opaque_iterator_t* it, const char* namespace_name)
+bool Storage::findEntry(nvs_opaque_iterator_t* it, const char* namespace_name, const char* prefix)
 {
+    strncpy(it->prefix, prefix, sizeof(it->prefix) - 1);
+    it->prefix[sizeof(it->prefix) - 1] = 0;
     it->entryIndex = 0;
     it->nsIndex = Page::NS_ANY;
     it->page = mPageManager.begin();
+#ifdef CONFIG_NVS_ORDERED_INDEX
+    it->started = false;
+#endif
 
     if (namespace_name != nullptr) {
         if(createOrOpenNamespace(namespace_name, false, it->nsIndex) != ESP_OK) {
@@ -951,9 +1279,13 @@ bool Storage::findEntry(nvs_opaque_iterator_t* it, const char* namespace_name)
 
 bool Storage::findEntryNs(nvs_opaque_iterator_t* it, uint8_t nsIndex)
 {
+    it->prefix[0] = 0;
     it->entryIndex = 0;
     it->nsIndex = nsIndex;
     it->page = mPageManager.begin();
+#ifdef CONFIG_NVS_ORDERED_INDEX
+    it->started = false;
+#endif
 
     return nextEntry(it);
 }
@@ -972,16 +1304,33 @@ inline bool isMultipageBlob(Item& item)
                     || item.chunkIndex == static_cast<uint8_t>(VerOffset::VER_1_OFFSET)));
 }
 
+#ifdef CONFIG_NVS_ORDERED_INDEX
+bool Storage::nextEntry(nvs_opaque_iterator_t* it)
+{
+    auto entry = mOrderedIndex.next(it->nsIndex, (ItemType)it->type, it->prefix, it->started ? &it->last : nullptr);
+    if (entry == nullptr) {
+        return false;
+    }
+
+    it->last = *entry;
+    it->started = true;
+    Item item(entry->mNsIndex, entry->mDatatype, 0, entry->mKey);
+    fillEntryInfo(item, it->entry_info);
+    return true;
+}
+#else
 bool Storage::nextEntry(nvs_opaque_iterator_t* it)
 {
     Item item;
     esp_err_t err;
+    const size_t prefixLen = strlen(it->prefix);
 
     for (auto page = it->page; page != mPageManager.end(); ++page) {
         do {
             err = page->findItem(it->nsIndex, (ItemType)it->type, nullptr, it->entryIndex, item);
             it->entryIndex += item.span;
-            if(err == ESP_OK && isIterableItem(item) && !isMultipageBlob(item)) {
+            if(err == ESP_OK && isIterableItem(item) && !isMultipageBlob(item)
+                    && strncmp(item.key, it->prefix, prefixLen) == 0) {
                 fillEntryInfo(item, it->entry_info);
                 it->page = page;
                 return true;
@@ -993,7 +1342,250 @@ bool Storage::nextEntry(nvs_opaque_iterator_t* it)
 
     return false;
 }
+#endif // CONFIG_NVS_ORDERED_INDEX
+
+
+esp_err_t Storage::openBlobStream(nvs_opaque_blob_t* blob)
+{
+    if (mState != StorageState::ACTIVE) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+
+    Item item;
+    Page* findPage = nullptr;
+    auto err = findItem(blob->nsIndex, ItemType::BLOB_IDX, blob->key, findPage, item);
+    if (err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
+        return err;
+    }
+
+    if (blob->write) {
+        blob->chunkStart = VerOffset::VER_0_OFFSET;
+        if (err == ESP_OK) {
+            blob->replace = true;
+            blob->prevStart = item.blobIndex.chunkStart;
+            NVS_ASSERT_OR_RETURN(blob->prevStart == VerOffset::VER_0_OFFSET || blob->prevStart == VerOffset::VER_1_OFFSET, ESP_FAIL);
+            blob->chunkStart = (blob->prevStart == VerOffset::VER_1_OFFSET) ? VerOffset::VER_0_OFFSET : VerOffset::VER_1_OFFSET;
+        }
+        // chunks of a stream which was not closed, they would be taken for chunks of the new version
+        err = eraseBlobData(blob->nsIndex, blob->key, blob->chunkStart);
+        if (err == ESP_OK) {
+            ++mWriteStreamCount;
+        }
+        return err;
+    }
+
+    if (err == ESP_OK) {
+        blob->chunkStart = item.blobIndex.chunkStart;
+        blob->chunkCount = item.blobIndex.chunkCount;
+        blob->dataSize = item.blobIndex.dataSize;
+        return ESP_OK;
+    }
+
+    /* Support for earlier versions where BLOBS were stored without index */
+    err = findItem(blob->nsIndex, ItemType::BLOB, blob->key, findPage, item);
+    if (err != ESP_OK) {
+        return err;
+    }
+    blob->legacy = true;
+    blob->chunkCount = 1;
+    blob->dataSize = item.varLength.dataSize;
+    return ESP_OK;
+}
+
+esp_err_t Storage::flushBlobStream(nvs_opaque_blob_t* blob, bool final)
+{
+    // Each chunk fills the rest of the current page, except for the last one
+    while (blob->length > 0 || (final && blob->chunkCount == 0)) {
+        Page& page = getCurrentPage();
+        size_t tailroom = page.getVarDataTailroom();
+        if (!final && blob->length < tailroom) {
+            break;
+        }
+
+        if (tailroom == 0 || (tailroom < blob->length && tailroom < Page::CHUNK_MAX_SIZE / 10)) {
+            /* Not worth a chunk, the number of chunks is limited */
+            if (page.state() != Page::PageState::FULL) {
+                auto err = page.markFull();
+                if (err != ESP_OK) {
+                    return err;
+                }
+            }
+            auto err = mPageManager.requestNewPage();
+            if (err != ESP_OK) {
+                return err;
+            } else if (getCurrentPage().getVarDataTailroom() == tailroom) {
+                /* We got the same page or we are not improving.*/
+                return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+            }
+            continue;
+        }
+
+        if (blob->chunkCount >= (Page::CHUNK_ANY - 1) / 2) {
+            return ESP_ERR_NVS_VALUE_TOO_LONG;
+        }
+
+        size_t chunkSize = std::min(tailroom, blob->length);
+        auto err = page.writeItem(blob->nsIndex, ItemType::BLOB_DATA, blob->key, blob->buffer, chunkSize,
+                static_cast<uint8_t> (blob->chunkStart) + blob->chunkCount);
+        NVS_ASSERT_OR_RETURN(err != ESP_ERR_NVS_PAGE_FULL, err);
+        if (err != ESP_OK) {
+            return err;
+        }
+        blob->chunkCount++;
+        blob->length -= chunkSize;
+        memmove(blob->buffer, blob->buffer + chunkSize, blob->length);
+    }
+    return ESP_OK;
+}
+
+esp_err_t Storage::writeBlobStream(nvs_opaque_blob_t* blob, const void* data, size_t length)
+{
+    if (mState != StorageState::ACTIVE) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
 
+    if (blob->err != ESP_OK) {
+        return blob->err;
+    }
+
+    /* Check how much maximum data can be accommodated**/
+    uint32_t max_pages = mPageManager.getPageCount() - 1;
+    if (max_pages > (Page::CHUNK_ANY - 1) / 2) {
+        max_pages = (Page::CHUNK_ANY - 1) / 2;
+    }
+    if (length > max_pages * Page::CHUNK_MAX_SIZE - blob->dataSize) {
+        blob->err = ESP_ERR_NVS_VALUE_TOO_LONG;
+        return blob->err;
+    }
+
+    const uint8_t* src = static_cast<const uint8_t*>(data);
+    while (length > 0) {
+        size_t copySize = std::min(length, sizeof(blob->buffer) - blob->length);
+        memcpy(blob->buffer + blob->length, src, copySize);
+        blob->length += copySize;
+        blob->dataSize += copySize;
+        src += copySize;
+        length -= copySize;
+
+        if (blob->length == sizeof(blob->buffer)) {
+            blob->err = flushBlobStream(blob, false);
+            if (blob->err != ESP_OK) {
+                return blob->err;
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t Storage::readBlobStream(nvs_opaque_blob_t* blob, void* data, size_t& length)
+{
+    if (mState != StorageState::ACTIVE) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+
+    uint8_t* dst = static_cast<uint8_t*>(data);
+    size_t readSize = 0;
+    while (readSize < length) {
+        if (blob->offset == blob->length) {
+            if (blob->chunkIndex == blob->chunkCount) {
+                break;
+            }
+
+            /* Read the next chunk into the buffer */
+            const ItemType datatype = blob->legacy ? ItemType::BLOB : ItemType::BLOB_DATA;
+            const uint8_t chunkIdx = blob->legacy ? Page::CHUNK_ANY : static_cast<uint8_t> (blob->chunkStart) + blob->chunkIndex;
+            Item item;
+            Page* findPage = nullptr;
+            auto err = findItem(blob->nsIndex, datatype, blob->key, findPage, item, chunkIdx);
+            if (err != ESP_OK) {
+                return err;
+            }
+            if (item.varLength.dataSize > sizeof(blob->buffer)) {
+                return ESP_ERR_NVS_INVALID_LENGTH;
+            }
+            err = findPage->readItem(blob->nsIndex, datatype, blob->key, blob->buffer, item.varLength.dataSize, chunkIdx);
+            if (err != ESP_OK) {
+                return err;
+            }
+            blob->chunkIndex++;
+            blob->offset = 0;
+            blob->length = item.varLength.dataSize;
+            continue;
+        }
+
+        size_t copySize = std::min(length - readSize, blob->length - blob->offset);
+        memcpy(dst + readSize, blob->buffer + blob->offset, copySize);
+        blob->offset += copySize;
+        readSize += copySize;
+    }
+
+    length = readSize;
+    return ESP_OK;
+}
+
+esp_err_t Storage::closeBlobStream(nvs_opaque_blob_t* blob)
+{
+    if (mState != StorageState::ACTIVE) {
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+    if (!blob->write) {
+        return ESP_OK;
+    }
+    --mWriteStreamCount;
+
+    esp_err_t err = blob->err;
+    if (err == ESP_OK) {
+        err = flushBlobStream(blob, true);
+    }
+    if (err == ESP_OK) {
+        /* All chunks are stored. Now store the index.*/
+        Item item;
+        std::fill_n(item.data, sizeof(item.data), 0xff);
+        item.blobIndex.dataSize = blob->dataSize;
+        item.blobIndex.chunkCount = blob->chunkCount;
+        item.blobIndex.chunkStart = blob->chunkStart;
+
+        Page& page = getCurrentPage();
+        err = page.writeItem(blob->nsIndex, ItemType::BLOB_IDX, blob->key, item.data, sizeof(item.data));
+        if (err == ESP_ERR_NVS_PAGE_FULL) {
+            err = ESP_OK;
+            if (page.state() != Page::PageState::FULL) {
+                err = page.markFull();
+            }
+            if (err == ESP_OK) {
+                err = mPageManager.requestNewPage();
+            }
+            if (err == ESP_OK) {
+                err = getCurrentPage().writeItem(blob->nsIndex, ItemType::BLOB_IDX, blob->key, item.data, sizeof(item.data));
+            }
+        }
+    }
+
+    if (err != ESP_OK) {
+        /* Anything failed, then we should erase all the written chunks*/
+        eraseBlobData(blob->nsIndex, blob->key, blob->chunkStart);
+        return err;
+    }
+
+    if (blob->replace) {
+        /* Erase the blob with earlier version*/
+        err = eraseMultiPageBlob(blob->nsIndex, blob->key, blob->prevStart);
+    } else {
+        /* Support for earlier versions where BLOBS were stored without index */
+        Item item;
+        Page* findPage = nullptr;
+        err = findItem(blob->nsIndex, ItemType::BLOB, blob->key, findPage, item);
+        if (err == ESP_OK) {
+            err = findPage->eraseItem(blob->nsIndex, ItemType::BLOB, blob->key);
+        } else if (err == ESP_ERR_NVS_NOT_FOUND) {
+            err = ESP_OK;
+        }
+    }
+    if (err == ESP_ERR_FLASH_OP_FAIL) {
+        return ESP_ERR_NVS_REMOVE_FAILED;
+    }
+    return err;
+}
 
 }
 
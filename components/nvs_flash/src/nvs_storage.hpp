@@ -9,10 +9,13 @@
 #include <memory>
 #include <cstdlib>
 #include <unordered_map>
+#include "sdkconfig.h"
 #include "nvs.hpp"
 #include "nvs_types.hpp"
 #include "nvs_page.hpp"
 #include "nvs_pagemanager.hpp"
+#include "nvs_key_index.hpp"
+#include "nvs_ordered_index.hpp"
 #include "nvs_memory_management.hpp"
 #include "partition.hpp"
 
@@ -55,7 +58,41 @@ class Storage : public intrusive_list_node<Storage>, public ExceptionlessAllocat
 
     typedef intrusive_list<BlobIndexNode> TBlobIndexList;
 
+    /**
+     * Namespace table entry stored in the index snapshot, name is not terminated if it has the maximum length.
+     */
+    struct SnapshotNamespace {
+        char name[Item::MAX_KEY_LENGTH];
+        uint8_t index;
+    };
+
 public:
+    /**
+     * Item staged by a write transaction and written by writeBatch().
+     */
+    struct BatchItem : public intrusive_list_node<BatchItem>, public ExceptionlessAllocatable {
+    public:
+        ~BatchItem()
+        {
+            delete[] data;
+        }
+
+        char key[Item::MAX_KEY_LENGTH + 1];
+        ItemType datatype;
+        uint8_t* data = nullptr;
+        size_t dataSize = 0;
+
+        // state used by writeBatch()
+        bool unchanged;
+        Page* oldPage;
+        bool oldBlobIndex;
+        VerOffset oldChunkStart;
+        VerOffset chunkStart;
+        uint8_t blobIndex[8];
+    };
+
+    typedef intrusive_list<BatchItem> TBatchList;
+
     ~Storage();
 
     Storage(Partition *partition) : mPartition(partition) {
@@ -72,6 +109,12 @@ public:
 
     esp_err_t writeItem(uint8_t nsIndex, ItemType datatype, const char* key, const void* data, size_t dataSize);
 
+    /**
+     * Writes all items of the batch to the current page at once, see Page::writeItems().
+     * Blobs are stored as a single chunk, so the whole batch has to fit into one page.
+     */
+    esp_err_t writeBatch(uint8_t nsIndex, TBatchList& batch);
+
     esp_err_t readItem(uint8_t nsIndex, ItemType datatype, const char* key, void* data, size_t dataSize);
 
     esp_err_t findKey(const uint8_t nsIndex, const char* key, ItemType* datatype);
@@ -128,14 +171,39 @@ public:
 
     esp_err_t fillStats(nvs_stats_t& nvsStats);
 
+    void fillRamUsage(nvs_ram_usage_t& ramUsage);
+
+#ifdef CONFIG_NVS_GC_STEP
+    esp_err_t collectGarbage(size_t maxEntries);
+#endif
+
+    /**
+     * Writes the index snapshot used by init() to skip reading all items when nothing has changed since,
+     * see CONFIG_NVS_FAST_MOUNT. It holds the namespace table of the partition.
+     */
+    esp_err_t writeSnapshot();
+
     esp_err_t calcEntriesInNamespace(uint8_t nsIndex, size_t& usedEntries);
 
-    bool findEntry(nvs_opaque_iterator_t* it, const char* name);
+    bool findEntry(nvs_opaque_iterator_t* it, const char* name, const char* prefix = "");
 
     bool findEntryNs(nvs_opaque_iterator_t* it, uint8_t nsIndex);
 
     bool nextEntry(nvs_opaque_iterator_t* it);
 
+    /**
+     * Streaming access to blobs, see nvs_blob_open(). Written data is collected in the page sized buffer of
+     * the stream and stored as BLOB_DATA chunks of the next blob version whenever it fills the rest of the
+     * current page. The BLOB_IDX item which makes the new version visible is written by closeBlobStream().
+     */
+    esp_err_t openBlobStream(nvs_opaque_blob_t* blob);
+
+    esp_err_t writeBlobStream(nvs_opaque_blob_t* blob, const void* data, size_t length);
+
+    esp_err_t readBlobStream(nvs_opaque_blob_t* blob, void* data, size_t& length);
+
+    esp_err_t closeBlobStream(nvs_opaque_blob_t* blob);
+
 protected:
 
     Page& getCurrentPage()
@@ -145,6 +213,10 @@ protected:
 
     void clearNamespaces();
 
+    esp_err_t loadNamespaces();
+
+    esp_err_t loadSnapshot();
+
     esp_err_t populateBlobIndices(TBlobIndexList&);
 
     void eraseMismatchedBlobIndexes(TBlobIndexList&);
@@ -153,6 +225,10 @@ protected:
 
     void fillEntryInfo(Item &item, nvs_entry_info_t &info);
 
+    esp_err_t flushBlobStream(nvs_opaque_blob_t* blob, bool final);
+
+    esp_err_t eraseBlobData(uint8_t nsIndex, const char* key, VerOffset chunkStart);
+
     esp_err_t findItem(uint8_t nsIndex, ItemType datatype, const char* key, Page* &page, Item& item, uint8_t chunkIdx = Page::CHUNK_ANY, VerOffset chunkStart = VerOffset::VER_ANY);
 
 protected:
@@ -162,6 +238,13 @@ protected:
     TNamespaces mNamespaces;
     CompressedEnumTable<bool, 1, 256> mNamespaceUsage;
     StorageState mState = StorageState::INVALID;
+    size_t mWriteStreamCount = 0;
+#ifdef CONFIG_NVS_GLOBAL_KEY_INDEX
+    KeyIndex mKeyIndex;
+#endif
+#ifdef CONFIG_NVS_ORDERED_INDEX
+    OrderedIndex mOrderedIndex;
+#endif
 };
 
 } // namespace nvs
@@ -174,6 +257,30 @@ struct nvs_opaque_iterator_t
     nvs::Storage *storage;
     intrusive_list<nvs::Page>::iterator page;
     nvs_entry_info_t entry_info;
+    char prefix[NVS_KEY_NAME_MAX_SIZE];
+#ifdef CONFIG_NVS_ORDERED_INDEX
+    bool started;
+    nvs::OrderedIndex::Entry last;
+#endif
+};
+
+struct nvs_opaque_blob_t
+{
+    nvs_handle_t handle;
+    uint8_t nsIndex;
+    char key[NVS_KEY_NAME_MAX_SIZE];
+    bool write;
+    bool legacy;                /* reading a blob stored without index, as a single BLOB item */
+    bool replace;               /* writing a blob which replaces an existing one of version prevStart */
+    esp_err_t err;              /* first error while writing, the stream is discarded on close */
+    nvs::VerOffset chunkStart;
+    nvs::VerOffset prevStart;
+    uint8_t chunkCount;         /* chunks written so far, or chunks of the blob being read */
+    uint8_t chunkIndex;         /* next chunk to read */
+    size_t dataSize;            /* bytes written so far, or size of the blob being read */
+    size_t offset;              /* bytes of buffer consumed by reads */
+    size_t length;              /* bytes in buffer */
+    uint8_t buffer[nvs::Page::CHUNK_MAX_SIZE];
 };
 
 #endif /* nvs_storage_hpp */